@@ -0,0 +1,137 @@
+// GET /api/v1/candles handled in-process: query parsing, repository read and
+// the JSON encoding of Controllers::candles, without the socket.
+//
+//   make bench   (links against the server objects; see the Makefile)
+//   ./bin/bench_candles_json [requests]
+//
+// The repository is an in-memory stand-in holding 100k 1m candles, so the
+// figures isolate the handler from DuckDB. They are all closed, so after the
+// first request each response is assembled from pre-encoded candle blocks.
+// Each limit is timed separately; body_bytes is the size of one response.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "api/Controllers.hpp"
+#include "domain/Ports.hpp"
+#include "logging/Log.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kStoredCandles = 100'000;
+constexpr std::int32_t kMaxLimit = 5000;
+
+class MemoryCandleRepo : public domain::contracts::ICandleReadRepo {
+public:
+    explicit MemoryCandleRepo(std::size_t count) {
+        candles_.resize(count);
+        std::mt19937_64 rng(42);
+        std::normal_distribution<double> step(0.0, 25.0);
+        double price = 60'000.0;
+        for (std::size_t i = 0; i < count; ++i) {
+            auto& candle = candles_[i];
+            candle.ts = 1'700'000'000'000LL + static_cast<std::int64_t>(i) * 60'000;
+            candle.o = price;
+            price = std::max(1.0, price + step(rng));
+            candle.c = price;
+            candle.h = std::max(candle.o, candle.c) + 4.25;
+            candle.l = std::min(candle.o, candle.c) - 3.75;
+            candle.v = 12.345678 + static_cast<double>(i % 97);
+        }
+    }
+
+    // Same contract as the real repositories: a range returns its first
+    // `limit` rows, no range the latest `limit`.
+    std::vector<domain::contracts::Candle> getCandles(const domain::contracts::Symbol& symbol,
+                                                      domain::contracts::Interval interval,
+                                                      std::int64_t fromTs,
+                                                      std::int64_t toTs,
+                                                      std::size_t limit) const override {
+        (void)symbol;
+        (void)interval;
+        auto begin = candles_.begin();
+        auto end = candles_.end();
+        if (fromTs > 0) {
+            begin = std::lower_bound(begin, end, fromTs, [](const auto& candle, std::int64_t ts) { return candle.ts < ts; });
+        }
+        if (toTs > 0) {
+            end = std::upper_bound(begin, end, toTs, [](std::int64_t ts, const auto& candle) { return ts < candle.ts; });
+        }
+        if (static_cast<std::size_t>(end - begin) > limit) {
+            if (fromTs > 0 || toTs > 0) {
+                end = begin + static_cast<std::ptrdiff_t>(limit);
+            }
+            else {
+                begin = end - static_cast<std::ptrdiff_t>(limit);
+            }
+        }
+        return {begin, end};
+    }
+
+    std::optional<std::pair<std::int64_t, std::int64_t>> get_min_max_ts(const domain::contracts::Symbol& symbol,
+                                                                        const std::string& interval) const override {
+        (void)symbol;
+        (void)interval;
+        return std::make_pair(candles_.front().ts, candles_.back().ts);
+    }
+
+    std::optional<bool> symbolExists(const domain::contracts::Symbol& symbol) const override {
+        return symbol == "BTCUSDT";
+    }
+
+private:
+    std::vector<domain::contracts::Candle> candles_;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t requests = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000;
+    if (requests == 0) {
+        std::fprintf(stderr, "usage: %s [requests]\n", argv[0]);
+        return 1;
+    }
+
+    logging::Log::set_log_level(config::LogLevel::Warn);
+    ttp::api::setCandleRepository(std::make_shared<MemoryCandleRepo>(kStoredCandles));
+    ttp::api::setHttpLimits(500, kMaxLimit);
+
+    std::printf("{\"bench\":\"candles_json\",\"requests\":%zu", requests);
+    int failures = 0;
+    for (const int limit : {100, 1000, kMaxLimit}) {
+        const ttp::api::Request request("GET /api/v1/candles?symbol=BTCUSDT&interval=1m&limit=" + std::to_string(limit)
+                                        + " HTTP/1.1\r\n\r\n");
+
+        std::size_t bodyBytes = 0;
+        const auto start = Clock::now();
+        for (std::size_t i = 0; i < requests; ++i) {
+            const auto response = ttp::api::candles(request);
+            if (response.statusCode != 200) {
+                ++failures;
+            }
+            bodyBytes = response.body.size();
+        }
+        const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+        const double usPerRequest = elapsed.count() / static_cast<double>(requests);
+        std::printf(",\"limit_%d_us_per_request\":%.1f,\"limit_%d_body_bytes\":%zu,\"limit_%d_mb_per_sec\":%.1f",
+                    limit,
+                    usPerRequest,
+                    limit,
+                    bodyBytes,
+                    limit,
+                    static_cast<double>(bodyBytes) / usPerRequest);
+    }
+    std::printf(",\"failures\":%d}\n", failures);
+    return failures == 0 ? 0 : 1;
+}
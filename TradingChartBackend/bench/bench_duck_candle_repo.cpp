@@ -0,0 +1,143 @@
+// DuckCandleRepo on a synthetic 1m series: bulk upsert_batch, then latest-N
+// and range reads through getCandles.
+//
+//   make bench BENCH_DUCK_ROWS=10000000   (needs DuckDB, see the Makefile)
+//   ./bin/bench_duck_candle_repo [rows] [db path] [reads]
+//
+// Rows are generated one batch at a time, so 100M-row runs only need disk.
+// The database file is recreated on every run and removed at the end.
+// Without DuckDB compiled in the bench reports itself as skipped.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "adapters/duckdb/DuckCandleRepo.hpp"
+#include "adapters/duckdb/DuckStore.hpp"
+#include "domain/Models.hpp"
+#include "domain/Types.h"
+#include "logging/Log.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kUpsertBatch = 100'000;
+constexpr std::int64_t kFirstOpenMs = 1'600'000'000'000LL;
+constexpr std::int64_t kIntervalMs = 60'000;
+
+void fillBatch(std::size_t first, std::size_t count, double& price, std::mt19937_64& rng, std::vector<domain::Candle>& rows) {
+    std::normal_distribution<double> step(0.0, 25.0);
+    rows.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto& candle = rows[i];
+        candle.openTime = kFirstOpenMs + static_cast<std::int64_t>(first + i) * kIntervalMs;
+        candle.closeTime = candle.openTime + kIntervalMs - 1;
+        candle.open = price;
+        price = std::max(1.0, price + step(rng));
+        candle.close = price;
+        candle.high = std::max(candle.open, candle.close) + 5.0;
+        candle.low = std::min(candle.open, candle.close) - 5.0;
+        candle.baseVolume = 1.0 + static_cast<double>(i % 50);
+        candle.isClosed = true;
+    }
+}
+
+template <typename Fn>
+double averageUs(std::size_t reads, Fn&& fn) {
+    const auto start = Clock::now();
+    for (std::size_t i = 0; i < reads; ++i) {
+        fn(i);
+    }
+    const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+    return elapsed.count() / static_cast<double>(reads);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const std::string dbPath = argc > 2 ? argv[2] : "bench/data/bench_candles.duckdb";
+    const std::size_t reads = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 200;
+    if (rows == 0 || reads == 0) {
+        std::fprintf(stderr, "usage: %s [rows] [db path] [reads]\n", argv[0]);
+        return 1;
+    }
+
+#if !defined(HAS_DUCKDB)
+    std::printf("{\"bench\":\"duck_candle_repo\",\"rows\":%zu,\"skipped\":\"built without DuckDB\"}\n", rows);
+    return 0;
+#else
+    logging::Log::set_log_level(config::LogLevel::Warn);
+    std::error_code ec;
+    std::filesystem::remove(dbPath, ec);
+    std::filesystem::remove(dbPath + ".wal", ec);
+
+    const std::string symbol = "BTCUSDT";
+    const std::string intervalLabel = "1m";
+    const auto interval = domain::contracts::intervalFromString(intervalLabel);
+    // The partition catalog and series bounds are created by the migration.
+    adapters::duckdb::DuckStore(dbPath).migrate();
+    adapters::duckdb::DuckCandleRepo repo(dbPath);
+
+    std::mt19937_64 rng(42);
+    double price = 30'000.0;
+    std::vector<domain::Candle> batch;
+    bool ok = true;
+    const auto upsertStart = Clock::now();
+    for (std::size_t first = 0; first < rows && ok; first += kUpsertBatch) {
+        fillBatch(first, std::min(kUpsertBatch, rows - first), price, rng, batch);
+        ok = repo.upsert_batch(symbol, intervalLabel, batch);
+    }
+    const std::chrono::duration<double> upsertElapsed = Clock::now() - upsertStart;
+
+    // Replacing rows that already exist takes the conflict path of the upsert.
+    const std::size_t tail = std::min<std::size_t>(rows, 1000);
+    fillBatch(rows - tail, tail, price, rng, batch);
+    const auto replaceStart = Clock::now();
+    ok = repo.upsert_batch(symbol, intervalLabel, batch) && ok;
+    const std::chrono::duration<double, std::milli> replaceElapsed = Clock::now() - replaceStart;
+
+    std::size_t returned = 0;
+    const double latestUs = averageUs(reads, [&](std::size_t) {
+        returned += repo.getCandles(symbol, interval, 0, 0, 1000).size();
+    });
+
+    // One-day windows spread over the whole series, so reads span partitions.
+    const std::size_t window = 1440;
+    const std::size_t span = rows > window ? rows - window : 1;
+    const double rangeUs = averageUs(reads, [&](std::size_t i) {
+        const auto offset = static_cast<std::int64_t>((i * 7919U) % span);
+        const auto from = kFirstOpenMs + offset * kIntervalMs;
+        const auto to = from + static_cast<std::int64_t>(window - 1) * kIntervalMs;
+        returned += repo.getCandles(symbol, interval, from, to, window).size();
+    });
+
+    std::uintmax_t fileBytes = std::filesystem::file_size(dbPath, ec);
+    if (ec) {
+        fileBytes = 0;
+    }
+    std::filesystem::remove(dbPath, ec);
+    std::filesystem::remove(dbPath + ".wal", ec);
+
+    std::printf("{\"bench\":\"duck_candle_repo\",\"rows\":%zu,\"reads\":%zu,\"upsert_rows_per_sec\":%.0f,"
+                "\"replace_1000_ms\":%.1f,\"latest_1000_us\":%.0f,\"range_1440_us\":%.0f,"
+                "\"db_bytes\":%ju,\"returned\":%zu,\"ok\":%s}\n",
+                rows,
+                reads,
+                static_cast<double>(rows) / upsertElapsed.count(),
+                replaceElapsed.count(),
+                latestUs,
+                rangeUs,
+                fileBytes,
+                returned,
+                ok ? "true" : "false");
+    return ok ? 0 : 1;
+#endif
+}
@@ -0,0 +1,155 @@
+// K EMA periods in one pass (indicators::fan::emaFan) against K separate
+// IndicatorEngine::computeEMA calls over the same candles.
+//
+//   g++ -std=c++17 -O3 -Isrc bench/bench_indicator_fan.cpp src/indicators/IndicatorEngine.cpp -o bin/bench_indicator_fan
+//   ./bin/bench_indicator_fan [candles] [periods]
+//
+// Defaults to 1M synthetic 1m candles and the 9,21,50,100,200 overlay; pass
+// e.g. 10,20,30,40,50,60,70,80,90,100,110,120 for a ribbon. Each figure is
+// the best of several runs. The fan timings include extracting the close column;
+// the result block is reused across runs, as a caller refreshing a chart would.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "domain/Types.h"
+#include "indicators/IndicatorEngine.h"
+#include "indicators/IndicatorFan.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kRuns = 5;
+
+std::vector<int> parsePeriods(const char* raw) {
+    std::vector<int> periods;
+    std::string text{raw};
+    std::size_t start = 0;
+    while (start <= text.size()) {
+        const auto end = std::min(text.find(',', start), text.size());
+        if (end > start) {
+            periods.push_back(std::atoi(text.substr(start, end - start).c_str()));
+        }
+        start = end + 1;
+    }
+    return periods;
+}
+
+domain::CandleSeries makeSeries(std::size_t count) {
+    domain::CandleSeries series;
+    series.interval = domain::Interval{60'000};
+    series.data.resize(count);
+    std::mt19937_64 rng(42);
+    std::normal_distribution<double> step(0.0, 25.0);
+    double price = 60'000.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto& candle = series.data[i];
+        candle.openTime = 1'700'000'000'000LL + static_cast<std::int64_t>(i) * 60'000;
+        candle.closeTime = candle.openTime + 59'999;
+        candle.open = price;
+        price = std::max(1.0, price + step(rng));
+        candle.close = price;
+        candle.high = std::max(candle.open, candle.close) + 5.0;
+        candle.low = std::min(candle.open, candle.close) - 5.0;
+        candle.baseVolume = 1.0;
+        candle.isClosed = true;
+    }
+    series.firstOpen = series.data.front().openTime;
+    series.lastOpen = series.data.back().openTime;
+    return series;
+}
+
+template <typename Fn>
+double bestMs(Fn&& fn) {
+    double best = 1e300;
+    for (int run = 0; run < kRuns; ++run) {
+        const auto start = Clock::now();
+        fn();
+        const std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+template <typename T>
+double maxRelativeError(const indicators::fan::FanResult<T>& block, const std::vector<indicators::IndicatorSeries>& reference) {
+    double worst = 0.0;
+    for (std::size_t k = 0; k < reference.size(); ++k) {
+        const T* column = block.column(k);
+        for (std::size_t i = 0; i < block.rows; ++i) {
+            const double expected = reference[k].values[i];
+            const double actual = static_cast<double>(column[i]);
+            if (std::isnan(expected) != std::isnan(actual)) {
+                return 1.0;
+            }
+            if (!std::isnan(expected)) {
+                worst = std::max(worst, std::fabs(actual - expected) / std::max(1.0, std::fabs(expected)));
+            }
+        }
+    }
+    return worst;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const auto periods = parsePeriods(argc > 2 ? argv[2] : "9,21,50,100,200");
+    if (count == 0 || periods.empty()) {
+        std::fprintf(stderr, "usage: %s [candles] [p1,p2,...]\n", argv[0]);
+        return 1;
+    }
+
+    const auto series = makeSeries(count);
+
+    std::vector<indicators::IndicatorSeries> reference(periods.size());
+    const double separateMs = bestMs([&]() {
+        for (std::size_t k = 0; k < periods.size(); ++k) {
+            reference[k] = indicators::IndicatorEngine::computeEMA(series, indicators::EmaParams{periods[k]});
+        }
+    });
+
+    std::vector<double> closes;
+    indicators::fan::FanResult<float> fanFloat;
+    const double floatMs = bestMs([&]() {
+        closes.assign(count, 0.0);
+        for (std::size_t i = 0; i < count; ++i) {
+            closes[i] = series.data[i].close;
+        }
+        indicators::fan::emaFan(closes.data(), count, periods, fanFloat);
+    });
+
+    indicators::fan::FanResult<double> fanDouble;
+    const double doubleMs = bestMs([&]() {
+        closes.assign(count, 0.0);
+        for (std::size_t i = 0; i < count; ++i) {
+            closes[i] = series.data[i].close;
+        }
+        indicators::fan::emaFan(closes.data(), count, periods, fanDouble);
+    });
+
+    const double floatError = maxRelativeError(fanFloat, reference);
+    const double doubleError = maxRelativeError(fanDouble, reference);
+
+    std::printf("{\"bench\":\"indicator_fan\",\"candles\":%zu,\"periods\":%zu,\"separate_ms\":%.2f,"
+                "\"fan_float_ms\":%.2f,\"fan_double_ms\":%.2f,\"speedup_float\":%.2f,\"speedup_double\":%.2f,"
+                "\"max_rel_err_float\":%.2e,\"max_rel_err_double\":%.2e}\n",
+                count,
+                periods.size(),
+                separateMs,
+                floatMs,
+                doubleMs,
+                separateMs / floatMs,
+                separateMs / doubleMs,
+                floatError,
+                doubleError);
+    // computeEMA rounds to float, so both variants are held to float accuracy.
+    return floatError < 1e-5 && doubleError < 1e-5 ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+// Batch indicator kernels (computeIndicator over OHLCV columns), the legacy
+// IndicatorEngine::computeEMA and the per-bar RollingIndicator update.
+//
+//   g++ -std=c++17 -O3 -Isrc bench/bench_indicator_kernels.cpp src/indicators/IndicatorKernels.cpp src/indicators/IndicatorSpec.cpp src/indicators/RollingIndicator.cpp src/indicators/IndicatorEngine.cpp -o bin/bench_indicator_kernels
+//   ./bin/bench_indicator_kernels [candles]
+//
+// Every indicator runs with its default parameters over the same synthetic
+// 1m random walk. Figures are ns per bar, best of several runs.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "domain/Types.h"
+#include "indicators/IndicatorEngine.h"
+#include "indicators/IndicatorSpec.h"
+#include "indicators/RollingIndicator.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kRuns = 5;
+
+constexpr indicators::IndicatorKind kKinds[] = {
+    indicators::IndicatorKind::Ema,
+    indicators::IndicatorKind::Sma,
+    indicators::IndicatorKind::Rsi,
+    indicators::IndicatorKind::Macd,
+    indicators::IndicatorKind::Bbands,
+    indicators::IndicatorKind::Atr,
+    indicators::IndicatorKind::Vwap,
+};
+
+indicators::kernels::OhlcvColumns makeColumns(std::size_t count) {
+    indicators::kernels::OhlcvColumns columns;
+    columns.resize(count);
+    std::mt19937_64 rng(42);
+    std::normal_distribution<double> step(0.0, 25.0);
+    std::uniform_real_distribution<double> volume(0.1, 50.0);
+    double price = 60'000.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        columns.openTime[i] = 1'700'000'000'000LL + static_cast<std::int64_t>(i) * 60'000;
+        columns.open[i] = price;
+        price = std::max(1.0, price + step(rng));
+        columns.close[i] = price;
+        columns.high[i] = std::max(columns.open[i], price) + 5.0;
+        columns.low[i] = std::min(columns.open[i], price) - 5.0;
+        columns.volume[i] = volume(rng);
+    }
+    return columns;
+}
+
+domain::CandleSeries toSeries(const indicators::kernels::OhlcvColumns& columns) {
+    domain::CandleSeries series;
+    series.interval = domain::Interval{60'000};
+    series.data.resize(columns.size());
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        auto& candle = series.data[i];
+        candle.openTime = columns.openTime[i];
+        candle.closeTime = candle.openTime + 59'999;
+        candle.open = columns.open[i];
+        candle.high = columns.high[i];
+        candle.low = columns.low[i];
+        candle.close = columns.close[i];
+        candle.baseVolume = columns.volume[i];
+        candle.isClosed = true;
+    }
+    series.firstOpen = series.data.front().openTime;
+    series.lastOpen = series.data.back().openTime;
+    return series;
+}
+
+template <typename Fn>
+double bestNsPerBar(std::size_t count, Fn&& fn) {
+    double best = 1e300;
+    for (int run = 0; run < kRuns; ++run) {
+        const auto start = Clock::now();
+        fn();
+        const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best / static_cast<double>(count);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    if (count == 0) {
+        std::fprintf(stderr, "usage: %s [candles]\n", argv[0]);
+        return 1;
+    }
+
+    const auto columns = makeColumns(count);
+    double checksum = 0.0;
+    const auto accumulate = [&checksum](double value) {
+        if (std::isfinite(value)) {
+            checksum += value;
+        }
+    };
+
+    std::printf("{\"bench\":\"indicator_kernels\",\"candles\":%zu", count);
+    for (const auto kind : kKinds) {
+        const indicators::IndicatorSpec spec{kind, *indicators::parseIndicatorParams(kind, "")};
+        const auto* name = indicators::indicatorKindName(kind);
+
+        const double batchNs = bestNsPerBar(count, [&]() {
+            const auto outputs = indicators::computeIndicator(spec, columns);
+            accumulate(outputs.front().back());
+        });
+
+        const double rollingNs = bestNsPerBar(count, [&]() {
+            indicators::RollingIndicator rolling(spec);
+            indicators::IndicatorValue last{};
+            for (std::size_t i = 0; i < count; ++i) {
+                last = rolling.push(indicators::IndicatorBar{
+                    columns.openTime[i], columns.high[i], columns.low[i], columns.close[i], columns.volume[i]});
+            }
+            accumulate(last[0]);
+        });
+
+        std::printf(",\"%s_batch_ns_per_bar\":%.2f,\"%s_rolling_ns_per_bar\":%.2f", name, batchNs, name, rollingNs);
+    }
+
+    const auto series = toSeries(columns);
+    const double engineNs = bestNsPerBar(count, [&]() {
+        const auto result = indicators::IndicatorEngine::computeEMA(series, indicators::EmaParams{20});
+        accumulate(result.values.back());
+    });
+
+    std::printf(",\"engine_ema_ns_per_bar\":%.2f,\"checksum\":%.3f}\n", engineNs, checksum);
+    return 0;
+}
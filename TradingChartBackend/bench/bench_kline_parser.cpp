@@ -0,0 +1,88 @@
+// Throughput of the Binance WS kline parser (single thread = per core).
+//
+//   g++ -std=c++17 -O2 -Isrc bench/bench_kline_parser.cpp src/adapters/binance/KlineMessageParser.cpp -o bin/bench_kline_parser
+//   ./bin/bench_kline_parser [bench/data/binance_kline_1m.jsonl] [iterations]
+//
+// When Boost.JSON is available the DOM parse used as fallback is measured too.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if __has_include(<boost/json.hpp>)
+#include <boost/json.hpp>
+#define BENCH_HAS_BOOST_JSON 1
+#endif
+
+#include "adapters/binance/KlineMessageParser.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::vector<std::string> loadPayloads(const char* path) {
+    std::vector<std::string> payloads;
+    std::ifstream input(path);
+    std::string line;
+    while (std::getline(input, line)) {
+        if (!line.empty()) {
+            payloads.push_back(line);
+        }
+    }
+    return payloads;
+}
+
+template <typename Fn>
+double messagesPerSecond(const std::vector<std::string>& payloads, std::size_t iterations, Fn&& parse) {
+    const auto start = Clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        for (const auto& payload : payloads) {
+            parse(payload);
+        }
+    }
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+    return static_cast<double>(iterations * payloads.size()) / elapsed.count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : "bench/data/binance_kline_1m.jsonl";
+    const std::size_t iterations = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000;
+
+    const auto payloads = loadPayloads(path);
+    if (payloads.empty()) {
+        std::fprintf(stderr, "no payloads in %s\n", path);
+        return 1;
+    }
+
+    std::size_t rejected = 0;
+    double checksum = 0.0;
+    const auto fast = messagesPerSecond(payloads, iterations, [&](const std::string& payload) {
+        adapters::binance::KlineMessage message;
+        if (adapters::binance::parse_kline_message(payload, message)) {
+            checksum += message.candle.close;
+        }
+        else {
+            ++rejected;
+        }
+    });
+
+    std::printf("{\"bench\":\"kline_parser\",\"payloads\":%zu,\"iterations\":%zu,\"fast_msgs_per_sec\":%.0f",
+                payloads.size(), iterations, fast);
+#if defined(BENCH_HAS_BOOST_JSON)
+    const auto dom = messagesPerSecond(payloads, iterations, [&](const std::string& payload) {
+        boost::json::error_code ec;
+        const auto value = boost::json::parse(payload, ec);
+        if (!ec) {
+            checksum += std::stod(std::string(value.at("data").at("k").at("c").as_string()));
+        }
+    });
+    std::printf(",\"dom_msgs_per_sec\":%.0f,\"speedup\":%.2f", dom, fast / dom);
+#endif
+    std::printf(",\"rejected\":%zu,\"checksum\":%.3f}\n", rejected, checksum);
+    return rejected == 0 ? 0 : 1;
+}
@@ -0,0 +1,94 @@
+// Request parsing (api/Request) and query-string lookups (http/QueryParams) as
+// HttpServer and the candle and indicator handlers issue them.
+//
+//   g++ -std=c++17 -O2 -Isrc bench/bench_query_params.cpp src/api/Request.cpp src/http/QueryParams.cpp -o bin/bench_query_params
+//   ./bin/bench_query_params [iterations]
+//
+// <case>_parse_ns times building a Request from the received head, including
+// the copy of the buffer the server would have moved in. <case>_ns_per_request
+// repeats the lookups of parse_candle_query on a parsed request: symbol,
+// interval, then limit/from/to looked up once and parsed as numbers.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "api/Request.hpp"
+#include "http/QueryParams.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Case {
+    const char* name;
+    std::string query;
+};
+
+std::int64_t parseCandleQuery(const ttp::api::Request& request) {
+    std::int64_t checksum = 0;
+    if (const auto symbol = ttp::http::opt_string(request, "symbol")) {
+        checksum += static_cast<std::int64_t>(symbol->size());
+    }
+    if (const auto interval = ttp::http::opt_string(request, "interval")) {
+        checksum += static_cast<std::int64_t>(interval->size());
+    }
+    if (const auto limit = ttp::http::opt_string(request, "limit")) {
+        checksum += ttp::http::parse_int(*limit).value_or(0);
+    }
+    if (const auto from = ttp::http::opt_string(request, "from")) {
+        checksum += ttp::http::parse_int64(*from).value_or(0);
+    }
+    if (const auto to = ttp::http::opt_string(request, "to")) {
+        checksum += ttp::http::parse_int64(*to).value_or(0);
+    }
+    return checksum;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    if (iterations == 0) {
+        std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    const std::vector<Case> cases = {
+        {"latest", "symbol=BTCUSDT&interval=1m&limit=500"},
+        {"range", "symbol=BTCUSDT&interval=1m&from=1700000000000&to=1700086400000&limit=1440"},
+        {"encoded", "symbol=BTC%55SDT&interval=1m&limit=500&type=macd&params=12%2C26%2C9"},
+    };
+
+    std::printf("{\"bench\":\"query_params\",\"iterations\":%zu", iterations);
+    std::int64_t checksum = 0;
+    for (const auto& testCase : cases) {
+        const std::string head = "GET /api/v1/candles?" + testCase.query
+            + " HTTP/1.1\r\nHost: localhost:8080\r\nAccept: application/json\r\n"
+              "If-None-Match: \"0123456789abcdef\"\r\n\r\n";
+
+        const auto parseStart = Clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            const ttp::api::Request parsed(head);
+            checksum += static_cast<std::int64_t>(parsed.paramCount());
+        }
+        const std::chrono::duration<double, std::nano> parseElapsed = Clock::now() - parseStart;
+
+        const ttp::api::Request request(head);
+        const auto start = Clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            checksum += parseCandleQuery(request);
+        }
+        const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        std::printf(",\"%s_parse_ns\":%.1f,\"%s_ns_per_request\":%.1f",
+                    testCase.name,
+                    parseElapsed.count() / static_cast<double>(iterations),
+                    testCase.name,
+                    elapsed.count() / static_cast<double>(iterations));
+    }
+    std::printf(",\"checksum\":%lld}\n", static_cast<long long>(checksum));
+    return 0;
+}
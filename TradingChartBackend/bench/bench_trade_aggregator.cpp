@@ -0,0 +1,121 @@
+// aggTrade -> sub-minute candles on one core: parse + 1s/5s/15s aggregation.
+//
+//   g++ -std=c++17 -O2 -pthread -Isrc bench/bench_trade_aggregator.cpp src/app/TradeAggregator.cpp src/adapters/binance/KlineMessageParser.cpp src/adapters/replay/KlineRecording.cpp src/logging/Log.cpp src/core/LogUtils.cpp -o bin/bench_trade_aggregator
+//   ./bin/bench_trade_aggregator [recording] [trades]
+//
+// With a recording (KlineRecorder format, e.g. --live-record of a trade feed)
+// its aggTrade frames are replayed at full speed; without one, a synthetic
+// BTCUSDT stream of `trades` frames is generated. The reported rate compares
+// against peak BTCUSDT bursts of roughly 10-20k aggTrades/s.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "adapters/binance/KlineMessageParser.hpp"
+#include "adapters/replay/KlineRecording.hpp"
+#include "app/TradeAggregator.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::vector<std::string> loadRecording(const char* path) {
+    std::vector<std::string> payloads;
+    adapters::replay::KlineRecordingReader reader;
+    if (!reader.open(path)) {
+        return payloads;
+    }
+    adapters::replay::RecordedMessage message;
+    while (reader.next(message)) {
+        payloads.emplace_back(message.payload);
+    }
+    return payloads;
+}
+
+// Random walk around 65k with bursty timestamps: ~15k trades/s of exchange time.
+std::vector<std::string> synthesize(std::size_t count) {
+    std::vector<std::string> payloads;
+    payloads.reserve(count);
+    std::mt19937_64 rng{42};
+    std::normal_distribution<double> step(0.0, 0.5);
+    std::exponential_distribution<double> gapUs(1.0 / 66.0);
+    std::uniform_real_distribution<double> qty(0.0001, 0.25);
+    double price = 65000.0;
+    double timeUs = 1'717'200'000'000'000.0;
+    char buffer[320];
+    for (std::size_t i = 0; i < count; ++i) {
+        price += step(rng);
+        timeUs += gapUs(rng);
+        const auto tradeMs = static_cast<long long>(timeUs / 1000.0);
+        const int len = std::snprintf(buffer,
+                                      sizeof(buffer),
+                                      "{\"stream\":\"btcusdt@aggTrade\",\"data\":{\"e\":\"aggTrade\",\"E\":%lld,"
+                                      "\"s\":\"BTCUSDT\",\"a\":%zu,\"p\":\"%.2f\",\"q\":\"%.5f\",\"f\":%zu,"
+                                      "\"l\":%zu,\"T\":%lld,\"m\":%s,\"M\":true}}",
+                                      tradeMs + 1,
+                                      i,
+                                      price,
+                                      qty(rng),
+                                      i * 2,
+                                      i * 2 + 1,
+                                      tradeMs,
+                                      (i % 3 == 0) ? "true" : "false");
+        payloads.emplace_back(buffer, static_cast<std::size_t>(len));
+    }
+    return payloads;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : nullptr;
+    const std::size_t count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2'000'000;
+
+    const auto payloads = path != nullptr ? loadRecording(path) : synthesize(count);
+    if (payloads.empty()) {
+        std::fprintf(stderr, "no payloads%s%s\n", path != nullptr ? " in " : "", path != nullptr ? path : "");
+        return 1;
+    }
+
+    app::TradeAggregator aggregator({domain::Interval{1'000}, domain::Interval{5'000}, domain::Interval{15'000}},
+                                    3'600'000);
+    std::vector<app::TradeAggregator::ClosedBar> closed;
+    std::size_t bars = 0;
+    std::size_t skipped = 0;
+
+    const auto start = Clock::now();
+    for (std::size_t i = 0; i < payloads.size(); ++i) {
+        adapters::binance::AggTradeMessage message;
+        if (!adapters::binance::parse_agg_trade_message(payloads[i], message)) {
+            ++skipped;
+            continue;
+        }
+        aggregator.on_trade(message.symbol, message.trade);
+        // What the ingestor's flusher does every 250 ms, roughly.
+        if ((i & 4095U) == 4095U) {
+            aggregator.close_idle_bars(500);
+            aggregator.drain_closed(closed);
+            bars += closed.size();
+            closed.clear();
+        }
+    }
+    aggregator.close_idle_bars(-1'000'000);
+    aggregator.drain_closed(closed);
+    bars += closed.size();
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    const auto trades = aggregator.trades();
+    std::printf("{\"bench\":\"trade_aggregator\",\"payloads\":%zu,\"trades\":%llu,\"skipped\":%zu,\"bars\":%zu,"
+                "\"elapsed_s\":%.3f,\"trades_per_sec\":%.0f}\n",
+                payloads.size(),
+                static_cast<unsigned long long>(trades),
+                skipped,
+                bars,
+                elapsed.count(),
+                static_cast<double>(trades) / elapsed.count());
+    return trades > 0 ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+// WebSocket frame encoding and WebSocketServer::broadcast fan-out on one core.
+//
+//   g++ -std=c++17 -O2 -pthread -Isrc bench/bench_ws_fanout.cpp src/api/WebSocketServer.cpp src/common/Log.cpp src/common/Metrics.cpp src/common/Trace.cpp -o bin/bench_ws_fanout
+//   ./bin/bench_ws_fanout [sessions] [messages]
+//
+// Sessions are real server sessions on AF_UNIX socket pairs, so broadcast()
+// pays the same per-session encode, copy and send() it does in production.
+// A reader thread drains the client ends; the fan-out figure stops the clock
+// when every client has received every frame.
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "api/WebSocketServer.hpp"
+#include "common/Log.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// A live candle update as LiveIngestor broadcasts it.
+const std::string kCandleMessage =
+    R"({"type":"candle","symbol":"BTCUSDT","interval":"1m","final":false,)"
+    R"("data":[1700000040000,37012.45,37020,37001.1,37015.31,12.48391]})";
+
+double encodeNsPerFrame(const std::string& payload, std::size_t iterations) {
+    std::vector<std::uint8_t> frame;
+    std::size_t checksum = 0;
+    const auto* data = reinterpret_cast<const std::uint8_t*>(payload.data());
+    const auto start = Clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        ttp::api::encodeFrame(0x1, data, payload.size(), frame);
+        checksum += frame[1];
+    }
+    const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    if (checksum == 0) {
+        std::fprintf(stderr, "unexpected empty frames\n");
+    }
+    return elapsed.count() / static_cast<double>(iterations);
+}
+
+// Reads until the 101 response and the welcome frame handleClient sends have arrived.
+bool drainHandshake(int fd) {
+    std::string received;
+    char buffer[512];
+    while (true) {
+        const auto headerEnd = received.find("\r\n\r\n");
+        if (headerEnd != std::string::npos && received.find("welcome", headerEnd) != std::string::npos) {
+            return true;
+        }
+        const auto n = ::read(fd, buffer, sizeof(buffer));
+        if (n <= 0) {
+            return false;
+        }
+        received.append(buffer, static_cast<std::size_t>(n));
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t sessions = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64;
+    const std::size_t messages = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000;
+    if (sessions == 0 || messages == 0) {
+        std::fprintf(stderr, "usage: %s [sessions] [messages]\n", argv[0]);
+        return 1;
+    }
+    ttp::log::setLevel(ttp::log::Level::Warn);
+
+    const double smallNs = encodeNsPerFrame(kCandleMessage, 1'000'000);
+    const double largeNs = encodeNsPerFrame(std::string(64 * 1024, 'x'), 20'000);
+
+    auto& server = ttp::api::WebSocketServer::instance();
+    const ttp::api::Request request(
+        "GET /ws HTTP/1.1\r\nHost: bench\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n");
+
+    std::vector<int> clients;
+    clients.reserve(sessions);
+    for (std::size_t i = 0; i < sessions; ++i) {
+        int fds[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+            std::fprintf(stderr, "socketpair failed after %zu sessions\n", i);
+            return 1;
+        }
+        if (!server.handleClient(fds[0], request) || !drainHandshake(fds[1])) {
+            std::fprintf(stderr, "handshake failed for session %zu\n", i);
+            return 1;
+        }
+        clients.push_back(fds[1]);
+    }
+
+    std::vector<std::uint8_t> frame;
+    ttp::api::encodeFrame(0x1,
+                          reinterpret_cast<const std::uint8_t*>(kCandleMessage.data()),
+                          kCandleMessage.size(),
+                          frame);
+    const std::uint64_t expected = static_cast<std::uint64_t>(frame.size()) * messages * sessions;
+
+    std::atomic<std::uint64_t> received{0};
+    std::thread reader([&]() {
+        std::vector<pollfd> polls(clients.size());
+        for (std::size_t i = 0; i < clients.size(); ++i) {
+            polls[i] = pollfd{clients[i], POLLIN, 0};
+        }
+        std::vector<char> buffer(256 * 1024);
+        std::uint64_t total = 0;
+        while (total < expected) {
+            if (::poll(polls.data(), polls.size(), 1000) <= 0) {
+                break;
+            }
+            for (auto& entry : polls) {
+                if ((entry.revents & POLLIN) == 0) {
+                    continue;
+                }
+                const auto n = ::read(entry.fd, buffer.data(), buffer.size());
+                if (n > 0) {
+                    total += static_cast<std::uint64_t>(n);
+                }
+            }
+        }
+        received.store(total);
+    });
+
+    const auto start = Clock::now();
+    for (std::size_t i = 0; i < messages; ++i) {
+        server.broadcast(kCandleMessage);
+    }
+    reader.join();
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    const auto deliveries = static_cast<double>(messages * sessions);
+    std::printf("{\"bench\":\"ws_fanout\",\"sessions\":%zu,\"messages\":%zu,\"frame_bytes\":%zu,"
+                "\"encode_ns_per_frame\":%.1f,\"encode_64k_ns_per_frame\":%.0f,"
+                "\"broadcasts_per_sec\":%.0f,\"deliveries_per_sec\":%.0f,\"mb_per_sec\":%.1f,\"complete\":%s}\n",
+                sessions,
+                messages,
+                frame.size(),
+                smallNs,
+                largeNs,
+                static_cast<double>(messages) / elapsed.count(),
+                deliveries / elapsed.count(),
+                static_cast<double>(received.load()) / elapsed.count() / 1e6,
+                received.load() == expected ? "true" : "false");
+    std::fflush(stdout);
+
+    // Session threads are detached and still blocked on their sockets; skip
+    // static destruction instead of racing the server teardown.
+    std::_Exit(received.load() == expected ? 0 : 1);
+}
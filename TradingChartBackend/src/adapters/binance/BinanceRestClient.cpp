@@ -63,13 +63,27 @@ double json_to_double(const boost::json::value& value) {
 namespace adapters::binance {
 
 namespace {
-constexpr const char* kHost = "api.binance.com";
 constexpr std::size_t kMaxLimit = 1000;
 constexpr int kMaxRetries = 5;
-constexpr int kRateLimitPerMinute = 1200;
-constexpr double kRateLimitThreshold = 0.9;
-constexpr double kRateLimitThresholdValue = kRateLimitPerMinute * kRateLimitThreshold;
+constexpr std::uint32_t kKlinesRequestWeight = 2;
+
+std::chrono::milliseconds retryDelay(const infra::http::JsonResponse& response, int attempt) {
+    if (!response.retry_after_header.empty()) {
+        try {
+            return std::chrono::seconds(std::max(1LL, std::stoll(response.retry_after_header)));
+        } catch (const std::exception&) {
+            // Fall back to exponential backoff on malformed values.
+        }
+    }
+    return std::chrono::seconds(1LL << (attempt - 1));
 }
+}
+
+BinanceRestClient::BinanceRestClient() : BinanceRestClient(std::make_shared<WeightBudget>()) {}
+
+BinanceRestClient::BinanceRestClient(std::shared_ptr<WeightBudget> budget, std::string host)
+    : budget_(budget ? std::move(budget) : std::make_shared<WeightBudget>()),
+      host_(host.empty() ? std::string{kDefaultHost} : std::move(host)) {}
 
 std::int64_t BinanceRestClient::interval_to_seconds(domain::Interval interval) {
     if (!interval.valid()) {
@@ -127,25 +141,39 @@ domain::KlinesPage BinanceRestClient::fetch_klines(const std::string& symbol,
         infra::http::JsonResponse response;
         bool request_success = false;
         for (int attempt = 1; attempt <= kMaxRetries; ++attempt) {
-            response = infra::http::https_get_json_response(kHost, request_target);
+            budget_->acquire(kKlinesRequestWeight);
+            response = infra::http::TlsHttpClient::shared().get_json(host_, request_target);
             const unsigned status = response.status;
+            if (!response.used_weight_header.empty()) {
+                try {
+                    budget_->observeUsedWeight(static_cast<std::uint32_t>(std::stoul(response.used_weight_header)));
+                } catch (const std::exception&) {
+                    // Ignore malformed header values; the local bucket still applies.
+                }
+            }
             if (status == 200U) {
                 request_success = true;
                 break;
             }
 
-            if (status == 429U || (status >= 500U && status < 600U)) {
+            const bool rateLimited = status == 429U || status == 418U;
+            if (rateLimited || (status >= 500U && status < 600U)) {
                 if (attempt == kMaxRetries) {
                     std::ostringstream oss;
                     oss << "Binance REST request " << request_target << " failed after " << kMaxRetries
                         << " attempts with HTTP " << status;
                     throw std::runtime_error(oss.str());
                 }
-                const auto backoff = std::chrono::seconds(1LL << (attempt - 1));
+                const auto backoff = retryDelay(response, attempt);
                 LOG_WARN(logging::LogCategory::NET,
                          "Binance REST backoff attempt %d due to HTTP %u, sleeping %lld ms",
-                         attempt, status, static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(backoff).count()));
-                std::this_thread::sleep_for(backoff);
+                         attempt, status, static_cast<long long>(backoff.count()));
+                if (rateLimited) {
+                    // Stop every client sharing the budget, not just this one.
+                    budget_->pauseFor(backoff);
+                } else {
+                    std::this_thread::sleep_for(backoff);
+                }
                 continue;
             }
 
@@ -224,18 +252,6 @@ domain::KlinesPage BinanceRestClient::fetch_klines(const std::string& symbol,
         }
 
         current_start_ms = last_close_ms + 1;
-
-        if (!response.used_weight_header.empty()) {
-            try {
-                const int used_weight = std::stoi(response.used_weight_header);
-                if (static_cast<double>(used_weight) > kRateLimitThresholdValue && page.rows.size() < limit &&
-                    current_start_ms < to_ms) {
-                    std::this_thread::sleep_for(std::chrono::seconds(2));
-                }
-            } catch (const std::exception&) {
-                // Ignore malformed header values; continue without throttling.
-            }
-        }
     }
 
     if (!page.rows.empty() && page.rows.size() >= limit) {
@@ -1,15 +1,20 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
+#include "adapters/binance/WeightBudget.hpp"
 #include "domain/exchange/IExchangeKlines.hpp"
 
 namespace adapters::binance {
 
 class BinanceRestClient : public domain::IExchangeKlines {
 public:
-    BinanceRestClient() = default;
+    BinanceRestClient();
+    // Clients sharing a budget share the request-weight limit; `host` may
+    // include a port (e.g. a local stub server).
+    explicit BinanceRestClient(std::shared_ptr<WeightBudget> budget, std::string host = kDefaultHost);
     ~BinanceRestClient() override = default;
 
     domain::KlinesPage fetch_klines(const std::string& symbol,
@@ -19,9 +24,13 @@ public:
                                     std::size_t page_limit = 1000) override;
 
     static constexpr std::int64_t kDefaultFromTs = 1754006400;  // 2025-08-01 00:00:00 UTC
+    static constexpr const char* kDefaultHost = "api.binance.com";
 
 private:
     static std::int64_t interval_to_seconds(domain::Interval interval);
+
+    std::shared_ptr<WeightBudget> budget_;
+    std::string host_;
 };
 
 }  // namespace adapters::binance
@@ -12,6 +12,8 @@
 #include <stdexcept>
 #include <string>
 #include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <boost/asio/ip/tcp.hpp>
@@ -35,8 +37,11 @@
 #include <openssl/err.h>
 #include <openssl/ssl.h>
 
+#include "adapters/binance/KlineMessageParser.hpp"
+#include "adapters/replay/KlineRecording.hpp"
 #include "logging/Log.h"
 #include "common/Metrics.hpp"
+#include "common/Trace.hpp"
 
 namespace adapters::binance {
 namespace {
@@ -46,9 +51,12 @@ constexpr const char* kBasePath = "/stream?streams=";
 constexpr std::chrono::milliseconds kBackoffBase{1000};
 constexpr std::chrono::milliseconds kBackoffCap{30000};
 constexpr std::chrono::milliseconds kStopPoll{200};
+// aggTrade has no heartbeat of its own; a liquid pair trades many times a
+// second, so a minute of silence means the connection is gone.
+constexpr std::chrono::milliseconds kTradeSilenceThreshold{60000};
 
 std::string build_stream_path(const std::vector<std::string>& symbolsUpper,
-                              const std::string& intervalLabel) {
+                              const std::string& streamName) {
     std::ostringstream oss;
     oss << kBasePath;
     bool first = true;
@@ -61,7 +69,7 @@ std::string build_stream_path(const std::vector<std::string>& symbolsUpper,
         std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char ch) {
             return static_cast<char>(std::tolower(ch));
         });
-        oss << lower << "@kline_" << intervalLabel;
+        oss << lower << '@' << streamName;
     }
     return oss.str();
 }
@@ -70,6 +78,101 @@ std::runtime_error make_error(const std::string& message) {
     return std::runtime_error("BinanceWsClient: " + message);
 }
 
+// Every client in the process (one per ShardedKlineFeed shard, plus the
+// aggTrade feed) reports into the same ws_state and last_msg_age_ms gauges,
+// which therefore carry the worst of them: ws_state is 1 only while all are
+// connected, and last_msg_age_ms is the age of the stalest kline client's last
+// message. The age gauge holds the age at its update time; readers add the
+// time since.
+class ConnectionGauges {
+public:
+    static ConnectionGauges& instance() {
+        static ConnectionGauges gauges;
+        return gauges;
+    }
+
+    void add(const void* client, bool klines) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        clients_[client] = State{false, klines, Clock::now()};
+        publishStateLocked_();
+        publishAgeLocked_(Clock::now());
+    }
+
+    void remove(const void* client) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (clients_.erase(client) > 0) {
+            publishStateLocked_();
+            publishAgeLocked_(Clock::now());
+        }
+    }
+
+    void connected(const void* client, bool up) {
+        const auto now = Clock::now();
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = clients_.find(client);
+        if (it == clients_.end()) {
+            return;
+        }
+        it->second.connected = up;
+        if (up) {
+            it->second.lastMessage = now;
+        }
+        publishStateLocked_();
+        publishAgeLocked_(now);
+    }
+
+    // Called per kline; republishes only when the stalest client moves on.
+    void message(const void* client) {
+        const auto now = Clock::now();
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = clients_.find(client);
+        if (it == clients_.end()) {
+            return;
+        }
+        const bool wasOldest = it->second.lastMessage == oldest_;
+        it->second.lastMessage = now;
+        if (wasOldest) {
+            publishAgeLocked_(now);
+        }
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct State {
+        bool connected{false};
+        bool klines{false};
+        Clock::time_point lastMessage{};
+    };
+
+    ConnectionGauges()
+        : state_(ttp::common::metrics::Registry::instance().gauge("ws_state")),
+          age_(ttp::common::metrics::Registry::instance().gauge("last_msg_age_ms")) {}
+
+    void publishStateLocked_() {
+        const bool allConnected = !clients_.empty()
+            && std::all_of(clients_.begin(), clients_.end(), [](const auto& entry) { return entry.second.connected; });
+        state_.set(allConnected ? 1.0 : 0.0);
+    }
+
+    void publishAgeLocked_(Clock::time_point now) {
+        oldest_ = Clock::time_point::max();
+        for (const auto& entry : clients_) {
+            if (entry.second.klines) {
+                oldest_ = std::min(oldest_, entry.second.lastMessage);
+            }
+        }
+        const auto age = oldest_ == Clock::time_point::max() ? Clock::duration::zero() : now - oldest_;
+        age_.set(std::chrono::duration<double, std::milli>(age).count());
+    }
+
+    std::mutex mutex_;
+    std::unordered_map<const void*, State> clients_;
+    Clock::time_point oldest_{Clock::time_point::max()};
+    ttp::common::metrics::Gauge& state_;
+    ttp::common::metrics::Gauge& age_;
+};
+
 }  // namespace
 
 namespace beast = boost::beast;
@@ -114,21 +217,44 @@ void BinanceWsClient::subscribe(const std::vector<std::string>& symbols,
         throw make_error("subscribe requires a valid callback");
     }
 
-    std::vector<std::string> normalized;
-    normalized.reserve(symbols.size());
-    for (const auto& symbol : symbols) {
-        auto upper = normalize_symbol_(symbol);
-        if (upper.empty()) {
-            throw make_error("symbol cannot be empty");
-        }
-        normalized.push_back(std::move(upper));
-    }
-
     const std::string intervalLabel = domain::interval_label(interval);
     if (intervalLabel.empty()) {
         throw make_error("unsupported interval for live klines");
     }
 
+    auto normalized = normalize_symbols_(symbols);
+    if (subscribed_.load(std::memory_order_acquire)) {
+        throw make_error("already subscribed");
+    }
+    {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        on_closed_candle_ = std::move(on_closed_candle);
+    }
+    start_(std::move(normalized),
+           "kline_" + intervalLabel,
+           std::chrono::milliseconds(interval.ms * 2 + 5000));
+}
+
+void BinanceWsClient::subscribe_trades(const std::vector<std::string>& symbols,
+                                       std::function<void(std::string_view, const domain::AggTrade&)> on_trade) {
+    if (symbols.empty()) {
+        throw make_error("subscribe_trades called with empty symbol list");
+    }
+    if (!on_trade) {
+        throw make_error("subscribe_trades requires a valid callback");
+    }
+
+    auto normalized = normalize_symbols_(symbols);
+    if (subscribed_.load(std::memory_order_acquire)) {
+        throw make_error("already subscribed");
+    }
+    on_trade_ = std::move(on_trade);
+    start_(std::move(normalized), "aggTrade", kTradeSilenceThreshold);
+}
+
+void BinanceWsClient::start_(std::vector<std::string> symbolsUpper,
+                             std::string streamName,
+                             std::chrono::milliseconds silenceThreshold) {
     bool expected = false;
     if (!subscribed_.compare_exchange_strong(expected, true)) {
         throw make_error("already subscribed");
@@ -136,19 +262,31 @@ void BinanceWsClient::subscribe(const std::vector<std::string>& symbols,
 
     running_.store(true, std::memory_order_release);
     last_msg_tp_.store(std::chrono::steady_clock::now(), std::memory_order_release);
-    ttp::common::metrics::Registry::instance().setGauge("ws_state", 0.0);
-    ttp::common::metrics::Registry::instance().setGauge("last_msg_age_ms", 0.0);
-    {
-        std::lock_guard<std::mutex> lock(callback_mutex_);
-        on_closed_candle_ = std::move(on_closed_candle);
-    }
+    ConnectionGauges::instance().add(this, !on_trade_);
 
     LOG_INFO(logging::LogCategory::NET,
-             "BinanceWsClient subscribe requested symbols=%zu interval_ms=%lld",
-             normalized.size(),
-             static_cast<long long>(interval.ms));
+             "BinanceWsClient subscribe requested symbols=%zu stream=%s",
+             symbolsUpper.size(),
+             streamName.c_str());
+
+    worker_ = std::thread(&BinanceWsClient::run_,
+                          this,
+                          std::move(symbolsUpper),
+                          std::move(streamName),
+                          silenceThreshold);
+}
 
-    worker_ = std::thread(&BinanceWsClient::run_, this, std::move(normalized), interval);
+std::vector<std::string> BinanceWsClient::normalize_symbols_(const std::vector<std::string>& symbols) {
+    std::vector<std::string> normalized;
+    normalized.reserve(symbols.size());
+    for (const auto& symbol : symbols) {
+        auto upper = normalize_symbol_(symbol);
+        if (upper.empty()) {
+            throw make_error("symbol cannot be empty");
+        }
+        normalized.push_back(std::move(upper));
+    }
+    return normalized;
 }
 
 void BinanceWsClient::set_on_reconnected(std::function<void()> callback) {
@@ -156,6 +294,10 @@ void BinanceWsClient::set_on_reconnected(std::function<void()> callback) {
     on_reconnected_ = std::move(callback);
 }
 
+void BinanceWsClient::set_recorder(std::shared_ptr<replay::KlineRecorder> recorder) {
+    recorder_ = std::move(recorder);
+}
+
 void BinanceWsClient::stop() {
     running_.store(false, std::memory_order_release);
 
@@ -270,19 +412,17 @@ void BinanceWsClient::stop() {
         worker_.join();
     }
     subscribed_.store(false, std::memory_order_release);
-    ttp::common::metrics::Registry::instance().setGauge("ws_state", 0.0);
+    ConnectionGauges::instance().remove(this);
 }
 
-void BinanceWsClient::run_(std::vector<std::string> symbolsUpper, domain::Interval interval) {
+void BinanceWsClient::run_(std::vector<std::string> symbolsUpper,
+                           std::string streamName,
+                           std::chrono::milliseconds silenceThreshold) {
     try {
         LOG_INFO(logging::LogCategory::NET, "BinanceWsClient worker thread starting");
 
         std::size_t attempt = 0;
         std::mt19937 rng{std::random_device{}()};
-        const std::string intervalLabel = domain::interval_label(interval);
-        if (intervalLabel.empty()) {
-            throw make_error("unsupported interval for live klines");
-        }
 
         while (running_.load(std::memory_order_acquire)) {
             auto ioc = std::make_shared<net::io_context>();
@@ -423,7 +563,7 @@ void BinanceWsClient::run_(std::vector<std::string> symbolsUpper, domain::Interv
                     throw make_error("TLS handshake failed: " + ec.message());
                 }
 
-                const auto target = build_stream_path(symbolsUpper, intervalLabel);
+                const auto target = build_stream_path(symbolsUpper, streamName);
                 ws->handshake(std::string{kHost} + ":" + kPort, target, ec);
                 if (ec) {
                     throw make_error("WebSocket handshake failed: " + ec.message());
@@ -443,8 +583,6 @@ void BinanceWsClient::run_(std::vector<std::string> symbolsUpper, domain::Interv
 
                 const auto pingInterval = std::chrono::seconds(60);
                 const auto silenceInterval = std::chrono::seconds(10);
-                const auto silenceThreshold =
-                    std::chrono::milliseconds(interval.ms * 2 + 5000);
 
                 auto pingScheduler = std::make_shared<std::function<void()>>();
                 auto silenceScheduler = std::make_shared<std::function<void()>>();
@@ -562,8 +700,7 @@ void BinanceWsClient::run_(std::vector<std::string> symbolsUpper, domain::Interv
                          kHost,
                          target.c_str());
 
-                ttp::common::metrics::Registry::instance().setGauge("ws_state", 1.0);
-                ttp::common::metrics::Registry::instance().setGauge("last_msg_age_ms", 0.0);
+                ConnectionGauges::instance().connected(this, true);
 
                 std::function<void()> onReconnect;
                 {
@@ -596,13 +733,21 @@ void BinanceWsClient::run_(std::vector<std::string> symbolsUpper, domain::Interv
                         throw make_error("read failed: " + ec.message());
                     }
 
+                    received_ns_ = ttp::common::trace::nowNs();
                     const std::string payload = beast::buffers_to_string(buffer.cdata());
                     if (!payload.empty()) {
+                        if (recorder_) {
+                            recorder_->record(payload);
+                        }
                         LOG_DEBUG(logging::LogCategory::NET,
                                   "BinanceWsClient received message bytes=%zu",
                                   payload.size());
                         try {
-                            process_message_(payload);
+                            if (on_trade_) {
+                                process_trade_message_(payload);
+                            } else {
+                                process_message_(payload);
+                            }
                         } catch (const std::exception& ex) {
                             LOG_WARN(logging::LogCategory::NET,
                                      "BinanceWsClient failed to process message: %s",
@@ -615,7 +760,7 @@ void BinanceWsClient::run_(std::vector<std::string> symbolsUpper, domain::Interv
             }
 
             cleanup();
-            ttp::common::metrics::Registry::instance().setGauge("ws_state", 0.0);
+            ConnectionGauges::instance().connected(this, false);
 
             if (!running_.load(std::memory_order_acquire)) {
                 break;
@@ -658,6 +803,30 @@ void BinanceWsClient::run_(std::vector<std::string> symbolsUpper, domain::Interv
 }
 
 void BinanceWsClient::process_message_(const std::string& payload) {
+    KlineMessage message;
+    if (parse_kline_message(payload, message)) {
+        dispatch_kline_(message.symbol, message.candle, message.eventTime);
+        return;
+    }
+
+    ttp::common::metrics::Registry::instance().incrementCounter("ws.kline_parse_fallbacks");
+    std::string symbol;
+    parse_kline_message_dom(payload, message, symbol);
+    dispatch_kline_(message.symbol, message.candle, message.eventTime);
+}
+
+void BinanceWsClient::process_trade_message_(const std::string& payload) {
+    AggTradeMessage message;
+    if (!parse_agg_trade_message(payload, message)) {
+        // Subscription acks and escaped payloads; aggTrade frames are flat.
+        ttp::common::metrics::Registry::instance().incrementCounter("ws.trade_parse_skipped");
+        return;
+    }
+    last_msg_tp_.store(std::chrono::steady_clock::now(), std::memory_order_release);
+    on_trade_(message.symbol, message.trade);
+}
+
+void BinanceWsClient::parse_kline_message_dom(std::string_view payload, KlineMessage& out, std::string& symbol) {
     boost::json::error_code ec;
     auto json = boost::json::parse(payload, ec);
     if (ec || !json.is_object()) {
@@ -688,16 +857,14 @@ void BinanceWsClient::process_message_(const std::string& payload) {
         throw make_error("kline missing symbol");
     }
 
-    last_msg_tp_.store(std::chrono::steady_clock::now(), std::memory_order_release);
-    ttp::common::metrics::Registry::instance().setGauge("last_msg_age_ms", 0.0);
-
     const auto openTimeIt = kObj.if_contains("t");
     const auto closeTimeIt = kObj.if_contains("T");
     if (openTimeIt == nullptr || closeTimeIt == nullptr) {
         throw make_error("kline missing timestamps");
     }
 
-    domain::Candle candle{};
+    auto& candle = out.candle;
+    candle = domain::Candle{};
     candle.openTime = parse_json_int_(*openTimeIt);
     candle.closeTime = parse_json_int_(*closeTimeIt);
     candle.open = parse_json_number_(kObj.at("o"));
@@ -713,7 +880,28 @@ void BinanceWsClient::process_message_(const std::string& payload) {
     }
     candle.isClosed = isClosed;
 
-    const std::string symbolUpper = normalize_symbol_(std::string(symbolIt->as_string().c_str()));
+    out.eventTime = 0;
+    if (const auto eventTimeIt = dataObj.if_contains("E"); eventTimeIt != nullptr) {
+        out.eventTime = parse_json_int_(*eventTimeIt);
+    }
+
+    const auto& symbolValue = symbolIt->as_string();
+    symbol.assign(symbolValue.data(), symbolValue.size());
+    out.symbol = symbol;
+}
+
+void BinanceWsClient::dispatch_kline_(std::string_view symbol,
+                                      const domain::Candle& candle,
+                                      std::int64_t eventTimeMs) {
+    last_msg_tp_.store(std::chrono::steady_clock::now(), std::memory_order_release);
+    ConnectionGauges::instance().message(this);
+
+    symbol_scratch_.clear();
+    for (unsigned char ch : symbol) {
+        if (!std::isspace(ch)) {
+            symbol_scratch_.push_back(static_cast<char>(std::toupper(ch)));
+        }
+    }
 
     std::function<void(const std::string&, const domain::Candle&)> callback;
     {
@@ -721,7 +909,9 @@ void BinanceWsClient::process_message_(const std::string& payload) {
         callback = on_closed_candle_;
     }
     if (callback) {
-        callback(symbolUpper, candle);
+        const ttp::common::trace::Scope trace(
+            symbol_scratch_, candle.openTime, candle.isClosed, eventTimeMs, received_ns_);
+        callback(symbol_scratch_, candle);
     }
 }
 
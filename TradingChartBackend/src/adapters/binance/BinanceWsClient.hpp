@@ -6,6 +6,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 
@@ -19,11 +20,17 @@
 #include <boost/beast/websocket.hpp>
 #include <boost/json/value.hpp>
 
+#include "adapters/binance/KlineMessageParser.hpp"
 #include "domain/exchange/IExchangeKlines.hpp"
+#include "domain/exchange/IExchangeTrades.hpp"
+
+namespace adapters::replay {
+class KlineRecorder;
+}  // namespace adapters::replay
 
 namespace adapters::binance {
 
-class BinanceWsClient : public domain::IExchangeLiveKlines {
+class BinanceWsClient : public domain::IExchangeLiveKlines, public domain::IExchangeLiveTrades {
 public:
     BinanceWsClient();
     ~BinanceWsClient() override;
@@ -32,10 +39,24 @@ public:
                    domain::Interval interval,
                    std::function<void(const std::string&, const domain::Candle&)> on_closed_candle) override;
 
+    // Streams <symbol>@aggTrade instead of klines. One client serves either
+    // klines or trades, not both.
+    void subscribe_trades(const std::vector<std::string>& symbols,
+                          std::function<void(std::string_view, const domain::AggTrade&)> on_trade) override;
+
     void set_on_reconnected(std::function<void()> callback) override;
 
     void stop() override;
 
+    // Every raw frame is appended to the recorder before it is parsed. Set
+    // before subscribe().
+    void set_recorder(std::shared_ptr<replay::KlineRecorder> recorder);
+
+    // Full JSON parse of a kline event, used when parse_kline_message()
+    // rejects a payload. `out.symbol` points into `symbol`. Throws
+    // std::runtime_error on payloads without a complete kline.
+    static void parse_kline_message_dom(std::string_view payload, KlineMessage& out, std::string& symbol);
+
 private:
     using WsStream = boost::beast::websocket::stream<
         boost::asio::ssl::stream<boost::beast::tcp_stream>>;
@@ -53,8 +74,16 @@ private:
 #endif
     };
 
-    void run_(std::vector<std::string> symbols, domain::Interval interval);
+    void start_(std::vector<std::string> symbolsUpper,
+                std::string streamName,
+                std::chrono::milliseconds silenceThreshold);
+    void run_(std::vector<std::string> symbolsUpper,
+              std::string streamName,
+              std::chrono::milliseconds silenceThreshold);
+    static std::vector<std::string> normalize_symbols_(const std::vector<std::string>& symbols);
     void process_message_(const std::string& payload);
+    void dispatch_kline_(std::string_view symbol, const domain::Candle& candle, std::int64_t eventTimeMs);
+    void process_trade_message_(const std::string& payload);
     static std::string normalize_symbol_(const std::string& symbol);
     static double parse_json_number_(const boost::json::value& value);
     static std::int64_t parse_json_int_(const boost::json::value& value);
@@ -64,8 +93,16 @@ private:
     std::atomic<std::chrono::steady_clock::time_point> last_msg_tp_{
         std::chrono::steady_clock::now()};
     std::function<void(const std::string&, const domain::Candle&)> on_closed_candle_;
+    // Set before the worker starts and left alone while it runs, so the hot
+    // path calls it without taking callback_mutex_.
+    std::function<void(std::string_view, const domain::AggTrade&)> on_trade_;
     std::function<void()> on_reconnected_;
     std::mutex callback_mutex_;
+    // Reused by the worker thread so dispatching a kline does not allocate.
+    std::string symbol_scratch_;
+    // Wall-clock read time of the frame being processed; starts its trace.
+    std::int64_t received_ns_{0};
+    std::shared_ptr<replay::KlineRecorder> recorder_;
     std::thread worker_;
 
     std::mutex ws_mutex_;
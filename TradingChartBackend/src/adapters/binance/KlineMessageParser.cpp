@@ -0,0 +1,310 @@
+#include "adapters/binance/KlineMessageParser.hpp"
+
+#include <charconv>
+
+namespace adapters::binance {
+namespace {
+
+constexpr std::string_view kKlineKey = "\"k\":";
+constexpr std::string_view kDataKey = "\"data\":";
+constexpr std::string_view kEventTimeKey = "\"E\":";
+
+class Cursor {
+public:
+    explicit Cursor(std::string_view input) : pos_(input.data()), end_(input.data() + input.size()) {}
+
+    void skipSpace() noexcept {
+        while (pos_ < end_ && (*pos_ == ' ' || *pos_ == '\t' || *pos_ == '\n' || *pos_ == '\r')) {
+            ++pos_;
+        }
+    }
+
+    bool consume(char expected) noexcept {
+        skipSpace();
+        if (pos_ < end_ && *pos_ == expected) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    bool peek(char expected) noexcept {
+        skipSpace();
+        return pos_ < end_ && *pos_ == expected;
+    }
+
+    // Plain strings only; an escape sends the message to the fallback parser.
+    bool string(std::string_view& out) noexcept {
+        if (!consume('"')) {
+            return false;
+        }
+        const char* start = pos_;
+        while (pos_ < end_ && *pos_ != '"') {
+            if (*pos_ == '\\') {
+                return false;
+            }
+            ++pos_;
+        }
+        if (pos_ >= end_) {
+            return false;
+        }
+        out = std::string_view(start, static_cast<std::size_t>(pos_ - start));
+        ++pos_;
+        return true;
+    }
+
+    // Raw scalar token: number, true, false or null.
+    bool scalar(std::string_view& out) noexcept {
+        skipSpace();
+        const char* start = pos_;
+        while (pos_ < end_ && *pos_ != ',' && *pos_ != '}' && *pos_ != ' ' && *pos_ != '\n' && *pos_ != '\r' &&
+               *pos_ != '\t') {
+            if (*pos_ == '{' || *pos_ == '[' || *pos_ == '"') {
+                return false;
+            }
+            ++pos_;
+        }
+        out = std::string_view(start, static_cast<std::size_t>(pos_ - start));
+        return !out.empty();
+    }
+
+private:
+    const char* pos_;
+    const char* end_;
+};
+
+template <typename Int>
+bool toInt(std::string_view token, Int& out) noexcept {
+    const auto result = std::from_chars(token.data(), token.data() + token.size(), out);
+    return result.ec == std::errc{} && result.ptr == token.data() + token.size();
+}
+
+bool toDouble(std::string_view token, double& out) noexcept {
+    const auto result = std::from_chars(token.data(), token.data() + token.size(), out);
+    return result.ec == std::errc{} && result.ptr == token.data() + token.size();
+}
+
+enum Field : unsigned {
+    kOpenTime = 1U << 0,
+    kCloseTime = 1U << 1,
+    kSymbol = 1U << 2,
+    kOpen = 1U << 3,
+    kHigh = 1U << 4,
+    kLow = 1U << 5,
+    kClose = 1U << 6,
+    kVolume = 1U << 7,
+    kClosed = 1U << 8,
+};
+
+constexpr unsigned kRequired =
+    kOpenTime | kCloseTime | kSymbol | kOpen | kHigh | kLow | kClose | kVolume | kClosed;
+
+enum TradeField : unsigned {
+    kTradeSymbol = 1U << 0,
+    kTradePrice = 1U << 1,
+    kTradeQuantity = 1U << 2,
+    kTradeTime = 1U << 3,
+    kTradeMaker = 1U << 4,
+};
+
+constexpr unsigned kTradeRequired = kTradeSymbol | kTradePrice | kTradeQuantity | kTradeTime | kTradeMaker;
+
+}  // namespace
+
+bool parse_kline_message(std::string_view payload, KlineMessage& out) noexcept {
+    // "k" is the last member of "data" in every kline event and the only
+    // nested object, so the first "k": key is the one we want.
+    const auto kPos = payload.find(kKlineKey);
+    if (kPos == std::string_view::npos || payload.find("\"data\"") > kPos) {
+        return false;
+    }
+
+    Cursor cursor(payload.substr(kPos + kKlineKey.size()));
+    if (!cursor.consume('{')) {
+        return false;
+    }
+
+    KlineMessage message{};
+    // "E" is informational, so a missing or odd value leaves eventTime at 0
+    // rather than rejecting the frame. It precedes "k" inside "data" as
+    // Binance sends it; members of "k" never use that key, so a later "E"
+    // still belongs to "data".
+    auto ePos = payload.rfind(kEventTimeKey, kPos);
+    if (ePos == std::string_view::npos) {
+        ePos = payload.find(kEventTimeKey, kPos);
+    }
+    if (ePos != std::string_view::npos) {
+        Cursor eventCursor(payload.substr(ePos + kEventTimeKey.size()));
+        std::string_view text;
+        if (eventCursor.scalar(text) && !toInt(text, message.eventTime)) {
+            message.eventTime = 0;
+        }
+    }
+
+    unsigned seen = 0;
+    if (!cursor.peek('}')) {
+        do {
+            std::string_view key;
+            if (!cursor.string(key) || !cursor.consume(':')) {
+                return false;
+            }
+
+            std::string_view text;
+            bool quoted = false;
+            if (cursor.peek('"')) {
+                if (!cursor.string(text)) {
+                    return false;
+                }
+                quoted = true;
+            }
+            else if (!cursor.scalar(text)) {
+                return false;
+            }
+
+            if (key.size() != 1) {
+                continue;
+            }
+            auto& candle = message.candle;
+            bool ok = true;
+            switch (key.front()) {
+            case 't':
+                ok = !quoted && toInt(text, candle.openTime);
+                seen |= kOpenTime;
+                break;
+            case 'T':
+                ok = !quoted && toInt(text, candle.closeTime);
+                seen |= kCloseTime;
+                break;
+            case 's':
+                ok = quoted && !text.empty();
+                message.symbol = text;
+                seen |= kSymbol;
+                break;
+            case 'o':
+                ok = toDouble(text, candle.open);
+                seen |= kOpen;
+                break;
+            case 'h':
+                ok = toDouble(text, candle.high);
+                seen |= kHigh;
+                break;
+            case 'l':
+                ok = toDouble(text, candle.low);
+                seen |= kLow;
+                break;
+            case 'c':
+                ok = toDouble(text, candle.close);
+                seen |= kClose;
+                break;
+            case 'v':
+                ok = toDouble(text, candle.baseVolume);
+                seen |= kVolume;
+                break;
+            case 'q':
+                ok = toDouble(text, candle.quoteVolume);
+                break;
+            case 'n':
+                ok = !quoted && toInt(text, candle.trades);
+                break;
+            case 'x':
+                ok = !quoted && (text == "true" || text == "false");
+                candle.isClosed = text == "true";
+                seen |= kClosed;
+                break;
+            default:
+                break;
+            }
+            if (!ok) {
+                return false;
+            }
+        } while (cursor.consume(','));
+    }
+
+    if (!cursor.consume('}') || (seen & kRequired) != kRequired) {
+        return false;
+    }
+    out = message;
+    return true;
+}
+
+bool parse_agg_trade_message(std::string_view payload, AggTradeMessage& out) noexcept {
+    const auto dataPos = payload.find(kDataKey);
+    if (dataPos == std::string_view::npos) {
+        return false;
+    }
+
+    Cursor cursor(payload.substr(dataPos + kDataKey.size()));
+    if (!cursor.consume('{')) {
+        return false;
+    }
+
+    AggTradeMessage message{};
+    unsigned seen = 0;
+    bool isAggTrade = false;
+    if (!cursor.peek('}')) {
+        do {
+            std::string_view key;
+            if (!cursor.string(key) || !cursor.consume(':')) {
+                return false;
+            }
+
+            std::string_view text;
+            bool quoted = false;
+            if (cursor.peek('"')) {
+                if (!cursor.string(text)) {
+                    return false;
+                }
+                quoted = true;
+            }
+            else if (!cursor.scalar(text)) {
+                return false;
+            }
+
+            if (key.size() != 1) {
+                continue;
+            }
+            auto& trade = message.trade;
+            bool ok = true;
+            switch (key.front()) {
+            case 'e':
+                isAggTrade = quoted && text == "aggTrade";
+                break;
+            case 's':
+                ok = quoted && !text.empty();
+                message.symbol = text;
+                seen |= kTradeSymbol;
+                break;
+            case 'p':
+                ok = toDouble(text, trade.price);
+                seen |= kTradePrice;
+                break;
+            case 'q':
+                ok = toDouble(text, trade.quantity);
+                seen |= kTradeQuantity;
+                break;
+            case 'T':
+                ok = !quoted && toInt(text, trade.tradeTime);
+                seen |= kTradeTime;
+                break;
+            case 'm':
+                ok = !quoted && (text == "true" || text == "false");
+                trade.buyerIsMaker = text == "true";
+                seen |= kTradeMaker;
+                break;
+            default:
+                break;
+            }
+            if (!ok) {
+                return false;
+            }
+        } while (cursor.consume(','));
+    }
+
+    if (!isAggTrade || !cursor.consume('}') || (seen & kTradeRequired) != kTradeRequired) {
+        return false;
+    }
+    out = message;
+    return true;
+}
+
+}  // namespace adapters::binance
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "domain/Types.h"
+#include "domain/exchange/IExchangeTrades.hpp"
+
+namespace adapters::binance {
+
+struct KlineMessage {
+    // Points into the parsed payload; valid while the payload is.
+    std::string_view symbol;
+    domain::Candle candle{};
+    // Event time "E" of the enclosing event in ms; 0 when absent.
+    std::int64_t eventTime{0};
+};
+
+// Single-pass parser for combined-stream kline events:
+//   {"stream":"btcusdt@kline_1m","data":{"e":"kline",...,"k":{"t":..,"s":"BTCUSDT",..}}}
+// Does not allocate. Returns false for anything outside that shape (escaped
+// strings, nested values inside "k", missing fields); callers then fall back
+// to a full JSON parse.
+bool parse_kline_message(std::string_view payload, KlineMessage& out) noexcept;
+
+struct AggTradeMessage {
+    // Points into the parsed payload; valid while the payload is.
+    std::string_view symbol;
+    domain::AggTrade trade{};
+};
+
+// Same contract for combined-stream aggTrade events:
+//   {"stream":"btcusdt@aggTrade","data":{"e":"aggTrade","s":"BTCUSDT","p":..,"q":..,"T":..,"m":..}}
+bool parse_agg_trade_message(std::string_view payload, AggTradeMessage& out) noexcept;
+
+}  // namespace adapters::binance
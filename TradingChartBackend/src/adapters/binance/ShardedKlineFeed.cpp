@@ -0,0 +1,304 @@
+#include "adapters/binance/ShardedKlineFeed.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+#include "common/Metrics.hpp"
+#include "logging/Log.h"
+
+namespace adapters::binance {
+namespace {
+
+constexpr logging::LogCategory kLogCategory = logging::LogCategory::NET;
+
+std::runtime_error make_error(const std::string& message) {
+    return std::runtime_error("ShardedKlineFeed: " + message);
+}
+
+}  // namespace
+
+ShardedKlineFeed::ShardedKlineFeed(ShardFactory factory,
+                                   std::size_t maxStreamsPerShard,
+                                   std::chrono::milliseconds handoverTimeout)
+    : factory_(std::move(factory)),
+      maxStreamsPerShard_(std::max<std::size_t>(1, maxStreamsPerShard)),
+      handoverTimeout_(handoverTimeout) {
+    if (!factory_) {
+        throw make_error("shard factory is required");
+    }
+}
+
+ShardedKlineFeed::~ShardedKlineFeed() {
+    stop();
+}
+
+void ShardedKlineFeed::subscribe(const std::vector<std::string>& symbols,
+                                 domain::Interval interval,
+                                 std::function<void(const std::string&, const domain::Candle&)> on_closed_candle) {
+    if (symbols.empty()) {
+        throw make_error("subscribe called with empty symbol list");
+    }
+    if (!on_closed_candle) {
+        throw make_error("subscribe requires a valid callback");
+    }
+
+    std::vector<std::string> unique;
+    std::unordered_set<std::string> seen;
+    for (const auto& symbol : symbols) {
+        auto upper = normalize_symbol_(symbol);
+        if (upper.empty()) {
+            throw make_error("symbol cannot be empty");
+        }
+        if (seen.insert(upper).second) {
+            unique.push_back(std::move(upper));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (subscribed_) {
+        throw make_error("already subscribed");
+    }
+    interval_ = interval;
+    on_closed_candle_ = std::move(on_closed_candle);
+
+    // Even split: 120 symbols with 50 per shard become 40/40/40, not 50/50/20.
+    const std::size_t shardCount = (unique.size() + maxStreamsPerShard_ - 1) / maxStreamsPerShard_;
+    const std::size_t perShard = (unique.size() + shardCount - 1) / shardCount;
+
+    std::vector<Shard> shards;
+    try {
+        for (std::size_t begin = 0; begin < unique.size(); begin += perShard) {
+            const std::size_t end = std::min(unique.size(), begin + perShard);
+            Shard shard;
+            shard.symbols.assign(unique.begin() + static_cast<std::ptrdiff_t>(begin),
+                                 unique.begin() + static_cast<std::ptrdiff_t>(end));
+            shard.client = start_shard_(shard.symbols);
+            shards.push_back(std::move(shard));
+        }
+    }
+    catch (...) {
+        std::vector<std::unique_ptr<domain::IExchangeLiveKlines>> started;
+        for (auto& shard : shards) {
+            started.push_back(std::move(shard.client));
+        }
+        stop_all_(std::move(started));
+        throw;
+    }
+
+    shards_ = std::move(shards);
+    symbols_ = std::move(seen);
+    subscribed_ = true;
+
+    LOG_INFO(kLogCategory,
+             "ShardedKlineFeed subscribed symbols=%zu shards=%zu max_per_shard=%zu",
+             symbols_.size(),
+             shards_.size(),
+             maxStreamsPerShard_);
+    publish_shard_count_(shards_.size());
+}
+
+void ShardedKlineFeed::set_on_reconnected(std::function<void()> callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    on_reconnected_ = std::move(callback);
+}
+
+void ShardedKlineFeed::stop() {
+    std::vector<std::unique_ptr<domain::IExchangeLiveKlines>> clients;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& shard : shards_) {
+            clients.push_back(std::move(shard.client));
+        }
+        shards_.clear();
+        symbols_.clear();
+        subscribed_ = false;
+    }
+    if (clients.empty()) {
+        return;
+    }
+    stop_all_(std::move(clients));
+    publish_shard_count_(0);
+}
+
+void ShardedKlineFeed::add_symbols(const std::vector<std::string>& symbols) {
+    std::vector<std::unique_ptr<domain::IExchangeLiveKlines>> retired;
+    std::vector<std::future<void>> handovers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!subscribed_) {
+            throw make_error("add_symbols called before subscribe");
+        }
+
+        std::vector<std::string> added;
+        for (const auto& symbol : symbols) {
+            auto upper = normalize_symbol_(symbol);
+            if (!upper.empty() && symbols_.insert(upper).second) {
+                added.push_back(std::move(upper));
+            }
+        }
+        if (added.empty()) {
+            return;
+        }
+
+        // Plan first so a failed restart leaves every running shard untouched.
+        std::vector<Shard> planned;
+        planned.reserve(shards_.size());
+        for (const auto& shard : shards_) {
+            planned.push_back(Shard{shard.symbols, nullptr});
+        }
+        std::vector<bool> touched(planned.size(), false);
+        for (const auto& symbol : added) {
+            auto target = planned.end();
+            for (auto it = planned.begin(); it != planned.end(); ++it) {
+                if (it->symbols.size() < maxStreamsPerShard_ &&
+                    (target == planned.end() || it->symbols.size() < target->symbols.size())) {
+                    target = it;
+                }
+            }
+            if (target == planned.end()) {
+                planned.push_back(Shard{});
+                touched.push_back(false);
+                target = planned.end() - 1;
+            }
+            target->symbols.push_back(symbol);
+            touched[static_cast<std::size_t>(target - planned.begin())] = true;
+        }
+
+        std::vector<std::unique_ptr<domain::IExchangeLiveKlines>> started;
+        try {
+            for (std::size_t i = 0; i < planned.size(); ++i) {
+                if (!touched[i]) {
+                    continue;
+                }
+                if (i < shards_.size()) {
+                    auto connected = std::make_shared<std::promise<void>>();
+                    handovers.push_back(connected->get_future());
+                    planned[i].client = start_shard_(planned[i].symbols, std::move(connected));
+                }
+                else {
+                    planned[i].client = start_shard_(planned[i].symbols);
+                }
+            }
+        }
+        catch (...) {
+            for (auto& shard : planned) {
+                if (shard.client) {
+                    started.push_back(std::move(shard.client));
+                }
+            }
+            for (const auto& symbol : added) {
+                symbols_.erase(symbol);
+            }
+            stop_all_(std::move(started));
+            throw;
+        }
+
+        for (std::size_t i = 0; i < planned.size(); ++i) {
+            if (!touched[i]) {
+                planned[i].client = std::move(shards_[i].client);
+            }
+            else if (i < shards_.size()) {
+                retired.push_back(std::move(shards_[i].client));
+            }
+        }
+        shards_ = std::move(planned);
+
+        LOG_INFO(kLogCategory,
+                 "ShardedKlineFeed rebalanced symbols=%zu shards=%zu restarted=%zu",
+                 symbols_.size(),
+                 shards_.size(),
+                 static_cast<std::size_t>(std::count(touched.begin(), touched.end(), true)));
+        publish_shard_count_(shards_.size());
+    }
+
+    // subscribe() only starts a shard; wait for the replacements to be
+    // streaming before their predecessors stop.
+    const auto deadline = std::chrono::steady_clock::now() + handoverTimeout_;
+    std::size_t late = 0;
+    for (auto& handover : handovers) {
+        if (handover.wait_until(deadline) != std::future_status::ready) {
+            ++late;
+        }
+    }
+    if (late > 0) {
+        LOG_WARN(kLogCategory,
+                 "ShardedKlineFeed handover timed out replacements=%zu late=%zu timeout_ms=%lld",
+                 handovers.size(),
+                 late,
+                 static_cast<long long>(handoverTimeout_.count()));
+    }
+
+    stop_all_(std::move(retired));
+}
+
+std::size_t ShardedKlineFeed::shard_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return shards_.size();
+}
+
+std::unique_ptr<domain::IExchangeLiveKlines> ShardedKlineFeed::start_shard_(
+    const std::vector<std::string>& symbols,
+    std::shared_ptr<std::promise<void>> connected) {
+    auto client = factory_();
+    if (!client) {
+        throw make_error("shard factory returned null");
+    }
+    client->set_on_reconnected([this, connected, once = std::make_shared<std::once_flag>()]() {
+        if (connected) {
+            std::call_once(*once, [&connected]() { connected->set_value(); });
+        }
+        notify_reconnected_();
+    });
+    client->subscribe(symbols, interval_, on_closed_candle_);
+    return client;
+}
+
+void ShardedKlineFeed::notify_reconnected_() {
+    std::function<void()> callback;
+    {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        callback = on_reconnected_;
+    }
+    if (callback) {
+        callback();
+    }
+}
+
+void ShardedKlineFeed::publish_shard_count_(std::size_t count) {
+    ttp::common::metrics::Registry::instance().setGauge("ws.shards", static_cast<double>(count));
+}
+
+std::string ShardedKlineFeed::normalize_symbol_(const std::string& symbol) {
+    std::string result;
+    result.reserve(symbol.size());
+    for (unsigned char ch : symbol) {
+        if (!std::isspace(ch)) {
+            result.push_back(static_cast<char>(std::toupper(ch)));
+        }
+    }
+    return result;
+}
+
+void ShardedKlineFeed::stop_all_(std::vector<std::unique_ptr<domain::IExchangeLiveKlines>> clients) {
+    // Each stop() can wait for a close handshake; run them side by side.
+    std::vector<std::future<void>> pending;
+    pending.reserve(clients.size());
+    for (auto& client : clients) {
+        if (!client) {
+            continue;
+        }
+        pending.push_back(std::async(std::launch::async, [shard = std::move(client)]() mutable {
+            shard->stop();
+            shard.reset();
+        }));
+    }
+    for (auto& future : pending) {
+        future.wait();
+    }
+}
+
+}  // namespace adapters::binance
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "domain/exchange/IExchangeKlines.hpp"
+
+namespace adapters::binance {
+
+// Live kline feed spread over several independent connections. Symbols are
+// packed into shards of at most maxStreamsPerShard streams; every shard is its
+// own IExchangeLiveKlines (one BinanceWsClient in production) with its own
+// worker/io threads and reconnect backoff, so a slow consumer or a reconnect
+// on one shard does not stall the others.
+//
+// Callbacks run on the shard threads and may therefore be invoked
+// concurrently for different symbols.
+class ShardedKlineFeed : public domain::IExchangeLiveKlines {
+public:
+    using ShardFactory = std::function<std::unique_ptr<domain::IExchangeLiveKlines>()>;
+
+    static constexpr std::size_t kDefaultMaxStreamsPerShard = 50;
+    static constexpr std::chrono::milliseconds kDefaultHandoverTimeout{10000};
+
+    ShardedKlineFeed(ShardFactory factory,
+                     std::size_t maxStreamsPerShard = kDefaultMaxStreamsPerShard,
+                     std::chrono::milliseconds handoverTimeout = kDefaultHandoverTimeout);
+    ~ShardedKlineFeed() override;
+
+    ShardedKlineFeed(const ShardedKlineFeed&) = delete;
+    ShardedKlineFeed& operator=(const ShardedKlineFeed&) = delete;
+
+    void subscribe(const std::vector<std::string>& symbols,
+                   domain::Interval interval,
+                   std::function<void(const std::string&, const domain::Candle&)> on_closed_candle) override;
+
+    // Fires whenever any shard (re)connects.
+    void set_on_reconnected(std::function<void()> callback) override;
+
+    void stop() override;
+
+    // Adds symbols to a running feed. New symbols go to the least loaded shards
+    // with room, and new shards are opened once all are full. Only the shards
+    // that change are restarted. The old shard keeps streaming until its
+    // replacement reports its first connection (or handoverTimeout passes),
+    // so a candle may be delivered twice; the replacement's reconnect
+    // notification triggers the usual catch-up for anything in between.
+    void add_symbols(const std::vector<std::string>& symbols);
+
+    std::size_t shard_count() const;
+
+private:
+    struct Shard {
+        std::vector<std::string> symbols;
+        std::unique_ptr<domain::IExchangeLiveKlines> client;
+    };
+
+    // `connected`, when given, is fulfilled on the shard's first connection.
+    std::unique_ptr<domain::IExchangeLiveKlines> start_shard_(const std::vector<std::string>& symbols,
+                                                              std::shared_ptr<std::promise<void>> connected = nullptr);
+    void notify_reconnected_();
+    static void publish_shard_count_(std::size_t count);
+    static std::string normalize_symbol_(const std::string& symbol);
+    static void stop_all_(std::vector<std::unique_ptr<domain::IExchangeLiveKlines>> clients);
+
+    const ShardFactory factory_;
+    const std::size_t maxStreamsPerShard_;
+    const std::chrono::milliseconds handoverTimeout_;
+
+    mutable std::mutex mutex_;
+    bool subscribed_{false};
+    domain::Interval interval_{};
+    std::function<void(const std::string&, const domain::Candle&)> on_closed_candle_;
+    std::unordered_set<std::string> symbols_;
+    std::vector<Shard> shards_;
+
+    std::mutex callback_mutex_;
+    std::function<void()> on_reconnected_;
+};
+
+}  // namespace adapters::binance
@@ -0,0 +1,64 @@
+#include "adapters/binance/WeightBudget.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace adapters::binance {
+
+WeightBudget::WeightBudget(std::uint32_t weightPerMinute)
+    : weightPerMinute_(std::max<std::uint32_t>(weightPerMinute, 1U)),
+      refillPerMs_(static_cast<double>(weightPerMinute_) / 60000.0),
+      tokens_(static_cast<double>(weightPerMinute_)),
+      lastRefill_(Clock::now()) {}
+
+void WeightBudget::acquire(std::uint32_t weight) {
+    const auto needed = static_cast<double>(std::min(weight, weightPerMinute_));
+    std::unique_lock lock(mutex_);
+    for (;;) {
+        const auto now = Clock::now();
+        if (now < pausedUntil_) {
+            cv_.wait_until(lock, pausedUntil_);
+            continue;
+        }
+
+        refillLocked_(now);
+        if (tokens_ >= needed) {
+            tokens_ -= needed;
+            return;
+        }
+
+        const auto waitMs = std::ceil((needed - tokens_) / refillPerMs_);
+        cv_.wait_for(lock, std::chrono::milliseconds(static_cast<std::int64_t>(waitMs)));
+    }
+}
+
+void WeightBudget::observeUsedWeight(std::uint32_t usedWeight) {
+    std::scoped_lock lock(mutex_);
+    refillLocked_(Clock::now());
+    // The server counts weight we may not have spent through this bucket
+    // (other processes, earlier runs); never believe we have more than it allows.
+    const auto remaining = static_cast<double>(weightPerMinute_) - static_cast<double>(usedWeight);
+    tokens_ = std::max(std::min(tokens_, remaining), -static_cast<double>(weightPerMinute_));
+}
+
+void WeightBudget::pauseFor(std::chrono::milliseconds duration) {
+    {
+        std::scoped_lock lock(mutex_);
+        const auto now = Clock::now();
+        pausedUntil_ = std::max(pausedUntil_, now + duration);
+        tokens_ = std::min(tokens_, 0.0);
+        lastRefill_ = pausedUntil_;
+    }
+    cv_.notify_all();
+}
+
+void WeightBudget::refillLocked_(Clock::time_point now) {
+    if (now <= lastRefill_) {
+        return;
+    }
+    const auto elapsedMs = std::chrono::duration<double, std::milli>(now - lastRefill_).count();
+    tokens_ = std::min(static_cast<double>(weightPerMinute_), tokens_ + elapsedMs * refillPerMs_);
+    lastRefill_ = now;
+}
+
+}  // namespace adapters::binance
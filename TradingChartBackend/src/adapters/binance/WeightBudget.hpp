@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace adapters::binance {
+
+// Token bucket for Binance REST request weight, shared by every client that
+// talks to the same API key/IP. Tokens refill continuously at
+// weightPerMinute / 60s and are reconciled with the X-MBX-USED-WEIGHT header
+// the server returns, so several concurrent fetchers stay under the limit.
+class WeightBudget {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit WeightBudget(std::uint32_t weightPerMinute = kDefaultWeightPerMinute);
+
+    WeightBudget(const WeightBudget&) = delete;
+    WeightBudget& operator=(const WeightBudget&) = delete;
+
+    // Blocks until `weight` is available (and any pause has elapsed), then spends it.
+    void acquire(std::uint32_t weight);
+
+    // Server-side weight used in the current minute window.
+    void observeUsedWeight(std::uint32_t usedWeight);
+
+    // 429/418 handling: no request leaves before the pause ends.
+    void pauseFor(std::chrono::milliseconds duration);
+
+    std::uint32_t weightPerMinute() const noexcept { return weightPerMinute_; }
+
+    static constexpr std::uint32_t kDefaultWeightPerMinute = 1000;
+
+private:
+    void refillLocked_(Clock::time_point now);
+
+    const std::uint32_t weightPerMinute_;
+    const double refillPerMs_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    double tokens_;
+    Clock::time_point lastRefill_;
+    Clock::time_point pausedUntil_{};
+};
+
+}  // namespace adapters::binance
@@ -0,0 +1,319 @@
+#include "adapters/columnar/ColumnarCandleRepo.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <system_error>
+#include <utility>
+
+#include "common/SeriesVersions.hpp"
+#include "domain/Models.hpp"
+#include "domain/Types.h"
+#include "infra/storage/PriceData.h"
+#include "logging/Log.h"
+
+namespace fs = std::filesystem;
+
+namespace adapters::columnar {
+namespace {
+
+constexpr logging::LogCategory kLogCategory = logging::LogCategory::DATA;
+constexpr const char* kSeriesExtension = ".col";
+constexpr std::size_t kImportChunkRecords = 4096;
+
+using infra::storage::ColumnarSeriesFile;
+
+std::vector<domain::contracts::Candle> readRange(const ColumnarSeriesFile& file,
+                                                 std::int64_t fromTs,
+                                                 std::int64_t toTs,
+                                                 std::size_t limit) {
+    const std::size_t total = file.size();
+    std::size_t begin = fromTs > 0 ? file.lowerBound(fromTs) : 0;
+    std::size_t end = toTs > 0 ? file.upperBound(toTs) : total;
+    if (end < begin) {
+        end = begin;
+    }
+
+    // Same contract as the other repos: a range returns its first `limit`
+    // rows, no range returns the latest `limit` rows.
+    if (limit > 0 && end - begin > limit) {
+        if (fromTs > 0 || toTs > 0) {
+            end = begin + limit;
+        }
+        else {
+            begin = end - limit;
+        }
+    }
+
+    const auto* ts = file.ts();
+    const auto* open = file.column(ColumnarSeriesFile::Open);
+    const auto* high = file.column(ColumnarSeriesFile::High);
+    const auto* low = file.column(ColumnarSeriesFile::Low);
+    const auto* close = file.column(ColumnarSeriesFile::Close);
+    const auto* volume = file.column(ColumnarSeriesFile::Volume);
+
+    std::vector<domain::contracts::Candle> candles(end - begin);
+    for (std::size_t i = begin; i < end; ++i) {
+        auto& candle = candles[i - begin];
+        candle.ts = ts[i];
+        candle.o = open[i];
+        candle.h = high[i];
+        candle.l = low[i];
+        candle.c = close[i];
+        candle.v = volume[i];
+    }
+    return candles;
+}
+
+// SYMBOL_interval -> (SYMBOL, canonical interval label).
+std::optional<std::pair<std::string, std::string>> parseSeriesStem(const std::string& stem) {
+    const auto separator = stem.rfind('_');
+    if (separator == std::string::npos || separator == 0 || separator + 1 >= stem.size()) {
+        return std::nullopt;
+    }
+    const auto interval = domain::contracts::intervalFromString(stem.substr(separator + 1));
+    const auto label = domain::contracts::intervalToString(interval);
+    if (label.empty()) {
+        return std::nullopt;
+    }
+    return std::make_pair(stem.substr(0, separator), label);
+}
+
+}  // namespace
+
+ColumnarCandleRepo::ColumnarCandleRepo(fs::path rootDir) : rootDir_(std::move(rootDir)) {}
+
+std::vector<domain::contracts::Candle> ColumnarCandleRepo::getCandles(const domain::contracts::Symbol& symbol,
+                                                                      domain::contracts::Interval interval,
+                                                                      std::int64_t fromTs,
+                                                                      std::int64_t toTs,
+                                                                      std::size_t limit) const {
+    const auto label = domain::contracts::intervalToString(interval);
+    if (symbol.empty() || label.empty()) {
+        return {};
+    }
+
+    {
+        std::shared_lock lock(mutex_);
+        const auto it = series_.find(SeriesKey{symbol, label});
+        if (it != series_.end()) {
+            return readRange(*it->second, fromTs, toTs, limit);
+        }
+    }
+
+    std::unique_lock lock(mutex_);
+    const auto* file = seriesUnsafe_(symbol, label, false, 0);
+    if (file == nullptr) {
+        return {};
+    }
+    return readRange(*file, fromTs, toTs, limit);
+}
+
+std::vector<domain::contracts::SymbolInfo> ColumnarCandleRepo::listSymbols() const {
+    std::vector<domain::contracts::SymbolInfo> symbols;
+    for (const auto& [symbol, interval] : listSeries_()) {
+        (void)interval;
+        if (symbols.empty() || symbols.back().symbol != symbol) {
+            domain::contracts::SymbolInfo info{};
+            info.symbol = symbol;
+            symbols.push_back(std::move(info));
+        }
+    }
+    return symbols;
+}
+
+std::optional<bool> ColumnarCandleRepo::symbolExists(const domain::contracts::Symbol& symbol) const {
+    const auto series = listSeries_();
+    return std::any_of(series.begin(), series.end(), [&symbol](const auto& key) { return key.first == symbol; });
+}
+
+std::vector<domain::contracts::IntervalRangeInfo>
+ColumnarCandleRepo::listSymbolIntervals(const domain::contracts::Symbol& symbol) const {
+    std::vector<domain::contracts::IntervalRangeInfo> intervals;
+    for (const auto& [seriesSymbol, interval] : listSeries_()) {
+        if (seriesSymbol != symbol) {
+            continue;
+        }
+        domain::contracts::IntervalRangeInfo info{};
+        info.interval = interval;
+        if (const auto range = get_min_max_ts(symbol, interval)) {
+            info.fromTs = range->first;
+            info.toTs = range->second;
+        }
+        intervals.push_back(std::move(info));
+    }
+    return intervals;
+}
+
+std::optional<std::pair<std::int64_t, std::int64_t>>
+ColumnarCandleRepo::get_min_max_ts(const std::string& symbol, const std::string& interval) const {
+    const auto label = domain::contracts::intervalToString(domain::contracts::intervalFromString(interval));
+    if (symbol.empty() || label.empty()) {
+        return std::nullopt;
+    }
+
+    std::unique_lock lock(mutex_);
+    const auto* file = seriesUnsafe_(symbol, label, false, 0);
+    if (file == nullptr || file->size() == 0) {
+        return std::nullopt;
+    }
+    return std::make_pair(file->ts()[0], file->ts()[file->size() - 1]);
+}
+
+bool ColumnarCandleRepo::upsert_batch(const std::string& symbol,
+                                      const std::string& interval,
+                                      const std::vector<domain::Candle>& rows) {
+    const auto label = domain::contracts::intervalToString(domain::contracts::intervalFromString(interval));
+    if (symbol.empty() || label.empty() || rows.empty()) {
+        return false;
+    }
+
+    std::vector<infra::storage::ColumnarRow> columnarRows;
+    columnarRows.reserve(rows.size());
+    for (const auto& candle : rows) {
+        infra::storage::ColumnarRow row{};
+        row.ts = static_cast<std::int64_t>(candle.openTime);
+        row.open = candle.open;
+        row.high = candle.high;
+        row.low = candle.low;
+        row.close = candle.close;
+        row.volume = candle.baseVolume;
+        columnarRows.push_back(row);
+    }
+    std::stable_sort(columnarRows.begin(), columnarRows.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.ts < rhs.ts;
+    });
+
+    std::unique_lock lock(mutex_);
+    auto* file = seriesUnsafe_(symbol, label, true, domain::interval_from_label(label).ms);
+    if (file == nullptr) {
+        return false;
+    }
+    const auto written = file->append(columnarRows.data(), columnarRows.size());
+    if (written > 0) {
+        ttp::common::SeriesVersions::instance().bump(symbol, label, columnarRows.front().ts, columnarRows.back().ts);
+    }
+    if (written < columnarRows.size()) {
+        LOG_WARN(kLogCategory,
+                 "ColumnarCandleRepo skipped rows older than the stored tail symbol=%s interval=%s rows=%zu skipped=%zu",
+                 symbol.c_str(),
+                 label.c_str(),
+                 columnarRows.size(),
+                 columnarRows.size() - written);
+        return false;
+    }
+    return true;
+}
+
+std::size_t ColumnarCandleRepo::importLegacyDatasets(const std::vector<fs::path>& searchPaths) {
+    std::size_t imported = 0;
+    for (const auto& base : searchPaths) {
+        std::error_code ec;
+        if (!fs::is_directory(base, ec)) {
+            continue;
+        }
+
+        for (const auto& entry : fs::directory_iterator(base, ec)) {
+            if (!entry.is_regular_file() || entry.path().extension() != ".bin") {
+                continue;
+            }
+            const auto key = parseSeriesStem(entry.path().stem().string());
+            if (!key.has_value() || fs::exists(seriesPath_(key->first, key->second), ec)) {
+                continue;
+            }
+
+            std::ifstream input(entry.path(), std::ios::binary);
+            if (!input) {
+                continue;
+            }
+
+            std::vector<infra::storage::ColumnarRow> rows;
+            std::vector<infra::storage::PriceData> chunk(kImportChunkRecords);
+            while (input) {
+                input.read(reinterpret_cast<char*>(chunk.data()),
+                           static_cast<std::streamsize>(chunk.size() * sizeof(infra::storage::PriceData)));
+                const auto records = static_cast<std::size_t>(input.gcount()) / sizeof(infra::storage::PriceData);
+                for (std::size_t i = 0; i < records; ++i) {
+                    const auto& record = chunk[i];
+                    if (record.openTime <= 0) {
+                        continue;
+                    }
+                    rows.push_back(infra::storage::ColumnarRow{static_cast<std::int64_t>(record.openTime),
+                                                               record.openPrice,
+                                                               record.highPrice,
+                                                               record.lowPrice,
+                                                               record.closePrice,
+                                                               record.volume});
+                }
+            }
+            std::stable_sort(rows.begin(), rows.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.ts < rhs.ts;
+            });
+
+            std::unique_lock lock(mutex_);
+            auto* file = seriesUnsafe_(key->first, key->second, true, domain::interval_from_label(key->second).ms);
+            if (file == nullptr) {
+                continue;
+            }
+            const auto written = file->append(rows.data(), rows.size());
+            ++imported;
+            LOG_INFO(kLogCategory,
+                     "ColumnarCandleRepo imported legacy dataset path=%s rows=%zu",
+                     entry.path().string().c_str(),
+                     written);
+        }
+    }
+    return imported;
+}
+
+fs::path ColumnarCandleRepo::seriesPath_(const std::string& symbol, const std::string& interval) const {
+    return rootDir_ / (symbol + '_' + interval + kSeriesExtension);
+}
+
+ColumnarSeriesFile* ColumnarCandleRepo::seriesUnsafe_(const std::string& symbol,
+                                                      const std::string& interval,
+                                                      bool create,
+                                                      std::int64_t intervalMs) const {
+    SeriesKey key{symbol, interval};
+    const auto it = series_.find(key);
+    if (it != series_.end()) {
+        return it->second.get();
+    }
+
+    const auto path = seriesPath_(symbol, interval);
+    std::error_code ec;
+    if (create) {
+        fs::create_directories(rootDir_, ec);
+    }
+    else if (!fs::exists(path, ec)) {
+        return nullptr;
+    }
+
+    auto file = std::make_unique<ColumnarSeriesFile>();
+    if (!file->open(path.string(), create, intervalMs)) {
+        return nullptr;
+    }
+    auto* raw = file.get();
+    series_.emplace(std::move(key), std::move(file));
+    return raw;
+}
+
+std::vector<ColumnarCandleRepo::SeriesKey> ColumnarCandleRepo::listSeries_() const {
+    std::vector<SeriesKey> series;
+    std::error_code ec;
+    if (!fs::is_directory(rootDir_, ec)) {
+        return series;
+    }
+    for (const auto& entry : fs::directory_iterator(rootDir_, ec)) {
+        if (!entry.is_regular_file() || entry.path().extension() != kSeriesExtension) {
+            continue;
+        }
+        if (auto key = parseSeriesStem(entry.path().stem().string())) {
+            series.push_back(std::move(*key));
+        }
+    }
+    std::sort(series.begin(), series.end());
+    return series;
+}
+
+}  // namespace adapters::columnar
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "domain/Ports.hpp"
+#include "infra/storage/ColumnarSeriesFile.h"
+
+namespace domain {
+struct Candle;
+}  // namespace domain
+
+namespace adapters::columnar {
+
+// Candle store with one mmap'd columnar file per series:
+// <root>/<SYMBOL>_<interval>.col (see infra::storage::ColumnarSeriesFile).
+class ColumnarCandleRepo : public domain::contracts::ICandleReadRepo {
+public:
+    explicit ColumnarCandleRepo(std::filesystem::path rootDir = "data/columnar");
+
+    std::vector<domain::contracts::Candle> getCandles(const domain::contracts::Symbol& symbol,
+                                                      domain::contracts::Interval interval,
+                                                      std::int64_t fromTs,
+                                                      std::int64_t toTs,
+                                                      std::size_t limit) const override;
+
+    std::vector<domain::contracts::SymbolInfo> listSymbols() const override;
+
+    std::optional<bool> symbolExists(const domain::contracts::Symbol& symbol) const override;
+
+    std::vector<domain::contracts::IntervalRangeInfo>
+    listSymbolIntervals(const domain::contracts::Symbol& symbol) const override;
+
+    std::optional<std::pair<std::int64_t, std::int64_t>>
+    get_min_max_ts(const std::string& symbol, const std::string& interval) const override;
+
+    // Rows past the stored tail are appended and rows already stored are
+    // rewritten in place. Older rows that would fill a gap are skipped with a
+    // warning and make the call return false.
+    bool upsert_batch(const std::string& symbol,
+                      const std::string& interval,
+                      const std::vector<domain::Candle>& rows);
+
+    // Converts legacy SYMBOL_interval.bin datasets that have no columnar file yet.
+    std::size_t importLegacyDatasets(const std::vector<std::filesystem::path>& searchPaths);
+
+private:
+    using SeriesKey = std::pair<std::string, std::string>;
+
+    std::filesystem::path seriesPath_(const std::string& symbol, const std::string& interval) const;
+    infra::storage::ColumnarSeriesFile* seriesUnsafe_(const std::string& symbol,
+                                                      const std::string& interval,
+                                                      bool create,
+                                                      std::int64_t intervalMs) const;
+    std::vector<SeriesKey> listSeries_() const;
+
+    std::filesystem::path rootDir_;
+    mutable std::shared_mutex mutex_;
+    mutable std::map<SeriesKey, std::unique_ptr<infra::storage::ColumnarSeriesFile>> series_;
+};
+
+}  // namespace adapters::columnar
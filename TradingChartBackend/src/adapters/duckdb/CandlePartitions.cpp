@@ -0,0 +1,439 @@
+#include "adapters/duckdb/CandlePartitions.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(HAS_DUCKDB)
+#include <duckdb.hpp>
+#endif
+
+namespace adapters::duckdb {
+namespace {
+
+constexpr std::int64_t kMillisPerDay = 86'400'000LL;
+
+struct CivilDate {
+    std::int64_t year{1970};
+    unsigned month{1};
+};
+
+// Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's algorithm).
+std::int64_t daysFromCivil(std::int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2 ? 1 : 0;
+    const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const auto yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned mp = month > 2 ? month - 3 : month + 9;
+    const unsigned doy = (153 * mp + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+CivilDate civilFromDays(std::int64_t days) {
+    days += 719468;
+    const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const auto doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned month = mp < 10 ? mp + 3 : mp - 9;
+    const std::int64_t year = static_cast<std::int64_t>(yoe) + era * 400 + (month <= 2 ? 1 : 0);
+    return CivilDate{year, month};
+}
+
+std::int64_t floorDiv(std::int64_t value, std::int64_t divisor) {
+    const auto quotient = value / divisor;
+    return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+}
+
+std::string sanitizeIdentifier(std::string_view value) {
+    std::string out;
+    out.reserve(value.size());
+    for (const char ch : value) {
+        const auto uch = static_cast<unsigned char>(ch);
+        if (std::isalnum(uch) != 0) {
+            out.push_back(static_cast<char>(std::tolower(uch)));
+        }
+    }
+    return out;
+}
+
+#if defined(HAS_DUCKDB)
+using DuckdbValueVector = ::duckdb::vector<::duckdb::Value>;
+
+std::string quoted(const std::string& name) {
+    return "\"" + name + "\"";
+}
+
+void runOrThrow(::duckdb::Connection& connection, const std::string& sql, const std::string& context) {
+    auto result = connection.Query(sql);
+    if (!result || result->HasError()) {
+        const std::string errorMessage = result ? result->GetError() : std::string{"unknown error"};
+        throw std::runtime_error("CandlePartitions " + context + " failed: " + errorMessage);
+    }
+}
+
+::duckdb::unique_ptr<::duckdb::QueryResult> executeOrThrow(::duckdb::Connection& connection,
+                                                          const std::string& sql,
+                                                          DuckdbValueVector& parameters,
+                                                          const std::string& context) {
+    auto statement = connection.Prepare(sql);
+    if (!statement || statement->HasError()) {
+        const std::string errorMessage =
+            statement ? statement->GetError() : std::string{"failed to prepare statement"};
+        throw std::runtime_error("CandlePartitions " + context + " failed: " + errorMessage);
+    }
+    auto result = statement->Execute(parameters);
+    if (!result || result->HasError()) {
+        const std::string errorMessage = result ? result->GetError() : std::string{"failed to execute statement"};
+        throw std::runtime_error("CandlePartitions " + context + " failed: " + errorMessage);
+    }
+    return result;
+}
+
+// Copies the partition into a fresh table sorted by (symbol, ts) so DuckDB's
+// zone maps stay tight, then swaps it in under the original name.
+void rebuildPartition(::duckdb::Connection& connection, const std::string& tableName, bool withPrimaryKey) {
+    const std::string staging = tableName + "__rebuild";
+    runOrThrow(connection, "DROP TABLE IF EXISTS " + quoted(staging), "rebuild " + tableName);
+    runOrThrow(connection, partitionTableDdl(staging, withPrimaryKey), "rebuild " + tableName);
+    runOrThrow(connection,
+               "INSERT INTO " + quoted(staging) + " SELECT symbol, ts, o, h, l, c, v FROM " + quoted(tableName)
+                   + " ORDER BY symbol, ts",
+               "rebuild " + tableName);
+    runOrThrow(connection, "DROP TABLE " + quoted(tableName), "rebuild " + tableName);
+    runOrThrow(connection,
+               "ALTER TABLE " + quoted(staging) + " RENAME TO " + quoted(tableName),
+               "rebuild " + tableName);
+}
+#endif
+
+}  // namespace
+
+std::optional<PartitionGranularity> partitionGranularityFromString(std::string_view value) {
+    std::string lowered{value};
+    std::transform(lowered.begin(), lowered.end(), lowered.begin(), [](unsigned char ch) {
+        return static_cast<char>(std::tolower(ch));
+    });
+    if (lowered == "none" || lowered == "off") {
+        return PartitionGranularity::None;
+    }
+    if (lowered == "month" || lowered == "monthly") {
+        return PartitionGranularity::Month;
+    }
+    if (lowered == "year" || lowered == "yearly") {
+        return PartitionGranularity::Year;
+    }
+    return std::nullopt;
+}
+
+const char* partitionGranularityToString(PartitionGranularity granularity) noexcept {
+    switch (granularity) {
+    case PartitionGranularity::Month:
+        return "month";
+    case PartitionGranularity::Year:
+        return "year";
+    case PartitionGranularity::None:
+    default:
+        return "none";
+    }
+}
+
+PartitionBounds partitionBoundsFor(std::int64_t tsMs, PartitionGranularity granularity) {
+    const auto date = civilFromDays(floorDiv(tsMs, kMillisPerDay));
+    switch (granularity) {
+    case PartitionGranularity::Month: {
+        const auto nextYear = date.month == 12 ? date.year + 1 : date.year;
+        const auto nextMonth = date.month == 12 ? 1U : date.month + 1;
+        return PartitionBounds{daysFromCivil(date.year, date.month, 1) * kMillisPerDay,
+                               daysFromCivil(nextYear, nextMonth, 1) * kMillisPerDay};
+    }
+    case PartitionGranularity::Year:
+        return PartitionBounds{daysFromCivil(date.year, 1, 1) * kMillisPerDay,
+                               daysFromCivil(date.year + 1, 1, 1) * kMillisPerDay};
+    case PartitionGranularity::None:
+    default:
+        return PartitionBounds{std::numeric_limits<std::int64_t>::min(),
+                               std::numeric_limits<std::int64_t>::max()};
+    }
+}
+
+std::string partitionTableName(std::string_view interval,
+                               const PartitionBounds& bounds,
+                               PartitionGranularity granularity) {
+    const auto date = civilFromDays(floorDiv(bounds.startMs, kMillisPerDay));
+    char period[32];  // wide enough for any int64 year
+    if (granularity == PartitionGranularity::Month) {
+        std::snprintf(period, sizeof(period), "%04lld%02u", static_cast<long long>(date.year), date.month);
+    }
+    else {
+        std::snprintf(period, sizeof(period), "%04lld", static_cast<long long>(date.year));
+    }
+    return "candles_" + sanitizeIdentifier(interval) + '_' + period;
+}
+
+std::string partitionTableDdl(const std::string& tableName, bool withPrimaryKey) {
+    std::string ddl = "CREATE TABLE IF NOT EXISTS \"" + tableName + "\" ("
+                      "symbol TEXT, ts BIGINT, o DOUBLE, h DOUBLE, l DOUBLE, c DOUBLE, v DOUBLE";
+    if (withPrimaryKey) {
+        ddl += ", PRIMARY KEY(symbol, ts)";
+    }
+    ddl += ")";
+    return ddl;
+}
+
+std::string partitionCatalogDdl() {
+    return "CREATE TABLE IF NOT EXISTS " + std::string{kPartitionCatalogTable} + " ("
+           "table_name TEXT PRIMARY KEY, "
+           "interval TEXT, "
+           "granularity TEXT, "
+           "start_ts BIGINT, "
+           "end_ts BIGINT, "
+           "frozen BOOLEAN DEFAULT false, "
+           "row_count BIGINT, "
+           "compacted_at BIGINT, "
+           "cold_path TEXT)";
+}
+
+std::string partitionCatalogUpgradeDdl() {
+    return "ALTER TABLE " + std::string{kPartitionCatalogTable} + " ADD COLUMN IF NOT EXISTS cold_path TEXT";
+}
+
+std::string seriesBoundsDdl() {
+    return "CREATE TABLE IF NOT EXISTS " + std::string{kSeriesBoundsTable} + " ("
+           "symbol TEXT, "
+           "interval TEXT, "
+           "min_ts BIGINT, "
+           "max_ts BIGINT, "
+           "version BIGINT DEFAULT 1, "
+           "PRIMARY KEY(symbol, interval))";
+}
+
+std::string seriesBoundsUpgradeDdl() {
+    return "ALTER TABLE " + std::string{kSeriesBoundsTable} + " ADD COLUMN IF NOT EXISTS version BIGINT DEFAULT 1";
+}
+
+std::string seriesWritesDdl() {
+    return "CREATE TABLE IF NOT EXISTS " + std::string{kSeriesWritesTable} + " ("
+           "symbol TEXT, "
+           "interval TEXT, "
+           "version BIGINT, "
+           "first_ts BIGINT, "
+           "last_ts BIGINT)";
+}
+
+std::string seriesBoundsMergeSql(const std::string& rows) {
+    return "INSERT INTO " + std::string{kSeriesBoundsTable} + " (symbol, interval, min_ts, max_ts) " + rows
+           + " ON CONFLICT (symbol, interval) DO UPDATE SET "
+             "min_ts = LEAST(min_ts, excluded.min_ts), max_ts = GREATEST(max_ts, excluded.max_ts), "
+             "version = version + 1";
+}
+
+std::string sqlStringLiteral(std::string_view value) {
+    std::string literal;
+    literal.reserve(value.size() + 2);
+    literal.push_back('\'');
+    for (const char ch : value) {
+        if (ch == '\'') {
+            literal.push_back('\'');
+        }
+        literal.push_back(ch);
+    }
+    literal.push_back('\'');
+    return literal;
+}
+
+std::string partitionSource(const std::string& tableName, const std::string& coldPath) {
+    if (coldPath.empty()) {
+        return "\"" + tableName + "\"";
+    }
+    return "read_parquet(" + sqlStringLiteral(coldPath) + ")";
+}
+
+#if defined(HAS_DUCKDB)
+void ensurePartition(::duckdb::Connection& connection,
+                     const std::string& tableName,
+                     std::string_view interval,
+                     const PartitionBounds& bounds,
+                     PartitionGranularity granularity) {
+    runOrThrow(connection, partitionTableDdl(tableName, true), "create " + tableName);
+
+    const std::string catalog{kPartitionCatalogTable};
+    DuckdbValueVector parameters;
+    parameters.emplace_back(tableName);
+    auto lookup = executeOrThrow(connection,
+                                 "SELECT frozen, cold_path FROM " + catalog + " WHERE table_name = ?",
+                                 parameters,
+                                 "lookup " + tableName);
+
+    bool registered = false;
+    bool frozen = false;
+    std::string coldPath;
+    if (auto chunk = lookup->Fetch()) {
+        if (chunk->size() > 0) {
+            registered = true;
+            const auto frozenValue = chunk->GetValue(0, 0);
+            frozen = !frozenValue.IsNull() && frozenValue.GetValue<bool>();
+            const auto coldValue = chunk->GetValue(1, 0);
+            if (!coldValue.IsNull()) {
+                coldPath = coldValue.GetValue<std::string>();
+            }
+        }
+    }
+
+    if (!registered) {
+        parameters.clear();
+        parameters.emplace_back(tableName);
+        parameters.emplace_back(std::string{interval});
+        parameters.emplace_back(partitionGranularityToString(granularity));
+        parameters.emplace_back(::duckdb::Value::BIGINT(bounds.startMs));
+        parameters.emplace_back(::duckdb::Value::BIGINT(bounds.endMs));
+        executeOrThrow(connection,
+                       "INSERT INTO " + catalog
+                           + " (table_name, interval, granularity, start_ts, end_ts, frozen) "
+                             "VALUES (?, ?, ?, ?, ?, false)",
+                       parameters,
+                       "register " + tableName);
+        return;
+    }
+
+    if (!coldPath.empty()) {
+        // The Parquet file is left in place; the next tiering run overwrites it.
+        runOrThrow(connection,
+                   "INSERT OR REPLACE INTO " + quoted(tableName)
+                       + " SELECT symbol, ts, o, h, l, c, v FROM " + partitionSource(tableName, coldPath),
+                   "rehydrate " + tableName);
+        parameters.clear();
+        parameters.emplace_back(tableName);
+        executeOrThrow(connection,
+                       "UPDATE " + catalog
+                           + " SET frozen = false, compacted_at = NULL, cold_path = NULL WHERE table_name = ?",
+                       parameters,
+                       "rehydrate " + tableName);
+        return;
+    }
+
+    if (frozen) {
+        rebuildPartition(connection, tableName, true);
+        parameters.clear();
+        parameters.emplace_back(tableName);
+        executeOrThrow(connection,
+                       "UPDATE " + catalog + " SET frozen = false, compacted_at = NULL WHERE table_name = ?",
+                       parameters,
+                       "thaw " + tableName);
+    }
+}
+
+std::int64_t freezePartition(::duckdb::Connection& connection, const std::string& tableName) {
+    rebuildPartition(connection, tableName, false);
+
+    DuckdbValueVector parameters;
+    auto countResult = executeOrThrow(connection,
+                                      "SELECT COUNT(*) FROM " + quoted(tableName),
+                                      parameters,
+                                      "count " + tableName);
+    std::int64_t rowCount = 0;
+    if (auto chunk = countResult->Fetch()) {
+        if (chunk->size() > 0) {
+            const auto value = chunk->GetValue(0, 0);
+            if (!value.IsNull()) {
+                rowCount = value.GetValue<std::int64_t>();
+            }
+        }
+    }
+
+    const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count();
+    parameters.emplace_back(::duckdb::Value::BIGINT(rowCount));
+    parameters.emplace_back(::duckdb::Value::BIGINT(static_cast<std::int64_t>(nowMs)));
+    parameters.emplace_back(tableName);
+    executeOrThrow(connection,
+                   "UPDATE " + std::string{kPartitionCatalogTable}
+                       + " SET frozen = true, row_count = ?, compacted_at = ? WHERE table_name = ?",
+                   parameters,
+                   "freeze " + tableName);
+    return rowCount;
+}
+
+void markPartitionCold(::duckdb::Connection& connection,
+                       const std::string& tableName,
+                       const std::string& coldPath) {
+    runOrThrow(connection, "DROP TABLE IF EXISTS " + quoted(tableName), "drop " + tableName);
+
+    DuckdbValueVector parameters;
+    parameters.emplace_back(coldPath);
+    parameters.emplace_back(tableName);
+    executeOrThrow(connection,
+                   "UPDATE " + std::string{kPartitionCatalogTable}
+                       + " SET frozen = true, cold_path = ? WHERE table_name = ?",
+                   parameters,
+                   "tier " + tableName);
+}
+
+std::int64_t rebuildSeriesBounds(::duckdb::Connection& connection) {
+    auto partitions = connection.Query("SELECT table_name, interval, cold_path FROM "
+                                       + std::string{kPartitionCatalogTable});
+    if (!partitions || partitions->HasError()) {
+        const std::string errorMessage = partitions ? partitions->GetError() : std::string{"unknown error"};
+        throw std::runtime_error("CandlePartitions bounds rebuild failed: " + errorMessage);
+    }
+
+    struct Source {
+        std::string tableName;
+        std::string interval;
+        std::string coldPath;
+    };
+    std::vector<Source> sources;
+    while (auto chunk = partitions->Fetch()) {
+        const auto count = chunk->size();
+        for (::duckdb::idx_t row = 0; row < count; ++row) {
+            const auto tableValue = chunk->GetValue(0, row);
+            const auto intervalValue = chunk->GetValue(1, row);
+            if (tableValue.IsNull() || intervalValue.IsNull()) {
+                continue;
+            }
+            const auto coldValue = chunk->GetValue(2, row);
+            sources.push_back(Source{tableValue.GetValue<std::string>(),
+                                     intervalValue.GetValue<std::string>(),
+                                     coldValue.IsNull() ? std::string{} : coldValue.GetValue<std::string>()});
+        }
+    }
+
+    // Versions restart with the rebuilt rows, so writes logged against the
+    // old ones would be misread.
+    runOrThrow(connection, "DELETE FROM " + std::string{kSeriesWritesTable}, "write log reset");
+    for (const auto& source : sources) {
+        runOrThrow(connection,
+                   seriesBoundsMergeSql("SELECT symbol, " + sqlStringLiteral(source.interval)
+                                        + ", MIN(ts), MAX(ts) FROM "
+                                        + partitionSource(source.tableName, source.coldPath)
+                                        + " GROUP BY symbol"),
+                   "bounds " + source.tableName);
+    }
+    // Rows still in the unified table (partitioning off) count as well.
+    runOrThrow(connection,
+               seriesBoundsMergeSql("SELECT symbol, interval, MIN(ts), MAX(ts) FROM candles GROUP BY symbol, interval"),
+               "bounds candles");
+
+    DuckdbValueVector parameters;
+    auto countResult = executeOrThrow(connection,
+                                      "SELECT COUNT(*) FROM " + std::string{kSeriesBoundsTable},
+                                      parameters,
+                                      "bounds count");
+    std::int64_t series = 0;
+    if (auto chunk = countResult->Fetch()) {
+        if (chunk->size() > 0 && !chunk->GetValue(0, 0).IsNull()) {
+            series = chunk->GetValue(0, 0).GetValue<std::int64_t>();
+        }
+    }
+    return series;
+}
+#endif
+
+}  // namespace adapters::duckdb
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#if defined(HAS_DUCKDB)
+namespace duckdb {
+class Connection;
+}  // namespace duckdb
+#endif
+
+namespace adapters::duckdb {
+
+// Candles are stored in one table per (interval, period). `None` keeps the
+// historical single `candles` table.
+enum class PartitionGranularity { None, Month, Year };
+
+std::optional<PartitionGranularity> partitionGranularityFromString(std::string_view value);
+const char* partitionGranularityToString(PartitionGranularity granularity) noexcept;
+
+// Half-open [startMs, endMs) window covered by a partition, in UTC.
+struct PartitionBounds {
+    std::int64_t startMs{0};
+    std::int64_t endMs{0};
+};
+
+PartitionBounds partitionBoundsFor(std::int64_t tsMs, PartitionGranularity granularity);
+
+// e.g. candles_1m_202401 (month) or candles_1h_2024 (year).
+std::string partitionTableName(std::string_view interval,
+                               const PartitionBounds& bounds,
+                               PartitionGranularity granularity);
+
+// Partition tables drop the interval column; (symbol, ts) is the conflict key.
+std::string partitionTableDdl(const std::string& tableName, bool withPrimaryKey);
+
+constexpr std::string_view kPartitionCatalogTable = "candle_partitions";
+std::string partitionCatalogDdl();
+
+// Catalogs created before the cold tier existed lack cold_path.
+std::string partitionCatalogUpgradeDdl();
+
+// MIN/MAX(ts) of every (symbol, interval) across its partitions (and the
+// unified table), widened by each write so bound lookups never scan data. `version` counts the
+// writes; it lives in the database so readers see writes from other
+// processes (e.g. a --backfill run) too.
+constexpr std::string_view kSeriesBoundsTable = "candle_series_bounds";
+std::string seriesBoundsDdl();
+
+// Bounds tables created before the write counter existed lack version.
+std::string seriesBoundsUpgradeDdl();
+
+// Open-time range of the last kSeriesWriteLogSize writes of each series, by
+// the bounds version each one produced, so readers can tell whether writes
+// from any process touched data they derived.
+constexpr std::string_view kSeriesWritesTable = "candle_series_writes";
+constexpr std::int64_t kSeriesWriteLogSize = 256;
+std::string seriesWritesDdl();
+
+// Widens the stored bounds with `rows` and counts a write: a VALUES list or
+// SELECT producing (symbol, interval, min_ts, max_ts), at most one row per
+// series.
+std::string seriesBoundsMergeSql(const std::string& rows);
+
+// Single-quoted SQL literal, for statements that cannot take parameters (COPY, read_parquet).
+std::string sqlStringLiteral(std::string_view value);
+
+// FROM-clause source for a partition: its hot table or, once tiered, its Parquet file.
+std::string partitionSource(const std::string& tableName, const std::string& coldPath);
+
+#if defined(HAS_DUCKDB)
+// Creates the partition table (and its catalog row) on first use. A frozen
+// partition is rebuilt with its primary key so INSERT OR REPLACE works again;
+// a cold one is reloaded from its Parquet file back into the hot table.
+// Throws std::runtime_error on failure; callers own the surrounding transaction.
+void ensurePartition(::duckdb::Connection& connection,
+                     const std::string& tableName,
+                     std::string_view interval,
+                     const PartitionBounds& bounds,
+                     PartitionGranularity granularity);
+
+// Rewrites a partition sorted by (symbol, ts), without the primary key index,
+// and marks it frozen in the catalog. Returns the number of rows kept.
+std::int64_t freezePartition(::duckdb::Connection& connection, const std::string& tableName);
+
+// Drops the hot table of a partition whose rows now live in coldPath.
+void markPartitionCold(::duckdb::Connection& connection,
+                       const std::string& tableName,
+                       const std::string& coldPath);
+
+// Recomputes the series bounds from every cataloged partition and the
+// unified table, for databases written before the bounds table existed, and
+// empties the write log. Returns the series recorded.
+std::int64_t rebuildSeriesBounds(::duckdb::Connection& connection);
+#endif
+
+}  // namespace adapters::duckdb
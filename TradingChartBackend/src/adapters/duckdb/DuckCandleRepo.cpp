@@ -4,6 +4,7 @@
 #include <cctype>
 #include <filesystem>
 #include <limits>
+#include <map>
 #include <optional>
 #include <stdexcept>
 #include <string>
@@ -12,6 +13,7 @@
 #include <unordered_set>
 #include <utility>
 
+#include "common/SeriesVersions.hpp"
 #include "domain/Models.hpp"
 #include "domain/Types.h"
 #include "logging/Log.h"
@@ -89,11 +91,131 @@ std::vector<domain::contracts::Candle> fetchCandles(DuckdbPreparedStatement& sta
 
     return candles;
 }
+
+struct PartitionRef {
+    std::string table;
+    std::int64_t startMs{0};
+    std::int64_t endMs{0};
+    std::string coldPath;
+
+    std::string source() const { return partitionSource(table, coldPath); }
+};
+
+// Partitions of `interval` whose window intersects [fromTs, toTs]; a
+// non-positive bound leaves that side open. Databases created before the
+// catalog existed simply yield no partitions.
+std::vector<PartitionRef> listPartitions(::duckdb::Connection& connection,
+                                         const std::string& interval,
+                                         std::int64_t fromTs,
+                                         std::int64_t toTs,
+                                         bool newestFirst) {
+    std::string query = "SELECT table_name, start_ts, end_ts, cold_path FROM " + std::string{kPartitionCatalogTable}
+                        + " WHERE interval = ?";
+    DuckdbValueVector parameters;
+    parameters.emplace_back(interval);
+    if (fromTs > 0) {
+        query += " AND end_ts > ?";
+        parameters.emplace_back(::duckdb::Value::BIGINT(fromTs));
+    }
+    if (toTs > 0) {
+        query += " AND start_ts <= ?";
+        parameters.emplace_back(::duckdb::Value::BIGINT(toTs));
+    }
+    query += newestFirst ? " ORDER BY start_ts DESC" : " ORDER BY start_ts ASC";
+
+    std::vector<PartitionRef> partitions;
+    auto statement = connection.Prepare(query);
+    if (!statement || statement->HasError()) {
+        const std::string errorMessage =
+            statement ? statement->GetError() : std::string{"failed to prepare partition lookup"};
+        if (errorMessage.find(kPartitionCatalogTable) == std::string::npos) {
+            LOG_WARN(kLogCategory, "DuckCandleRepo partition lookup failed: %s", errorMessage.c_str());
+        }
+        return partitions;
+    }
+
+    auto result = statement->Execute(parameters);
+    if (!result || result->HasError()) {
+        const std::string errorMessage =
+            result ? result->GetError() : std::string{"failed to execute partition lookup"};
+        LOG_WARN(kLogCategory, "DuckCandleRepo partition lookup failed: %s", errorMessage.c_str());
+        return partitions;
+    }
+
+    while (auto chunk = result->Fetch()) {
+        const auto count = chunk->size();
+        for (::duckdb::idx_t row = 0; row < count; ++row) {
+            const auto nameValue = chunk->GetValue(0, row);
+            if (nameValue.IsNull()) {
+                continue;
+            }
+            const auto coldValue = chunk->GetValue(3, row);
+            partitions.push_back(PartitionRef{nameValue.GetValue<std::string>(),
+                                              chunk->GetValue(1, row).GetValue<std::int64_t>(),
+                                              chunk->GetValue(2, row).GetValue<std::int64_t>(),
+                                              coldValue.IsNull() ? std::string{}
+                                                                 : coldValue.GetValue<std::string>()});
+        }
+    }
+    return partitions;
+}
+
+// MIN/MAX(ts) of a series across its partitions, from the bounds the writers
+// keep in the catalog. Databases not migrated since the bounds table was
+// added have none.
+std::optional<std::pair<std::int64_t, std::int64_t>> partitionedBounds(::duckdb::Connection& connection,
+                                                                       const std::string& symbol,
+                                                                       const std::string& interval) {
+    auto statement = connection.Prepare("SELECT min_ts, max_ts FROM " + std::string{kSeriesBoundsTable}
+                                        + " WHERE symbol = ? AND interval = ?");
+    if (!statement || statement->HasError()) {
+        const std::string errorMessage =
+            statement ? statement->GetError() : std::string{"failed to prepare bound query"};
+        if (errorMessage.find(kSeriesBoundsTable) != std::string::npos) {
+            return std::nullopt;
+        }
+        throw std::runtime_error("DuckCandleRepo partition bound failed: " + errorMessage);
+    }
+
+    DuckdbValueVector parameters;
+    parameters.emplace_back(symbol);
+    parameters.emplace_back(interval);
+    auto result = statement->Execute(parameters);
+    if (!result || result->HasError()) {
+        const std::string errorMessage = result ? result->GetError() : std::string{"failed to execute bound query"};
+        throw std::runtime_error("DuckCandleRepo partition bound failed: " + errorMessage);
+    }
+
+    if (auto chunk = result->Fetch()) {
+        if (chunk->size() > 0) {
+            const auto minValue = chunk->GetValue(0, 0);
+            const auto maxValue = chunk->GetValue(1, 0);
+            if (!minValue.IsNull() && !maxValue.IsNull()) {
+                return std::make_pair(normalize_timestamp_ms(minValue.GetValue<std::int64_t>()),
+                                      normalize_timestamp_ms(maxValue.GetValue<std::int64_t>()));
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::int64_t> combineBound(std::optional<std::int64_t> lhs,
+                                         std::optional<std::int64_t> rhs,
+                                         bool wantMax) {
+    if (!lhs) {
+        return rhs;
+    }
+    if (!rhs) {
+        return lhs;
+    }
+    return wantMax ? std::max(*lhs, *rhs) : std::min(*lhs, *rhs);
+}
 #endif
 
 }  // namespace
 
-DuckCandleRepo::DuckCandleRepo(std::string dbPath) : dbPath_(std::move(dbPath)) {}
+DuckCandleRepo::DuckCandleRepo(std::string dbPath, PartitionGranularity granularity)
+    : dbPath_(std::move(dbPath)), granularity_(granularity) {}
 
 std::vector<domain::contracts::Candle> DuckCandleRepo::getCandles(const domain::contracts::Symbol& symbol,
                                                                   domain::contracts::Interval interval,
@@ -135,49 +257,94 @@ std::vector<domain::contracts::Candle> DuckCandleRepo::getCandles(const domain::
         ::duckdb::DuckDB database(dbPath.string());  // reach global ::duckdb, not adapters::duckdb
         ::duckdb::Connection connection(database);
 
-        std::string query =
-            "SELECT ts, o, h, l, c, v FROM candles WHERE symbol = ? AND interval = ?";
-        DuckdbValueVector parameters;
-        parameters.reserve(5);
-        parameters.emplace_back(symbol);
-        parameters.emplace_back(label);
-
         const bool hasFrom = fromTs > 0;
         const bool hasTo = toTs > 0;
         const bool hasRange = hasFrom || hasTo;
 
-        if (fromTs > 0) {
-            query += " AND ts >= ?";
-            parameters.emplace_back(::duckdb::Value::BIGINT(fromTs));
-        }
-        if (toTs > 0) {
-            query += " AND ts <= ?";
-            parameters.emplace_back(::duckdb::Value::BIGINT(toTs));
-        }
+        // Range reads walk partitions oldest-first; "latest N" reads walk them
+        // newest-first so the limit is usually satisfied by one partition and
+        // Parquet files in the cold tier are only opened when the range reaches them.
+        const auto queryTable = [&](const std::string& source, bool unified, std::size_t tableLimit) {
+            std::string query = "SELECT ts, o, h, l, c, v FROM " + source + " WHERE symbol = ?";
+            DuckdbValueVector parameters;
+            parameters.reserve(5);
+            parameters.emplace_back(symbol);
+            if (unified) {
+                query += " AND interval = ?";
+                parameters.emplace_back(label);
+            }
 
-        if (hasRange) {
-            query += " ORDER BY ts ASC";
-        }
-        else {
-            query += " ORDER BY ts DESC";
-        }
-        if (limit > 0) {
-            query += " LIMIT ?";
-            const auto limitValue =
-                static_cast<std::int64_t>(std::min<std::size_t>(limit,
-                                                                static_cast<std::size_t>(
-                                                                    std::numeric_limits<std::int64_t>::max())));
-            parameters.emplace_back(::duckdb::Value::BIGINT(limitValue));
+            if (hasFrom) {
+                query += " AND ts >= ?";
+                parameters.emplace_back(::duckdb::Value::BIGINT(fromTs));
+            }
+            if (hasTo) {
+                query += " AND ts <= ?";
+                parameters.emplace_back(::duckdb::Value::BIGINT(toTs));
+            }
+
+            if (hasRange) {
+                query += " ORDER BY ts ASC";
+            }
+            else {
+                query += " ORDER BY ts DESC";
+            }
+            if (tableLimit > 0) {
+                query += " LIMIT ?";
+                const auto limitValue =
+                    static_cast<std::int64_t>(std::min<std::size_t>(tableLimit,
+                                                                    static_cast<std::size_t>(
+                                                                        std::numeric_limits<std::int64_t>::max())));
+                parameters.emplace_back(::duckdb::Value::BIGINT(limitValue));
+            }
+
+            auto statement = connection.Prepare(query);
+            if (!statement || statement->HasError()) {
+                const std::string errorMessage =
+                    statement ? statement->GetError() : std::string{"failed to prepare statement"};
+                throw std::runtime_error("DuckCandleRepo prepare failed: " + errorMessage);
+            }
+
+            return fetchCandles(*statement, parameters, tableLimit);
+        };
+
+        std::vector<domain::contracts::Candle> candles;
+        const auto partitions = listPartitions(connection, label, fromTs, toTs, !hasRange);
+        for (const auto& partition : partitions) {
+            if (limit > 0 && candles.size() >= limit) {
+                break;
+            }
+            auto rows = queryTable(partition.source(), false, limit > 0 ? limit - candles.size() : 0);
+            if (candles.empty()) {
+                candles = std::move(rows);
+            }
+            else {
+                candles.insert(candles.end(), rows.begin(), rows.end());
+            }
         }
 
-        auto statement = connection.Prepare(query);
-        if (!statement || statement->HasError()) {
-            const std::string errorMessage =
-                statement ? statement->GetError() : std::string{"failed to prepare statement"};
-            throw std::runtime_error("DuckCandleRepo prepare failed: " + errorMessage);
+        // Rows written with partitioning disabled, or not yet drained into
+        // partitions, still live in the unified table.
+        if (unifiedHasRows_(connection, label)) {
+            auto unifiedRows = queryTable("\"candles\"", true, limit);
+            if (candles.empty()) {
+                candles = std::move(unifiedRows);
+            }
+            else if (!unifiedRows.empty()) {
+                candles.insert(candles.end(), unifiedRows.begin(), unifiedRows.end());
+                const auto byTs = [hasRange](const auto& lhs, const auto& rhs) {
+                    return hasRange ? lhs.ts < rhs.ts : lhs.ts > rhs.ts;
+                };
+                std::stable_sort(candles.begin(), candles.end(), byTs);
+                candles.erase(std::unique(candles.begin(), candles.end(),
+                                          [](const auto& lhs, const auto& rhs) { return lhs.ts == rhs.ts; }),
+                              candles.end());
+                if (limit > 0 && candles.size() > limit) {
+                    candles.resize(limit);
+                }
+            }
         }
 
-        auto candles = fetchCandles(*statement, parameters, limit);
         if (!hasRange && limit > 0) {
             std::reverse(candles.begin(), candles.end());
         }
@@ -230,12 +397,41 @@ std::vector<domain::contracts::SymbolInfo> DuckCandleRepo::listSymbols() const {
                 }
             };
 
-        const auto fetchDistinctFrom = [&](const std::string& tableName) {
-            std::string query = "SELECT DISTINCT symbol FROM \"" + tableName + "\"";
-            auto result = connection.Query(query);
+        // Every write records its series in the bounds table (unified and
+        // partitioned alike, tiered partitions included), so symbols are read
+        // from there instead of scanning every partition and Parquet file.
+        {
+            auto result = connection.Query("SELECT DISTINCT symbol FROM " + std::string{kSeriesBoundsTable});
             if (!result || result->HasError()) {
                 const std::string errorMessage =
-                    result ? result->GetError() : std::string{"failed to execute distinct symbol query"};
+                    result ? result->GetError() : std::string{"failed to query series bounds"};
+                if (errorMessage.find(kSeriesBoundsTable) == std::string::npos) {
+                    throw std::runtime_error("DuckCandleRepo listSymbols failed: " + errorMessage);
+                }
+            }
+            else {
+                while (auto chunk = result->Fetch()) {
+                    const auto count = chunk->size();
+                    for (::duckdb::idx_t row = 0; row < count; ++row) {
+                        const auto value = chunk->GetValue(0, row);
+                        if (!value.IsNull()) {
+                            mergeSymbol(value.GetValue<std::string>(), std::nullopt, std::nullopt);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Legacy candles_<interval> tables predate the partition catalog and
+        // the bounds table; they are still scanned.
+        std::vector<std::string> legacyTables;
+        {
+            auto result = connection.Query("SELECT table_name FROM duckdb_tables WHERE table_schema = 'main' "
+                                           "AND table_name LIKE 'candles_%' AND table_name NOT IN "
+                                           "(SELECT table_name FROM " + std::string{kPartitionCatalogTable} + ")");
+            if (!result || result->HasError()) {
+                const std::string errorMessage =
+                    result ? result->GetError() : std::string{"failed to inspect candle tables"};
                 throw std::runtime_error("DuckCandleRepo listSymbols failed: " + errorMessage);
             }
 
@@ -243,24 +439,18 @@ std::vector<domain::contracts::SymbolInfo> DuckCandleRepo::listSymbols() const {
                 const auto count = chunk->size();
                 for (::duckdb::idx_t row = 0; row < count; ++row) {
                     const auto value = chunk->GetValue(0, row);
-                    if (value.IsNull()) {
-                        continue;
+                    if (!value.IsNull()) {
+                        legacyTables.push_back(value.GetValue<std::string>());
                     }
-                    mergeSymbol(value.GetValue<std::string>(), std::nullopt, std::nullopt);
                 }
             }
-        };
-
-        bool hasUnifiedTable = false;
-        std::vector<std::string> partitionTables;
+        }
 
-        {
-            auto result = connection.Query(
-                "SELECT table_name FROM duckdb_tables WHERE table_schema = 'main' "
-                "AND (table_name = 'candles' OR table_name LIKE 'candles_%')");
+        for (const auto& table : legacyTables) {
+            auto result = connection.Query("SELECT DISTINCT symbol FROM \"" + table + "\"");
             if (!result || result->HasError()) {
                 const std::string errorMessage =
-                    result ? result->GetError() : std::string{"failed to inspect candle tables"};
+                    result ? result->GetError() : std::string{"failed to execute distinct symbol query"};
                 throw std::runtime_error("DuckCandleRepo listSymbols failed: " + errorMessage);
             }
 
@@ -268,29 +458,13 @@ std::vector<domain::contracts::SymbolInfo> DuckCandleRepo::listSymbols() const {
                 const auto count = chunk->size();
                 for (::duckdb::idx_t row = 0; row < count; ++row) {
                     const auto value = chunk->GetValue(0, row);
-                    if (value.IsNull()) {
-                        continue;
-                    }
-
-                    auto tableName = value.GetValue<std::string>();
-                    if (tableName == "candles") {
-                        hasUnifiedTable = true;
-                    }
-                    else if (tableName.rfind("candles_", 0) == 0) {
-                        partitionTables.push_back(std::move(tableName));
+                    if (!value.IsNull()) {
+                        mergeSymbol(value.GetValue<std::string>(), std::nullopt, std::nullopt);
                     }
                 }
             }
         }
 
-        for (const auto& table : partitionTables) {
-            fetchDistinctFrom(table);
-        }
-
-        if (hasUnifiedTable) {
-            fetchDistinctFrom("candles");
-        }
-
         bool hasCatalogSymbols = false;
         {
             auto result = connection.Query(
@@ -499,12 +673,51 @@ DuckCandleRepo::listSymbolIntervals(const domain::contracts::Symbol& symbol) con
             auto [it, inserted] = merged.emplace(intervalLabel, domain::contracts::IntervalRangeInfo{});
             if (inserted) {
                 it->second.interval = intervalLabel;
+                it->second.fromTs = *from;
+                it->second.toTs = *to;
+                return;
             }
-            it->second.fromTs = *from;
-            it->second.toTs = *to;
+            it->second.fromTs = combineBound(it->second.fromTs, from, false);
+            it->second.toTs = combineBound(it->second.toTs, to, true);
         };
 
+        // Time partitions are registered in the catalog and aggregated per
+        // interval; any other candles_<interval> table is a legacy layout.
+        std::unordered_set<std::string> catalogTables;
+        std::vector<std::string> catalogIntervals;
+        {
+            auto result = connection.Query("SELECT table_name, interval FROM "
+                                           + std::string{kPartitionCatalogTable});
+            if (result && !result->HasError()) {
+                while (auto chunk = result->Fetch()) {
+                    const auto count = chunk->size();
+                    for (::duckdb::idx_t row = 0; row < count; ++row) {
+                        const auto tableValue = chunk->GetValue(0, row);
+                        const auto intervalValue = chunk->GetValue(1, row);
+                        if (tableValue.IsNull() || intervalValue.IsNull()) {
+                            continue;
+                        }
+                        catalogTables.insert(tableValue.GetValue<std::string>());
+                        auto intervalLabel = intervalValue.GetValue<std::string>();
+                        if (std::find(catalogIntervals.begin(), catalogIntervals.end(), intervalLabel)
+                            == catalogIntervals.end()) {
+                            catalogIntervals.push_back(std::move(intervalLabel));
+                        }
+                    }
+                }
+            }
+        }
+
+        for (const auto& intervalLabel : catalogIntervals) {
+            if (const auto bounds = partitionedBounds(connection, symbol, intervalLabel)) {
+                emplaceRange(intervalLabel, bounds->first, bounds->second);
+            }
+        }
+
         for (const auto& tableName : partitionTables) {
+            if (catalogTables.count(tableName) != 0) {
+                continue;
+            }
             const auto suffix = tableName.substr(kCandlesPartitionPrefix.size());
             if (suffix.empty()) {
                 continue;
@@ -675,46 +888,120 @@ DuckCandleRepo::get_min_max_ts(const std::string& symbol, const std::string& int
         ::duckdb::DuckDB database(dbPath.string());
         ::duckdb::Connection connection(database);
 
-        auto statement = connection.Prepare(
-            "SELECT MIN(ts) AS min_ts, MAX(ts) AS max_ts FROM candles WHERE symbol = ? AND interval = ?");
+        std::optional<std::int64_t> minTs;
+        std::optional<std::int64_t> maxTs;
+        if (unifiedHasRows_(connection, interval)) {
+            auto statement = connection.Prepare(
+                "SELECT MIN(ts) AS min_ts, MAX(ts) AS max_ts FROM candles WHERE symbol = ? AND interval = ?");
+            if (!statement || statement->HasError()) {
+                const std::string errorMessage =
+                    statement ? statement->GetError() : std::string{"failed to prepare min/max statement"};
+                LOG_WARN(kLogCategory,
+                         "DuckCandleRepo get_min_max_ts prepare failed error=%s",
+                         errorMessage.c_str());
+                return std::nullopt;
+            }
+
+            DuckdbValueVector parameters;
+            parameters.reserve(2);
+            parameters.emplace_back(symbol);
+            parameters.emplace_back(interval);
+
+            auto result = statement->Execute(parameters);
+            if (!result || result->HasError()) {
+                const std::string errorMessage =
+                    result ? result->GetError() : std::string{"failed to execute min/max statement"};
+                LOG_WARN(kLogCategory,
+                         "DuckCandleRepo get_min_max_ts execute failed error=%s",
+                         errorMessage.c_str());
+                return std::nullopt;
+            }
+
+            if (auto chunk = result->Fetch()) {
+                if (chunk->size() > 0) {
+                    const auto minValue = chunk->GetValue(0, 0);
+                    const auto maxValue = chunk->GetValue(1, 0);
+                    if (!minValue.IsNull() && !maxValue.IsNull()) {
+                        minTs = normalize_timestamp_ms(minValue.GetValue<std::int64_t>());
+                        maxTs = normalize_timestamp_ms(maxValue.GetValue<std::int64_t>());
+                    }
+                }
+            }
+        }
+
+        if (const auto bounds = partitionedBounds(connection, symbol, interval)) {
+            minTs = combineBound(minTs, bounds->first, false);
+            maxTs = combineBound(maxTs, bounds->second, true);
+        }
+        if (minTs && maxTs) {
+            return std::make_pair(*minTs, *maxTs);
+        }
+    }
+    catch (const std::exception& ex) {
+        LOG_WARN(kLogCategory,
+                 "DuckCandleRepo get_min_max_ts exception path=%s error=%s",
+                 dbPath_.c_str(),
+                 ex.what());
+    }
+
+    return std::nullopt;
+#endif
+}
+
+std::optional<std::uint64_t> DuckCandleRepo::storedVersion(const std::string& symbol,
+                                                          const std::string& interval) const {
+#if !defined(HAS_DUCKDB)
+    (void)symbol;
+    (void)interval;
+    return std::nullopt;
+#else
+    fs::path dbPath{dbPath_};
+    std::error_code ec;
+    if (!fs::exists(dbPath, ec) || fs::is_directory(dbPath, ec)) {
+        return std::nullopt;
+    }
+
+    try {
+        ::duckdb::DuckDB database(dbPath.string());
+        ::duckdb::Connection connection(database);
+
+        // Symbols are matched case-insensitively, like common::SeriesVersions.
+        auto statement = connection.Prepare("SELECT CAST(SUM(version) AS BIGINT) FROM "
+                                            + std::string{kSeriesBoundsTable}
+                                            + " WHERE (? = '' OR upper(symbol) = upper(?)) "
+                                              "AND (? = '' OR interval = ?)");
         if (!statement || statement->HasError()) {
             const std::string errorMessage =
-                statement ? statement->GetError() : std::string{"failed to prepare min/max statement"};
-            LOG_WARN(kLogCategory,
-                     "DuckCandleRepo get_min_max_ts prepare failed error=%s",
-                     errorMessage.c_str());
+                statement ? statement->GetError() : std::string{"failed to prepare version query"};
+            LOG_WARN(kLogCategory, "DuckCandleRepo storedVersion prepare failed error=%s", errorMessage.c_str());
             return std::nullopt;
         }
 
         DuckdbValueVector parameters;
-        parameters.reserve(2);
+        parameters.reserve(4);
+        parameters.emplace_back(symbol);
         parameters.emplace_back(symbol);
         parameters.emplace_back(interval);
-
+        parameters.emplace_back(interval);
         auto result = statement->Execute(parameters);
         if (!result || result->HasError()) {
             const std::string errorMessage =
-                result ? result->GetError() : std::string{"failed to execute min/max statement"};
-            LOG_WARN(kLogCategory,
-                     "DuckCandleRepo get_min_max_ts execute failed error=%s",
-                     errorMessage.c_str());
+                result ? result->GetError() : std::string{"failed to execute version query"};
+            LOG_WARN(kLogCategory, "DuckCandleRepo storedVersion execute failed error=%s", errorMessage.c_str());
             return std::nullopt;
         }
 
+        std::uint64_t version = 0;
         if (auto chunk = result->Fetch()) {
-            if (chunk->size() > 0) {
-                const auto minValue = chunk->GetValue(0, 0);
-                const auto maxValue = chunk->GetValue(1, 0);
-                if (!minValue.IsNull() && !maxValue.IsNull()) {
-                    return std::make_pair(normalize_timestamp_ms(minValue.GetValue<std::int64_t>()),
-                                          normalize_timestamp_ms(maxValue.GetValue<std::int64_t>()));
-                }
+            if (chunk->size() > 0 && !chunk->GetValue(0, 0).IsNull()) {
+                version = static_cast<std::uint64_t>(chunk->GetValue(0, 0).GetValue<std::int64_t>());
             }
         }
+        return version;
     }
     catch (const std::exception& ex) {
         LOG_WARN(kLogCategory,
-                 "DuckCandleRepo get_min_max_ts exception path=%s error=%s",
+                 "DuckCandleRepo storedVersion exception path=%s error=%s",
                  dbPath_.c_str(),
                  ex.what());
     }
@@ -723,7 +1010,110 @@ DuckCandleRepo::get_min_max_ts(const std::string& symbol, const std::string& int
 #endif
 }
 
+bool DuckCandleRepo::storedUntouched(const std::string& symbol,
+                                     const std::string& interval,
+                                     std::uint64_t since,
+                                     std::uint64_t until,
+                                     std::int64_t fromTs,
+                                     std::int64_t toTs) const {
+#if !defined(HAS_DUCKDB)
+    (void)symbol;
+    (void)interval;
+    (void)since;
+    (void)until;
+    (void)fromTs;
+    (void)toTs;
+    return false;
+#else
+    if (until <= since) {
+        return until == since;
+    }
+    fs::path dbPath{dbPath_};
+    std::error_code ec;
+    if (!fs::exists(dbPath, ec) || fs::is_directory(dbPath, ec)) {
+        return false;
+    }
+
+    try {
+        ::duckdb::DuckDB database(dbPath.string());
+        ::duckdb::Connection connection(database);
+
+        // Every version in (since, until] must be logged: migrations move the
+        // counter without logging what they touched.
+        auto statement = connection.Prepare("SELECT COUNT(*), COUNT(*) FILTER (WHERE first_ts <= ? AND last_ts >= ?) "
+                                            "FROM " + std::string{kSeriesWritesTable}
+                                            + " WHERE upper(symbol) = upper(?) AND interval = ? "
+                                              "AND version > ? AND version <= ?");
+        if (!statement || statement->HasError()) {
+            const std::string errorMessage =
+                statement ? statement->GetError() : std::string{"failed to prepare write log query"};
+            LOG_WARN(kLogCategory, "DuckCandleRepo storedUntouched prepare failed error=%s", errorMessage.c_str());
+            return false;
+        }
+
+        DuckdbValueVector parameters;
+        parameters.reserve(6);
+        parameters.emplace_back(::duckdb::Value::BIGINT(toTs));
+        parameters.emplace_back(::duckdb::Value::BIGINT(fromTs));
+        parameters.emplace_back(symbol);
+        parameters.emplace_back(interval);
+        parameters.emplace_back(::duckdb::Value::BIGINT(static_cast<std::int64_t>(since)));
+        parameters.emplace_back(::duckdb::Value::BIGINT(static_cast<std::int64_t>(until)));
+        auto result = statement->Execute(parameters);
+        if (!result || result->HasError()) {
+            const std::string errorMessage =
+                result ? result->GetError() : std::string{"failed to execute write log query"};
+            LOG_WARN(kLogCategory, "DuckCandleRepo storedUntouched execute failed error=%s", errorMessage.c_str());
+            return false;
+        }
+
+        if (auto chunk = result->Fetch()) {
+            if (chunk->size() > 0 && !chunk->GetValue(0, 0).IsNull() && !chunk->GetValue(1, 0).IsNull()) {
+                const auto logged = static_cast<std::uint64_t>(chunk->GetValue(0, 0).GetValue<std::int64_t>());
+                const auto overlapping = chunk->GetValue(1, 0).GetValue<std::int64_t>();
+                return logged == until - since && overlapping == 0;
+            }
+        }
+    }
+    catch (const std::exception& ex) {
+        LOG_WARN(kLogCategory,
+                 "DuckCandleRepo storedUntouched exception path=%s error=%s",
+                 dbPath_.c_str(),
+                 ex.what());
+    }
+
+    return false;
+#endif
+}
+
 #if defined(HAS_DUCKDB)
+bool DuckCandleRepo::unifiedHasRows_(::duckdb::Connection& connection, const std::string& interval) const {
+    if (granularity_ == PartitionGranularity::None) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(unifiedMutex_);
+    if (const auto it = unifiedIntervals_.find(interval); it != unifiedIntervals_.end()) {
+        return it->second;
+    }
+
+    // On error, keep reading the table rather than remember a guess.
+    auto statement = connection.Prepare("SELECT 1 FROM candles WHERE interval = ? LIMIT 1");
+    if (!statement || statement->HasError()) {
+        return true;
+    }
+    DuckdbValueVector parameters;
+    parameters.emplace_back(interval);
+    auto result = statement->Execute(parameters);
+    if (!result || result->HasError()) {
+        return true;
+    }
+    auto chunk = result->Fetch();
+    const bool hasRows = chunk && chunk->size() > 0;
+    unifiedIntervals_.emplace(interval, hasRows);
+    return hasRows;
+}
+
 namespace {
 void logRollbackFailure(const std::exception& ex) {
     LOG_WARN(kLogCategory, "DuckCandleRepo rollback failed: %s", ex.what());
@@ -778,72 +1168,223 @@ bool DuckCandleRepo::upsert_batch(const std::string& symbol,
             inTransaction = false;
         };
 
+        const auto [first, last] = std::minmax_element(rows.begin(), rows.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.openTime < rhs.openTime;
+        });
+        const auto firstOpen = static_cast<std::int64_t>(first->openTime);
+        const auto lastOpen = static_cast<std::int64_t>(last->openTime);
+
+        // Route each row to its (interval, period) partition so the conflict
+        // check only probes that partition's (symbol, ts) index.
+        struct PartitionRows {
+            std::string table;
+            std::vector<std::size_t> indices;
+        };
+        std::map<std::int64_t, PartitionRows> rowsByPartition;
+        if (granularity_ != PartitionGranularity::None) {
+            for (std::size_t index = 0; index < rows.size(); ++index) {
+                const auto bounds = partitionBoundsFor(static_cast<std::int64_t>(rows[index].openTime), granularity_);
+                auto& partition = rowsByPartition[bounds.startMs];
+                if (partition.table.empty()) {
+                    partition.table = partitionTableName(interval, bounds, granularity_);
+                }
+                partition.indices.push_back(index);
+            }
+        }
+        const auto forgetPartitions = [&]() {
+            std::lock_guard<std::mutex> lock(partitionsMutex_);
+            for (const auto& entry : rowsByPartition) {
+                writablePartitions_.erase(entry.second.table);
+            }
+        };
+
         try {
+            // Creating, thawing or rehydrating a partition rewrites it; do that
+            // once per partition in its own transaction, not under every upsert.
+            for (const auto& [startMs, partition] : rowsByPartition) {
+                {
+                    std::lock_guard<std::mutex> lock(partitionsMutex_);
+                    if (writablePartitions_.count(partition.table) != 0) {
+                        continue;
+                    }
+                }
+                connection.BeginTransaction();
+                inTransaction = true;
+                ensurePartition(connection,
+                                partition.table,
+                                interval,
+                                partitionBoundsFor(startMs, granularity_),
+                                granularity_);
+                connection.Commit();
+                inTransaction = false;
+                std::lock_guard<std::mutex> lock(partitionsMutex_);
+                writablePartitions_.insert(partition.table);
+            }
+
             connection.BeginTransaction();
             inTransaction = true;
 
-            auto statement = connection.Prepare("INSERT OR REPLACE INTO candles "
-                                                "(symbol, interval, ts, o, h, l, c, v) "
-                                                "VALUES (?, ?, ?, ?, ?, ?, ?, ?)");
-            if (!statement || statement->HasError()) {
-                const std::string errorMessage =
-                    statement ? statement->GetError() : std::string{"failed to prepare statement"};
-                LOG_WARN(kLogCategory,
-                         "DuckCandleRepo failed to prepare upsert statement error=%s",
-                         errorMessage.c_str());
-                rollback();
-                return false;
-            }
-
             bool affected = false;
             DuckdbValueVector parameters;
             parameters.reserve(8);
 
-            const std::size_t total = rows.size();
-            for (std::size_t offset = 0; offset < total; offset += kBatchChunkSize) {
-                const std::size_t end = std::min(offset + kBatchChunkSize, total);
-                for (std::size_t index = offset; index < end; ++index) {
-                    const auto& candle = rows[index];
-                    parameters.clear();
-                    parameters.emplace_back(symbol);
-                    parameters.emplace_back(interval);
-                    parameters.emplace_back(
-                        ::duckdb::Value::BIGINT(static_cast<std::int64_t>(candle.openTime)));
-                    parameters.emplace_back(::duckdb::Value::DOUBLE(candle.open));
-                    parameters.emplace_back(::duckdb::Value::DOUBLE(candle.high));
-                    parameters.emplace_back(::duckdb::Value::DOUBLE(candle.low));
-                    parameters.emplace_back(::duckdb::Value::DOUBLE(candle.close));
-                    parameters.emplace_back(::duckdb::Value::DOUBLE(candle.baseVolume));
-
-                    auto result = statement->Execute(parameters);
-                    if (!result || result->HasError()) {
+            const auto executeRow = [&](DuckdbPreparedStatement& statement) {
+                auto result = statement.Execute(parameters);
+                if (!result || result->HasError()) {
+                    const std::string errorMessage =
+                        result ? result->GetError() : std::string{"failed to execute statement"};
+                    LOG_WARN(kLogCategory,
+                             "DuckCandleRepo upsert execution failed error=%s",
+                             errorMessage.c_str());
+                    return false;
+                }
+
+                if (result->type == ::duckdb::QueryResultType::MATERIALIZED_RESULT) {
+                    auto& materialized = result->Cast<::duckdb::MaterializedQueryResult>();
+                    if (materialized.properties.return_type == ::duckdb::StatementReturnType::CHANGED_ROWS) {
+                        if (materialized.RowCount() > 0 &&
+                            materialized.GetValue<std::int64_t>(0, 0) > 0) {
+                            affected = true;
+                        }
+                    } else if (materialized.RowCount() > 0) {
+                        affected = true;
+                    }
+                } else {
+                    affected = true;
+                }
+                return true;
+            };
+
+            const auto bindCandle = [&](const domain::Candle& candle) {
+                parameters.emplace_back(
+                    ::duckdb::Value::BIGINT(static_cast<std::int64_t>(candle.openTime)));
+                parameters.emplace_back(::duckdb::Value::DOUBLE(candle.open));
+                parameters.emplace_back(::duckdb::Value::DOUBLE(candle.high));
+                parameters.emplace_back(::duckdb::Value::DOUBLE(candle.low));
+                parameters.emplace_back(::duckdb::Value::DOUBLE(candle.close));
+                parameters.emplace_back(::duckdb::Value::DOUBLE(candle.baseVolume));
+            };
+
+            if (granularity_ == PartitionGranularity::None) {
+                auto statement = connection.Prepare("INSERT OR REPLACE INTO candles "
+                                                    "(symbol, interval, ts, o, h, l, c, v) "
+                                                    "VALUES (?, ?, ?, ?, ?, ?, ?, ?)");
+                if (!statement || statement->HasError()) {
+                    const std::string errorMessage =
+                        statement ? statement->GetError() : std::string{"failed to prepare statement"};
+                    LOG_WARN(kLogCategory,
+                             "DuckCandleRepo failed to prepare upsert statement error=%s",
+                             errorMessage.c_str());
+                    rollback();
+                    return false;
+                }
+
+                const std::size_t total = rows.size();
+                for (std::size_t offset = 0; offset < total; offset += kBatchChunkSize) {
+                    const std::size_t end = std::min(offset + kBatchChunkSize, total);
+                    for (std::size_t index = offset; index < end; ++index) {
+                        parameters.clear();
+                        parameters.emplace_back(symbol);
+                        parameters.emplace_back(interval);
+                        bindCandle(rows[index]);
+                        if (!executeRow(*statement)) {
+                            rollback();
+                            return false;
+                        }
+                    }
+                }
+            }
+            else {
+                for (const auto& [startMs, partition] : rowsByPartition) {
+                    auto statement = connection.Prepare("INSERT OR REPLACE INTO \"" + partition.table
+                                                        + "\" (symbol, ts, o, h, l, c, v) "
+                                                          "VALUES (?, ?, ?, ?, ?, ?, ?)");
+                    if (!statement || statement->HasError()) {
                         const std::string errorMessage =
-                            result ? result->GetError() : std::string{"failed to execute statement"};
+                            statement ? statement->GetError() : std::string{"failed to prepare statement"};
                         LOG_WARN(kLogCategory,
-                                 "DuckCandleRepo upsert execution failed error=%s",
+                                 "DuckCandleRepo failed to prepare upsert statement table=%s error=%s",
+                                 partition.table.c_str(),
                                  errorMessage.c_str());
+                        forgetPartitions();
                         rollback();
                         return false;
                     }
 
-                    if (result->type == ::duckdb::QueryResultType::MATERIALIZED_RESULT) {
-                        auto& materialized = result->Cast<::duckdb::MaterializedQueryResult>();
-                        if (materialized.properties.return_type == ::duckdb::StatementReturnType::CHANGED_ROWS) {
-                            if (materialized.RowCount() > 0 &&
-                                materialized.GetValue<std::int64_t>(0, 0) > 0) {
-                                affected = true;
-                            }
-                        } else if (materialized.RowCount() > 0) {
-                            affected = true;
+                    for (const auto index : partition.indices) {
+                        parameters.clear();
+                        parameters.emplace_back(symbol);
+                        bindCandle(rows[index]);
+                        if (!executeRow(*statement)) {
+                            forgetPartitions();
+                            rollback();
+                            return false;
                         }
-                    } else {
-                        affected = true;
                     }
                 }
             }
 
+            // Counted in the unified layout too: the bounds row carries the write
+            // counter other processes read, the write log what each write touched.
+            const auto executeBookkeeping = [&](const std::string& sql, const char* what) {
+                auto statement = connection.Prepare(sql);
+                if (!statement || statement->HasError()) {
+                    const std::string errorMessage =
+                        statement ? statement->GetError() : std::string{"failed to prepare statement"};
+                    LOG_WARN(kLogCategory,
+                             "DuckCandleRepo failed to prepare %s statement error=%s",
+                             what,
+                             errorMessage.c_str());
+                    return false;
+                }
+                auto result = statement->Execute(parameters);
+                if (!result || result->HasError()) {
+                    const std::string errorMessage =
+                        result ? result->GetError() : std::string{"failed to execute statement"};
+                    LOG_WARN(kLogCategory, "DuckCandleRepo %s update failed error=%s", what, errorMessage.c_str());
+                    return false;
+                }
+                return true;
+            };
+
+            const std::string bounds{kSeriesBoundsTable};
+            const std::string writes{kSeriesWritesTable};
+            parameters.clear();
+            parameters.emplace_back(symbol);
+            parameters.emplace_back(interval);
+            parameters.emplace_back(::duckdb::Value::BIGINT(firstOpen));
+            parameters.emplace_back(::duckdb::Value::BIGINT(lastOpen));
+            if (!executeBookkeeping(seriesBoundsMergeSql("VALUES (?, ?, ?, ?)"), "series bounds")) {
+                rollback();
+                return false;
+            }
+            parameters.clear();
+            parameters.emplace_back(::duckdb::Value::BIGINT(firstOpen));
+            parameters.emplace_back(::duckdb::Value::BIGINT(lastOpen));
+            parameters.emplace_back(symbol);
+            parameters.emplace_back(interval);
+            if (!executeBookkeeping("INSERT INTO " + writes + " SELECT symbol, interval, version, ?, ? FROM " + bounds
+                                        + " WHERE symbol = ? AND interval = ?",
+                                    "series write log")) {
+                rollback();
+                return false;
+            }
+            parameters.clear();
+            parameters.emplace_back(symbol);
+            parameters.emplace_back(interval);
+            parameters.emplace_back(symbol);
+            parameters.emplace_back(interval);
+            if (!executeBookkeeping("DELETE FROM " + writes + " WHERE symbol = ? AND interval = ? AND version <= "
+                                        "(SELECT version FROM " + bounds + " WHERE symbol = ? AND interval = ?) - "
+                                        + std::to_string(kSeriesWriteLogSize),
+                                    "series write log")) {
+                rollback();
+                return false;
+            }
+
             connection.Commit();
             inTransaction = false;
+            ttp::common::SeriesVersions::instance().bump(symbol, interval, firstOpen, lastOpen);
             return affected;
         }
         catch (...) {
@@ -862,6 +1403,11 @@ bool DuckCandleRepo::upsert_batch(const std::string& symbol,
 #endif
 }
 
+void DuckCandleRepo::forgetWritablePartitions() {
+    std::lock_guard<std::mutex> lock(partitionsMutex_);
+    writablePartitions_.clear();
+}
+
 std::optional<std::int64_t> DuckCandleRepo::max_timestamp(const std::string& symbol,
                                                           const std::string& interval) const {
 #if !defined(HAS_DUCKDB)
@@ -891,40 +1437,47 @@ std::optional<std::int64_t> DuckCandleRepo::max_timestamp(const std::string& sym
         ::duckdb::DuckDB database(dbPath.string());
         ::duckdb::Connection connection(database);
 
-        auto statement =
-            connection.Prepare("SELECT MAX(ts) FROM candles WHERE symbol = ? AND interval = ?");
-        if (!statement || statement->HasError()) {
-            const std::string errorMessage =
-                statement ? statement->GetError() : std::string{"failed to prepare statement"};
-            LOG_WARN(kLogCategory,
-                     "DuckCandleRepo failed to prepare max_timestamp statement error=%s",
-                     errorMessage.c_str());
-            return std::nullopt;
-        }
+        std::optional<std::int64_t> maxTs;
+        if (unifiedHasRows_(connection, interval)) {
+            auto statement =
+                connection.Prepare("SELECT MAX(ts) FROM candles WHERE symbol = ? AND interval = ?");
+            if (!statement || statement->HasError()) {
+                const std::string errorMessage =
+                    statement ? statement->GetError() : std::string{"failed to prepare statement"};
+                LOG_WARN(kLogCategory,
+                         "DuckCandleRepo failed to prepare max_timestamp statement error=%s",
+                         errorMessage.c_str());
+                return std::nullopt;
+            }
 
-        DuckdbValueVector parameters;
-        parameters.reserve(2);
-        parameters.emplace_back(symbol);
-        parameters.emplace_back(interval);
+            DuckdbValueVector parameters;
+            parameters.reserve(2);
+            parameters.emplace_back(symbol);
+            parameters.emplace_back(interval);
 
-        auto result = statement->Execute(parameters);
-        if (!result || result->HasError()) {
-            const std::string errorMessage =
-                result ? result->GetError() : std::string{"failed to execute statement"};
-            LOG_WARN(kLogCategory,
-                     "DuckCandleRepo max_timestamp execution failed error=%s",
-                     errorMessage.c_str());
-            return std::nullopt;
-        }
+            auto result = statement->Execute(parameters);
+            if (!result || result->HasError()) {
+                const std::string errorMessage =
+                    result ? result->GetError() : std::string{"failed to execute statement"};
+                LOG_WARN(kLogCategory,
+                         "DuckCandleRepo max_timestamp execution failed error=%s",
+                         errorMessage.c_str());
+                return std::nullopt;
+            }
 
-        if (auto chunk = result->Fetch()) {
-            if (chunk->size() > 0) {
-                const auto value = chunk->GetValue(0, 0);
-                if (!value.IsNull()) {
-                    return normalize_timestamp_ms(value.GetValue<std::int64_t>());
+            if (auto chunk = result->Fetch()) {
+                if (chunk->size() > 0) {
+                    const auto value = chunk->GetValue(0, 0);
+                    if (!value.IsNull()) {
+                        maxTs = normalize_timestamp_ms(value.GetValue<std::int64_t>());
+                    }
                 }
             }
         }
+        if (const auto bounds = partitionedBounds(connection, symbol, interval)) {
+            maxTs = combineBound(maxTs, bounds->second, true);
+        }
+        return maxTs;
     }
     catch (const std::exception& ex) {
         LOG_WARN(kLogCategory,
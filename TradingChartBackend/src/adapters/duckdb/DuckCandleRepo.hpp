@@ -1,9 +1,14 @@
 #pragma once
 
+#include <cstdint>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "adapters/duckdb/CandlePartitions.hpp"
 #include "domain/Ports.hpp"
 
 namespace domain {
@@ -12,9 +17,10 @@ struct Candle;
 
 namespace adapters::duckdb {
 
-class DuckCandleRepo : public domain::contracts::ICandleReadRepo {
+class DuckCandleRepo : public domain::contracts::ICandleReadRepo, public domain::contracts::ICandleWriteRepo {
 public:
-    explicit DuckCandleRepo(std::string dbPath = "data/market.duckdb");
+    explicit DuckCandleRepo(std::string dbPath = "data/market.duckdb",
+                            PartitionGranularity granularity = PartitionGranularity::Month);
 
     std::vector<domain::contracts::Candle> getCandles(const domain::contracts::Symbol& symbol,
                                                       domain::contracts::Interval interval,
@@ -32,15 +38,48 @@ public:
     std::optional<std::pair<std::int64_t, std::int64_t>>
     get_min_max_ts(const std::string& symbol, const std::string& interval) const override;
 
+    // Sum of the write counters in candle_series_bounds.
+    std::optional<std::uint64_t> storedVersion(const std::string& symbol, const std::string& interval) const override;
+
+    // Checked against candle_series_writes.
+    bool storedUntouched(const std::string& symbol,
+                         const std::string& interval,
+                         std::uint64_t since,
+                         std::uint64_t until,
+                         std::int64_t fromTs,
+                         std::int64_t toTs) const override;
+
     bool upsert_batch(const std::string& symbol,
                       const std::string& interval,
-                      const std::vector<domain::Candle>& rows);
+                      const std::vector<domain::Candle>& rows) override;
 
     std::optional<std::int64_t> max_timestamp(const std::string& symbol,
-                                              const std::string& interval) const;
+                                              const std::string& interval) const override;
+
+    // Call after DuckStore froze or tiered partitions under a live repo: the
+    // next upsert into one of them thaws or rehydrates it first.
+    void forgetWritablePartitions();
 
 private:
+#if defined(HAS_DUCKDB)
+    // Whether the unified `candles` table may hold rows of `interval`.
+    bool unifiedHasRows_(::duckdb::Connection& connection, const std::string& interval) const;
+#endif
+
     std::string dbPath_;
+    PartitionGranularity granularity_;
+
+    // Partitions made writable here. DuckStore's periodic freezing and
+    // tiering invalidate them (see forgetWritablePartitions); an upsert that
+    // fails forgets the partitions it touched, so one racing the job recovers
+    // on the next write.
+    std::mutex partitionsMutex_;
+    std::unordered_set<std::string> writablePartitions_;
+
+    // With partitioning on nothing writes to the unified table after the
+    // startup drain, so an interval found empty there stays empty.
+    mutable std::mutex unifiedMutex_;
+    mutable std::unordered_map<std::string, bool> unifiedIntervals_;
 };
 
 }  // namespace adapters::duckdb
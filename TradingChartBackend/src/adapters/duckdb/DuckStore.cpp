@@ -6,6 +6,7 @@
 #include <string>
 #include <system_error>
 #include <utility>
+#include <vector>
 
 #include "common/Log.hpp"
 
@@ -16,8 +17,144 @@
 namespace fs = std::filesystem;
 
 namespace adapters::duckdb {
+namespace {
 
-DuckStore::DuckStore(std::string dbPath) : dbPath_(std::move(dbPath)) {}
+#if defined(HAS_DUCKDB)
+using DuckdbValueVector = ::duckdb::vector<::duckdb::Value>;
+
+const char* dateTruncUnit(PartitionGranularity granularity) {
+    return granularity == PartitionGranularity::Year ? "year" : "month";
+}
+
+// Moves rows written before partitioning was enabled out of the unified
+// `candles` table, widening the series bounds as it goes. Each interval is
+// moved in its own transaction so a failure leaves the remaining rows
+// readable where they were.
+void drainUnifiedTable(::duckdb::Connection& connection, PartitionGranularity granularity) {
+    const std::string bucketQuery = std::string{"SELECT interval, epoch_ms(date_trunc('"}
+                                    + dateTruncUnit(granularity)
+                                    + "', epoch_ms(ts))) AS bucket, COUNT(*) FROM candles "
+                                      "GROUP BY interval, bucket ORDER BY interval, bucket";
+    auto bucketsResult = connection.Query(bucketQuery);
+    if (!bucketsResult || bucketsResult->HasError()) {
+        const std::string errorMessage = bucketsResult ? bucketsResult->GetError()
+                                                       : std::string{"failed to inspect unified candles"};
+        LOG_WARN("DuckStore: unable to inspect unified candles table: " << errorMessage);
+        return;
+    }
+
+    struct Bucket {
+        std::string interval;
+        std::int64_t startMs{0};
+        std::int64_t rows{0};
+    };
+    std::vector<Bucket> buckets;
+    while (auto chunk = bucketsResult->Fetch()) {
+        const auto count = chunk->size();
+        for (::duckdb::idx_t row = 0; row < count; ++row) {
+            const auto intervalValue = chunk->GetValue(0, row);
+            const auto bucketValue = chunk->GetValue(1, row);
+            if (intervalValue.IsNull() || bucketValue.IsNull()) {
+                continue;
+            }
+            buckets.push_back(Bucket{intervalValue.GetValue<std::string>(),
+                                     bucketValue.GetValue<std::int64_t>(),
+                                     chunk->GetValue(2, row).GetValue<std::int64_t>()});
+        }
+    }
+
+    std::size_t index = 0;
+    while (index < buckets.size()) {
+        const std::string interval = buckets[index].interval;
+        std::int64_t moved = 0;
+        try {
+            connection.BeginTransaction();
+            for (; index < buckets.size() && buckets[index].interval == interval; ++index) {
+                const auto bounds = partitionBoundsFor(buckets[index].startMs, granularity);
+                const auto tableName = partitionTableName(interval, bounds, granularity);
+                ensurePartition(connection, tableName, interval, bounds, granularity);
+
+                auto statement = connection.Prepare("INSERT OR REPLACE INTO \"" + tableName
+                                                    + "\" SELECT symbol, ts, o, h, l, c, v FROM candles "
+                                                      "WHERE interval = ? AND ts >= ? AND ts < ?");
+                if (!statement || statement->HasError()) {
+                    throw std::runtime_error(statement ? statement->GetError()
+                                                       : std::string{"failed to prepare partition copy"});
+                }
+                DuckdbValueVector parameters;
+                parameters.emplace_back(interval);
+                parameters.emplace_back(::duckdb::Value::BIGINT(bounds.startMs));
+                parameters.emplace_back(::duckdb::Value::BIGINT(bounds.endMs));
+                auto result = statement->Execute(parameters);
+                if (!result || result->HasError()) {
+                    throw std::runtime_error(result ? result->GetError()
+                                                    : std::string{"failed to copy partition rows"});
+                }
+                moved += buckets[index].rows;
+            }
+
+            auto boundsStatement = connection.Prepare(seriesBoundsMergeSql(
+                "SELECT symbol, interval, MIN(ts), MAX(ts) FROM candles WHERE interval = ? GROUP BY symbol, interval"));
+            if (!boundsStatement || boundsStatement->HasError()) {
+                throw std::runtime_error(boundsStatement ? boundsStatement->GetError()
+                                                         : std::string{"failed to prepare bounds update"});
+            }
+            DuckdbValueVector boundsParameters;
+            boundsParameters.emplace_back(interval);
+            auto boundsResult = boundsStatement->Execute(boundsParameters);
+            if (!boundsResult || boundsResult->HasError()) {
+                throw std::runtime_error(boundsResult ? boundsResult->GetError()
+                                                      : std::string{"failed to record series bounds"});
+            }
+
+            auto deleteStatement = connection.Prepare("DELETE FROM candles WHERE interval = ?");
+            if (!deleteStatement || deleteStatement->HasError()) {
+                throw std::runtime_error(deleteStatement ? deleteStatement->GetError()
+                                                         : std::string{"failed to prepare unified delete"});
+            }
+            DuckdbValueVector parameters;
+            parameters.emplace_back(interval);
+            auto deleteResult = deleteStatement->Execute(parameters);
+            if (!deleteResult || deleteResult->HasError()) {
+                throw std::runtime_error(deleteResult ? deleteResult->GetError()
+                                                      : std::string{"failed to delete unified rows"});
+            }
+
+            connection.Commit();
+            LOG_INFO("DuckStore moved " << moved << " candles interval=" << interval
+                                        << " into " << partitionGranularityToString(granularity)
+                                        << " partitions");
+        } catch (const std::exception& ex) {
+            LOG_WARN("DuckStore: partition migration failed interval=" << interval << ": " << ex.what());
+            try {
+                connection.Rollback();
+            } catch (const std::exception&) {
+            }
+            while (index < buckets.size() && buckets[index].interval == interval) {
+                ++index;
+            }
+        }
+    }
+}
+
+bool seriesBoundsEmpty(::duckdb::Connection& connection) {
+    auto result = connection.Query("SELECT COUNT(*) FROM " + std::string{kSeriesBoundsTable});
+    if (!result || result->HasError()) {
+        return false;
+    }
+    if (auto chunk = result->Fetch()) {
+        if (chunk->size() > 0 && !chunk->GetValue(0, 0).IsNull()) {
+            return chunk->GetValue(0, 0).GetValue<std::int64_t>() == 0;
+        }
+    }
+    return true;
+}
+#endif
+
+}  // namespace
+
+DuckStore::DuckStore(std::string dbPath, PartitionGranularity granularity)
+    : dbPath_(std::move(dbPath)), granularity_(granularity) {}
 
 void DuckStore::migrate() {
 #if !defined(HAS_DUCKDB)
@@ -62,16 +199,12 @@ void DuckStore::migrate() {
     static constexpr auto kLegacyCountQuery =
         "SELECT COUNT(*) FROM candles WHERE ts < 1000000000000";
     auto legacyCountResult = connection.Query(kLegacyCountQuery);
+    std::int64_t legacyCount = 0;
     if (!legacyCountResult || legacyCountResult->HasError()) {
         const std::string errorMessage = legacyCountResult ? legacyCountResult->GetError()
                                                           : std::string{"failed to query legacy timestamps"};
         LOG_WARN("DuckStore: unable to inspect legacy timestamps: " << errorMessage);
-        LOG_INFO("DuckStore migration finished for " << dbPath.string());
-        return;
-    }
-
-    std::int64_t legacyCount = 0;
-    if (auto chunk = legacyCountResult->Fetch()) {
+    } else if (auto chunk = legacyCountResult->Fetch()) {
         if (chunk->size() > 0) {
             const auto value = chunk->GetValue(0, 0);
             if (!value.IsNull()) {
@@ -109,9 +242,237 @@ void DuckStore::migrate() {
         }
     }
 
+    auto catalogResult = connection.Query(partitionCatalogDdl());
+    if (!catalogResult || catalogResult->HasError()) {
+        const std::string errorMessage = catalogResult ? catalogResult->GetError()
+                                                       : std::string{"unknown error creating partition catalog"};
+        throw std::runtime_error("DuckStore: migration failed: " + errorMessage);
+    }
+
+    auto upgradeResult = connection.Query(partitionCatalogUpgradeDdl());
+    if (!upgradeResult || upgradeResult->HasError()) {
+        const std::string errorMessage = upgradeResult ? upgradeResult->GetError()
+                                                       : std::string{"unknown error upgrading partition catalog"};
+        throw std::runtime_error("DuckStore: migration failed: " + errorMessage);
+    }
+
+    auto boundsResult = connection.Query(seriesBoundsDdl());
+    if (!boundsResult || boundsResult->HasError()) {
+        const std::string errorMessage = boundsResult ? boundsResult->GetError()
+                                                      : std::string{"unknown error creating series bounds"};
+        throw std::runtime_error("DuckStore: migration failed: " + errorMessage);
+    }
+    auto boundsUpgradeResult = connection.Query(seriesBoundsUpgradeDdl());
+    if (!boundsUpgradeResult || boundsUpgradeResult->HasError()) {
+        const std::string errorMessage = boundsUpgradeResult ? boundsUpgradeResult->GetError()
+                                                             : std::string{"unknown error upgrading series bounds"};
+        throw std::runtime_error("DuckStore: migration failed: " + errorMessage);
+    }
+    auto writesResult = connection.Query(seriesWritesDdl());
+    if (!writesResult || writesResult->HasError()) {
+        const std::string errorMessage = writesResult ? writesResult->GetError()
+                                                      : std::string{"unknown error creating series write log"};
+        throw std::runtime_error("DuckStore: migration failed: " + errorMessage);
+    }
+    if (seriesBoundsEmpty(connection)) {
+        // Candles written before the bounds table existed.
+        try {
+            connection.BeginTransaction();
+            const auto series = rebuildSeriesBounds(connection);
+            connection.Commit();
+            if (series > 0) {
+                LOG_INFO("DuckStore recorded bounds for " << series << " series");
+            }
+        } catch (const std::exception& ex) {
+            LOG_WARN("DuckStore: unable to rebuild series bounds: " << ex.what());
+            try {
+                connection.Rollback();
+            } catch (const std::exception&) {
+            }
+        }
+    }
+
+    if (granularity_ != PartitionGranularity::None) {
+        drainUnifiedTable(connection, granularity_);
+    }
+
     LOG_INFO("DuckStore migration finished for " << dbPath.string());
 #endif
 }
 
-}  // namespace adapters::duckdb
+std::size_t DuckStore::freezePartitions(std::int64_t cutoffMs) {
+#if !defined(HAS_DUCKDB)
+    (void)cutoffMs;
+    return 0;
+#else
+    const fs::path dbPath{dbPath_};
+    std::error_code ec;
+    if (!fs::exists(dbPath, ec) || fs::is_directory(dbPath, ec)) {
+        return 0;
+    }
+
+    ::duckdb::DuckDB db(dbPath.string());
+    ::duckdb::Connection connection(db);
+
+    auto statement = connection.Prepare("SELECT table_name FROM " + std::string{kPartitionCatalogTable}
+                                        + " WHERE frozen = false AND cold_path IS NULL AND end_ts <= ? "
+                                          "ORDER BY start_ts");
+    if (!statement || statement->HasError()) {
+        const std::string errorMessage =
+            statement ? statement->GetError() : std::string{"failed to prepare partition scan"};
+        LOG_WARN("DuckStore: unable to list partitions to freeze: " << errorMessage);
+        return 0;
+    }
+
+    DuckdbValueVector parameters;
+    parameters.emplace_back(::duckdb::Value::BIGINT(cutoffMs));
+    auto result = statement->Execute(parameters);
+    if (!result || result->HasError()) {
+        const std::string errorMessage =
+            result ? result->GetError() : std::string{"failed to execute partition scan"};
+        LOG_WARN("DuckStore: unable to list partitions to freeze: " << errorMessage);
+        return 0;
+    }
+
+    std::vector<std::string> candidates;
+    while (auto chunk = result->Fetch()) {
+        const auto count = chunk->size();
+        for (::duckdb::idx_t row = 0; row < count; ++row) {
+            const auto value = chunk->GetValue(0, row);
+            if (!value.IsNull()) {
+                candidates.push_back(value.GetValue<std::string>());
+            }
+        }
+    }
+
+    std::size_t frozen = 0;
+    for (const auto& tableName : candidates) {
+        try {
+            connection.BeginTransaction();
+            const auto rows = freezePartition(connection, tableName);
+            connection.Commit();
+            ++frozen;
+            LOG_INFO("DuckStore froze partition " << tableName << " rows=" << rows);
+        } catch (const std::exception& ex) {
+            LOG_WARN("DuckStore: unable to freeze partition " << tableName << ": " << ex.what());
+            try {
+                connection.Rollback();
+            } catch (const std::exception&) {
+            }
+        }
+    }
+
+    if (frozen > 0) {
+        // Reclaim the space released by the rewritten partitions.
+        connection.Query("CHECKPOINT");
+    }
+    return frozen;
+#endif
+}
+
+
+std::size_t DuckStore::tierColdPartitions(std::int64_t cutoffMs, const std::string& coldDir) {
+#if !defined(HAS_DUCKDB)
+    (void)cutoffMs;
+    (void)coldDir;
+    return 0;
+#else
+    const fs::path dbPath{dbPath_};
+    std::error_code ec;
+    if (coldDir.empty() || !fs::exists(dbPath, ec) || fs::is_directory(dbPath, ec)) {
+        return 0;
+    }
 
+    ::duckdb::DuckDB db(dbPath.string());
+    ::duckdb::Connection connection(db);
+
+    auto statement = connection.Prepare("SELECT table_name, interval FROM " + std::string{kPartitionCatalogTable}
+                                        + " WHERE cold_path IS NULL AND end_ts <= ? ORDER BY start_ts");
+    if (!statement || statement->HasError()) {
+        const std::string errorMessage =
+            statement ? statement->GetError() : std::string{"failed to prepare partition scan"};
+        LOG_WARN("DuckStore: unable to list partitions to tier: " << errorMessage);
+        return 0;
+    }
+
+    DuckdbValueVector parameters;
+    parameters.emplace_back(::duckdb::Value::BIGINT(cutoffMs));
+    auto result = statement->Execute(parameters);
+    if (!result || result->HasError()) {
+        const std::string errorMessage =
+            result ? result->GetError() : std::string{"failed to execute partition scan"};
+        LOG_WARN("DuckStore: unable to list partitions to tier: " << errorMessage);
+        return 0;
+    }
+
+    std::vector<std::pair<std::string, std::string>> candidates;
+    while (auto chunk = result->Fetch()) {
+        const auto count = chunk->size();
+        for (::duckdb::idx_t row = 0; row < count; ++row) {
+            const auto tableValue = chunk->GetValue(0, row);
+            const auto intervalValue = chunk->GetValue(1, row);
+            if (!tableValue.IsNull() && !intervalValue.IsNull()) {
+                candidates.emplace_back(tableValue.GetValue<std::string>(), intervalValue.GetValue<std::string>());
+            }
+        }
+    }
+
+    std::size_t tiered = 0;
+    for (const auto& [tableName, interval] : candidates) {
+        const fs::path targetDir = fs::absolute(fs::path{coldDir} / interval, ec);
+        if (!ec) {
+            fs::create_directories(targetDir, ec);
+        }
+        if (ec) {
+            LOG_WARN("DuckStore: unable to create cold directory for " << tableName << ": " << ec.message());
+            ec.clear();
+            continue;
+        }
+
+        const fs::path target = targetDir / (tableName + ".parquet");
+        const fs::path staging = targetDir / (tableName + ".parquet.tmp");
+
+        // Export outside the catalog transaction and publish with a rename so a
+        // half-written file is never referenced.
+        auto copyResult = connection.Query("COPY (SELECT symbol, ts, o, h, l, c, v FROM \"" + tableName
+                                           + "\" ORDER BY symbol, ts) TO " + sqlStringLiteral(staging.string())
+                                           + " (FORMAT PARQUET, COMPRESSION ZSTD, ROW_GROUP_SIZE 122880)");
+        if (!copyResult || copyResult->HasError()) {
+            const std::string errorMessage =
+                copyResult ? copyResult->GetError() : std::string{"failed to export partition"};
+            LOG_WARN("DuckStore: unable to export partition " << tableName << ": " << errorMessage);
+            fs::remove(staging, ec);
+            ec.clear();
+            continue;
+        }
+        fs::rename(staging, target, ec);
+        if (ec) {
+            LOG_WARN("DuckStore: unable to publish " << target.string() << ": " << ec.message());
+            fs::remove(staging, ec);
+            ec.clear();
+            continue;
+        }
+
+        try {
+            connection.BeginTransaction();
+            markPartitionCold(connection, tableName, target.string());
+            connection.Commit();
+            ++tiered;
+            LOG_INFO("DuckStore moved partition " << tableName << " to " << target.string());
+        } catch (const std::exception& ex) {
+            LOG_WARN("DuckStore: unable to tier partition " << tableName << ": " << ex.what());
+            try {
+                connection.Rollback();
+            } catch (const std::exception&) {
+            }
+        }
+    }
+
+    if (tiered > 0) {
+        connection.Query("CHECKPOINT");
+    }
+    return tiered;
+#endif
+}
+
+}  // namespace adapters::duckdb
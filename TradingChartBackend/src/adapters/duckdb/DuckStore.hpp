@@ -1,17 +1,32 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
+#include "adapters/duckdb/CandlePartitions.hpp"
+
 namespace adapters::duckdb {
 
 class DuckStore {
 public:
-    explicit DuckStore(std::string dbPath = "data/market.duckdb");
+    explicit DuckStore(std::string dbPath = "data/market.duckdb",
+                       PartitionGranularity granularity = PartitionGranularity::Month);
 
     void migrate();
 
+    // Compacts and freezes every partition that ends at or before cutoffMs.
+    // Returns how many partitions were frozen.
+    std::size_t freezePartitions(std::int64_t cutoffMs);
+
+    // Exports partitions that end at or before cutoffMs to zstd Parquet files
+    // under coldDir (sorted by symbol, ts) and drops their hot tables. Reads
+    // keep working through the catalog. Returns how many partitions moved.
+    std::size_t tierColdPartitions(std::int64_t cutoffMs, const std::string& coldDir);
+
 private:
     std::string dbPath_;
+    PartitionGranularity granularity_;
 };
 
 }  // namespace adapters::duckdb
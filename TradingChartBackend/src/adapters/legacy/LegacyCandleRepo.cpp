@@ -1,9 +1,16 @@
 #include "adapters/legacy/LegacyCandleRepo.hpp"
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
-#include <deque>
-#include <fstream>
+#include <cstddef>
+#include <iterator>
 #include <limits>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "domain/Models.hpp"
@@ -57,6 +64,222 @@ bool matchesRange(std::int64_t value, std::int64_t fromTs, std::int64_t toTs) {
     return true;
 }
 
+constexpr std::size_t kRecordSize = sizeof(infra::storage::PriceData);
+constexpr std::size_t kReadChunkRecords = 1024;
+// Written by PriceDataTimeSeriesRepository per interval; never a fallback
+// for another interval.
+constexpr std::string_view kTimeSeriesSuffix = "_timeseries.bin";
+
+struct RecordFile {
+    int fd{-1};
+    std::size_t count{0};
+};
+
+// Reads `count` fixed-size records starting at record `index`; returns how
+// many were read in full.
+std::size_t readRecords(const RecordFile& file,
+                        std::size_t index,
+                        std::size_t count,
+                        infra::storage::PriceData* out) {
+    if (index >= file.count) {
+        return 0;
+    }
+    count = std::min(count, file.count - index);
+    auto* buffer = reinterpret_cast<char*>(out);
+    const std::size_t wanted = count * kRecordSize;
+    std::size_t done = 0;
+    while (done < wanted) {
+        const auto got = ::pread(file.fd,
+                                 buffer + done,
+                                 wanted - done,
+                                 static_cast<off_t>(index * kRecordSize + done));
+        if (got <= 0) {
+            break;
+        }
+        done += static_cast<std::size_t>(got);
+    }
+    return done / kRecordSize;
+}
+
+std::optional<std::int64_t> openTimeAt(const RecordFile& file, std::size_t index) {
+    infra::storage::PriceData record{};
+    if (readRecords(file, index, 1, &record) != 1) {
+        return std::nullopt;
+    }
+    return static_cast<std::int64_t>(record.openTime);
+}
+
+// Datasets written by the app are append-ordered, but older tools wrote
+// unordered files or repeated an open time when a candle was updated. Only a
+// file whose open times strictly increase is served by binary search; the
+// caller caches the answer per file version.
+bool isStrictlyOrderedByOpenTime(const RecordFile& file) {
+    std::vector<infra::storage::PriceData> records(kReadChunkRecords);
+    std::int64_t previous = std::numeric_limits<std::int64_t>::min();
+    bool first = true;
+    for (std::size_t index = 0; index < file.count;) {
+        const auto read = readRecords(file, index, kReadChunkRecords, records.data());
+        if (read == 0) {
+            return false;
+        }
+        for (std::size_t i = 0; i < read; ++i) {
+            const auto ts = static_cast<std::int64_t>(records[i].openTime);
+            if (!first && ts <= previous) {
+                return false;
+            }
+            previous = ts;
+            first = false;
+        }
+        index += read;
+    }
+    return true;
+}
+
+// Result of the last ordering scan of a dataset, valid while its size and
+// mtime are unchanged.
+struct OrderEntry {
+    std::int64_t size{0};
+    std::int64_t mtimeNs{0};
+    bool ordered{false};
+};
+
+bool isOrdered(const std::string& path, const struct stat& st, const RecordFile& file) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, OrderEntry> entries;
+
+    const auto size = static_cast<std::int64_t>(st.st_size);
+    const auto mtimeNs = static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1'000'000'000LL
+        + static_cast<std::int64_t>(st.st_mtim.tv_nsec);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (const auto it = entries.find(path);
+            it != entries.end() && it->second.size == size && it->second.mtimeNs == mtimeNs) {
+            return it->second.ordered;
+        }
+    }
+
+    const bool ordered = isStrictlyOrderedByOpenTime(file);
+    std::lock_guard<std::mutex> lock(mutex);
+    entries[path] = OrderEntry{size, mtimeNs, ordered};
+    return ordered;
+}
+
+// First record index whose openTime is >= value.
+std::size_t lowerBoundOpenTime(const RecordFile& file, std::int64_t value) {
+    std::size_t low = 0;
+    std::size_t high = file.count;
+    while (low < high) {
+        const std::size_t mid = low + (high - low) / 2;
+        const auto ts = openTimeAt(file, mid);
+        if (ts && *ts < value) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+domain::contracts::Candle toCandle(const infra::storage::PriceData& record) {
+    domain::contracts::Candle candle{};
+    candle.ts = static_cast<std::int64_t>(record.openTime);
+    candle.o = record.openPrice;
+    candle.h = record.highPrice;
+    candle.l = record.lowPrice;
+    candle.c = record.closePrice;
+    candle.v = record.volume;
+    return candle;
+}
+
+std::vector<domain::contracts::Candle> readSorted(const RecordFile& file,
+                                                  std::int64_t fromTs,
+                                                  std::int64_t toTs,
+                                                  std::size_t limit) {
+    std::vector<domain::contracts::Candle> candles;
+    const bool hasRange = (fromTs > 0) || (toTs > 0);
+
+    if (!hasRange && limit > 0) {
+        // Last N candles: one read from the tail of the file.
+        const std::size_t count = std::min(limit, file.count);
+        std::vector<infra::storage::PriceData> records(count);
+        const auto read = readRecords(file, file.count - count, count, records.data());
+        candles.reserve(read);
+        for (std::size_t i = 0; i < read; ++i) {
+            candles.push_back(toCandle(records[i]));
+        }
+        return candles;
+    }
+
+    const std::size_t maxItems = effectiveLimit(limit);
+    std::size_t index = fromTs > 0 ? lowerBoundOpenTime(file, fromTs) : 0;
+    candles.reserve(std::min<std::size_t>({maxItems, file.count - std::min(index, file.count), 4096}));
+
+    std::vector<infra::storage::PriceData> records(kReadChunkRecords);
+    while (index < file.count && candles.size() < maxItems) {
+        const auto read = readRecords(file, index, kReadChunkRecords, records.data());
+        if (read == 0) {
+            break;
+        }
+        for (std::size_t i = 0; i < read && candles.size() < maxItems; ++i) {
+            const auto ts = static_cast<std::int64_t>(records[i].openTime);
+            if (toTs > 0 && ts > toTs) {
+                return candles;
+            }
+            candles.push_back(toCandle(records[i]));
+        }
+        index += read;
+    }
+    return candles;
+}
+
+std::vector<domain::contracts::Candle> readUnsorted(const RecordFile& file,
+                                                    std::int64_t fromTs,
+                                                    std::int64_t toTs,
+                                                    std::size_t limit) {
+    const bool hasRange = (fromTs > 0) || (toTs > 0);
+    std::vector<domain::contracts::Candle> candles;
+
+    std::vector<infra::storage::PriceData> records(kReadChunkRecords);
+    for (std::size_t index = 0; index < file.count;) {
+        const auto read = readRecords(file, index, kReadChunkRecords, records.data());
+        if (read == 0) {
+            break;
+        }
+        for (std::size_t i = 0; i < read; ++i) {
+            const auto ts = static_cast<std::int64_t>(records[i].openTime);
+            if (matchesRange(ts, fromTs, toTs)) {
+                candles.push_back(toCandle(records[i]));
+            }
+        }
+        index += read;
+    }
+
+    // The last record written for an open time is the newest version of that
+    // candle.
+    std::stable_sort(candles.begin(), candles.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.ts < rhs.ts;
+    });
+    auto out = candles.begin();
+    for (auto it = candles.begin(); it != candles.end(); ++it) {
+        const auto next = std::next(it);
+        if (next == candles.end() || next->ts != it->ts) {
+            *out++ = *it;
+        }
+    }
+    candles.erase(out, candles.end());
+
+    if (limit > 0 && candles.size() > limit) {
+        if (hasRange) {
+            candles.resize(limit);
+        }
+        else {
+            candles.erase(candles.begin(), candles.end() - static_cast<std::ptrdiff_t>(limit));
+        }
+    }
+    return candles;
+}
+
 }  // namespace
 
 LegacyCandleRepo::LegacyCandleRepo()
@@ -159,7 +382,9 @@ std::optional<std::filesystem::path> LegacyCandleRepo::findDatasetFallback(
                 continue;
             }
 
-            if (filename.rfind(prefix, 0) == 0 && entry.path().extension() == ".bin") {
+            const bool timeSeries = filename.size() >= kTimeSeriesSuffix.size()
+                && filename.compare(filename.size() - kTimeSeriesSuffix.size(), kTimeSeriesSuffix.size(), kTimeSeriesSuffix) == 0;
+            if (filename.rfind(prefix, 0) == 0 && entry.path().extension() == ".bin" && !timeSeries) {
                 return entry.path();
             }
         }
@@ -173,71 +398,41 @@ std::vector<domain::contracts::Candle> LegacyCandleRepo::readDataset(
     std::int64_t fromTs,
     std::int64_t toTs,
     std::size_t limit) const {
-    std::ifstream input(path, std::ios::binary);
-    if (!input) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
         LOG_WARN(kLogCategory,
                  "LegacyCandleRepo failed to open dataset path=%s",
                  path.string().c_str());
         return {};
     }
 
-    const bool hasRange = (fromTs > 0) || (toTs > 0);
-    const bool limitEnabled = (limit > 0);
-    const std::size_t maxItems = effectiveLimit(limit);
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return {};
+    }
+    const RecordFile file{fd, static_cast<std::size_t>(st.st_size) / kRecordSize};
 
     std::vector<domain::contracts::Candle> candles;
-    std::deque<domain::contracts::Candle> window;
-    if (!hasRange && limitEnabled) {
-        window.clear();
+    if (isOrdered(path.string(), st, file)) {
+        candles = readSorted(file, fromTs, toTs, limit);
     }
     else {
-        candles.reserve(std::min<std::size_t>(maxItems, 1024));
+        LOG_DEBUG(kLogCategory,
+                  "LegacyCandleRepo dataset not ordered, scanning path=%s",
+                  path.string().c_str());
+        candles = readUnsorted(file, fromTs, toTs, limit);
     }
-
-    infra::storage::PriceData record{};
-    while (input.read(reinterpret_cast<char*>(&record), sizeof(record))) {
-        const auto ts = static_cast<std::int64_t>(record.openTime);
-        if (fromTs > 0 && ts < fromTs) {
-            continue;
-        }
-        if (toTs > 0 && ts > toTs) {
-            break;
-        }
-        if (!matchesRange(ts, fromTs, toTs)) {
-            continue;
-        }
-
-        domain::contracts::Candle candle{};
-        candle.ts = ts;
-        candle.o = record.openPrice;
-        candle.h = record.highPrice;
-        candle.l = record.lowPrice;
-        candle.c = record.closePrice;
-        candle.v = record.volume;
-
-        if (!hasRange && limitEnabled) {
-            window.push_back(candle);
-            if (window.size() > maxItems) {
-                window.pop_front();
-            }
-            continue;
-        }
-
-        candles.push_back(candle);
-
-        if (limitEnabled && candles.size() >= maxItems) {
-            break;
-        }
+    ::close(fd);
+
+    if (!std::is_sorted(candles.begin(), candles.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.ts < rhs.ts;
+        })) {
+        std::sort(candles.begin(), candles.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.ts < rhs.ts;
+        });
     }
 
-    if (!hasRange && limitEnabled) {
-        candles.assign(window.begin(), window.end());
-    }
-
-    std::sort(candles.begin(), candles.end(), [](const auto& lhs, const auto& rhs) {
-        return lhs.ts < rhs.ts;
-    });
-
     return candles;
 }
 
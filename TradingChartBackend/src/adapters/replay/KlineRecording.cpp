@@ -0,0 +1,146 @@
+#include "adapters/replay/KlineRecording.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <limits>
+
+#include "logging/Log.h"
+
+namespace adapters::replay {
+namespace {
+
+constexpr logging::LogCategory kLogCategory = logging::LogCategory::DATA;
+constexpr char kMagic[8] = {'T', 'T', 'P', 'R', 'E', 'C', '1', '\0'};
+constexpr std::size_t kRecordHeaderBytes = sizeof(std::int64_t) + sizeof(std::uint32_t);
+constexpr std::size_t kWriteBufferBytes = 1 << 20;
+
+}  // namespace
+
+KlineRecorder::KlineRecorder(const std::string& path) : path_(path) {
+    file_ = std::fopen(path.c_str(), "ab");
+    if (file_ == nullptr) {
+        LOG_WARN(kLogCategory, "KlineRecorder open failed path=%s error=%s", path.c_str(), std::strerror(errno));
+        return;
+    }
+    std::setvbuf(file_, nullptr, _IOFBF, kWriteBufferBytes);
+    std::fseek(file_, 0, SEEK_END);
+    if (std::ftell(file_) == 0) {
+        std::fwrite(kMagic, 1, sizeof(kMagic), file_);
+    }
+    LOG_INFO(kLogCategory, "KlineRecorder recording to path=%s", path.c_str());
+}
+
+KlineRecorder::~KlineRecorder() {
+    if (file_ != nullptr) {
+        std::fclose(file_);
+        LOG_INFO(kLogCategory,
+                 "KlineRecorder closed path=%s messages=%llu",
+                 path_.c_str(),
+                 static_cast<unsigned long long>(recorded()));
+    }
+}
+
+void KlineRecorder::record(std::string_view payload) {
+    if (file_ == nullptr || payload.size() > std::numeric_limits<std::uint32_t>::max()) {
+        return;
+    }
+    const std::int64_t recvNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::system_clock::now().time_since_epoch())
+                                    .count();
+    const auto length = static_cast<std::uint32_t>(payload.size());
+
+    char header[kRecordHeaderBytes];
+    std::memcpy(header, &recvNs, sizeof(recvNs));
+    std::memcpy(header + sizeof(recvNs), &length, sizeof(length));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::fwrite(header, 1, sizeof(header), file_);
+    std::fwrite(payload.data(), 1, payload.size(), file_);
+    recorded_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void KlineRecorder::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_ != nullptr) {
+        std::fflush(file_);
+    }
+}
+
+KlineRecordingReader::~KlineRecordingReader() {
+    close();
+}
+
+bool KlineRecordingReader::open(const std::string& path) {
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOG_WARN(kLogCategory, "KlineRecordingReader open failed path=%s error=%s", path.c_str(), std::strerror(errno));
+        return false;
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(kMagic)) {
+        LOG_WARN(kLogCategory, "KlineRecordingReader invalid file path=%s", path.c_str());
+        ::close(fd);
+        return false;
+    }
+
+    const auto bytes = static_cast<std::size_t>(st.st_size);
+    void* mapped = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        LOG_WARN(kLogCategory, "KlineRecordingReader mmap failed path=%s error=%s", path.c_str(), std::strerror(errno));
+        return false;
+    }
+    ::madvise(mapped, bytes, MADV_SEQUENTIAL);
+
+    if (std::memcmp(mapped, kMagic, sizeof(kMagic)) != 0) {
+        LOG_WARN(kLogCategory, "KlineRecordingReader bad magic path=%s", path.c_str());
+        ::munmap(mapped, bytes);
+        return false;
+    }
+
+    base_ = static_cast<const char*>(mapped);
+    size_ = bytes;
+    offset_ = sizeof(kMagic);
+    return true;
+}
+
+void KlineRecordingReader::close() {
+    if (base_ != nullptr) {
+        ::munmap(const_cast<char*>(base_), size_);
+    }
+    base_ = nullptr;
+    size_ = 0;
+    offset_ = 0;
+}
+
+bool KlineRecordingReader::next(RecordedMessage& out) noexcept {
+    if (base_ == nullptr || size_ - offset_ < kRecordHeaderBytes) {
+        return false;
+    }
+    std::uint32_t length = 0;
+    std::memcpy(&out.recvNs, base_ + offset_, sizeof(out.recvNs));
+    std::memcpy(&length, base_ + offset_ + sizeof(out.recvNs), sizeof(length));
+    if (size_ - offset_ - kRecordHeaderBytes < length) {
+        return false;
+    }
+    out.payload = std::string_view(base_ + offset_ + kRecordHeaderBytes, length);
+    offset_ += kRecordHeaderBytes + length;
+    return true;
+}
+
+void KlineRecordingReader::rewind() noexcept {
+    if (base_ != nullptr) {
+        offset_ = sizeof(kMagic);
+    }
+}
+
+}  // namespace adapters::replay
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace adapters::replay {
+
+// Recording file layout (host byte order):
+//   [magic "TTPREC1\0"]
+//   repeated: [recvNs : int64][length : uint32][payload : length bytes]
+// recvNs is the wall-clock receive time (ns since epoch) of the raw WS frame.
+struct RecordedMessage {
+    std::int64_t recvNs{0};
+    // Points into the reader's mapping; valid until the reader is closed.
+    std::string_view payload;
+};
+
+// Appends raw WS payloads to a recording. Thread-safe, so every shard of a
+// feed can share one recorder.
+class KlineRecorder {
+public:
+    explicit KlineRecorder(const std::string& path);
+    ~KlineRecorder();
+
+    KlineRecorder(const KlineRecorder&) = delete;
+    KlineRecorder& operator=(const KlineRecorder&) = delete;
+
+    bool isOpen() const noexcept { return file_ != nullptr; }
+    const std::string& path() const noexcept { return path_; }
+
+    void record(std::string_view payload);
+    void flush();
+
+    std::uint64_t recorded() const noexcept { return recorded_.load(std::memory_order_relaxed); }
+
+private:
+    std::string path_;
+    std::mutex mutex_;
+    std::FILE* file_{nullptr};
+    std::atomic<std::uint64_t> recorded_{0};
+};
+
+// Sequential reader over an mmap'd recording.
+class KlineRecordingReader {
+public:
+    KlineRecordingReader() = default;
+    ~KlineRecordingReader();
+
+    KlineRecordingReader(const KlineRecordingReader&) = delete;
+    KlineRecordingReader& operator=(const KlineRecordingReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const noexcept { return base_ != nullptr; }
+
+    // Returns false at the end of the file or at a truncated trailing record.
+    bool next(RecordedMessage& out) noexcept;
+    void rewind() noexcept;
+
+private:
+    const char* base_{nullptr};
+    std::size_t size_{0};
+    std::size_t offset_{0};
+};
+
+}  // namespace adapters::replay
@@ -0,0 +1,234 @@
+#include "adapters/replay/ReplayKlineFeed.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+#include "adapters/binance/KlineMessageParser.hpp"
+#include "adapters/replay/KlineRecording.hpp"
+#include "common/Metrics.hpp"
+#include "logging/Log.h"
+
+namespace adapters::replay {
+namespace {
+
+constexpr logging::LogCategory kLogCategory = logging::LogCategory::NET;
+
+std::runtime_error make_error(const std::string& message) {
+    return std::runtime_error("ReplayKlineFeed: " + message);
+}
+
+std::string normalize_symbol(const std::string& symbol) {
+    std::string result;
+    result.reserve(symbol.size());
+    for (unsigned char ch : symbol) {
+        if (!std::isspace(ch)) {
+            result.push_back(static_cast<char>(std::toupper(ch)));
+        }
+    }
+    return result;
+}
+
+}  // namespace
+
+ReplayKlineFeed::ReplayKlineFeed(std::string path, Options options)
+    : path_(std::move(path)), options_(options) {}
+
+ReplayKlineFeed::~ReplayKlineFeed() {
+    stop();
+}
+
+void ReplayKlineFeed::subscribe(const std::vector<std::string>& symbols,
+                                domain::Interval interval,
+                                std::function<void(const std::string&, const domain::Candle&)> on_closed_candle) {
+    if (symbols.empty()) {
+        throw make_error("subscribe called with empty symbol list");
+    }
+    if (!interval.valid()) {
+        throw make_error("invalid interval");
+    }
+    if (!on_closed_candle) {
+        throw make_error("subscribe requires a valid callback");
+    }
+    if (worker_.joinable()) {
+        throw make_error("already subscribed");
+    }
+
+    auto normalized = normalize_symbols_(symbols);
+    const auto symbolCount = normalized.size();
+    const auto intervalMs = static_cast<std::int64_t>(interval.ms);
+    std::string symbol;
+    binance::KlineMessage kline;
+    start_(
+        [symbols = std::move(normalized), intervalMs, onCandle = std::move(on_closed_candle), symbol, kline](
+            std::string_view payload) mutable {
+            if (!binance::parse_kline_message(payload, kline)) {
+                return Outcome::Unparsed;
+            }
+            if (kline.candle.closeTime - kline.candle.openTime + 1 != intervalMs) {
+                return Outcome::Filtered;
+            }
+            symbol.assign(kline.symbol.data(), kline.symbol.size());
+            if (symbols.find(symbol) == symbols.end()) {
+                return Outcome::Filtered;
+            }
+            onCandle(symbol, kline.candle);
+            return Outcome::Delivered;
+        },
+        symbolCount);
+}
+
+void ReplayKlineFeed::subscribe_trades(const std::vector<std::string>& symbols,
+                                       std::function<void(std::string_view, const domain::AggTrade&)> on_trade) {
+    if (symbols.empty()) {
+        throw make_error("subscribe_trades called with empty symbol list");
+    }
+    if (!on_trade) {
+        throw make_error("subscribe_trades requires a valid callback");
+    }
+    if (worker_.joinable()) {
+        throw make_error("already subscribed");
+    }
+
+    auto normalized = normalize_symbols_(symbols);
+    const auto symbolCount = normalized.size();
+    std::string symbol;
+    binance::AggTradeMessage message;
+    start_(
+        [symbols = std::move(normalized), onTrade = std::move(on_trade), symbol, message](
+            std::string_view payload) mutable {
+            if (!binance::parse_agg_trade_message(payload, message)) {
+                return Outcome::Unparsed;
+            }
+            symbol.assign(message.symbol.data(), message.symbol.size());
+            if (symbols.find(symbol) == symbols.end()) {
+                return Outcome::Filtered;
+            }
+            onTrade(message.symbol, message.trade);
+            return Outcome::Delivered;
+        },
+        symbolCount);
+}
+
+void ReplayKlineFeed::start_(Deliver deliver, std::size_t symbolCount) {
+    delivered_.store(0, std::memory_order_relaxed);
+    running_.store(true, std::memory_order_release);
+    worker_ = std::thread(&ReplayKlineFeed::run_, this, std::move(deliver), symbolCount);
+}
+
+std::unordered_set<std::string> ReplayKlineFeed::normalize_symbols_(const std::vector<std::string>& symbols) {
+    std::unordered_set<std::string> normalized;
+    for (const auto& symbol : symbols) {
+        auto upper = normalize_symbol(symbol);
+        if (!upper.empty()) {
+            normalized.insert(std::move(upper));
+        }
+    }
+    return normalized;
+}
+
+void ReplayKlineFeed::set_on_reconnected(std::function<void()> callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    on_reconnected_ = std::move(callback);
+}
+
+void ReplayKlineFeed::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        running_.store(false, std::memory_order_release);
+    }
+    wake_cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void ReplayKlineFeed::wait() {
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    wake_cv_.wait(lock, [this]() { return !running_.load(std::memory_order_acquire); });
+}
+
+bool ReplayKlineFeed::sleep_until_(std::chrono::steady_clock::time_point deadline) {
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    return !wake_cv_.wait_until(lock, deadline, [this]() { return !running_.load(std::memory_order_acquire); });
+}
+
+void ReplayKlineFeed::run_(Deliver deliver, std::size_t symbolCount) {
+    KlineRecordingReader reader;
+    if (!reader.open(path_)) {
+        LOG_ERROR(kLogCategory, "ReplayKlineFeed cannot open recording path=%s", path_.c_str());
+    }
+    else {
+        std::function<void()> onReconnected;
+        {
+            std::lock_guard<std::mutex> lock(callback_mutex_);
+            onReconnected = on_reconnected_;
+        }
+        if (onReconnected) {
+            onReconnected();
+        }
+
+        LOG_INFO(kLogCategory,
+                 "ReplayKlineFeed playing path=%s speed=%.2f loop=%s symbols=%zu",
+                 path_.c_str(),
+                 options_.speed,
+                 options_.loop ? "true" : "false",
+                 symbolCount);
+
+        std::uint64_t passRead = 0;
+        do {
+            const auto passStart = std::chrono::steady_clock::now();
+            std::int64_t firstRecvNs = -1;
+            passRead = 0;
+            std::uint64_t passDelivered = 0;
+            std::uint64_t passSkipped = 0;
+            RecordedMessage message;
+
+            while (running_.load(std::memory_order_acquire) && reader.next(message)) {
+                ++passRead;
+                if (options_.speed > 0.0) {
+                    if (firstRecvNs < 0) {
+                        firstRecvNs = message.recvNs;
+                    }
+                    const auto offsetNs = static_cast<double>(message.recvNs - firstRecvNs) / options_.speed;
+                    const auto due = passStart + std::chrono::nanoseconds(static_cast<std::int64_t>(offsetNs));
+                    if (due > std::chrono::steady_clock::now() && !sleep_until_(due)) {
+                        break;
+                    }
+                }
+
+                const auto outcome = deliver(message.payload);
+                if (outcome == Outcome::Unparsed) {
+                    ++passSkipped;
+                    continue;
+                }
+                if (outcome == Outcome::Filtered) {
+                    continue;
+                }
+                ++passDelivered;
+                delivered_.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - passStart).count();
+            const double rate = elapsed > 0.0 ? static_cast<double>(passDelivered) / elapsed : 0.0;
+            ttp::common::metrics::Registry::instance().setGauge("replay.msgs_per_sec", rate);
+            LOG_INFO(kLogCategory,
+                     "ReplayKlineFeed pass done delivered=%llu skipped=%llu elapsed_s=%.3f msgs_per_sec=%.0f",
+                     static_cast<unsigned long long>(passDelivered),
+                     static_cast<unsigned long long>(passSkipped),
+                     elapsed,
+                     rate);
+            reader.rewind();
+        } while (options_.loop && passRead > 0 && running_.load(std::memory_order_acquire));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        running_.store(false, std::memory_order_release);
+    }
+    wake_cv_.notify_all();
+}
+
+}  // namespace adapters::replay
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "domain/exchange/IExchangeKlines.hpp"
+#include "domain/exchange/IExchangeTrades.hpp"
+
+namespace adapters::replay {
+
+// Plays a KlineRecorder file back through the live-feed interface. Payloads
+// are parsed like the Binance combined stream and delivered on one worker
+// thread, paced by their recorded receive times. Like BinanceWsClient, one
+// instance plays either the klines or the aggTrade frames of a recording.
+class ReplayKlineFeed : public domain::IExchangeLiveKlines, public domain::IExchangeLiveTrades {
+public:
+    struct Options {
+        // 1 = recorded pace, N = N times faster, 0 = as fast as possible.
+        double speed{1.0};
+        // Start over at the end of the file until stop().
+        bool loop{false};
+    };
+
+    ReplayKlineFeed(std::string path, Options options);
+    ~ReplayKlineFeed() override;
+
+    ReplayKlineFeed(const ReplayKlineFeed&) = delete;
+    ReplayKlineFeed& operator=(const ReplayKlineFeed&) = delete;
+
+    // Symbols are matched case-insensitively; klines of other intervals in the
+    // recording are skipped.
+    void subscribe(const std::vector<std::string>& symbols,
+                   domain::Interval interval,
+                   std::function<void(const std::string&, const domain::Candle&)> on_closed_candle) override;
+
+    void subscribe_trades(const std::vector<std::string>& symbols,
+                          std::function<void(std::string_view, const domain::AggTrade&)> on_trade) override;
+
+    // Fires once when playback starts, like a first connect.
+    void set_on_reconnected(std::function<void()> callback) override;
+
+    void stop() override;
+
+    // Blocks until a non-looping replay has delivered the whole file (or stop()).
+    void wait();
+
+    std::uint64_t delivered() const noexcept { return delivered_.load(std::memory_order_relaxed); }
+
+private:
+    enum class Outcome { Delivered, Filtered, Unparsed };
+    // Parses and delivers one recorded payload.
+    using Deliver = std::function<Outcome(std::string_view)>;
+
+    void start_(Deliver deliver, std::size_t symbolCount);
+    void run_(Deliver deliver, std::size_t symbolCount);
+    static std::unordered_set<std::string> normalize_symbols_(const std::vector<std::string>& symbols);
+    bool sleep_until_(std::chrono::steady_clock::time_point deadline);
+
+    const std::string path_;
+    const Options options_;
+
+    std::atomic<bool> running_{false};
+    std::atomic<std::uint64_t> delivered_{0};
+    std::function<void()> on_reconnected_;
+    std::mutex callback_mutex_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::thread worker_;
+};
+
+}  // namespace adapters::replay
@@ -0,0 +1,102 @@
+#include "adapters/replay/ReplayKlines.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+#include "adapters/binance/KlineMessageParser.hpp"
+#include "adapters/replay/KlineRecording.hpp"
+#include "logging/Log.h"
+
+namespace adapters::replay {
+namespace {
+
+constexpr logging::LogCategory kLogCategory = logging::LogCategory::DATA;
+constexpr std::size_t kMaxLimit = 1000;
+
+}  // namespace
+
+ReplayKlines::ReplayKlines(const std::string& path) {
+    KlineRecordingReader reader;
+    if (!reader.open(path)) {
+        LOG_WARN(kLogCategory, "ReplayKlines cannot open recording path=%s", path.c_str());
+        return;
+    }
+
+    RecordedMessage message;
+    binance::KlineMessage kline;
+    while (reader.next(message)) {
+        if (!binance::parse_kline_message(message.payload, kline) || !kline.candle.isClosed) {
+            continue;
+        }
+        const std::int64_t intervalMs = kline.candle.closeTime - kline.candle.openTime + 1;
+        series_[SeriesKey{std::string(kline.symbol), intervalMs}].push_back(kline.candle);
+    }
+
+    for (auto& [key, candles] : series_) {
+        (void)key;
+        std::stable_sort(candles.begin(), candles.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.openTime < rhs.openTime;
+        });
+        // Keep the last delivery of each open time, as an upsert would.
+        auto out = candles.begin();
+        for (auto it = candles.begin(); it != candles.end(); ++it) {
+            if (out != candles.begin() && (out - 1)->openTime == it->openTime) {
+                *(out - 1) = *it;
+            }
+            else {
+                *out++ = *it;
+            }
+        }
+        candles.erase(out, candles.end());
+        candleCount_ += candles.size();
+    }
+
+    LOG_INFO(kLogCategory,
+             "ReplayKlines loaded path=%s series=%zu candles=%zu",
+             path.c_str(),
+             series_.size(),
+             candleCount_);
+}
+
+domain::KlinesPage ReplayKlines::fetch_klines(const std::string& symbol,
+                                              domain::Interval interval,
+                                              std::int64_t from_ts,
+                                              std::int64_t to_ts,
+                                              std::size_t page_limit) {
+    domain::KlinesPage page;
+    if (symbol.empty() || to_ts <= 0 || from_ts >= to_ts) {
+        return page;
+    }
+
+    std::string upper = symbol;
+    std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char ch) {
+        return static_cast<char>(std::toupper(ch));
+    });
+    const auto it = series_.find(SeriesKey{upper, static_cast<std::int64_t>(interval.ms)});
+    if (it == series_.end()) {
+        return page;
+    }
+
+    const auto limit = std::clamp<std::size_t>(page_limit == 0 ? kMaxLimit : page_limit, 1, kMaxLimit);
+    const std::int64_t fromMs = std::max<std::int64_t>(0, from_ts) * 1000;
+    const std::int64_t toMs = to_ts * 1000;
+
+    const auto& candles = it->second;
+    auto cursor = std::lower_bound(candles.begin(), candles.end(), fromMs, [](const auto& candle, std::int64_t value) {
+        return candle.openTime < value;
+    });
+    for (; cursor != candles.end() && page.rows.size() < limit; ++cursor) {
+        if (cursor->closeTime > toMs) {
+            break;
+        }
+        page.rows.push_back(*cursor);
+    }
+
+    if (page.rows.size() >= limit && cursor != candles.end() && cursor->closeTime <= toMs) {
+        page.has_more = true;
+        page.next_from_ts = (page.rows.back().closeTime + 1) / 1000;
+    }
+    return page;
+}
+
+}  // namespace adapters::replay
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "domain/exchange/IExchangeKlines.hpp"
+
+namespace adapters::replay {
+
+// REST-side counterpart of ReplayKlineFeed: serves the closed klines of a
+// recording through fetch_klines, with the Binance paging contract
+// (seconds in, candles whose close time is <= to_ts). Immutable after
+// construction, so concurrent callers need no locking.
+class ReplayKlines : public domain::IExchangeKlines {
+public:
+    explicit ReplayKlines(const std::string& path);
+
+    domain::KlinesPage fetch_klines(const std::string& symbol,
+                                    domain::Interval interval,
+                                    std::int64_t from_ts,
+                                    std::int64_t to_ts,
+                                    std::size_t page_limit = 1000) override;
+
+    std::size_t candleCount() const noexcept { return candleCount_; }
+
+private:
+    using SeriesKey = std::pair<std::string, std::int64_t>;
+
+    std::map<SeriesKey, std::vector<domain::Candle>> series_;
+    std::size_t candleCount_{0};
+};
+
+}  // namespace adapters::replay
@@ -0,0 +1,414 @@
+#include "api/CandleBlocks.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+#include "api/SeriesVersion.hpp"
+#include "common/Metrics.hpp"
+#include "domain/Types.h"
+#include "logging/Log.h"
+
+namespace ttp::api {
+
+namespace {
+
+constexpr logging::LogCategory kLogCategory = logging::LogCategory::DATA;
+constexpr std::int64_t kMillisecondsThreshold = 1'000'000'000'000LL;
+// Approximate bookkeeping per block on top of its vectors and JSON.
+constexpr std::size_t kNodeOverhead = 160;
+
+struct BlockCounters {
+    common::metrics::Counter& hits;
+    common::metrics::Counter& builds;
+    common::metrics::Counter& fallbacks;
+    common::metrics::Counter& evictions;
+};
+
+BlockCounters& counters() {
+    auto& registry = common::metrics::Registry::instance();
+    static BlockCounters handles{registry.counter("candle_blocks.hits"),
+                                 registry.counter("candle_blocks.builds"),
+                                 registry.counter("candle_blocks.fallbacks"),
+                                 registry.counter("candle_blocks.evictions")};
+    return handles;
+}
+
+void appendNumber(std::string& out, std::int64_t value) {
+    char buffer[24];
+    const auto result = std::to_chars(std::begin(buffer), std::end(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void appendNumber(std::string& out, double value) {
+    char buffer[32];
+    const auto result = std::to_chars(std::begin(buffer), std::end(buffer), std::isfinite(value) ? value : 0.0);
+    out.append(buffer, result.ptr);
+}
+
+// Floor division, so negative open times land in the block before 0.
+std::int64_t blockIndex(std::int64_t ts, std::int64_t span) {
+    const auto quotient = ts / span;
+    return (ts % span != 0 && ts < 0) ? quotient - 1 : quotient;
+}
+
+std::string blockKey(const std::string& symbol, const std::string& label, std::int64_t index) {
+    std::string key = symbol;
+    key += '|';
+    key += label;
+    key += '|';
+    key += std::to_string(index);
+    return key;
+}
+
+}  // namespace
+
+void appendCandleRow(std::string& out, const domain::contracts::Candle& candle) {
+    const std::int64_t ts = candle.ts > 0 && candle.ts < kMillisecondsThreshold ? candle.ts * 1000 : candle.ts;
+    out.push_back('[');
+    appendNumber(out, ts);
+    for (const auto value : {candle.o, candle.h, candle.l, candle.c, candle.v}) {
+        out.push_back(',');
+        appendNumber(out, value);
+    }
+    out.append("],");
+}
+
+std::size_t CandleBlockStore::Block::cost() const {
+    return kNodeOverhead + json.capacity() + ts.capacity() * sizeof(std::int64_t)
+        + offsets.capacity() * sizeof(std::uint32_t);
+}
+
+CandleBlockStore& CandleBlockStore::instance() {
+    static CandleBlockStore store;
+    return store;
+}
+
+std::size_t CandleBlockStore::bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+std::optional<std::size_t> CandleBlockStore::assemble(const domain::contracts::ICandleReadRepo& repo,
+                                                      const std::string& symbol,
+                                                      domain::contracts::Interval interval,
+                                                      std::int64_t fromTs,
+                                                      std::int64_t toTs,
+                                                      std::size_t limit,
+                                                      std::string& out) {
+    auto label = domain::contracts::intervalToString(interval);
+    const auto intervalMs = domain::interval_from_label(label).ms;
+    if (symbol.empty() || intervalMs <= 0 || limit == 0) {
+        return std::nullopt;
+    }
+
+    const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count();
+    // Same boundary as the long-lived Cache-Control: the last closed candle
+    // may still be rewritten by the ingestor, so only older ones are sealed.
+    Series series{repo,
+                  symbol,
+                  interval,
+                  std::move(label),
+                  intervalMs,
+                  intervalMs * static_cast<std::int64_t>(kBlockSlots),
+                  nowMs / intervalMs * intervalMs - intervalMs,
+                  0,
+                  0};
+    // Read once, before the repository: a concurrent write can only leave
+    // what this request builds stamped older than its contents.
+    series.version = seriesVersion(&repo, symbol, series.label);
+
+    const auto mark = out.size();
+    std::optional<std::size_t> count;
+    try {
+        count = fromTs > 0 || toTs > 0 ? range(series, fromTs, toTs, limit, out) : latest(series, limit, out);
+    }
+    catch (const std::exception& ex) {
+        LOG_WARN(kLogCategory,
+                 "CandleBlockStore read failed symbol=%s interval=%s error=%s",
+                 symbol.c_str(),
+                 series.label.c_str(),
+                 ex.what());
+        count.reset();
+    }
+    if (!count) {
+        out.resize(mark);
+        counters().fallbacks.add();
+    }
+    return count;
+}
+
+std::optional<std::size_t> CandleBlockStore::latest(Series& series, std::size_t limit, std::string& out) {
+    const auto floorTs = floor(series);
+    if (!floorTs || *floorTs >= series.horizon) {
+        return std::nullopt;
+    }
+
+    auto index = blockIndex(series.horizon - 1, series.span);
+    auto current = block(series, index);
+    if (!current) {
+        return std::nullopt;
+    }
+    auto tail = series.repo.getCandles(series.symbol, series.interval, current->sealedAt, 0, kMaxTailRows);
+    if (tail.size() >= kMaxTailRows) {
+        return std::nullopt;
+    }
+    std::sort(tail.begin(), tail.end(), [](const auto& lhs, const auto& rhs) { return lhs.ts < rhs.ts; });
+    const auto tailBegin = tail.size() > limit ? tail.size() - limit : 0U;
+
+    // Walk back from the horizon until enough rows are collected, then emit
+    // the slices oldest first.
+    struct Slice {
+        BlockPtr block;
+        std::size_t begin;
+    };
+    std::vector<Slice> slices;
+    std::size_t needed = limit - (tail.size() - tailBegin);
+    while (needed > 0) {
+        const auto rows = current->ts.size();
+        const auto take = std::min(needed, rows);
+        if (take > 0) {
+            slices.push_back(Slice{current, rows - take});
+            needed -= take;
+        }
+        if (needed == 0 || current->start <= *floorTs) {
+            break;
+        }
+        current = block(series, --index);
+        if (!current) {
+            return std::nullopt;
+        }
+    }
+
+    std::size_t count = 0;
+    for (auto slice = slices.rbegin(); slice != slices.rend(); ++slice) {
+        const auto& block = *slice->block;
+        out.append(block.json, block.offsets[slice->begin], std::string::npos);
+        count += block.ts.size() - slice->begin;
+    }
+    for (auto row = tail.begin() + static_cast<std::ptrdiff_t>(tailBegin); row != tail.end(); ++row) {
+        appendCandleRow(out, *row);
+        ++count;
+    }
+    return count;
+}
+
+std::optional<std::size_t> CandleBlockStore::range(Series& series,
+                                                   std::int64_t fromTs,
+                                                   std::int64_t toTs,
+                                                   std::size_t limit,
+                                                   std::string& out) {
+    const auto floorTs = floor(series);
+    if (!floorTs) {
+        return std::nullopt;
+    }
+    const auto first = std::max(fromTs > 0 ? fromTs : std::numeric_limits<std::int64_t>::min(), *floorTs);
+    const auto last = toTs > 0 ? toTs : std::numeric_limits<std::int64_t>::max();
+    if (first > last) {
+        return 0U;
+    }
+    if (first >= series.horizon) {
+        return std::nullopt;
+    }
+
+    std::size_t count = 0;
+    for (auto index = blockIndex(first, series.span);; ++index) {
+        const auto current = block(series, index);
+        if (!current) {
+            return std::nullopt;
+        }
+        const auto& ts = current->ts;
+        const auto begin = static_cast<std::size_t>(std::lower_bound(ts.begin(), ts.end(), first) - ts.begin());
+        const auto end = static_cast<std::size_t>(std::upper_bound(ts.begin(), ts.end(), last) - ts.begin());
+        if (end > begin) {
+            const auto take = std::min(end - begin, limit - count);
+            const auto offset = current->offsets[begin];
+            out.append(current->json, offset, current->offsets[begin + take] - offset);
+            count += take;
+        }
+
+        const auto blockEnd = current->start + series.span;
+        if (count == limit) {
+            break;
+        }
+        if (current->sealedAt < blockEnd) {
+            if (current->sealedAt > last) {
+                break;
+            }
+            // Past the horizon: the rest comes straight from the repository.
+            const auto from = std::max(first, current->sealedAt);
+            auto rest = series.repo.getCandles(series.symbol, series.interval, from, toTs, limit - count);
+            std::sort(rest.begin(), rest.end(), [](const auto& lhs, const auto& rhs) { return lhs.ts < rhs.ts; });
+            for (const auto& row : rest) {
+                if (count == limit) {
+                    break;
+                }
+                appendCandleRow(out, row);
+                ++count;
+            }
+            break;
+        }
+        if (blockEnd > last) {
+            break;
+        }
+    }
+    return count;
+}
+
+CandleBlockStore::BlockPtr CandleBlockStore::block(Series& series, std::int64_t index) {
+    const auto start = index * series.span;
+    const auto sealedAt = std::max(start, std::min(start + series.span, series.horizon));
+    const auto key = blockKey(series.symbol, series.label, index);
+
+    // The write log may be the repository's, so it is not consulted under
+    // the lock.
+    BlockPtr cached;
+    std::uint64_t since = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (const auto it = index_.find(key); it != index_.end()) {
+            cached = it->second->block;
+            since = it->second->version;
+        }
+    }
+    if (cached && sealedAt - cached->sealedAt <= kRefreshSlots * series.intervalMs
+        && (cached->sealedAt == cached->start
+            || untouchedBetween(&series.repo,
+                                series.symbol,
+                                series.label,
+                                since,
+                                series.version,
+                                cached->start,
+                                cached->sealedAt - 1))) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (const auto it = index_.find(key); it != index_.end() && it->second->block == cached) {
+            it->second->version = series.version;
+            lru_.splice(lru_.begin(), lru_, it->second);
+        }
+        counters().hits.add();
+        return cached;
+    }
+
+    if (++series.builds > kMaxBuildsPerRequest) {
+        return nullptr;
+    }
+    // The version keeps a build begun before a write from being handed to a
+    // request that arrives after it.
+    const auto flightKey = key + '|' + std::to_string(sealedAt) + '|' + std::to_string(series.version);
+    const auto outcome = builds_.run(flightKey, [&]() { return build(series, start, sealedAt); });
+    if (outcome.value->truncated) {
+        return nullptr;
+    }
+    if (!outcome.shared) {
+        counters().builds.add();
+        store(key, outcome.value);
+    }
+    return outcome.value;
+}
+
+CandleBlockStore::Block CandleBlockStore::build(const Series& series, std::int64_t start, std::int64_t sealedAt) const {
+    Block block;
+    block.start = start;
+    block.sealedAt = sealedAt;
+    // Read before the repository: a concurrent write can only leave the block
+    // stamped older than its contents, which the next lookup rechecks.
+    block.version = series.version;
+    block.offsets.push_back(0);
+    if (sealedAt == start) {
+        return block;
+    }
+
+    // Open times off the interval grid could put more rows in a block than
+    // it has slots; such series are served by the plain read.
+    const auto cap = 2 * kBlockSlots;
+    auto rows = series.repo.getCandles(series.symbol, series.interval, start, sealedAt - 1, cap);
+    if (rows.size() >= cap) {
+        block.truncated = true;
+        return block;
+    }
+    std::sort(rows.begin(), rows.end(), [](const auto& lhs, const auto& rhs) { return lhs.ts < rhs.ts; });
+
+    block.ts.reserve(rows.size());
+    block.offsets.reserve(rows.size() + 1U);
+    block.json.reserve(rows.size() * 96U);
+    for (const auto& row : rows) {
+        block.ts.push_back(row.ts);
+        appendCandleRow(block.json, row);
+        block.offsets.push_back(static_cast<std::uint32_t>(block.json.size()));
+    }
+    block.json.shrink_to_fit();
+    return block;
+}
+
+std::optional<std::int64_t> CandleBlockStore::floor(const Series& series) {
+    const auto key = series.symbol + '|' + series.label;
+    std::optional<Floor> cached;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (const auto it = floors_.find(key); it != floors_.end()) {
+            cached = it->second;
+        }
+    }
+    // Only a write below the oldest candle moves it.
+    if (cached
+        && untouchedBetween(&series.repo,
+                            series.symbol,
+                            series.label,
+                            cached->version,
+                            series.version,
+                            std::numeric_limits<std::int64_t>::min(),
+                            cached->minTs - 1)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (const auto it = floors_.find(key); it != floors_.end() && it->second.minTs == cached->minTs) {
+            it->second.version = series.version;
+        }
+        return cached->minTs;
+    }
+
+    const auto minMax = series.repo.get_min_max_ts(series.symbol, series.label);
+    if (!minMax) {
+        return std::nullopt;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    floors_[key] = Floor{minMax->first, series.version};
+    return minMax->first;
+}
+
+void CandleBlockStore::store(const std::string& key, BlockPtr block) {
+    std::size_t evicted = 0;
+    std::size_t total = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (const auto it = index_.find(key); it != index_.end()) {
+            bytes_ -= it->second->block->cost();
+            lru_.erase(it->second);
+            index_.erase(it);
+        }
+        const auto version = block->version;
+        bytes_ += block->cost();
+        lru_.push_front(Node{key, version, std::move(block)});
+        index_.emplace(key, lru_.begin());
+        while (bytes_ > kMaxBytes && lru_.size() > 1) {
+            auto& victim = lru_.back();
+            bytes_ -= victim.block->cost();
+            index_.erase(victim.key);
+            lru_.pop_back();
+            ++evicted;
+        }
+        total = bytes_;
+    }
+    if (evicted > 0) {
+        counters().evictions.add(evicted);
+    }
+    common::metrics::Registry::instance().setGauge("candle_blocks.bytes", static_cast<double>(total));
+}
+
+}  // namespace ttp::api
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/SingleFlight.hpp"
+#include "domain/Models.hpp"
+#include "domain/Ports.hpp"
+
+namespace ttp::api {
+
+// Appends `[ts,o,h,l,c,v],` (trailing comma included) in the /candles wire
+// format: ts in milliseconds, non-finite values as 0, doubles in their
+// shortest round-trip form.
+void appendCandleRow(std::string& out, const domain::contracts::Candle& candle);
+
+// Closed candles grouped in aligned blocks of kBlockSlots intervals per
+// series, each encoded once and reused by every response that overlaps it.
+// A response is the slice of its edge blocks plus the middle blocks verbatim;
+// only candles after the sealed horizon (the forming and the last closed
+// candle) are read and encoded per request.
+//
+// A block remembers the series version it was read at. Writes that do not
+// touch its range (the common case: appends at the head) only move that
+// stamp forward; a write inside the range rebuilds it. Version and write log
+// are the repository's stored ones when it keeps them (see seriesVersion()),
+// so writes from other processes are seen too.
+class CandleBlockStore {
+public:
+    static constexpr std::size_t kBlockSlots = 1024;
+    // The block under the horizon is rebuilt once it lags by this many slots;
+    // until then the gap is part of the per-request tail.
+    static constexpr std::int64_t kRefreshSlots = 64;
+    static constexpr std::size_t kMaxTailRows = 80;
+    // Cold ranges fall back to a plain read rather than building every block
+    // at once.
+    static constexpr std::size_t kMaxBuildsPerRequest = 16;
+    static constexpr std::size_t kMaxBytes = 64U * 1024U * 1024U;
+
+    static CandleBlockStore& instance();
+
+    // Appends to `out` the rows getCandles(symbol, interval, fromTs, toTs,
+    // limit) would return, oldest first, and returns their count. nullopt
+    // (with `out` untouched) when the blocks cannot answer: the caller then
+    // reads the repository directly.
+    std::optional<std::size_t> assemble(const domain::contracts::ICandleReadRepo& repo,
+                                        const std::string& symbol,
+                                        domain::contracts::Interval interval,
+                                        std::int64_t fromTs,
+                                        std::int64_t toTs,
+                                        std::size_t limit,
+                                        std::string& out);
+
+    std::size_t bytes() const;
+
+private:
+    struct Block {
+        std::int64_t start{0};
+        // Rows cover [start, sealedAt); sealedAt < start + span only for the
+        // block under the horizon.
+        std::int64_t sealedAt{0};
+        std::uint64_t version{0};
+        bool truncated{false};
+        std::vector<std::int64_t> ts;
+        // ts.size() + 1 offsets into json; row i is json[offsets[i], offsets[i + 1]).
+        std::vector<std::uint32_t> offsets;
+        std::string json;
+
+        std::size_t cost() const;
+    };
+
+    using BlockPtr = std::shared_ptr<const Block>;
+
+    struct Node {
+        std::string key;
+        std::uint64_t version{0};
+        BlockPtr block;
+    };
+
+    struct Floor {
+        std::int64_t minTs{0};
+        std::uint64_t version{0};
+    };
+
+    struct Series {
+        const domain::contracts::ICandleReadRepo& repo;
+        const std::string& symbol;
+        domain::contracts::Interval interval;
+        std::string label;
+        std::int64_t intervalMs{0};
+        std::int64_t span{0};
+        std::int64_t horizon{0};
+        std::size_t builds{0};
+        // seriesVersion() at the start of the request.
+        std::uint64_t version{0};
+    };
+
+    CandleBlockStore() = default;
+
+    std::optional<std::size_t> latest(Series& series, std::size_t limit, std::string& out);
+    std::optional<std::size_t> range(Series& series,
+                                     std::int64_t fromTs,
+                                     std::int64_t toTs,
+                                     std::size_t limit,
+                                     std::string& out);
+
+    BlockPtr block(Series& series, std::int64_t index);
+    Block build(const Series& series, std::int64_t start, std::int64_t sealedAt) const;
+    std::optional<std::int64_t> floor(const Series& series);
+    void store(const std::string& key, BlockPtr block);
+
+    mutable std::mutex mutex_;
+    std::list<Node> lru_;  // most recently used first
+    std::unordered_map<std::string, std::list<Node>::iterator> index_;
+    std::unordered_map<std::string, Floor> floors_;
+    std::size_t bytes_{0};
+    common::SingleFlight<Block> builds_;
+};
+
+}  // namespace ttp::api
@@ -20,15 +20,22 @@
 #include <utility>
 #include <vector>
 
+#include "api/CandleBlocks.hpp"
+#include "api/SeriesVersion.hpp"
 #include "app/ServiceLocator.hpp"
 #include "common/Metrics.hpp"
+#include "common/SingleFlight.hpp"
+#include "common/Trace.hpp"
 #include "domain/Models.hpp"
 #include "domain/Ports.hpp"
+#include "domain/Types.h"
 #include "http/ErrorCodes.hpp"
 #include "http/HttpJson.hpp"
 #include "http/json_error.hpp"
 #include "http/QueryParams.hpp"
 #include "http/Validation.hpp"
+#include "indicators/IndicatorCache.h"
+#include "indicators/IndicatorSpec.h"
 #include "logging/Log.h"
 
 #include <boost/json/array.hpp>
@@ -45,6 +52,7 @@ constexpr char kSymbolsRouteKey[] = "GET /api/v1/symbols";
 constexpr char kSymbolIntervalsRouteKey[] = "GET /api/v1/symbols/:symbol/intervals";
 constexpr char kCandlesRouteKey[] = "GET /api/v1/candles";
 constexpr char kIntervalsRouteKey[] = "GET /api/v1/intervals";
+constexpr char kIndicatorsRouteKey[] = "GET /api/v1/indicators";
 
 struct HttpLimitState {
     std::atomic<std::int32_t> defaultLimit{600};
@@ -86,6 +94,21 @@ std::vector<std::string> liveIntervalsSnapshot() {
     return liveIntervalsStorage();
 }
 
+std::mutex& liveCandleSourceMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::shared_ptr<const domain::contracts::ILiveCandleSource>& liveCandleSourceStorage() {
+    static std::shared_ptr<const domain::contracts::ILiveCandleSource> source;
+    return source;
+}
+
+std::shared_ptr<const domain::contracts::ILiveCandleSource> liveCandleSourceSnapshot() {
+    std::lock_guard<std::mutex> lock(liveCandleSourceMutex());
+    return liveCandleSourceStorage();
+}
+
 std::int64_t normalize_timestamp_ms(std::int64_t ts) {
     if (ts > 0 && ts < kMillisecondsThreshold) {
         return ts * 1000LL;
@@ -111,7 +134,7 @@ std::string to_upper_copy(std::string_view value) {
     return upper;
 }
 
-bool parse_active_filter(std::optional<std::string> raw) {
+bool parse_active_filter(std::optional<std::string_view> raw) {
     if (!raw) {
         return true;
     }
@@ -126,7 +149,7 @@ bool parse_active_filter(std::optional<std::string> raw) {
     return true;
 }
 
-bool parse_boolean(std::optional<std::string> raw, bool defaultValue) {
+bool parse_boolean(std::optional<std::string_view> raw, bool defaultValue) {
     if (!raw) {
         return defaultValue;
     }
@@ -227,13 +250,6 @@ const domain::contracts::ICandleReadRepo& repo() {
     return *repoHandle;
 }
 
-double sanitize_value(double value) {
-    if (std::isfinite(value)) {
-        return value;
-    }
-    return 0.0;
-}
-
 std::optional<bool> lookup_symbol(const std::string& symbol) {
     const auto* repoHandle = app::ServiceLocator::instance().candleReadRepo();
     if (!repoHandle) {
@@ -297,6 +313,505 @@ std::string escapeJsonString(std::string_view value) {
     return escaped;
 }
 
+std::int32_t max_http_limit() {
+    return std::max<std::int32_t>(1, httpLimitState().maxLimit.load(std::memory_order_relaxed));
+}
+
+struct CandleQuery {
+    std::string symbol;
+    domain::contracts::Interval interval{domain::contracts::Interval::Unknown};
+    std::string intervalLabel;
+    std::int32_t limit{0};
+    bool fromProvided{false};
+    bool toProvided{false};
+    std::int64_t fromMs{0};
+    std::int64_t toMs{0};
+    // Set by load_candles when the live source answered instead of the repository.
+    bool servedFromMemory{false};
+    // seriesVersion() of the series, read once before the repository.
+    std::uint64_t version{0};
+};
+
+// Validates symbol/interval/limit/from/to the way /api/v1/candles does. On
+// failure the error has already been written to `response`.
+std::optional<CandleQuery> parse_candle_query(const Request& request, const char* handler, Response& response) {
+    CandleQuery query;
+
+    const auto symbolOpt = ttp::http::opt_string(request, "symbol");
+    if (!symbolOpt || symbolOpt->empty()) {
+        LOG_WARN(kLogCategory,
+                 "%s missing symbol query=%s",
+                 handler,
+                 std::string(request.query()).c_str());
+        ttp::http::json_error(response, 400, ttp::http::errors::symbol_required);
+        return std::nullopt;
+    }
+    query.symbol = *symbolOpt;
+
+    const auto intervalParam = ttp::http::opt_string(request, "interval");
+    if (!intervalParam || !ttp::http::validation::is_valid_interval(*intervalParam)) {
+        LOG_WARN(kLogCategory,
+                 "%s invalid interval query=%s",
+                 handler,
+                 std::string(request.query()).c_str());
+        ttp::http::json_error(response, 400, ttp::http::errors::interval_invalid);
+        return std::nullopt;
+    }
+
+    query.interval = domain::contracts::intervalFromString(*intervalParam);
+    query.intervalLabel = domain::contracts::intervalToString(query.interval);
+
+    const auto maxLimitConfig = max_http_limit();
+    std::int32_t defaultLimitConfig = std::max<std::int32_t>(
+        1, httpLimitState().defaultLimit.load(std::memory_order_relaxed));
+    if (defaultLimitConfig > maxLimitConfig) {
+        defaultLimitConfig = maxLimitConfig;
+    }
+
+    std::int32_t limitValue = defaultLimitConfig;
+    if (const auto rawLimit = ttp::http::opt_string(request, "limit")) {
+        if (const auto parsed = ttp::http::parse_int(*rawLimit)) {
+            limitValue = *parsed;
+        }
+        else {
+            LOG_WARN(kLogCategory,
+                     "%s invalid limit query=%s",
+                     handler,
+                     std::string(request.query()).c_str());
+            ttp::http::json_error(response, 400, ttp::http::errors::limit_invalid);
+            return std::nullopt;
+        }
+    }
+
+    if (limitValue < 1) {
+        limitValue = 1;
+    }
+    if (limitValue > maxLimitConfig) {
+        // Clamp to configured max per API specification instead of returning an error.
+        limitValue = maxLimitConfig;
+    }
+    query.limit = limitValue;
+
+    if (const auto fromRaw = ttp::http::opt_string(request, "from")) {
+        query.fromProvided = true;
+        if (const auto parsed = ttp::http::parse_int64(*fromRaw)) {
+            query.fromMs = normalize_timestamp_ms(*parsed);
+        }
+        else {
+            LOG_WARN(kLogCategory,
+                     "%s invalid from query=%s",
+                     handler,
+                     std::string(request.query()).c_str());
+            ttp::http::json_error(response, 400, ttp::http::errors::time_range_invalid);
+            return std::nullopt;
+        }
+    }
+
+    if (const auto toRaw = ttp::http::opt_string(request, "to")) {
+        query.toProvided = true;
+        if (const auto parsed = ttp::http::parse_int64(*toRaw)) {
+            query.toMs = normalize_timestamp_ms(*parsed);
+        }
+        else {
+            LOG_WARN(kLogCategory,
+                     "%s invalid to query=%s",
+                     handler,
+                     std::string(request.query()).c_str());
+            ttp::http::json_error(response, 400, ttp::http::errors::time_range_invalid);
+            return std::nullopt;
+        }
+    }
+
+    if ((query.fromProvided && query.fromMs < 0) || (query.toProvided && query.toMs < 0)) {
+        LOG_WARN(kLogCategory,
+                 "%s negative timestamp query=%s",
+                 handler,
+                 std::string(request.query()).c_str());
+        ttp::http::json_error(response, 400, ttp::http::errors::time_range_invalid);
+        return std::nullopt;
+    }
+
+    if (query.fromProvided && query.toProvided && query.fromMs > query.toMs) {
+        LOG_WARN(kLogCategory,
+                 "%s from greater than to query=%s",
+                 handler,
+                 std::string(request.query()).c_str());
+        ttp::http::json_error(response, 400, ttp::http::errors::time_range_invalid);
+        return std::nullopt;
+    }
+
+    return query;
+}
+
+// Asks the live source first: sub-minute candles live in memory until their
+// retention runs out, and the newest of them may not have reached the
+// repository yet. Returns false when it cannot answer `query` in full.
+bool load_live_candles(CandleQuery& query, std::size_t limit, std::vector<domain::contracts::Candle>& candles) {
+    bool servedFromMemory = false;
+    if (const auto liveSource = liveCandleSourceSnapshot()) {
+        servedFromMemory = liveSource->tryGetCandles(query.symbol,
+                                                     query.interval,
+                                                     query.fromProvided ? query.fromMs : 0,
+                                                     query.toProvided ? query.toMs : 0,
+                                                     limit,
+                                                     candles);
+    }
+    query.servedFromMemory = servedFromMemory;
+    return servedFromMemory;
+}
+
+// Reads at most `limit` candles for `query` from the repository. Range bounds
+// are clamped to what the repository holds. Returns false after writing a 500.
+bool load_repo_candles(CandleQuery& query,
+                       std::size_t limit,
+                       std::vector<domain::contracts::Candle>& candles,
+                       const char* handler,
+                       Response& response) {
+    const auto* repoHandle = app::ServiceLocator::instance().candleReadRepo();
+    const bool hasRange = query.fromProvided || query.toProvided;
+
+    bool skipQuery = false;
+    if (hasRange && repoHandle) {
+        try {
+            if (const auto minMax = repoHandle->get_min_max_ts(query.symbol, query.intervalLabel)) {
+                const auto minTs = minMax->first;
+                const auto maxTs = minMax->second;
+                if (query.fromProvided) {
+                    const auto clampedFrom = std::max(query.fromMs, minTs);
+                    if (clampedFrom != query.fromMs) {
+                        query.fromMs = clampedFrom;
+                    }
+                }
+                if (query.toProvided) {
+                    const auto clampedTo = std::min(query.toMs, maxTs);
+                    if (clampedTo != query.toMs) {
+                        query.toMs = clampedTo;
+                    }
+                }
+                if (query.fromProvided && query.toProvided && query.fromMs > query.toMs) {
+                    skipQuery = true;
+                }
+            }
+        }
+        catch (const std::exception& ex) {
+            LOG_WARN(kLogCategory,
+                     "%s clamp lookup failed symbol=%s interval=%s error=%s",
+                     handler,
+                     query.symbol.c_str(),
+                     query.intervalLabel.c_str(),
+                     ex.what());
+        }
+    }
+
+    if (!skipQuery) {
+        try {
+            const auto fromQuery = query.fromProvided ? query.fromMs : 0;
+            const auto toQuery = query.toProvided ? query.toMs : 0;
+            candles = repo().getCandles(query.symbol, query.interval, fromQuery, toQuery, limit);
+        }
+        catch (const std::exception& ex) {
+            LOG_ERROR(kLogCategory,
+                      "%s database error symbol=%s interval=%s error=%s",
+                      handler,
+                      query.symbol.c_str(),
+                      query.intervalLabel.c_str(),
+                      ex.what());
+            ttp::http::json_error(response, 500, ttp::http::errors::internal_error);
+            return false;
+        }
+    }
+    return true;
+}
+
+void sort_and_trim(std::vector<domain::contracts::Candle>& candles, std::size_t limit) {
+    std::sort(candles.begin(), candles.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.ts < rhs.ts;
+    });
+
+    if (!candles.empty() && candles.size() > limit) {
+        const auto overflow = candles.size() - limit;
+        candles.erase(
+            candles.begin(),
+            candles.begin()
+                + static_cast<std::vector<domain::contracts::Candle>::difference_type>(overflow));
+    }
+}
+
+// Reads at most `limit` candles for `query`, oldest first: the live source
+// when it covers the request, the repository otherwise. Returns false after
+// writing a 500.
+bool load_candles(CandleQuery& query,
+                  std::size_t limit,
+                  std::vector<domain::contracts::Candle>& candles,
+                  const char* handler,
+                  Response& response) {
+    if (!load_live_candles(query, limit, candles)
+        && !load_repo_candles(query, limit, candles, handler, response)) {
+        return false;
+    }
+    sort_and_trim(candles, limit);
+    return true;
+}
+
+void write_indicator_payload(Response& response,
+                             const CandleQuery& query,
+                             const ::indicators::IndicatorSpec& spec,
+                             const std::vector<std::int64_t>& openTimes,
+                             const std::vector<std::vector<double>>& outputs,
+                             std::size_t first) {
+    boost::json::object payload;
+    payload["symbol"] = query.symbol;
+    payload["interval"] = query.intervalLabel;
+    payload["type"] = ::indicators::indicatorKindName(spec.kind);
+
+    boost::json::array paramsJson;
+    paramsJson.reserve(spec.params.size());
+    for (const auto value : spec.params) {
+        if (std::floor(value) == value) {
+            paramsJson.emplace_back(static_cast<std::int64_t>(value));
+        }
+        else {
+            paramsJson.emplace_back(value);
+        }
+    }
+    payload["params"] = std::move(paramsJson);
+
+    boost::json::array columnNames;
+    columnNames.emplace_back("ts");
+    for (const auto* name : ::indicators::indicatorOutputNames(spec.kind)) {
+        columnNames.emplace_back(name);
+    }
+    payload["columns"] = std::move(columnNames);
+
+    boost::json::array data;
+    data.reserve(openTimes.size() - first);
+    for (std::size_t i = first; i < openTimes.size(); ++i) {
+        boost::json::array row;
+        row.reserve(outputs.size() + 1U);
+        row.emplace_back(openTimes[i]);
+        for (const auto& series : outputs) {
+            if (std::isfinite(series[i])) {
+                row.emplace_back(series[i]);
+            }
+            else {
+                row.emplace_back(nullptr);
+            }
+        }
+        data.emplace_back(std::move(row));
+    }
+    payload["data"] = std::move(data);
+
+    ttp::http::write_json(response, payload);
+}
+
+common::SingleFlight<Response>& candleFlights() {
+    static common::SingleFlight<Response> flights;
+    return flights;
+}
+
+// Everything that selects the rows of a /candles response, after validation
+// and clamping of the limit, plus the series version: a request arriving after
+// a write starts its own read instead of joining one begun before it. With
+// the stored version this holds for writes from other processes too.
+std::string candle_flight_key(const CandleQuery& query) {
+    std::string key = query.symbol;
+    key += '|';
+    key += query.intervalLabel;
+    key += '|';
+    key += std::to_string(query.limit);
+    key += '|';
+    if (query.fromProvided) {
+        key += std::to_string(query.fromMs);
+    }
+    key += '|';
+    if (query.toProvided) {
+        key += std::to_string(query.toMs);
+    }
+    key += '|';
+    key += std::to_string(query.version);
+    return key;
+}
+
+// In-process versions restart at 0 with the process, so ETags built on them
+// also carry its start time.
+std::int64_t process_epoch_ms() {
+    static const auto epoch = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                  std::chrono::system_clock::now().time_since_epoch())
+                                  .count();
+    return epoch;
+}
+
+// Strong validator over the normalized query and the series version, which
+// was read before the repository so a concurrent write can only make it
+// older. A version from the store also moves with writes from other
+// processes and survives restarts.
+std::string candle_etag(const CandleQuery& query) {
+    auto material = candle_flight_key(query);
+    if ((query.version & 1U) == 0U) {
+        material += '|';
+        material += std::to_string(process_epoch_ms());
+    }
+    std::uint64_t hash = 1469598103934665603ULL;
+    for (const unsigned char ch : material) {
+        hash ^= ch;
+        hash *= 1099511628211ULL;
+    }
+    std::ostringstream oss;
+    oss << '"' << std::hex << std::setw(16) << std::setfill('0') << hash << '"';
+    return oss.str();
+}
+
+// A non-empty range is cached for a day once it ends before the last closed
+// candle and lies inside what the repository holds: the ingestor may still
+// rewrite newer candles, and rows outside the stored span may yet be
+// backfilled. Not `immutable`, since a backfill may still correct stored
+// history; the client then revalidates against the ETag. Everything else is
+// revalidated on every use.
+std::string candle_cache_control(const CandleQuery& query, bool nonEmpty) {
+    constexpr const char* kRevalidate = "no-cache";
+    const auto intervalMs = domain::interval_from_label(query.intervalLabel).ms;
+    if (!nonEmpty || !query.fromProvided || !query.toProvided || intervalMs <= 0) {
+        return kRevalidate;
+    }
+    const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count();
+    const auto lastClosedOpen = nowMs / intervalMs * intervalMs - intervalMs;
+    if (query.toMs >= lastClosedOpen) {
+        return kRevalidate;
+    }
+
+    const auto* repoHandle = app::ServiceLocator::instance().candleReadRepo();
+    if (!repoHandle) {
+        return kRevalidate;
+    }
+    try {
+        const auto minMax = repoHandle->get_min_max_ts(query.symbol, query.intervalLabel);
+        if (minMax && minMax->first <= query.fromMs && minMax->second >= query.toMs) {
+            return "public, max-age=86400";
+        }
+    }
+    catch (const std::exception& ex) {
+        LOG_WARN(kLogCategory,
+                 "Controllers::candles cache-control lookup failed symbol=%s interval=%s error=%s",
+                 query.symbol.c_str(),
+                 query.intervalLabel.c_str(),
+                 ex.what());
+    }
+    return kRevalidate;
+}
+
+// Whether the live source, not the repository, would answer `query`; those
+// responses carry no validator.
+bool live_source_serves(const CandleQuery& query) {
+    const auto liveSource = liveCandleSourceSnapshot();
+    if (!liveSource) {
+        return false;
+    }
+    std::vector<domain::contracts::Candle> scratch;
+    return liveSource->tryGetCandles(query.symbol,
+                                     query.interval,
+                                     query.fromProvided ? query.fromMs : 0,
+                                     query.toProvided ? query.toMs : 0,
+                                     static_cast<std::size_t>(query.limit),
+                                     scratch);
+}
+
+Response render_candles(CandleQuery query) {
+    Response response{};
+    // load_repo_candles clamps the range, so the validators are taken from
+    // the query as requested.
+    const auto etag = candle_etag(query);
+    const CandleQuery requested = query;
+    const std::string& symbol = query.symbol;
+    const std::string& intervalLabel = query.intervalLabel;
+    const std::int32_t limitValue = query.limit;
+    const auto limit = static_cast<std::size_t>(limitValue);
+    const bool hasRange = query.fromProvided || query.toProvided;
+
+    std::string body;
+    body.reserve(64U + symbol.size());
+    body.append(R"({"symbol":")").append(escapeJsonString(symbol));
+    body.append(R"(","interval":")").append(escapeJsonString(intervalLabel)).append(R"(","data":[)");
+
+    // Live candles are encoded as they are; repository reads go through the
+    // pre-encoded closed blocks when they can and fall back to a plain read.
+    std::size_t count = 0;
+    std::vector<domain::contracts::Candle> candles;
+    std::optional<std::size_t> assembled;
+    if (!load_live_candles(query, limit, candles)) {
+        if (const auto* repoHandle = app::ServiceLocator::instance().candleReadRepo()) {
+            assembled = CandleBlockStore::instance().assemble(*repoHandle,
+                                                              symbol,
+                                                              query.interval,
+                                                              query.fromProvided ? query.fromMs : 0,
+                                                              query.toProvided ? query.toMs : 0,
+                                                              limit,
+                                                              body);
+        }
+        if (!assembled && !load_repo_candles(query, limit, candles, "Controllers::candles", response)) {
+            return response;
+        }
+    }
+    if (assembled) {
+        count = *assembled;
+    }
+    else {
+        sort_and_trim(candles, limit);
+        body.reserve(body.size() + candles.size() * 96U);
+        for (const auto& candle : candles) {
+            appendCandleRow(body, candle);
+        }
+        count = candles.size();
+    }
+
+    if (count == 0) {
+        if (const auto exists = lookup_symbol(symbol); exists.has_value() && !*exists) {
+            ttp::http::json_error(response, 404, ttp::http::errors::symbol_not_found);
+            return response;
+        }
+    }
+
+    if (body.back() == ',') {
+        body.pop_back();
+    }
+    body.append("]}");
+    response = makeJsonResponse(200, "OK", std::move(body));
+    response.contentType = "application/json; charset=utf-8";
+    // In-memory candles change on every trade without a repository write, so
+    // neither the Router nor any client may cache them against the version.
+    if (query.servedFromMemory) {
+        response.headers.emplace_back("Cache-Control", "no-store");
+    }
+    else {
+        response.headers.emplace_back("ETag", etag);
+        response.headers.emplace_back("Cache-Control", candle_cache_control(requested, count > 0));
+    }
+
+    const auto fromLog = hasRange ? query.fromMs : 0;
+    const auto toLog = hasRange ? query.toMs : 0;
+    LOG_INFO(kLogCategory,
+             "Controllers::candles symbol=%s interval=%s from=%lld to=%lld limit=%d result=%zu",
+             symbol.c_str(),
+             intervalLabel.c_str(),
+             static_cast<long long>(fromLog),
+             static_cast<long long>(toLog),
+             limitValue,
+             count);
+
+    return response;
+}
+
+// last_msg_age_ms holds the age of the stalest live stream when it was last
+// set (see BinanceWsClient); the time since then is added here.
+double last_msg_age_ms(const common::metrics::Registry::GaugeSnapshot& gauge,
+                       std::chrono::steady_clock::time_point now) {
+    if (gauge.updatedAt == std::chrono::steady_clock::time_point{}) {
+        return gauge.value;
+    }
+    return gauge.value + std::chrono::duration<double, std::milli>(now - gauge.updatedAt).count();
+}
+
 }  // namespace
 
 Response healthz() {
@@ -314,14 +829,7 @@ Response healthz() {
 
     double lastMsgAgeMs = 0.0;
     if (const auto it = snapshot.gauges.find("last_msg_age_ms"); it != snapshot.gauges.end()) {
-        if (it->second.updatedAt != std::chrono::steady_clock::time_point{}) {
-            lastMsgAgeMs = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(snapshot.capturedAt
-                                                                                                - it->second.updatedAt)
-                               .count();
-        }
-        else {
-            lastMsgAgeMs = it->second.value;
-        }
+        lastMsgAgeMs = last_msg_age_ms(it->second, snapshot.capturedAt);
     }
 
     double wsState = 1.0;
@@ -380,12 +888,12 @@ Response symbols(const Request& request) {
     const bool activeOnly = parse_active_filter(ttp::http::opt_string(request, "active"));
     const auto queryOpt = ttp::http::opt_string(request, "q");
     const std::string queryLower = queryOpt ? to_lower_copy(*queryOpt) : std::string{};
-    const char* queryLog = queryOpt ? queryOpt->c_str() : "";
+    const std::string queryLog{queryOpt.value_or(std::string_view{})};
 
     LOG_INFO(kLogCategory,
              "Controllers::symbols activeOnly=%s query=\"%s\"",
              activeOnly ? "true" : "false",
-             queryLog);
+             queryLog.c_str());
 
     struct SymbolEntry {
         std::string symbol;
@@ -481,7 +989,7 @@ Response symbols(const Request& request) {
               catalogSymbols.size(),
               merged.size(),
               filtered.size(),
-              queryLog);
+              queryLog.c_str());
 
     boost::json::array items;
     items.reserve(filtered.size());
@@ -519,7 +1027,7 @@ Response makeIntervalsResponse(const Request& request,
              symbol.c_str(),
              includeRanges ? "true" : "false");
 
-    static constexpr std::array<std::string_view, 4> kSupportedIntervals{"1m", "5m", "1h", "1d"};
+    static constexpr std::array<std::string_view, 7> kSupportedIntervals{"1s", "5s", "15s", "1m", "5m", "1h", "1d"};
 
     const auto liveSymbols = liveSymbolsSnapshot();
     const bool isLiveSymbol = std::find(liveSymbols.begin(), liveSymbols.end(), symbol) != liveSymbols.end();
@@ -719,225 +1227,190 @@ Response intervals(const Request& request) {
     if (!symbolOpt || symbolOpt->empty()) {
         LOG_WARN(kLogCategory,
                  "Controllers::intervals missing symbol query=%s",
-                 request.query.c_str());
+                 std::string(request.query()).c_str());
         ttp::http::json_error(response, 400, ttp::http::errors::symbol_required);
         return response;
     }
 
-    return makeIntervalsResponse(request, *symbolOpt, "Controllers::intervals");
+    return makeIntervalsResponse(request, std::string(*symbolOpt), "Controllers::intervals");
 }
 
 Response candles(const Request& request) {
-    common::metrics::Registry::ScopedTimer requestTimer(kCandlesRouteKey);
+    static auto& route = common::metrics::Registry::instance().route(kCandlesRouteKey);
+    common::metrics::Registry::ScopedTimer requestTimer(route);
+    static auto& executed = common::metrics::Registry::instance().counter("candles_singleflight.executed");
+    static auto& coalesced = common::metrics::Registry::instance().counter("candles_singleflight.coalesced");
 
     Response response{};
 
-    const auto symbolOpt = ttp::http::opt_string(request, "symbol");
-    if (!symbolOpt || symbolOpt->empty()) {
-        LOG_WARN(kLogCategory,
-                 "Controllers::candles missing symbol query=%s",
-                 request.query.c_str());
-        ttp::http::json_error(response, 400, ttp::http::errors::symbol_required);
+    auto query = parse_candle_query(request, "Controllers::candles", response);
+    if (!query) {
         return response;
     }
-    const std::string symbol = *symbolOpt;
-
-    const auto intervalParam = ttp::http::opt_string(request, "interval");
-    if (!intervalParam || !ttp::http::validation::is_valid_interval(*intervalParam)) {
-        LOG_WARN(kLogCategory,
-                 "Controllers::candles invalid interval query=%s",
-                 request.query.c_str());
-        ttp::http::json_error(response, 400, ttp::http::errors::interval_invalid);
-        return response;
-    }
-
-    const auto interval = domain::contracts::intervalFromString(*intervalParam);
-    const std::string intervalLabel = domain::contracts::intervalToString(interval);
-    const auto* repoHandle = app::ServiceLocator::instance().candleReadRepo();
-
-    const auto maxLimitConfig = std::max<std::int32_t>(
-        1, httpLimitState().maxLimit.load(std::memory_order_relaxed));
-    std::int32_t defaultLimitConfig = std::max<std::int32_t>(
-        1, httpLimitState().defaultLimit.load(std::memory_order_relaxed));
-    if (defaultLimitConfig > maxLimitConfig) {
-        defaultLimitConfig = maxLimitConfig;
-    }
-
-    std::int32_t limitValue = defaultLimitConfig;
-    if (const auto rawLimit = ttp::http::opt_string(request, "limit")) {
-        if (const auto parsed = ttp::http::opt_int(request, "limit")) {
-            limitValue = *parsed;
-        }
-        else {
-            LOG_WARN(kLogCategory,
-                     "Controllers::candles invalid limit query=%s",
-                     request.query.c_str());
-            ttp::http::json_error(response, 400, ttp::http::errors::limit_invalid);
-            return response;
+    // Read once, before the repository, for the validator and the flight key.
+    query->version =
+        seriesVersion(app::ServiceLocator::instance().candleReadRepo(), query->symbol, query->intervalLabel);
+
+    // Revalidation is answered before single-flight: 304s depend on the
+    // client's validator and must not be shared. Without the rows it is not
+    // known whether the response was empty, so a 304 never upgrades it to a
+    // cacheable max-age.
+    if (const auto ifNoneMatch = ttp::http::opt_header(request, "if-none-match")) {
+        const auto etag = candle_etag(*query);
+        if (ttp::http::etag_matches(*ifNoneMatch, etag) && !live_source_serves(*query)) {
+            static auto& notModified = common::metrics::Registry::instance().counter("candles.not_modified");
+            notModified.add();
+            return Response{304,
+                            "Not Modified",
+                            std::string{},
+                            "application/json",
+                            {{"ETag", etag}, {"Cache-Control", candle_cache_control(*query, false)}}};
         }
     }
 
-    if (limitValue < 1) {
-        limitValue = 1;
-    }
-    if (limitValue > maxLimitConfig) {
-        // Clamp to configured max per API specification instead of returning an error.
-        limitValue = maxLimitConfig;
-    }
+    // Identical queries already being answered (e.g. every chart re-polling
+    // right after a candle closes) wait for that answer instead of reading
+    // the repository again.
+    const auto outcome = candleFlights().run(candle_flight_key(*query), [&query]() {
+        return render_candles(*query);
+    });
+    (outcome.shared ? coalesced : executed).add();
+    return *outcome.value;
+}
 
-    bool fromProvided = false;
-    bool toProvided = false;
-    std::int64_t fromMs = 0;
-    std::int64_t toMs = 0;
+Response indicators(const Request& request) {
+    static auto& route = common::metrics::Registry::instance().route(kIndicatorsRouteKey);
+    common::metrics::Registry::ScopedTimer requestTimer(route);
 
-    if (const auto fromRaw = ttp::http::opt_string(request, "from")) {
-        fromProvided = true;
-        if (const auto parsed = ttp::http::opt_int64(request, "from")) {
-            fromMs = normalize_timestamp_ms(*parsed);
-        }
-        else {
-            LOG_WARN(kLogCategory,
-                     "Controllers::candles invalid from query=%s",
-                     request.query.c_str());
-            ttp::http::json_error(response, 400, ttp::http::errors::time_range_invalid);
-            return response;
-        }
-    }
+    Response response{};
 
-    if (const auto toRaw = ttp::http::opt_string(request, "to")) {
-        toProvided = true;
-        if (const auto parsed = ttp::http::opt_int64(request, "to")) {
-            toMs = normalize_timestamp_ms(*parsed);
-        }
-        else {
-            LOG_WARN(kLogCategory,
-                     "Controllers::candles invalid to query=%s",
-                     request.query.c_str());
-            ttp::http::json_error(response, 400, ttp::http::errors::time_range_invalid);
-            return response;
-        }
+    auto query = parse_candle_query(request, "Controllers::indicators", response);
+    if (!query) {
+        return response;
     }
 
-    if ((fromProvided && fromMs < 0) || (toProvided && toMs < 0)) {
+    const auto typeParam = ttp::http::opt_string(request, "type");
+    const auto kind = typeParam ? ::indicators::indicatorKindFromString(to_lower_copy(*typeParam)) : std::nullopt;
+    if (!kind) {
         LOG_WARN(kLogCategory,
-                 "Controllers::candles negative timestamp query=%s",
-                 request.query.c_str());
-        ttp::http::json_error(response, 400, ttp::http::errors::time_range_invalid);
+                 "Controllers::indicators invalid type query=%s",
+                 std::string(request.query()).c_str());
+        ttp::http::json_error(response, 400, ttp::http::errors::indicator_type_invalid);
         return response;
     }
 
-    if (fromProvided && toProvided && fromMs > toMs) {
+    ::indicators::IndicatorSpec spec;
+    spec.kind = *kind;
+    auto params = ::indicators::parseIndicatorParams(*kind, ttp::http::opt_string(request, "params").value_or(""));
+    if (!params) {
         LOG_WARN(kLogCategory,
-                 "Controllers::candles from greater than to query=%s",
-                 request.query.c_str());
-        ttp::http::json_error(response, 400, ttp::http::errors::time_range_invalid);
+                 "Controllers::indicators invalid params query=%s",
+                 std::string(request.query()).c_str());
+        ttp::http::json_error(response, 400, ttp::http::errors::indicator_params_invalid);
         return response;
     }
-
-    const bool hasRange = fromProvided || toProvided;
-
-    bool skipQuery = false;
-    if (hasRange && repoHandle) {
-        try {
-            if (const auto minMax = repoHandle->get_min_max_ts(symbol, intervalLabel)) {
-                const auto minTs = minMax->first;
-                const auto maxTs = minMax->second;
-                if (fromProvided) {
-                    const auto clampedFrom = std::max(fromMs, minTs);
-                    if (clampedFrom != fromMs) {
-                        fromMs = clampedFrom;
-                    }
-                }
-                if (toProvided) {
-                    const auto clampedTo = std::min(toMs, maxTs);
-                    if (clampedTo != toMs) {
-                        toMs = clampedTo;
-                    }
-                }
-                if (fromProvided && toProvided && fromMs > toMs) {
-                    skipQuery = true;
+    spec.params = std::move(*params);
+
+    // Read extra candles ahead of the requested window so the first returned
+    // value is already settled rather than NaN or seed-biased.
+    const auto intervalMs = domain::interval_from_label(query->intervalLabel).ms;
+    const auto warmup = ::indicators::indicatorWarmupBars(spec, intervalMs);
+    const auto limit = static_cast<std::size_t>(query->limit);
+
+    // Latest-N reads of a live series come from the rolling cache, which the
+    // ingestor advances on every closed candle.
+    const bool hasRange = query->fromProvided || query->toProvided;
+    const auto seriesId = ::indicators::seriesKey(query->symbol, query->intervalLabel);
+    auto& cache = ::indicators::IndicatorCache::instance();
+    if (!hasRange && cache.tracks(seriesId)) {
+        static auto& hits = common::metrics::Registry::instance().counter("indicator_cache.hits");
+        static auto& misses = common::metrics::Registry::instance().counter("indicator_cache.misses");
+        auto snapshot = cache.latest(seriesId, spec, limit);
+        const bool cached = snapshot.has_value();
+        if (cached) {
+            hits.add();
+        }
+        else {
+            misses.add();
+            const auto capacity = std::max(limit, static_cast<std::size_t>(max_http_limit()));
+            std::vector<domain::contracts::Candle> candles;
+            if (!load_candles(*query, capacity + warmup, candles, "Controllers::indicators", response)) {
+                return response;
+            }
+            const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   std::chrono::system_clock::now().time_since_epoch())
+                                   .count();
+            std::vector<::indicators::IndicatorBar> bars;
+            bars.reserve(candles.size());
+            for (const auto& candle : candles) {
+                const auto openTime = normalize_timestamp_ms(candle.ts);
+                if (openTime + intervalMs > nowMs) {
+                    // Still open; the live feed supplies it as a partial.
+                    continue;
                 }
+                bars.push_back(::indicators::IndicatorBar{openTime, candle.h, candle.l, candle.c, candle.v});
             }
+            snapshot = cache.seed(seriesId, spec, bars, capacity, limit);
         }
-        catch (const std::exception& ex) {
-            LOG_WARN(kLogCategory,
-                     "Controllers::candles clamp lookup failed symbol=%s interval=%s error=%s",
-                     symbol.c_str(),
-                     intervalLabel.c_str(),
-                     ex.what());
-        }
-    }
 
-    std::vector<domain::contracts::Candle> candles;
-    if (!skipQuery) {
-        try {
-            const auto limitSize = static_cast<std::size_t>(limitValue);
-            const auto fromQuery = fromProvided ? fromMs : 0;
-            const auto toQuery = toProvided ? toMs : 0;
-            candles = repo().getCandles(symbol, interval, fromQuery, toQuery, limitSize);
-        }
-        catch (const std::exception& ex) {
-            LOG_ERROR(kLogCategory,
-                      "Controllers::candles database error symbol=%s interval=%s error=%s",
-                      symbol.c_str(),
-                      intervalLabel.c_str(),
-                      ex.what());
-            ttp::http::json_error(response, 500, ttp::http::errors::internal_error);
-            return response;
-        }
+        write_indicator_payload(response, *query, spec, snapshot->openTimes, snapshot->outputs, 0);
+        LOG_INFO(kLogCategory,
+                 "Controllers::indicators symbol=%s interval=%s type=%s cached=%d partial=%d result=%zu",
+                 query->symbol.c_str(),
+                 query->intervalLabel.c_str(),
+                 ::indicators::indicatorKindName(spec.kind),
+                 cached ? 1 : 0,
+                 snapshot->partial ? 1 : 0,
+                 snapshot->openTimes.size());
+        return response;
     }
 
-    std::sort(candles.begin(), candles.end(), [](const auto& lhs, const auto& rhs) {
-        return lhs.ts < rhs.ts;
-    });
+    const auto requestedFrom = query->fromMs;
+    if (query->fromProvided) {
+        query->fromMs = std::max<std::int64_t>(0, requestedFrom - static_cast<std::int64_t>(warmup) * intervalMs);
+    }
 
-    if (!candles.empty() && candles.size() > static_cast<std::size_t>(limitValue)) {
-        const auto overflow = candles.size() - static_cast<std::size_t>(limitValue);
-        candles.erase(
-            candles.begin(),
-            candles.begin()
-                + static_cast<std::vector<domain::contracts::Candle>::difference_type>(overflow));
+    std::vector<domain::contracts::Candle> candles;
+    if (!load_candles(*query, limit + warmup, candles, "Controllers::indicators", response)) {
+        return response;
     }
 
     if (candles.empty()) {
-        if (const auto exists = lookup_symbol(symbol); exists.has_value() && !*exists) {
+        if (const auto exists = lookup_symbol(query->symbol); exists.has_value() && !*exists) {
             ttp::http::json_error(response, 404, ttp::http::errors::symbol_not_found);
             return response;
         }
     }
 
-    boost::json::object payload;
-    payload["symbol"] = symbol;
-    payload["interval"] = intervalLabel;
-
-    boost::json::array data;
-    data.reserve(candles.size());
-    for (const auto& candle : candles) {
-        boost::json::array row;
-        row.reserve(6);
-        row.emplace_back(normalize_timestamp_ms(candle.ts));
-        row.emplace_back(sanitize_value(candle.o));
-        row.emplace_back(sanitize_value(candle.h));
-        row.emplace_back(sanitize_value(candle.l));
-        row.emplace_back(sanitize_value(candle.c));
-        row.emplace_back(sanitize_value(candle.v));
-        data.emplace_back(std::move(row));
+    ::indicators::kernels::OhlcvColumns columns;
+    columns.resize(candles.size());
+    for (std::size_t i = 0; i < candles.size(); ++i) {
+        const auto& candle = candles[i];
+        columns.openTime[i] = normalize_timestamp_ms(candle.ts);
+        columns.open[i] = candle.o;
+        columns.high[i] = candle.h;
+        columns.low[i] = candle.l;
+        columns.close[i] = candle.c;
+        columns.volume[i] = candle.v;
     }
+    const auto outputs = ::indicators::computeIndicator(spec, columns);
 
-    payload["data"] = std::move(data);
+    std::size_t first = candles.size() > limit ? candles.size() - limit : 0;
+    if (query->fromProvided) {
+        const auto requestedBegin = std::lower_bound(columns.openTime.begin(), columns.openTime.end(), requestedFrom);
+        first = std::max(first, static_cast<std::size_t>(requestedBegin - columns.openTime.begin()));
+    }
 
-    ttp::http::write_json(response, payload);
+    write_indicator_payload(response, *query, spec, columns.openTime, outputs, first);
 
-    const auto fromLog = hasRange ? fromMs : 0;
-    const auto toLog = hasRange ? toMs : 0;
     LOG_INFO(kLogCategory,
-             "Controllers::candles symbol=%s interval=%s from=%lld to=%lld limit=%d result=%zu",
-             symbol.c_str(),
-             intervalLabel.c_str(),
-             static_cast<long long>(fromLog),
-             static_cast<long long>(toLog),
-             limitValue,
-             static_cast<std::size_t>(candles.size()));
+             "Controllers::indicators symbol=%s interval=%s type=%s warmup=%zu loaded=%zu result=%zu",
+             query->symbol.c_str(),
+             query->intervalLabel.c_str(),
+             ::indicators::indicatorKindName(spec.kind),
+             warmup,
+             candles.size(),
+             candles.size() - first);
 
     return response;
 }
@@ -967,6 +1440,13 @@ Response stats(const Request&) {
     const auto restCatchup = restCatchupIt != snapshot.counters.end() ? restCatchupIt->second.value : 0ULL;
     oss << "\"reconnect_attempts_total\":" << reconnectAttempts << ',';
     oss << "\"rest_catchup_candles_total\":" << restCatchup << ',';
+    oss << "\"log_dropped_total\":" << logging::Log::dropped_messages() << ',';
+    const auto counterValue = [&snapshot](const char* key) {
+        const auto it = snapshot.counters.find(key);
+        return it != snapshot.counters.end() ? it->second.value : 0ULL;
+    };
+    oss << "\"candles_singleflight\":{\"executed\":" << counterValue("candles_singleflight.executed")
+        << ",\"coalesced\":" << counterValue("candles_singleflight.coalesced") << "},";
 
     double wsState = 0.0;
     if (const auto it = snapshot.gauges.find("ws_state"); it != snapshot.gauges.end()) {
@@ -975,14 +1455,7 @@ Response stats(const Request&) {
 
     double lastMsgAgeMs = 0.0;
     if (const auto it = snapshot.gauges.find("last_msg_age_ms"); it != snapshot.gauges.end()) {
-        if (it->second.updatedAt != std::chrono::steady_clock::time_point{}) {
-            lastMsgAgeMs = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(snapshot.capturedAt
-                                                                                                - it->second.updatedAt)
-                               .count();
-        }
-        else {
-            lastMsgAgeMs = it->second.value;
-        }
+        lastMsgAgeMs = last_msg_age_ms(it->second, snapshot.capturedAt);
     }
 
     oss << "\"ws_state\":" << wsState << ',';
@@ -1012,10 +1485,78 @@ Response stats(const Request&) {
     return makeJsonResponse(200, "OK", oss.str());
 }
 
+Response metrics(const Request&) {
+    Response response{};
+    response.statusCode = 200;
+    response.statusText = "OK";
+    response.body = common::metrics::Registry::instance().prometheusText();
+    response.contentType = "text/plain; version=0.0.4; charset=utf-8";
+    return response;
+}
+
+Response traces(const Request& request) {
+    constexpr std::int32_t kDefaultTraceLimit = 100;
+    constexpr std::int32_t kMaxTraceLimit = 1024;
+
+    std::int32_t limitValue = kDefaultTraceLimit;
+    if (const auto rawLimit = ttp::http::opt_string(request, "limit")) {
+        if (const auto parsed = ttp::http::parse_int(*rawLimit)) {
+            limitValue = std::clamp(*parsed, 1, kMaxTraceLimit);
+        }
+        else {
+            Response response{};
+            ttp::http::json_error(response, 400, ttp::http::errors::limit_invalid);
+            return response;
+        }
+    }
+
+    const auto sampled = common::trace::recent(static_cast<std::size_t>(limitValue));
+
+    std::ostringstream oss;
+    oss << "{\"sample_every\":" << common::trace::Scope::kSampleEvery << ",\"traces\":[";
+    for (std::size_t i = 0; i < sampled.size(); ++i) {
+        const auto& trace = sampled[i];
+        if (i != 0U) {
+            oss << ',';
+        }
+        oss << "{\"symbol\":\"" << escapeJsonString(trace.symbol.data()) << "\",\"open_time\":" << trace.openTime
+            << ",\"final\":" << (trace.isFinal ? "true" : "false") << ",\"exchange_ms\":" << trace.exchangeMs;
+
+        // Absolute wall-clock stamps, then each stage's delta from the one before it.
+        std::int64_t previousNs = trace.exchangeMs * 1'000'000;
+        std::ostringstream deltas;
+        bool firstDelta = true;
+        for (std::size_t stage = 0; stage < common::trace::kStageCount; ++stage) {
+            const auto name = common::trace::stageName(static_cast<common::trace::Stage>(stage));
+            const auto stampNs = trace.stageNs[stage];
+            oss << ",\"" << name << "_ns\":";
+            if (stampNs == 0) {
+                oss << "null";
+                continue;
+            }
+            oss << stampNs;
+            if (previousNs > 0) {
+                deltas << (firstDelta ? "" : ",") << '"' << name << "\":" << (stampNs - previousNs) / 1000;
+                firstDelta = false;
+            }
+            previousNs = stampNs;
+        }
+        oss << ",\"stages_us\":{" << deltas.str() << "}}";
+    }
+    oss << "]}";
+
+    return makeJsonResponse(200, "OK", oss.str());
+}
+
 void setCandleRepository(std::shared_ptr<const domain::contracts::ICandleReadRepo> repoHandle) {
     app::ServiceLocator::instance().setCandleReadRepo(std::move(repoHandle));
 }
 
+void setLiveCandleSource(std::shared_ptr<const domain::contracts::ILiveCandleSource> source) {
+    std::lock_guard<std::mutex> lock(liveCandleSourceMutex());
+    liveCandleSourceStorage() = std::move(source);
+}
+
 void setHttpLimits(std::int32_t defaultLimit, std::int32_t maxLimit) {
     if (maxLimit < 1) {
         maxLimit = 1;
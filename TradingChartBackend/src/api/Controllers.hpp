@@ -3,23 +3,18 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "api/Request.hpp"
+
 namespace domain::contracts {
 class ICandleReadRepo;
+class ILiveCandleSource;
 }
 
 namespace ttp::api {
 
-struct Request {
-    std::string method;
-    std::string target;
-    std::string path;
-    std::string query;
-    std::string version;
-    std::string body;
-};
-
 struct Response {
     int statusCode;
     std::string statusText;
@@ -34,6 +29,8 @@ Response version();
 
 Response candles(const Request& request);
 
+Response indicators(const Request& request);
+
 Response symbols(const Request& request);
 
 Response intervals(const Request& request);
@@ -42,8 +39,15 @@ Response symbolIntervals(const Request& request, const std::string& symbol);
 
 Response stats(const Request& request);
 
+Response metrics(const Request& request);
+
+Response traces(const Request& request);
+
 void setCandleRepository(std::shared_ptr<const domain::contracts::ICandleReadRepo> repo);
 
+// Consulted before the repository for /candles; nullptr disables it.
+void setLiveCandleSource(std::shared_ptr<const domain::contracts::ILiveCandleSource> source);
+
 void setHttpLimits(std::int32_t defaultLimit, std::int32_t maxLimit);
 
 void setLiveSymbols(std::vector<std::string> symbols);
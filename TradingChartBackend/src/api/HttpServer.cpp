@@ -3,13 +3,15 @@
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <array>
 #include <cerrno>
 #include <cstring>
-#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include "common/Log.hpp"
@@ -39,6 +41,8 @@ HttpServer::~HttpServer() { stop(); }
 
 void HttpServer::setCorsConfig(CorsConfig config) { corsConfig_ = std::move(config); }
 
+void HttpServer::setAdminToken(std::string token) { router_.setAdminToken(std::move(token)); }
+
 void HttpServer::start() {
     bool expected = false;
     if (!running_.compare_exchange_strong(expected, true)) {
@@ -154,87 +158,67 @@ void HttpServer::workerLoop(std::size_t workerId) {
 }
 
 void HttpServer::handleClient(int clientFd) {
-    std::string request;
-    request.reserve(1024);
-    char buffer[1024];
-
-    while (request.find("\r\n\r\n") == std::string::npos) {
-        const auto bytes = ::recv(clientFd, buffer, sizeof(buffer), 0);
+    // The head is received straight into the buffer the Request keeps and
+    // parses in place; only the new bytes are scanned for its end.
+    constexpr std::size_t kMaxRequestHead = 8192 + 1024;
+    std::string request(kMaxRequestHead, '\0');
+    std::size_t received = 0;
+    while (received < request.size()) {
+        const auto bytes = ::recv(clientFd, request.data() + received, request.size() - received, 0);
         if (bytes <= 0) {
             break;
         }
-        request.append(buffer, static_cast<std::size_t>(bytes));
-        if (request.size() > 8192) {
+        const auto scanFrom = received > 3 ? received - 3 : 0;
+        received += static_cast<std::size_t>(bytes);
+        if (std::string_view(request.data(), received).find("\r\n\r\n", scanFrom) != std::string_view::npos) {
             break;
         }
     }
+    request.resize(received);
 
-    std::istringstream requestStream(request);
-    std::string requestLine;
-    std::getline(requestStream, requestLine);
-    if (!requestLine.empty() && requestLine.back() == '\r') {
-        requestLine.pop_back();
-    }
-
-    std::istringstream lineStream(requestLine);
-    std::string method;
-    std::string target;
-    std::string version;
-    lineStream >> method >> target >> version;
-
-    Request apiRequest{};
-    apiRequest.method = method;
-    apiRequest.target = target;
-    apiRequest.version = version;
-
-    const auto queryPos = target.find('?');
-    if (queryPos != std::string::npos) {
-        apiRequest.path = target.substr(0, queryPos);
-        apiRequest.query = target.substr(queryPos + 1);
-    } else {
-        apiRequest.path = target;
-    }
-
-    if (WebSocketServer::instance().handleClient(clientFd, request, apiRequest)) {
+    const Request apiRequest(std::move(request));
+    if (WebSocketServer::instance().handleClient(clientFd, apiRequest)) {
         return;
     }
 
     const auto responseData = router_.handle(apiRequest);
-    const auto& statusCode = responseData.statusCode;
-    const auto& statusText = responseData.statusText;
-    const auto& body = responseData.body;
-
-    std::ostringstream response;
-    response << "HTTP/1.1 " << statusCode << ' ' << statusText << "\r\n";
-    const std::string contentType = responseData.contentType.empty() ? "application/json" : responseData.contentType;
-    response << "Content-Type: " << contentType << "\r\n";
-    if (!responseData.headers.empty()) {
-        for (const auto& header : responseData.headers) {
-            if (!header.first.empty()) {
-                response << header.first << ": " << header.second << "\r\n";
-            }
-        }
-    }
-    if (corsConfig_.enabled && !corsConfig_.origin.empty()) {
-        response << "Access-Control-Allow-Origin: " << corsConfig_.origin << "\r\n";
-        response << "Vary: Origin\r\n";
-        response << "Access-Control-Allow-Headers: Content-Type\r\n";
-    }
-    response << "Content-Length: " << body.size() << "\r\n";
-    response << "Connection: close\r\n\r\n";
-    response << body;
 
-    const auto responseStr = response.str();
-    const char* data = responseStr.data();
-    std::size_t remaining = responseStr.size();
-
-    while (remaining > 0) {
-        const auto written = ::send(clientFd, data, remaining, 0);
+    // The head and body may be a cached entry shared with other requests;
+    // only the connection-level headers are built here.
+    std::string tail;
+    tail.reserve(160);
+    if (corsConfig_.enabled && !corsConfig_.origin.empty()) {
+        tail.append("Access-Control-Allow-Origin: ").append(corsConfig_.origin).append("\r\n");
+        tail.append("Vary: Origin\r\n");
+        tail.append("Access-Control-Allow-Headers: Content-Type\r\n");
+    }
+    if (responseData->statusCode != 304) {
+        tail.append("Content-Length: ").append(std::to_string(responseData->body.size())).append("\r\n");
+    }
+    tail.append("Connection: close\r\n\r\n");
+
+    std::array<iovec, 3> parts{};
+    parts[0] = iovec{const_cast<char*>(responseData->head.data()), responseData->head.size()};
+    parts[1] = iovec{tail.data(), tail.size()};
+    parts[2] = iovec{const_cast<char*>(responseData->body.data()), responseData->body.size()};
+    std::size_t first = 0;
+    while (first < parts.size()) {
+        msghdr message{};
+        message.msg_iov = parts.data() + first;
+        message.msg_iovlen = parts.size() - first;
+        const auto written = ::sendmsg(clientFd, &message, MSG_NOSIGNAL);
         if (written <= 0) {
             break;
         }
-        remaining -= static_cast<std::size_t>(written);
-        data += written;
+        auto remaining = static_cast<std::size_t>(written);
+        while (first < parts.size() && remaining >= parts[first].iov_len) {
+            remaining -= parts[first].iov_len;
+            ++first;
+        }
+        if (first < parts.size()) {
+            parts[first].iov_base = static_cast<char*>(parts[first].iov_base) + remaining;
+            parts[first].iov_len -= remaining;
+        }
     }
 
     ::shutdown(clientFd, SHUT_RDWR);
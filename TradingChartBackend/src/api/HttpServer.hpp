@@ -49,6 +49,8 @@ public:
     void wait();
 
     void setCorsConfig(CorsConfig config);
+    // Must be called before start(); see Router::setAdminToken.
+    void setAdminToken(std::string token);
 
 private:
     void workerLoop(std::size_t workerId);
@@ -0,0 +1,173 @@
+#include "api/Request.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <system_error>
+
+namespace ttp::api {
+
+namespace {
+
+bool isBlank(char ch) {
+    return ch == ' ' || ch == '\t';
+}
+
+char lowerAscii(char ch) {
+    return ch >= 'A' && ch <= 'Z' ? static_cast<char>(ch - 'A' + 'a') : ch;
+}
+
+bool equalsIgnoreCase(std::string_view lhs, std::string_view rhs) {
+    return lhs.size() == rhs.size()
+        && std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](char a, char b) {
+               return lowerAscii(a) == lowerAscii(b);
+           });
+}
+
+// '+' is a space and %XX a byte; malformed escapes are kept as they are.
+void appendDecoded(std::string& out, std::string_view value) {
+    for (std::size_t i = 0; i < value.size(); ++i) {
+        const char ch = value[i];
+        if (ch == '+') {
+            out.push_back(' ');
+        }
+        else if (ch == '%' && i + 2 < value.size()) {
+            const char* begin = value.data() + i + 1;
+            const char* end = begin + 2;
+            unsigned int code{};
+            auto [ptr, ec] = std::from_chars(begin, end, code, 16);
+            if (ec == std::errc() && ptr == end) {
+                out.push_back(static_cast<char>(code));
+                i += 2;
+            }
+            else {
+                out.push_back(ch);
+            }
+        }
+        else {
+            out.push_back(ch);
+        }
+    }
+}
+
+}  // namespace
+
+Request::Request(std::string raw) : raw_(std::move(raw)) {
+    parseHead();
+    indexQuery();
+}
+
+std::optional<std::string_view> Request::header(std::string_view name) const {
+    for (std::size_t i = 0; i < headers_.size(); ++i) {
+        const auto& field = headers_[i];
+        if (equalsIgnoreCase(view(field.name), name)) {
+            return view(field.value);
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string_view> Request::param(std::string_view name) const {
+    for (std::size_t i = 0; i < params_.size(); ++i) {
+        const auto& field = params_[i];
+        if (view(field.name) == name) {
+            return view(field.value);
+        }
+    }
+    return std::nullopt;
+}
+
+std::pair<std::string_view, std::string_view> Request::paramAt(std::size_t index) const {
+    const auto& field = params_[index];
+    return {view(field.name), view(field.value)};
+}
+
+void Request::parseHead() {
+    const std::string_view raw(raw_);
+    const auto slice = [](std::size_t offset, std::size_t size) {
+        return Slice{static_cast<std::uint32_t>(offset), static_cast<std::uint32_t>(size), false};
+    };
+
+    bool requestLine = true;
+    std::size_t lineStart = 0;
+    while (lineStart < raw.size()) {
+        const auto lineEnd = std::min(raw.find('\n', lineStart), raw.size());
+        auto end = lineEnd;
+        if (end > lineStart && raw[end - 1] == '\r') {
+            --end;
+        }
+
+        if (requestLine) {
+            // METHOD target VERSION, separated by runs of blanks.
+            requestLine = false;
+            auto pos = lineStart;
+            for (auto* token : {&method_, &target_, &version_}) {
+                while (pos < end && isBlank(raw[pos])) {
+                    ++pos;
+                }
+                auto tokenEnd = pos;
+                while (tokenEnd < end && !isBlank(raw[tokenEnd])) {
+                    ++tokenEnd;
+                }
+                *token = slice(pos, tokenEnd - pos);
+                pos = tokenEnd;
+            }
+        }
+        else if (end == lineStart) {
+            break;
+        }
+        else if (const auto colon = raw.find(':', lineStart); colon < end) {
+            auto valueBegin = colon + 1;
+            auto valueEnd = end;
+            while (valueBegin < valueEnd && isBlank(raw[valueBegin])) {
+                ++valueBegin;
+            }
+            while (valueEnd > valueBegin && isBlank(raw[valueEnd - 1])) {
+                --valueEnd;
+            }
+            headers_.push_back(Field{slice(lineStart, colon - lineStart), slice(valueBegin, valueEnd - valueBegin)});
+        }
+        lineStart = lineEnd + 1;
+    }
+
+    const auto queryPos = target().find('?');
+    path_ = target_;
+    if (queryPos != std::string_view::npos) {
+        path_.size = static_cast<std::uint32_t>(queryPos);
+        query_ = slice(target_.offset + queryPos + 1, target_.size - queryPos - 1);
+    }
+}
+
+void Request::indexQuery() {
+    const auto query = this->query();
+    std::size_t start = 0;
+    while (start < query.size()) {
+        const auto end = std::min(query.find('&', start), query.size());
+        if (end > start) {
+            const auto eq = std::min(query.find('=', start), end);
+            const auto valueStart = std::min(eq + 1, end);
+            const Slice name{static_cast<std::uint32_t>(query_.offset + start),
+                             static_cast<std::uint32_t>(eq - start),
+                             false};
+            const Slice value{static_cast<std::uint32_t>(query_.offset + valueStart),
+                              static_cast<std::uint32_t>(end - valueStart),
+                              false};
+            params_.push_back(Field{decode(name), decode(value)});
+        }
+        start = end + 1;
+    }
+}
+
+Request::Slice Request::decode(Slice slice) {
+    const auto encoded = view(slice);
+    if (encoded.find_first_of("%+") == std::string_view::npos) {
+        return slice;
+    }
+    if (decoded_.empty()) {
+        decoded_.reserve(query_.size);
+    }
+    const auto offset = decoded_.size();
+    appendDecoded(decoded_, encoded);
+    return Slice{static_cast<std::uint32_t>(offset), static_cast<std::uint32_t>(decoded_.size() - offset), true};
+}
+
+}  // namespace ttp::api
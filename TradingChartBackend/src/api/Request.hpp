@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ttp::api {
+
+// An HTTP request head, parsed once from the receive buffer it owns. The
+// request line, headers and query parameters are kept as offsets into that
+// buffer, so a copy or a move of the Request stays valid. Parameters are
+// percent-decoded while indexing, into a side buffer and only when they
+// contain escapes; parsing allocates nothing else for up to kInlineParams
+// parameters and kInlineHeaders headers.
+class Request {
+public:
+    static constexpr std::size_t kInlineParams = 16;
+    static constexpr std::size_t kInlineHeaders = 24;
+
+    Request() = default;
+    // `raw` holds the request line and headers, CRLF- or LF-terminated.
+    explicit Request(std::string raw);
+
+    std::string_view method() const { return view(method_); }
+    std::string_view target() const { return view(target_); }
+    std::string_view path() const { return view(path_); }
+    // Raw query string, without the '?'.
+    std::string_view query() const { return view(query_); }
+    std::string_view version() const { return view(version_); }
+    const std::string& raw() const { return raw_; }
+
+    // First header named `name`, compared case-insensitively; the value is
+    // trimmed.
+    std::optional<std::string_view> header(std::string_view name) const;
+
+    // Decoded value of the first parameter whose decoded name is `name`.
+    std::optional<std::string_view> param(std::string_view name) const;
+
+    // Decoded name and value of every non-empty parameter, in arrival order.
+    std::size_t paramCount() const { return params_.size(); }
+    std::pair<std::string_view, std::string_view> paramAt(std::size_t index) const;
+
+private:
+    struct Slice {
+        std::uint32_t offset{0};
+        std::uint32_t size{0};
+        // Points into decoded_ rather than raw_.
+        bool decoded{false};
+    };
+
+    struct Field {
+        Slice name;
+        Slice value;
+    };
+
+    // Fixed inline storage that spills to the heap past N entries.
+    template <std::size_t N>
+    class Fields {
+    public:
+        void push_back(const Field& field) {
+            if (size_ < N) {
+                inline_[size_] = field;
+            }
+            else {
+                overflow_.push_back(field);
+            }
+            ++size_;
+        }
+        const Field& operator[](std::size_t index) const {
+            return index < N ? inline_[index] : overflow_[index - N];
+        }
+        std::size_t size() const { return size_; }
+
+    private:
+        std::array<Field, N> inline_{};
+        std::vector<Field> overflow_;
+        std::size_t size_{0};
+    };
+
+    std::string_view view(const Slice& slice) const {
+        const auto& buffer = slice.decoded ? decoded_ : raw_;
+        return std::string_view(buffer).substr(slice.offset, slice.size);
+    }
+
+    void parseHead();
+    void indexQuery();
+    Slice decode(Slice slice);
+
+    std::string raw_;
+    std::string decoded_;
+    Slice method_;
+    Slice target_;
+    Slice path_;
+    Slice query_;
+    Slice version_;
+    Fields<kInlineHeaders> headers_;
+    Fields<kInlineParams> params_;
+};
+
+}  // namespace ttp::api
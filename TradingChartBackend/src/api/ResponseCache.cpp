@@ -0,0 +1,120 @@
+#include "api/ResponseCache.hpp"
+
+#include <functional>
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+#include "common/Metrics.hpp"
+
+namespace ttp::api {
+
+namespace {
+
+// Approximate bookkeeping per entry on top of key, headers and body.
+constexpr std::size_t kNodeOverhead = 160;
+
+struct CacheCounters {
+    common::metrics::Counter& hits;
+    common::metrics::Counter& misses;
+    common::metrics::Counter& stale;
+    common::metrics::Counter& evictions;
+};
+
+CacheCounters& counters() {
+    auto& registry = common::metrics::Registry::instance();
+    static CacheCounters handles{registry.counter("response_cache.hits"),
+                                 registry.counter("response_cache.misses"),
+                                 registry.counter("response_cache.stale"),
+                                 registry.counter("response_cache.evictions")};
+    return handles;
+}
+
+}  // namespace
+
+SerializedResponse serializeResponse(const Response& response) {
+    SerializedResponse serialized;
+    serialized.statusCode = response.statusCode;
+    const std::string_view contentType =
+        response.contentType.empty() ? std::string_view("application/json") : std::string_view(response.contentType);
+
+    auto& head = serialized.head;
+    head.reserve(64 + response.statusText.size() + contentType.size());
+    head.append("HTTP/1.1 ").append(std::to_string(response.statusCode)).push_back(' ');
+    head.append(response.statusText).append("\r\n");
+    head.append("Content-Type: ").append(contentType).append("\r\n");
+    for (const auto& [name, value] : response.headers) {
+        if (!name.empty()) {
+            head.append(name).append(": ").append(value).append("\r\n");
+        }
+        if (name == "ETag") {
+            serialized.etag = value;
+        }
+    }
+    serialized.body = response.body;
+    return serialized;
+}
+
+ResponseCache::ResponseCache(std::size_t maxBytes, std::chrono::milliseconds ttl)
+    : shardBudget_(maxBytes / kShardCount), ttl_(ttl) {}
+
+ResponseCache::Shard& ResponseCache::shardFor(const std::string& key) {
+    return shards_[std::hash<std::string>{}(key) % kShardCount];
+}
+
+void ResponseCache::erase(Shard& shard, std::list<Node>::iterator node) {
+    shard.bytes -= node->cost;
+    shard.index.erase(node->key);
+    shard.lru.erase(node);
+}
+
+ResponseCache::Entry ResponseCache::find(const std::string& key, std::uint64_t version) {
+    const auto now = std::chrono::steady_clock::now();
+    auto& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+        counters().misses.add();
+        return nullptr;
+    }
+    const auto node = it->second;
+    if (node->version != version || now >= node->expiresAt) {
+        erase(shard, node);
+        counters().stale.add();
+        return nullptr;
+    }
+    shard.lru.splice(shard.lru.begin(), shard.lru, node);
+    counters().hits.add();
+    return node->entry;
+}
+
+void ResponseCache::store(const std::string& key, std::uint64_t version, Entry entry) {
+    const auto cost = kNodeOverhead + 2U * key.size() + entry->head.size() + entry->body.size();
+    if (cost > shardBudget_) {
+        return;
+    }
+    const auto expiresAt = std::chrono::steady_clock::now() + ttl_;
+    auto& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (const auto it = shard.index.find(key); it != shard.index.end()) {
+        erase(shard, it->second);
+    }
+    while (!shard.lru.empty() && shard.bytes + cost > shardBudget_) {
+        erase(shard, std::prev(shard.lru.end()));
+        counters().evictions.add();
+    }
+    shard.lru.push_front(Node{key, version, expiresAt, cost, std::move(entry)});
+    shard.index.emplace(key, shard.lru.begin());
+    shard.bytes += cost;
+}
+
+std::size_t ResponseCache::bytes() const {
+    std::size_t total = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.bytes;
+    }
+    return total;
+}
+
+}  // namespace ttp::api
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "api/Controllers.hpp"
+
+namespace ttp::api {
+
+// A response ready for the wire: `head` holds the status line, Content-Type
+// and handler headers, each CRLF-terminated. HttpServer appends the
+// connection-level headers (CORS, Content-Length, Connection) and the body.
+struct SerializedResponse {
+    int statusCode{0};
+    std::string head;
+    std::string body;
+    // Value of the ETag header, if the handler set one.
+    std::string etag;
+};
+
+SerializedResponse serializeResponse(const Response& response);
+
+// Sharded LRU of serialized responses bounded by total bytes. Each entry
+// remembers the series version it was built from; a lookup with any other
+// version misses and drops the entry, so writes invalidate exactly the
+// responses they affect. The TTL bounds entries whose data has no version.
+class ResponseCache {
+public:
+    using Entry = std::shared_ptr<const SerializedResponse>;
+
+    static constexpr std::size_t kShardCount = 16;
+
+    ResponseCache(std::size_t maxBytes, std::chrono::milliseconds ttl);
+
+    Entry find(const std::string& key, std::uint64_t version);
+    void store(const std::string& key, std::uint64_t version, Entry entry);
+
+    std::size_t bytes() const;
+
+private:
+    struct Node {
+        std::string key;
+        std::uint64_t version{0};
+        std::chrono::steady_clock::time_point expiresAt;
+        std::size_t cost{0};
+        Entry entry;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Node> lru;  // most recently used first
+        std::unordered_map<std::string, std::list<Node>::iterator> index;
+        std::size_t bytes{0};
+    };
+
+    Shard& shardFor(const std::string& key);
+    static void erase(Shard& shard, std::list<Node>::iterator node);
+
+    std::size_t shardBudget_;
+    std::chrono::milliseconds ttl_;
+    std::array<Shard, kShardCount> shards_;
+};
+
+}  // namespace ttp::api
@@ -7,15 +7,23 @@
 #include <string_view>
 #include <utility>
 
+#include "api/SeriesVersion.hpp"
+#include "app/ServiceLocator.hpp"
 #include "common/Metrics.hpp"
+#include "domain/Models.hpp"
 #include "http/QueryParams.hpp"
 
 namespace ttp::api {
 
 namespace {
 
-std::string makeKey(const std::string& method, const std::string& path) {
-    return method + ' ' + path;
+constexpr char kSymbolIntervalsRouteKey[] = "GET /api/v1/symbols/:symbol/intervals";
+
+std::string makeKey(std::string_view method, std::string_view path) {
+    std::string key;
+    key.reserve(method.size() + path.size() + 1U);
+    key.append(method).append(1, ' ').append(path);
+    return key;
 }
 
 std::string toLowerCopy(std::string value) {
@@ -25,6 +33,72 @@ std::string toLowerCopy(std::string value) {
     return value;
 }
 
+bool includesRanges(const Request& request) {
+    const auto includeRanges = ttp::http::opt_string(request, "includeRanges");
+    if (!includeRanges) {
+        return false;
+    }
+    const auto normalized = toLowerCopy(std::string(*includeRanges));
+    return normalized == "true" || normalized == "1" || normalized == "yes" || normalized == "on";
+}
+
+// "/api/v1/symbols/<symbol>/intervals" -> symbol.
+std::optional<std::string> symbolIntervalsPath(const Request& request) {
+    static constexpr std::string_view kPrefix = "/api/v1/symbols/";
+    static constexpr std::string_view kSuffix = "/intervals";
+
+    const auto path = request.path();
+    if (request.method() != "GET" || path.size() <= kPrefix.size() || path.compare(0, kPrefix.size(), kPrefix) != 0) {
+        return std::nullopt;
+    }
+    const auto remainder = path.substr(kPrefix.size());
+    const auto slashPos = remainder.find('/');
+    if (slashPos == std::string_view::npos || remainder.compare(slashPos, std::string_view::npos, kSuffix) != 0) {
+        return std::nullopt;
+    }
+    return std::string(remainder.substr(0, slashPos));
+}
+
+// Handlers mark responses built from data that changes without a repository
+// write (e.g. the in-memory forming candle) with Cache-Control: no-store.
+bool isNoStore(const Response& response) {
+    return std::any_of(response.headers.begin(), response.headers.end(), [](const auto& header) {
+        return toLowerCopy(header.first) == "cache-control" && header.second.find("no-store") != std::string::npos;
+    });
+}
+
+std::shared_ptr<const SerializedResponse> notFound() {
+    static const auto response = std::make_shared<const SerializedResponse>(
+        serializeResponse(Response{404, "Not Found", R"({"error":"not_found"})", "application/json", {}}));
+    return response;
+}
+
+std::shared_ptr<const SerializedResponse> unauthorized() {
+    static const auto response = std::make_shared<const SerializedResponse>(serializeResponse(Response{
+        401, "Unauthorized", R"({"error":"unauthorized"})", "application/json", {{"WWW-Authenticate", "Bearer"}}}));
+    return response;
+}
+
+bool isAdminPath(std::string_view path) {
+    static constexpr std::string_view kAdminPrefix = "/admin/";
+    return path.compare(0, kAdminPrefix.size(), kAdminPrefix) == 0;
+}
+
+// Compares every byte whatever the first mismatch, so the time taken does
+// not tell how much of the token was right.
+bool bearerMatches(std::optional<std::string_view> authorization, const std::string& token) {
+    static constexpr std::string_view kScheme = "Bearer ";
+    if (!authorization || authorization->size() != kScheme.size() + token.size()
+        || authorization->compare(0, kScheme.size(), kScheme) != 0) {
+        return false;
+    }
+    unsigned char diff = 0;
+    for (std::size_t i = 0; i < token.size(); ++i) {
+        diff = static_cast<unsigned char>(diff | ((*authorization)[kScheme.size() + i] ^ token[i]));
+    }
+    return diff == 0;
+}
+
 }  // namespace
 
 Router::Router() {
@@ -33,105 +107,101 @@ Router::Router() {
     routes_.emplace(makeKey("GET", "/api/v1/symbols"), [](const Request& request) { return symbols(request); });
     routes_.emplace(makeKey("GET", "/api/v1/intervals"), [](const Request& request) { return intervals(request); });
     routes_.emplace(makeKey("GET", "/api/v1/candles"), [](const Request& request) { return candles(request); });
+    routes_.emplace(makeKey("GET", "/api/v1/indicators"), [](const Request& request) { return indicators(request); });
     routes_.emplace(makeKey("GET", "/stats"), [](const Request& request) { return stats(request); });
+    routes_.emplace(makeKey("GET", "/metrics"), [](const Request& request) { return metrics(request); });
+    routes_.emplace(makeKey("GET", "/admin/traces"), [](const Request& request) { return traces(request); });
 }
 
-Response Router::handle(const Request& request) const {
-    const auto key = makeKey(request.method, request.path);
+std::shared_ptr<const SerializedResponse> Router::handle(const Request& request) const {
+    const auto key = makeKey(request.method(), request.path());
     const auto it = routes_.find(key);
-    if (it != routes_.end()) {
-        common::metrics::Registry::instance().incrementRequest(key);
-        const bool cacheable = shouldCache(request) || shouldCacheSymbolIntervals(request);
-        if (cacheable) {
-            const auto cacheKey = buildCacheKey(request);
-            if (auto cached = tryGetCachedResponse(cacheKey)) {
-                return *cached;
-            }
-            auto response = it->second(request);
-            storeCachedResponse(cacheKey, response);
-            return response;
+    const auto symbolPath = it == routes_.end() ? symbolIntervalsPath(request) : std::nullopt;
+    if (it == routes_.end() && !symbolPath) {
+        return notFound();
+    }
+    if (isAdminPath(request.path())) {
+        if (adminToken_.empty()) {
+            return notFound();
+        }
+        if (!bearerMatches(ttp::http::opt_header(request, "authorization"), adminToken_)) {
+            return unauthorized();
         }
-        return it->second(request);
     }
 
-    if (request.method == "GET") {
-        static constexpr std::string_view kPrefix = "/api/v1/symbols/";
-        static constexpr std::string_view kSuffix = "/intervals";
-
-        if (request.path.size() > kPrefix.size()
-            && request.path.compare(0, kPrefix.size(), kPrefix) == 0) {
-            const auto remainder = request.path.substr(kPrefix.size());
-            const auto slashPos = remainder.find('/');
-            if (slashPos != std::string::npos) {
-                const auto symbol = remainder.substr(0, slashPos);
-                const auto tail = remainder.substr(slashPos);
-                if (tail == kSuffix) {
-                    common::metrics::Registry::instance().incrementRequest(
-                        "GET /api/v1/symbols/:symbol/intervals");
-                    const bool cacheable = shouldCacheSymbolIntervals(request);
-                    if (cacheable) {
-                        const auto cacheKey = buildCacheKey(request);
-                        if (auto cached = tryGetCachedResponse(cacheKey)) {
-                            return *cached;
-                        }
-                        auto response = symbolIntervals(request, symbol);
-                        storeCachedResponse(cacheKey, response);
-                        return response;
-                    }
-                    return symbolIntervals(request, symbol);
-                }
-            }
+    auto& registry = common::metrics::Registry::instance();
+    registry.incrementRequest(symbolPath ? std::string(kSymbolIntervalsRouteKey) : key);
+    const auto dispatch = [&]() {
+        return symbolPath ? symbolIntervals(request, *symbolPath) : it->second(request);
+    };
+
+    // The version is read before the handler runs: a write that lands while
+    // the response is being built leaves it tagged with the older version, so
+    // the next lookup misses rather than serving pre-write data.
+    const auto policy = cachePolicy(request, symbolPath ? &*symbolPath : nullptr);
+    if (!policy) {
+        return std::make_shared<const SerializedResponse>(serializeResponse(dispatch()));
+    }
+    if (auto cached = cache_.find(policy->key, policy->version)) {
+        // A matching validator is answered by the handler with a 304.
+        const auto ifNoneMatch = ttp::http::opt_header(request, "if-none-match");
+        if (!ifNoneMatch || cached->etag.empty() || !ttp::http::etag_matches(*ifNoneMatch, cached->etag)) {
+            return cached;
         }
     }
-
-    return Response{404, "Not Found", R"({"error":"not_found"})", "application/json"};
+    const auto response = dispatch();
+    auto serialized = std::make_shared<const SerializedResponse>(serializeResponse(response));
+    if (response.statusCode == 200 && !isNoStore(response)) {
+        cache_.store(policy->key, policy->version, serialized);
+        registry.setGauge("response_cache.bytes", static_cast<double>(cache_.bytes()));
+    }
+    return serialized;
 }
 
-bool Router::shouldCache(const Request& request) const {
-    return request.method == "GET" && request.path == "/api/v1/symbols";
-}
+void Router::setAdminToken(std::string token) { adminToken_ = std::move(token); }
 
-bool Router::shouldCacheSymbolIntervals(const Request& request) const {
-    if (request.method != "GET") {
-        return false;
-    }
-    const auto includeRanges = ttp::http::opt_string(request, "includeRanges");
-    if (!includeRanges) {
-        return false;
+std::optional<Router::CachePolicy> Router::cachePolicy(const Request& request, const std::string* symbolPath) const {
+    if (request.method() != "GET") {
+        return std::nullopt;
     }
-    const auto normalized = toLowerCopy(*includeRanges);
-    return normalized == "true" || normalized == "1" || normalized == "yes" || normalized == "on";
-}
 
-std::string Router::buildCacheKey(const Request& request) const {
-    std::string key = request.method;
-    key.push_back(' ');
-    key.append(request.path);
-    if (!request.query.empty()) {
-        key.push_back('?');
-        key.append(request.query);
+    // Read from the repository's stored counter where it keeps one: a
+    // backfill in another process writes the same database.
+    const auto* repo = app::ServiceLocator::instance().candleReadRepo();
+    std::uint64_t version = 0;
+    const auto path = request.path();
+    if (path == "/api/v1/candles") {
+        const auto symbol = ttp::http::opt_string(request, "symbol");
+        const auto interval = ttp::http::opt_string(request, "interval");
+        if (!symbol || !interval) {
+            return std::nullopt;
+        }
+        const auto label = domain::contracts::intervalToString(domain::contracts::intervalFromString(*interval));
+        version = seriesVersion(repo, std::string(*symbol), label);
     }
-    return key;
-}
-
-std::optional<Response> Router::tryGetCachedResponse(const std::string& key) const {
-    const auto now = std::chrono::steady_clock::now();
-    std::lock_guard<std::mutex> lock(cacheMutex_);
-    const auto it = cache_.find(key);
-    if (it == cache_.end()) {
-        return std::nullopt;
+    else if (symbolPath != nullptr || path == "/api/v1/intervals") {
+        // Ranges move with every write to any interval of the symbol.
+        if (!includesRanges(request)) {
+            return std::nullopt;
+        }
+        const auto symbol = symbolPath != nullptr ? std::optional<std::string_view>(*symbolPath)
+                                                  : ttp::http::opt_string(request, "symbol");
+        version = seriesVersion(repo, symbol ? std::string(*symbol) : std::string{}, std::string{});
+    }
+    else if (path == "/api/v1/symbols") {
+        // New series add symbols.
+        version = seriesVersion(repo, std::string{}, std::string{});
     }
-    if (now >= it->second.expiresAt) {
-        cache_.erase(it);
+    else {
         return std::nullopt;
     }
-    return it->second.response;
-}
 
-void Router::storeCachedResponse(const std::string& key, const Response& response) const {
-    const auto expiresAt = std::chrono::steady_clock::now() + kCacheTtl;
-    std::lock_guard<std::mutex> lock(cacheMutex_);
-    cache_[key] = CachedResponse{response, expiresAt};
+    CachePolicy policy;
+    policy.key.assign(path);
+    policy.key.push_back('?');
+    policy.key.append(ttp::http::canonical_query(request));
+    policy.version = version;
+    return policy;
 }
 
 }  // namespace ttp::api
@@ -1,14 +1,15 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <map>
-#include <mutex>
+#include <memory>
 #include <optional>
 #include <string>
-#include <unordered_map>
 
 #include "api/Controllers.hpp"
+#include "api/ResponseCache.hpp"
 
 namespace ttp::api {
 
@@ -16,26 +17,28 @@ class Router {
 public:
     Router();
 
-    Response handle(const Request& request) const;
+    // Cacheable GETs may return an entry shared with other requests.
+    std::shared_ptr<const SerializedResponse> handle(const Request& request) const;
+
+    // Routes under /admin/ answer only requests carrying
+    // "Authorization: Bearer <token>"; with no token they are not served.
+    void setAdminToken(std::string token);
 
 private:
     using Handler = std::function<Response(const Request&)>;
 
-    struct CachedResponse {
-        Response response;
-        std::chrono::steady_clock::time_point expiresAt;
+    struct CachePolicy {
+        std::string key;
+        std::uint64_t version{0};
     };
 
-    [[nodiscard]] bool shouldCache(const Request& request) const;
-    [[nodiscard]] bool shouldCacheSymbolIntervals(const Request& request) const;
-    [[nodiscard]] std::string buildCacheKey(const Request& request) const;
-    [[nodiscard]] std::optional<Response> tryGetCachedResponse(const std::string& key) const;
-    void storeCachedResponse(const std::string& key, const Response& response) const;
+    [[nodiscard]] std::optional<CachePolicy> cachePolicy(const Request& request, const std::string* symbolPath) const;
 
     std::map<std::string, Handler> routes_;
+    std::string adminToken_;
     static constexpr std::chrono::seconds kCacheTtl{10};
-    mutable std::mutex cacheMutex_;
-    mutable std::unordered_map<std::string, CachedResponse> cache_;
+    static constexpr std::size_t kCacheMaxBytes = 64U * 1024U * 1024U;
+    mutable ResponseCache cache_{kCacheMaxBytes, kCacheTtl};
 };
 
 }  // namespace ttp::api
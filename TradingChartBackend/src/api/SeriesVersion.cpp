@@ -0,0 +1,42 @@
+#include "api/SeriesVersion.hpp"
+
+#include "common/SeriesVersions.hpp"
+#include "domain/Ports.hpp"
+
+namespace ttp::api {
+
+std::uint64_t seriesVersion(const domain::contracts::ICandleReadRepo* repo,
+                            const std::string& symbol,
+                            const std::string& interval) {
+    if (repo) {
+        if (const auto stored = repo->storedVersion(symbol, interval)) {
+            return (*stored << 1U) | 1U;
+        }
+    }
+    if (symbol.empty()) {
+        return 0U;
+    }
+    const auto& versions = common::SeriesVersions::instance();
+    return (interval.empty() ? versions.symbol(symbol) : versions.series(symbol, interval)) << 1U;
+}
+
+bool untouchedBetween(const domain::contracts::ICandleReadRepo* repo,
+                      const std::string& symbol,
+                      const std::string& interval,
+                      std::uint64_t since,
+                      std::uint64_t now,
+                      std::int64_t fromTs,
+                      std::int64_t toTs) {
+    if (since == now) {
+        return true;
+    }
+    if ((since & 1U) != (now & 1U)) {
+        return false;
+    }
+    if ((now & 1U) != 0U) {
+        return repo != nullptr && repo->storedUntouched(symbol, interval, since >> 1U, now >> 1U, fromTs, toTs);
+    }
+    return common::SeriesVersions::instance().untouchedSince(symbol, interval, since >> 1U, fromTs, toTs);
+}
+
+}  // namespace ttp::api
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace domain::contracts {
+class ICandleReadRepo;
+}
+
+namespace ttp::api {
+
+// Version of the data behind a response about `symbol` and `interval` (an
+// empty interval covers every interval of the symbol, an empty symbol the
+// whole store). Taken from the repository's stored write counter when it
+// keeps one, so writes from other processes count; otherwise from this
+// process's common::SeriesVersions. The low bit tells the two sources apart.
+std::uint64_t seriesVersion(const domain::contracts::ICandleReadRepo* repo,
+                            const std::string& symbol,
+                            const std::string& interval);
+
+// Whether the writes that took one series from seriesVersion() `since` to
+// `now` all left open times [fromTs, toTs] alone. False when that is not
+// known: the versions come from different sources, or the writes are no
+// longer all in the write log.
+bool untouchedBetween(const domain::contracts::ICandleReadRepo* repo,
+                      const std::string& symbol,
+                      const std::string& interval,
+                      std::uint64_t since,
+                      std::uint64_t now,
+                      std::int64_t fromTs,
+                      std::int64_t toTs);
+
+}  // namespace ttp::api
@@ -13,12 +13,12 @@
 #include <sstream>
 #include <string>
 #include <thread>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "common/Log.hpp"
 #include "common/Metrics.hpp"
+#include "common/Trace.hpp"
 
 namespace ttp::api {
 
@@ -55,18 +55,6 @@ std::int64_t steadyNowMs() {
         .count();
 }
 
-std::string trim(const std::string& input) {
-    std::size_t start = 0;
-    while (start < input.size() && std::isspace(static_cast<unsigned char>(input[start]))) {
-        ++start;
-    }
-    std::size_t end = input.size();
-    while (end > start && std::isspace(static_cast<unsigned char>(input[end - 1]))) {
-        --end;
-    }
-    return input.substr(start, end - start);
-}
-
 std::string toLower(std::string value) {
     for (char& ch : value) {
         ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
@@ -74,30 +62,6 @@ std::string toLower(std::string value) {
     return value;
 }
 
-std::unordered_map<std::string, std::string> parseHeaders(const std::string& rawRequest) {
-    std::unordered_map<std::string, std::string> headers;
-    std::istringstream stream(rawRequest);
-    std::string line;
-    // descartar primera línea
-    std::getline(stream, line);
-    while (std::getline(stream, line)) {
-        if (!line.empty() && line.back() == '\r') {
-            line.pop_back();
-        }
-        if (line.empty()) {
-            break;
-        }
-        const auto colonPos = line.find(':');
-        if (colonPos == std::string::npos) {
-            continue;
-        }
-        auto key = toLower(trim(line.substr(0, colonPos)));
-        auto value = trim(line.substr(colonPos + 1));
-        headers.emplace(std::move(key), std::move(value));
-    }
-    return headers;
-}
-
 class Sha1 {
 public:
     Sha1() { reset(); }
@@ -441,9 +405,9 @@ void WebSocketServer::configureBackpressure(std::size_t maxMessages,
              << " stall_timeout=" << safeStall << "ms");
 }
 
-bool WebSocketServer::handleClient(int clientFd, const std::string& rawRequest, const Request& request) {
+bool WebSocketServer::handleClient(int clientFd, const Request& request) {
     SessionPtr session;
-    const bool targeted = performHandshake(clientFd, rawRequest, request, session);
+    const bool targeted = performHandshake(clientFd, request, session);
     if (!targeted) {
         return false;
     }
@@ -479,43 +443,39 @@ bool WebSocketServer::handleClient(int clientFd, const std::string& rawRequest,
     return true;
 }
 
-bool WebSocketServer::performHandshake(int clientFd,
-                                       const std::string& rawRequest,
-                                       const Request& request,
-                                       SessionPtr& session) {
+bool WebSocketServer::performHandshake(int clientFd, const Request& request, SessionPtr& session) {
     if (!running_.load()) {
         return false;
     }
 
-    if (request.method != "GET" || request.path != "/ws") {
+    if (request.method() != "GET" || request.path() != "/ws") {
         return false;
     }
 
-    const auto headers = parseHeaders(rawRequest);
-    const auto upgradeIt = headers.find("upgrade");
-    if (upgradeIt == headers.end() || toLower(upgradeIt->second) != "websocket") {
+    const auto upgrade = request.header("upgrade");
+    if (!upgrade || toLower(std::string(*upgrade)) != "websocket") {
         sendHttpError(clientFd, 400, "Bad Request", "Missing or invalid Upgrade header\n");
         return true;
     }
 
-    const auto connectionIt = headers.find("connection");
-    if (connectionIt == headers.end()) {
+    const auto connection = request.header("connection");
+    if (!connection) {
         sendHttpError(clientFd, 400, "Bad Request", "Missing Connection header\n");
         return true;
     }
-    const auto connectionValue = toLower(connectionIt->second);
+    const auto connectionValue = toLower(std::string(*connection));
     if (connectionValue.find("upgrade") == std::string::npos) {
         sendHttpError(clientFd, 400, "Bad Request", "Connection header must include 'Upgrade'\n");
         return true;
     }
 
-    const auto keyIt = headers.find("sec-websocket-key");
-    if (keyIt == headers.end() || keyIt->second.empty()) {
+    const auto key = request.header("sec-websocket-key");
+    if (!key || key->empty()) {
         sendHttpError(clientFd, 400, "Bad Request", "Missing Sec-WebSocket-Key header\n");
         return true;
     }
 
-    const auto acceptKey = computeAcceptKey(keyIt->second);
+    const auto acceptKey = computeAcceptKey(std::string(*key));
 
     std::ostringstream response;
     response << "HTTP/1.1 101 Switching Protocols\r\n";
@@ -563,24 +523,7 @@ bool WebSocketServer::sendFrame(const SessionPtr& session,
     }
 
     std::vector<std::uint8_t> frame;
-    frame.reserve(2 + payload.size());
-    frame.push_back(static_cast<std::uint8_t>(0x80U | (opcode & 0x0FU)));
-
-    const std::uint64_t payloadSize = payload.size();
-    if (payloadSize <= 125U) {
-        frame.push_back(static_cast<std::uint8_t>(payloadSize & 0x7FU));
-    } else if (payloadSize <= 0xFFFFU) {
-        frame.push_back(126U);
-        frame.push_back(static_cast<std::uint8_t>((payloadSize >> 8) & 0xFFU));
-        frame.push_back(static_cast<std::uint8_t>(payloadSize & 0xFFU));
-    } else {
-        frame.push_back(127U);
-        for (int shift = 56; shift >= 0; shift -= 8) {
-            frame.push_back(static_cast<std::uint8_t>((payloadSize >> shift) & 0xFFU));
-        }
-    }
-
-    frame.insert(frame.end(), payload.begin(), payload.end());
+    encodeFrame(opcode, payload.data(), payload.size(), frame);
 
     const std::size_t frameSize = frame.size();
     {
@@ -831,6 +774,7 @@ bool WebSocketServer::recvAll(int fd, void* buffer, std::size_t length) {
 }
 
 void WebSocketServer::broadcast(const std::string& jsonMessage) {
+    common::trace::mark(common::trace::Stage::Enqueued);
     std::vector<SessionPtr> sessionsCopy;
     {
         std::lock_guard<std::mutex> lock(sessionsMutex_);
@@ -838,16 +782,22 @@ void WebSocketServer::broadcast(const std::string& jsonMessage) {
     }
 
     std::vector<SessionPtr> toRemove;
+    bool delivered = false;
     for (const auto& session : sessionsCopy) {
         if (!session || !session->active.load()) {
             toRemove.push_back(session);
             continue;
         }
-        if (!sendTextFrame(session, jsonMessage)) {
+        if (sendTextFrame(session, jsonMessage)) {
+            delivered = true;
+        } else {
             closeWithReason(session, kCloseCodeAbnormal, "write_error", "write_error");
             toRemove.push_back(session);
         }
     }
+    if (delivered) {
+        common::trace::mark(common::trace::Stage::Sent);
+    }
 
     if (!toRemove.empty()) {
         std::lock_guard<std::mutex> lock(sessionsMutex_);
@@ -868,6 +818,28 @@ void broadcast(const std::string& jsonMessage) {
     WebSocketServer::instance().broadcast(jsonMessage);
 }
 
+void encodeFrame(std::uint8_t opcode, const std::uint8_t* payload, std::size_t size, std::vector<std::uint8_t>& frame) {
+    frame.clear();
+    frame.reserve(10 + size);
+    frame.push_back(static_cast<std::uint8_t>(0x80U | (opcode & 0x0FU)));
+
+    const std::uint64_t payloadSize = size;
+    if (payloadSize <= 125U) {
+        frame.push_back(static_cast<std::uint8_t>(payloadSize & 0x7FU));
+    } else if (payloadSize <= 0xFFFFU) {
+        frame.push_back(126U);
+        frame.push_back(static_cast<std::uint8_t>((payloadSize >> 8) & 0xFFU));
+        frame.push_back(static_cast<std::uint8_t>(payloadSize & 0xFFU));
+    } else {
+        frame.push_back(127U);
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            frame.push_back(static_cast<std::uint8_t>((payloadSize >> shift) & 0xFFU));
+        }
+    }
+
+    frame.insert(frame.end(), payload, payload + size);
+}
+
 std::vector<WebSocketServer::SessionSnapshot> WebSocketServer::getSessionSnapshots() {
     std::vector<SessionPtr> sessionsCopy;
     {
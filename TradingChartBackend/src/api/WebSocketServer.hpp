@@ -25,7 +25,7 @@ public:
 
     static WebSocketServer& instance();
 
-    bool handleClient(int clientFd, const std::string& rawRequest, const Request& request);
+    bool handleClient(int clientFd, const Request& request);
 
     void broadcast(const std::string& jsonMessage);
 
@@ -89,7 +89,7 @@ private:
 
     using SessionPtr = std::shared_ptr<Session>;
 
-    bool performHandshake(int clientFd, const std::string& rawRequest, const Request& request, SessionPtr& session);
+    bool performHandshake(int clientFd, const Request& request, SessionPtr& session);
     bool sendTextFrame(const SessionPtr& session, const std::string& message);
     bool sendPingFrame(const SessionPtr& session);
     bool sendPongFrame(const SessionPtr& session, const std::vector<std::uint8_t>& payload);
@@ -137,4 +137,7 @@ private:
 
 void broadcast(const std::string& jsonMessage);
 
+// Unmasked server-to-client frame with FIN set; `frame` is overwritten.
+void encodeFrame(std::uint8_t opcode, const std::uint8_t* payload, std::size_t size, std::vector<std::uint8_t>& frame);
+
 }  // namespace ttp::api
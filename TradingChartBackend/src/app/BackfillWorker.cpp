@@ -1,16 +1,22 @@
 #include "app/BackfillWorker.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
 #include <cctype>
 #include <ctime>
+#include <deque>
 #include <exception>
 #include <iomanip>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -28,6 +34,11 @@ namespace exchange = domain;
 
 constexpr std::size_t kPageSize = 1000;
 constexpr std::size_t kProgressLogInterval = 5000;
+// Pages per segment: a series is cut into segments this long so several
+// fetchers can work on the same series at once.
+constexpr std::int64_t kSegmentPages = 50;
+// Fetched pages waiting for the writer; bounds memory when DuckDB lags.
+constexpr std::size_t kWriteQueueCapacity = 16;
 
 #if defined(_WIN32)
 std::time_t timegm_compat(std::tm* tm) {
@@ -111,6 +122,85 @@ std::vector<domain::Candle> toDuckCandles(const std::vector<exchange::Candle>& r
     return converted;
 }
 
+struct SeriesSpec {
+    std::string symbol;
+    exchange::Interval exchangeInterval;
+    std::string intervalLabel;
+    std::int64_t intervalMs{0};
+};
+
+struct Segment {
+    std::size_t series{0};
+    std::int64_t fromSeconds{0};
+    std::int64_t toSeconds{0};
+};
+
+struct WriteBatch {
+    std::size_t series{0};
+    std::int64_t pageFrom{0};
+    std::vector<domain::Candle> rows;
+};
+
+// Blocking bounded FIFO between fetchers and the writer.
+class BatchQueue {
+public:
+    explicit BatchQueue(std::size_t capacity) : capacity_(capacity) {}
+
+    void push(WriteBatch batch) {
+        std::unique_lock lock(mutex_);
+        notFull_.wait(lock, [this] { return queue_.size() < capacity_; });
+        queue_.push_back(std::move(batch));
+        notEmpty_.notify_one();
+    }
+
+    // Returns false once closed and drained.
+    bool pop(WriteBatch& out) {
+        std::unique_lock lock(mutex_);
+        notEmpty_.wait(lock, [this] { return !queue_.empty() || closed_; });
+        if (queue_.empty()) {
+            return false;
+        }
+        out = std::move(queue_.front());
+        queue_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::scoped_lock lock(mutex_);
+        closed_ = true;
+        notEmpty_.notify_all();
+    }
+
+private:
+    const std::size_t capacity_;
+    std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+    std::deque<WriteBatch> queue_;
+    bool closed_ = false;
+};
+
+std::vector<Segment> splitSegments(const std::vector<SeriesSpec>& series,
+                                   std::int64_t fromSeconds,
+                                   std::int64_t toSeconds) {
+    std::vector<Segment> segments;
+    for (std::size_t index = 0; index < series.size(); ++index) {
+        const auto intervalSeconds = std::max<std::int64_t>(series[index].intervalMs / 1000, 1);
+        const auto span = intervalSeconds * static_cast<std::int64_t>(kPageSize) * kSegmentPages;
+        // Segment ends are inclusive for candle close times, so the next
+        // segment starting at `end` picks up the candle opening there.
+        for (std::int64_t start = fromSeconds; start < toSeconds; start += span) {
+            segments.push_back(Segment{index, start, std::min(start + span, toSeconds)});
+        }
+    }
+    // Interleave series so concurrent fetchers spread over all of them.
+    std::stable_sort(segments.begin(), segments.end(), [](const Segment& lhs, const Segment& rhs) {
+        return lhs.fromSeconds < rhs.fromSeconds;
+    });
+    return segments;
+}
+
 std::vector<std::string> deduplicateList(std::vector<std::string> values) {
     std::vector<std::string> unique;
     unique.reserve(values.size());
@@ -131,11 +221,15 @@ std::vector<std::string> deduplicateList(std::vector<std::string> values) {
 
 BackfillWorker::BackfillWorker(const ttp::common::Config& config)
     : duckdbPath_(config.duckdbPath),
+      duckdbPartition_(config.duckdbPartition),
       exchange_(config.backfillExchange.empty() ? std::string{"binance"} : config.backfillExchange),
       symbols_(config.backfillSymbols),
       intervals_(config.backfillIntervals),
       from_(config.backfillFrom.empty() ? std::string{"2025-08-01"} : config.backfillFrom),
-      to_(config.backfillTo.empty() ? std::string{"now"} : config.backfillTo) {
+      to_(config.backfillTo.empty() ? std::string{"now"} : config.backfillTo),
+      concurrency_(std::max<std::size_t>(config.backfillConcurrency, 1)),
+      weightBudget_(config.backfillWeightBudget),
+      restHost_(config.binanceRestHost) {
     if (symbols_.empty()) {
         symbols_.emplace_back("BTCUSDT");
     }
@@ -191,9 +285,11 @@ void BackfillWorker::run() {
         toSeconds = fromSeconds + 1;
     }
 
-    adapters::binance::BinanceRestClient client;
-    adapters::duckdb::DuckCandleRepo duckRepo(duckdbPath_);
+    const auto granularity = adapters::duckdb::partitionGranularityFromString(duckdbPartition_)
+                                 .value_or(adapters::duckdb::PartitionGranularity::Month);
+    adapters::duckdb::DuckCandleRepo duckRepo(duckdbPath_, granularity);
 
+    std::vector<SeriesSpec> series;
     for (const auto& symbol : symbols_) {
         for (const auto& intervalInput : intervals_) {
             exchange::Interval exchangeInterval;
@@ -210,54 +306,116 @@ void BackfillWorker::run() {
                 continue;
             }
 
-            const auto intervalLabel = domain::interval_label(domainInterval);
-
-            LOG_INFO("BackfillWorker: iniciando backfill exchange=binance symbol=" << symbol
-                                                                                   << " interval=" << intervalLabel
-                                                                                   << " from=" << fromSeconds
-                                                                                   << " to=" << toSeconds);
-
-            std::int64_t pageFrom = fromSeconds;
-            std::size_t processed = 0;
-            std::size_t lastLogged = 0;
+            series.push_back(SeriesSpec{symbol, exchangeInterval, domain::interval_label(domainInterval),
+                                        domainInterval.ms});
+        }
+    }
+    if (series.empty()) {
+        return;
+    }
 
-            while (pageFrom <= toSeconds) {
-                auto page = client.fetch_klines(symbol, exchangeInterval, pageFrom, toSeconds, kPageSize);
-                if (page.rows.empty()) {
-                    break;
-                }
+    const auto segments = splitSegments(series, fromSeconds, toSeconds);
+    const auto workers = std::min(concurrency_, segments.size());
+    for (const auto& spec : series) {
+        LOG_INFO("BackfillWorker: iniciando backfill exchange=binance symbol=" << spec.symbol
+                                                                               << " interval=" << spec.intervalLabel
+                                                                               << " from=" << fromSeconds
+                                                                               << " to=" << toSeconds);
+    }
+    LOG_INFO("BackfillWorker: segmentos=" << segments.size() << " fetchers=" << workers
+                                          << " presupuesto_peso=" << weightBudget_ << "/min");
+
+    auto budget = std::make_shared<adapters::binance::WeightBudget>(weightBudget_);
+    BatchQueue queue(kWriteQueueCapacity);
+    std::atomic<std::size_t> nextSegment{0};
+    std::atomic<std::size_t> failedSegments{0};
+
+    auto fetchLoop = [&]() {
+        adapters::binance::BinanceRestClient client(budget, restHost_);
+        for (;;) {
+            const auto segmentIndex = nextSegment.fetch_add(1);
+            if (segmentIndex >= segments.size()) {
+                return;
+            }
+            const auto& segment = segments[segmentIndex];
+            const auto& spec = series[segment.series];
 
-                auto repoRows = toDuckCandles(page.rows, domainInterval.ms);
-                if (!repoRows.empty()) {
-                    if (!duckRepo.upsert_batch(symbol, intervalLabel, repoRows)) {
-                        LOG_WARN("BackfillWorker: fallo al persistir lote symbol=" << symbol
-                                                                                   << " interval=" << intervalLabel
-                                                                                   << " desde=" << pageFrom);
-                    }
-                    processed += repoRows.size();
-                    if (processed - lastLogged >= kProgressLogInterval) {
-                        LOG_INFO("BackfillWorker: progreso symbol=" << symbol << " interval=" << intervalLabel
-                                                                      << " velas=" << processed);
-                        lastLogged = processed;
+            std::int64_t pageFrom = segment.fromSeconds;
+            try {
+                while (pageFrom <= segment.toSeconds) {
+                    auto page = client.fetch_klines(spec.symbol, spec.exchangeInterval, pageFrom, segment.toSeconds,
+                                                    kPageSize);
+                    if (page.rows.empty()) {
+                        break;
                     }
-                }
 
-                if (page.has_more && page.next_from_ts > pageFrom) {
-                    pageFrom = page.next_from_ts;
-                } else {
-                    if (page.has_more && page.next_from_ts <= pageFrom) {
-                        LOG_WARN("BackfillWorker: sin avance para symbol=" << symbol
-                                                                          << " interval=" << intervalLabel
-                                                                          << " next_from=" << page.next_from_ts
-                                                                          << " actual=" << pageFrom);
+                    queue.push(WriteBatch{segment.series, pageFrom, toDuckCandles(page.rows, spec.intervalMs)});
+
+                    if (page.has_more && page.next_from_ts > pageFrom) {
+                        pageFrom = page.next_from_ts;
+                    } else {
+                        if (page.has_more && page.next_from_ts <= pageFrom) {
+                            LOG_WARN("BackfillWorker: sin avance para symbol=" << spec.symbol
+                                                                              << " interval=" << spec.intervalLabel
+                                                                              << " next_from=" << page.next_from_ts
+                                                                              << " actual=" << pageFrom);
+                        }
+                        break;
                     }
-                    break;
                 }
+            } catch (const std::exception& ex) {
+                failedSegments.fetch_add(1);
+                LOG_ERR("BackfillWorker: fallo al descargar symbol=" << spec.symbol << " interval="
+                                                                      << spec.intervalLabel << " desde=" << pageFrom
+                                                                      << " hasta=" << segment.toSeconds
+                                                                      << " error=" << ex.what());
             }
+        }
+    };
+
+    std::vector<std::thread> fetchers;
+    fetchers.reserve(workers);
+    for (std::size_t i = 0; i < workers; ++i) {
+        fetchers.emplace_back(fetchLoop);
+    }
+    std::thread closer([&]() {
+        for (auto& fetcher : fetchers) {
+            fetcher.join();
+        }
+        queue.close();
+    });
 
-            LOG_INFO("BackfillWorker: completado symbol=" << symbol << " interval=" << intervalLabel
-                                                            << " velas procesadas=" << processed);
+    // DuckDB keeps a single writer; persistence overlaps with the fetchers above.
+    std::vector<std::size_t> processed(series.size(), 0);
+    std::vector<std::size_t> lastLogged(series.size(), 0);
+    WriteBatch batch;
+    while (queue.pop(batch)) {
+        const auto& spec = series[batch.series];
+        if (batch.rows.empty()) {
+            continue;
+        }
+        if (!duckRepo.upsert_batch(spec.symbol, spec.intervalLabel, batch.rows)) {
+            LOG_WARN("BackfillWorker: fallo al persistir lote symbol=" << spec.symbol
+                                                                       << " interval=" << spec.intervalLabel
+                                                                       << " desde=" << batch.pageFrom);
         }
+        auto& count = processed[batch.series];
+        count += batch.rows.size();
+        if (count - lastLogged[batch.series] >= kProgressLogInterval) {
+            LOG_INFO("BackfillWorker: progreso symbol=" << spec.symbol << " interval=" << spec.intervalLabel
+                                                          << " velas=" << count);
+            lastLogged[batch.series] = count;
+        }
+    }
+    closer.join();
+
+    for (std::size_t i = 0; i < series.size(); ++i) {
+        LOG_INFO("BackfillWorker: completado symbol=" << series[i].symbol << " interval=" << series[i].intervalLabel
+                                                        << " velas procesadas=" << processed[i]);
+    }
+    if (failedSegments.load() > 0) {
+        LOG_WARN("BackfillWorker: segmentos con error=" << failedSegments.load()
+                                                        << "; relanzar el backfill completa los huecos");
     }
 #endif
 }
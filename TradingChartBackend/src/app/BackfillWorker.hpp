@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -9,6 +11,9 @@ struct Config;
 
 namespace app {
 
+// Historical backfill: series are split into time segments fetched by
+// `concurrency_` threads under one shared Binance weight budget, while a
+// single writer persists the fetched pages to DuckDB.
 class BackfillWorker {
 public:
     explicit BackfillWorker(const ttp::common::Config& config);
@@ -17,11 +22,15 @@ public:
 
 private:
     std::string duckdbPath_;
+    std::string duckdbPartition_;
     std::string exchange_;
     std::vector<std::string> symbols_;
     std::vector<std::string> intervals_;
     std::string from_;
     std::string to_;
+    std::size_t concurrency_;
+    std::uint32_t weightBudget_;
+    std::string restHost_;
 };
 
 }  // namespace app
@@ -13,11 +13,12 @@
 #include <utility>
 #include <cerrno>
 
-#include "adapters/duckdb/DuckCandleRepo.hpp"
 #include "api/WebSocketServer.hpp"
 #include "domain/Types.h"
 #include "logging/Log.h"
 #include "common/Metrics.hpp"
+#include "common/Trace.hpp"
+#include "indicators/IndicatorCache.h"
 
 namespace app {
 namespace {
@@ -170,10 +171,18 @@ void broadcast_candle(const std::string& symbol,
 
 }  // namespace
 
-LiveIngestor::LiveIngestor(adapters::duckdb::DuckCandleRepo& repo,
+struct LiveIngestor::CatchUpRecovery {
+    std::chrono::steady_clock::time_point startedAt;
+    std::mutex mutex;
+    std::size_t remaining{0};
+    std::vector<std::string> resynced;
+};
+
+LiveIngestor::LiveIngestor(domain::contracts::ICandleWriteRepo& repo,
                            domain::IExchangeKlines& rest,
-                           domain::IExchangeLiveKlines& ws)
-    : repo_(repo), rest_(rest), ws_(ws) {}
+                           domain::IExchangeLiveKlines& ws,
+                           std::size_t catchUpConcurrency)
+    : repo_(repo), rest_(rest), ws_(ws), catchUpConcurrency_(std::max<std::size_t>(1, catchUpConcurrency)) {}
 
 LiveIngestor::~LiveIngestor() {
     stop();
@@ -185,6 +194,8 @@ void LiveIngestor::run(const std::vector<std::string>& symbols, domain::Interval
     }
 
     stopRequested_.store(false, std::memory_order_relaxed);
+    start_writer_();
+    start_catch_up_pool_();
 
     std::vector<std::string> symbolsCopy = symbols;
     worker_ = std::thread([this, symbolsCopy = std::move(symbolsCopy), interval]() mutable {
@@ -428,7 +439,7 @@ void LiveIngestor::run_worker_(std::vector<std::string> symbols, domain::Interva
                     break;
                 }
 
-                bool persisted = repo_.upsert_batch(symbol, intervalLabel, repoRows);
+                const bool persisted = submit_write_(symbol, intervalLabel, repoRows).get();
                 if (!persisted) {
                     LOG_WARN(kLogCategory,
                              "LiveIngestor: failed to persist resync batch symbol=%s interval=%s size=%zu",
@@ -507,32 +518,24 @@ void LiveIngestor::run_worker_(std::vector<std::string> symbols, domain::Interva
              intervalLabel.c_str(),
              sanitized.size());
 
-    ws_.set_on_reconnected([this,
-                             intervalLabel,
-                             interval,
-                             intervalMs,
-                             symbols = sanitized]() {
+    for (const auto& symbol : sanitized) {
+        indicators::IndicatorCache::instance().trackSeries(indicators::seriesKey(symbol, intervalLabel), intervalMs);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(catchUpMutex_);
+        catchUpIntervalLabel_ = intervalLabel;
+        catchUpInterval_ = interval;
+        catchUpIntervalMs_ = intervalMs;
+    }
+
+    // Runs on the feed thread: only queue the work so live klines keep flowing
+    // while the pool backfills the gap.
+    ws_.set_on_reconnected([this, symbols = sanitized]() {
         if (stopRequested_.load(std::memory_order_relaxed)) {
             return;
         }
-        try {
-            this->catch_up_(symbols, intervalLabel, interval, intervalMs);
-            LOG_INFO(kLogCategory,
-                     "LiveIngestor: WS ready interval=%s symbols=%zu",
-                     intervalLabel.c_str(),
-                     symbols.size());
-        }
-        catch (const std::exception& ex) {
-            LOG_WARN(kLogCategory,
-                     "LiveIngestor: catch-up on reconnect failed interval=%s error=%s",
-                     intervalLabel.c_str(),
-                     ex.what());
-        }
-        catch (...) {
-            LOG_WARN(kLogCategory,
-                     "LiveIngestor: catch-up on reconnect failed with unknown error interval=%s",
-                     intervalLabel.c_str());
-        }
+        this->schedule_catch_up_(symbols);
     });
 
     try {
@@ -592,12 +595,12 @@ void LiveIngestor::run_worker_(std::vector<std::string> symbols, domain::Interva
                                   }
                               }
 
-                              if (shouldPersist) {
-                                  std::vector<domain::Candle> rows;
-                                  rows.reserve(1);
-                                  rows.push_back(snapshot);
+                              ttp::common::trace::mark(ttp::common::trace::Stage::Processed);
 
-                                  const bool persisted = repo_.upsert_batch(symbol, intervalLabel, rows);
+                              if (shouldPersist) {
+                                  // Waits for the writer: the candle is stored before it
+                                  // is broadcast as final.
+                                  const bool persisted = submit_write_(symbol, intervalLabel, {snapshot}).get();
                                   if (!persisted) {
                                       LOG_WARN(kLogCategory,
                                                "LiveIngestor: failed to persist live candle symbol=%s interval=%s open_ms=%lld",
@@ -605,10 +608,21 @@ void LiveIngestor::run_worker_(std::vector<std::string> symbols, domain::Interva
                                                intervalLabel.c_str(),
                                                static_cast<long long>(snapshot.openTime));
                                   } else {
+                                      ttp::common::trace::mark(ttp::common::trace::Stage::Persisted);
                                       record_last_closed_open_(symbol, snapshot.openTime);
                                   }
                               }
 
+                              indicators::IndicatorCache::instance().onCandle(
+                                  indicators::seriesKey(symbol, intervalLabel),
+                                  indicators::IndicatorBar{snapshot.openTime,
+                                                           snapshot.high,
+                                                           snapshot.low,
+                                                           snapshot.close,
+                                                           snapshot.baseVolume},
+                                  snapshot.isClosed);
+                              ttp::common::trace::mark(ttp::common::trace::Stage::Indicators);
+
                               if (shouldBroadcast) {
                                   broadcast_candle(symbol, intervalLabel, snapshot, snapshot.isClosed);
                               }
@@ -641,180 +655,424 @@ void LiveIngestor::run_worker_(std::vector<std::string> symbols, domain::Interva
     }
 }
 
-void LiveIngestor::catch_up_(const std::vector<std::string>& symbols,
-                             const std::string& intervalLabel,
-                             domain::Interval interval,
-                             std::int64_t intervalMs) {
-    if (intervalMs <= 0 || stopRequested_.load(std::memory_order_relaxed)) {
-        return;
+void LiveIngestor::start_writer_() {
+    if (writer_.joinable()) {
+        stop_writer_();
+    }
+    {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        writeStopping_ = false;
     }
+    writer_ = std::thread([this]() { this->writer_loop_(); });
+}
 
-    const auto nowOpenOpt = current_open_candle_floor(intervalMs);
-    if (!nowOpenOpt.has_value()) {
-        return;
+void LiveIngestor::stop_writer_() {
+    {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        writeStopping_ = true;
     }
-    const auto nowOpenMs = *nowOpenOpt;
-    std::vector<std::string> resyncedSymbols;
+    writeCv_.notify_all();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+}
 
-    for (const auto& symbol : symbols) {
-        if (stopRequested_.load(std::memory_order_relaxed)) {
-            break;
+std::future<bool> LiveIngestor::submit_write_(const std::string& symbol,
+                                              const std::string& interval,
+                                              std::vector<domain::Candle> rows) {
+    PendingWrite write{symbol, interval, std::move(rows), {}};
+    auto done = write.done.get_future();
+    {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        if (!writeStopping_ && writer_.joinable()) {
+            writeQueue_.push_back(std::move(write));
+            writeCv_.notify_one();
+            return done;
         }
+    }
+    write.done.set_value(false);
+    return done;
+}
 
-        auto lastOpenOpt = get_last_closed_open_ms_(symbol, intervalLabel, intervalMs);
-        if (!lastOpenOpt.has_value()) {
-            LOG_DEBUG(kLogCategory,
-                      "LiveIngestor: catch-up skipped symbol=%s interval=%s reason=no-last-open",
-                      symbol.c_str(),
-                      intervalLabel.c_str());
-            continue;
+// DuckDB keeps a single writer: catch-up workers fetch in parallel, but their
+// pages, resync batches and live closes are all stored from here, in order.
+void LiveIngestor::writer_loop_() {
+    while (true) {
+        PendingWrite write;
+        {
+            std::unique_lock<std::mutex> lock(writeMutex_);
+            writeCv_.wait(lock, [this]() { return writeStopping_ || !writeQueue_.empty(); });
+            if (writeQueue_.empty()) {
+                return;
+            }
+            write = std::move(writeQueue_.front());
+            writeQueue_.pop_front();
         }
 
-        auto currentStartOpen = *lastOpenOpt + intervalMs;
-        if (currentStartOpen >= nowOpenMs) {
-            LOG_DEBUG(kLogCategory,
-                      "LiveIngestor: catch-up not required symbol=%s interval=%s start_open_ms=%lld now_open_ms=%lld",
-                      symbol.c_str(),
-                      intervalLabel.c_str(),
-                      static_cast<long long>(currentStartOpen),
-                      static_cast<long long>(nowOpenMs));
-            continue;
+        bool persisted = false;
+        try {
+            persisted = repo_.upsert_batch(write.symbol, write.interval, write.rows);
         }
-        currentStartOpen = std::max<std::int64_t>(0, currentStartOpen);
+        catch (const std::exception& ex) {
+            LOG_WARN(kLogCategory,
+                     "LiveIngestor: upsert failed symbol=%s interval=%s error=%s",
+                     write.symbol.c_str(),
+                     write.interval.c_str(),
+                     ex.what());
+        }
+        catch (...) {
+            LOG_WARN(kLogCategory,
+                     "LiveIngestor: upsert failed with unknown error symbol=%s interval=%s",
+                     write.symbol.c_str(),
+                     write.interval.c_str());
+        }
+        write.done.set_value(persisted);
+    }
+}
 
-        LOG_INFO(kLogCategory,
-                 "LiveIngestor: catch-up starting symbol=%s interval=%s from_open_ms=%lld to_open_ms=%lld",
-                 symbol.c_str(),
-                 intervalLabel.c_str(),
-                 static_cast<long long>(currentStartOpen),
-                 static_cast<long long>(nowOpenMs));
+void LiveIngestor::start_catch_up_pool_() {
+    if (!catchUpWorkers_.empty()) {
+        stop_catch_up_pool_();
+    }
+    {
+        std::lock_guard<std::mutex> lock(catchUpMutex_);
+        catchUpStopping_ = false;
+        catchUpQueue_.clear();
+        catchUpStates_.clear();
+    }
+    catchUpWorkers_.reserve(catchUpConcurrency_);
+    for (std::size_t i = 0; i < catchUpConcurrency_; ++i) {
+        catchUpWorkers_.emplace_back([this]() { this->catch_up_worker_(); });
+    }
+}
 
-        std::size_t totalPersisted = 0;
+void LiveIngestor::stop_catch_up_pool_() {
+    {
+        std::lock_guard<std::mutex> lock(catchUpMutex_);
+        catchUpStopping_ = true;
+        catchUpQueue_.clear();
+        catchUpStates_.clear();
+    }
+    catchUpCv_.notify_all();
+    for (auto& worker : catchUpWorkers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    catchUpWorkers_.clear();
+}
 
-        while (!stopRequested_.load(std::memory_order_relaxed) && currentStartOpen < nowOpenMs) {
-            const auto maxWindow = static_cast<std::int64_t>(kResyncPageLimit) * intervalMs;
-            auto endOpenMs = currentStartOpen + maxWindow;
-            if (endOpenMs > nowOpenMs) {
-                endOpenMs = nowOpenMs;
-            }
-            if (endOpenMs <= currentStartOpen) {
-                break;
-            }
+void LiveIngestor::schedule_catch_up_(const std::vector<std::string>& symbols) {
+    if (symbols.empty()) {
+        return;
+    }
 
-            exchange::KlinesPage page;
-            try {
-                page = rest_.fetch_klines(symbol,
-                                          interval,
-                                          currentStartOpen / 1000,
-                                          endOpenMs / 1000,
-                                          kResyncPageLimit);
-            }
-            catch (const std::exception& ex) {
-                LOG_WARN(kLogCategory,
-                         "LiveIngestor: catch-up REST failed symbol=%s interval=%s start_open=%lld end_open=%lld error=%s",
-                         symbol.c_str(),
-                         intervalLabel.c_str(),
-                         static_cast<long long>(currentStartOpen),
-                         static_cast<long long>(endOpenMs),
-                         ex.what());
-                break;
-            }
-            catch (...) {
-                LOG_WARN(kLogCategory,
-                         "LiveIngestor: catch-up REST failed with unknown error symbol=%s interval=%s start_open=%lld end_open=%lld",
-                         symbol.c_str(),
-                         intervalLabel.c_str(),
-                         static_cast<long long>(currentStartOpen),
-                         static_cast<long long>(endOpenMs));
-                break;
-            }
+    auto recovery = std::make_shared<CatchUpRecovery>();
+    recovery->startedAt = std::chrono::steady_clock::now();
+    recovery->remaining = symbols.size();
 
-            if (page.rows.empty()) {
-                LOG_INFO(kLogCategory,
-                         "LiveIngestor: catch-up returned empty page symbol=%s interval=%s start_open=%lld end_open=%lld",
-                         symbol.c_str(),
-                         intervalLabel.c_str(),
-                         static_cast<long long>(currentStartOpen),
-                         static_cast<long long>(endOpenMs));
-                break;
+    std::size_t queued = 0;
+    {
+        std::lock_guard<std::mutex> lock(catchUpMutex_);
+        if (catchUpStopping_) {
+            return;
+        }
+        for (const auto& symbol : symbols) {
+            auto& state = catchUpStates_[symbol];
+            state.waiting.push_back(recovery);
+            if (!state.queued && !state.running) {
+                state.queued = true;
+                catchUpQueue_.push_back(symbol);
+                ++queued;
             }
+        }
+    }
+    catchUpCv_.notify_all();
 
-            auto repoRows = to_domain_candles(page.rows, intervalMs);
-            while (!repoRows.empty()) {
-                const auto lastOpenCandidate = domain::align_down_ms(repoRows.back().closeTime, intervalMs);
-                if (lastOpenCandidate < nowOpenMs) {
-                    break;
-                }
-                repoRows.pop_back();
-            }
+    ttp::common::metrics::Registry::instance().incrementCounter("catchup.recoveries_started_total");
+    LOG_DEBUG(kLogCategory,
+              "LiveIngestor: catch-up scheduled symbols=%zu queued=%zu coalesced=%zu",
+              symbols.size(),
+              queued,
+              symbols.size() - queued);
+}
 
-            if (repoRows.empty()) {
-                LOG_INFO(kLogCategory,
-                         "LiveIngestor: catch-up batch discarded symbol=%s interval=%s start_open=%lld",
-                         symbol.c_str(),
-                         intervalLabel.c_str(),
-                         static_cast<long long>(currentStartOpen));
-                break;
+void LiveIngestor::catch_up_worker_() {
+    while (true) {
+        std::string symbol;
+        std::string intervalLabel;
+        domain::Interval interval{};
+        std::int64_t intervalMs = 0;
+        std::vector<std::shared_ptr<CatchUpRecovery>> recoveries;
+        {
+            std::unique_lock<std::mutex> lock(catchUpMutex_);
+            catchUpCv_.wait(lock, [this]() { return catchUpStopping_ || !catchUpQueue_.empty(); });
+            if (catchUpStopping_) {
+                return;
             }
+            symbol = std::move(catchUpQueue_.front());
+            catchUpQueue_.pop_front();
+            auto& state = catchUpStates_[symbol];
+            state.queued = false;
+            state.running = true;
+            recoveries.swap(state.waiting);
+            intervalLabel = catchUpIntervalLabel_;
+            interval = catchUpInterval_;
+            intervalMs = catchUpIntervalMs_;
+        }
 
-            const bool persisted = repo_.upsert_batch(symbol, intervalLabel, repoRows);
-            if (!persisted) {
-                LOG_WARN(kLogCategory,
-                         "LiveIngestor: failed to persist catch-up batch symbol=%s interval=%s size=%zu",
-                         symbol.c_str(),
-                         intervalLabel.c_str(),
-                         repoRows.size());
-                break;
-            }
+        std::size_t persisted = 0;
+        try {
+            persisted = catch_up_symbol_(symbol, intervalLabel, interval, intervalMs);
+        }
+        catch (const std::exception& ex) {
+            LOG_WARN(kLogCategory,
+                     "LiveIngestor: catch-up failed symbol=%s interval=%s error=%s",
+                     symbol.c_str(),
+                     intervalLabel.c_str(),
+                     ex.what());
+        }
+        catch (...) {
+            LOG_WARN(kLogCategory,
+                     "LiveIngestor: catch-up failed with unknown error symbol=%s interval=%s",
+                     symbol.c_str(),
+                     intervalLabel.c_str());
+        }
 
-            ttp::common::metrics::Registry::instance().incrementCounter(
-                "rest_catchup_candles_total",
-                static_cast<std::uint64_t>(repoRows.size()));
-
-            const auto lastCloseMs = repoRows.back().closeTime;
-            const auto lastOpenMs = domain::align_down_ms(lastCloseMs, intervalMs);
-            record_last_closed_open_(symbol, lastOpenMs);
-            totalPersisted += repoRows.size();
-
-            const auto nextStartOpen = lastOpenMs + intervalMs;
-            if (nextStartOpen <= currentStartOpen) {
-                LOG_WARN(kLogCategory,
-                         "LiveIngestor: catch-up stalled symbol=%s interval=%s current_start=%lld next_start=%lld",
-                         symbol.c_str(),
-                         intervalLabel.c_str(),
-                         static_cast<long long>(currentStartOpen),
-                         static_cast<long long>(nextStartOpen));
-                break;
+        {
+            std::lock_guard<std::mutex> lock(catchUpMutex_);
+            const auto it = catchUpStates_.find(symbol);
+            if (it != catchUpStates_.end()) {
+                it->second.running = false;
+                if (!it->second.waiting.empty()) {
+                    // A reconnect arrived mid-run; its gap may end after ours.
+                    it->second.queued = true;
+                    catchUpQueue_.push_back(symbol);
+                    catchUpCv_.notify_one();
+                }
+                else {
+                    catchUpStates_.erase(it);
+                }
             }
-
-            currentStartOpen = nextStartOpen;
         }
 
-        LOG_INFO(kLogCategory,
-                 "LiveIngestor: catch-up completed symbol=%s interval=%s persisted=%zu",
-                 symbol.c_str(),
-                 intervalLabel.c_str(),
-                 totalPersisted);
+        for (const auto& recovery : recoveries) {
+            finish_recovery_(*recovery, symbol, persisted);
+        }
+    }
+}
 
-        if (totalPersisted > 0) {
-            resyncedSymbols.push_back(symbol);
+void LiveIngestor::finish_recovery_(CatchUpRecovery& recovery, const std::string& symbol, std::size_t persisted) {
+    std::vector<std::string> resynced;
+    {
+        std::lock_guard<std::mutex> lock(recovery.mutex);
+        if (persisted > 0) {
+            recovery.resynced.push_back(symbol);
         }
+        if (recovery.remaining == 0 || --recovery.remaining > 0) {
+            return;
+        }
+        resynced.swap(recovery.resynced);
     }
 
-    if (!resyncedSymbols.empty()) {
+    const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                               std::chrono::steady_clock::now() - recovery.startedAt)
+                               .count();
+    auto& metrics = ttp::common::metrics::Registry::instance();
+    metrics.setGauge("catchup.last_recovery_ms", static_cast<double>(elapsedMs));
+    metrics.incrementCounter("catchup.recoveries_total");
+
+    std::string intervalLabel;
+    {
+        std::lock_guard<std::mutex> lock(catchUpMutex_);
+        intervalLabel = catchUpIntervalLabel_;
+    }
+
+    LOG_INFO(kLogCategory,
+             "LiveIngestor: WS ready interval=%s resynced_symbols=%zu recovery_ms=%lld",
+             intervalLabel.c_str(),
+             resynced.size(),
+             static_cast<long long>(elapsedMs));
+
+    if (!resynced.empty()) {
         std::ostringstream oss;
         oss << "{\"type\":\"resync_done\",\"interval\":\"" << intervalLabel << "\",\"symbols\":[";
-        for (std::size_t i = 0; i < resyncedSymbols.size(); ++i) {
+        for (std::size_t i = 0; i < resynced.size(); ++i) {
             if (i > 0) {
                 oss << ',';
             }
-            oss << "\"" << resyncedSymbols[i] << "\"";
+            oss << "\"" << resynced[i] << "\"";
         }
         oss << "]}";
         ttp::api::broadcast(oss.str());
     }
 }
 
+std::size_t LiveIngestor::catch_up_symbol_(const std::string& symbol,
+                                           const std::string& intervalLabel,
+                                           domain::Interval interval,
+                                           std::int64_t intervalMs) {
+    if (intervalMs <= 0 || stopRequested_.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+
+    const auto nowOpenOpt = current_open_candle_floor(intervalMs);
+    if (!nowOpenOpt.has_value()) {
+        return 0;
+    }
+    const auto nowOpenMs = *nowOpenOpt;
+
+    auto lastOpenOpt = get_last_closed_open_ms_(symbol, intervalLabel, intervalMs);
+    if (!lastOpenOpt.has_value()) {
+        LOG_DEBUG(kLogCategory,
+                  "LiveIngestor: catch-up skipped symbol=%s interval=%s reason=no-last-open",
+                  symbol.c_str(),
+                  intervalLabel.c_str());
+        return 0;
+    }
+
+    auto currentStartOpen = *lastOpenOpt + intervalMs;
+    if (currentStartOpen >= nowOpenMs) {
+        LOG_DEBUG(kLogCategory,
+                  "LiveIngestor: catch-up not required symbol=%s interval=%s start_open_ms=%lld now_open_ms=%lld",
+                  symbol.c_str(),
+                  intervalLabel.c_str(),
+                  static_cast<long long>(currentStartOpen),
+                  static_cast<long long>(nowOpenMs));
+        return 0;
+    }
+    currentStartOpen = std::max<std::int64_t>(0, currentStartOpen);
+
+    LOG_INFO(kLogCategory,
+             "LiveIngestor: catch-up starting symbol=%s interval=%s from_open_ms=%lld to_open_ms=%lld",
+             symbol.c_str(),
+             intervalLabel.c_str(),
+             static_cast<long long>(currentStartOpen),
+             static_cast<long long>(nowOpenMs));
+
+    std::size_t totalPersisted = 0;
+
+    // The page in the writer's hands while the next one is fetched.
+    std::future<bool> pendingWrite;
+    std::size_t pendingRows = 0;
+    std::int64_t pendingLastOpenMs = 0;
+    const auto settlePending = [&]() {
+        if (!pendingWrite.valid()) {
+            return true;
+        }
+        if (!pendingWrite.get()) {
+            LOG_WARN(kLogCategory,
+                     "LiveIngestor: failed to persist catch-up batch symbol=%s interval=%s size=%zu",
+                     symbol.c_str(),
+                     intervalLabel.c_str(),
+                     pendingRows);
+            return false;
+        }
+        ttp::common::metrics::Registry::instance().incrementCounter("rest_catchup_candles_total",
+                                                                    static_cast<std::uint64_t>(pendingRows));
+        record_last_closed_open_(symbol, pendingLastOpenMs);
+        totalPersisted += pendingRows;
+        return true;
+    };
+
+    while (!stopRequested_.load(std::memory_order_relaxed) && currentStartOpen < nowOpenMs) {
+        const auto maxWindow = static_cast<std::int64_t>(kResyncPageLimit) * intervalMs;
+        auto endOpenMs = currentStartOpen + maxWindow;
+        if (endOpenMs > nowOpenMs) {
+            endOpenMs = nowOpenMs;
+        }
+        if (endOpenMs <= currentStartOpen) {
+            break;
+        }
+
+        exchange::KlinesPage page;
+        try {
+            page = rest_.fetch_klines(symbol,
+                                      interval,
+                                      currentStartOpen / 1000,
+                                      endOpenMs / 1000,
+                                      kResyncPageLimit);
+        }
+        catch (const std::exception& ex) {
+            LOG_WARN(kLogCategory,
+                     "LiveIngestor: catch-up REST failed symbol=%s interval=%s start_open=%lld end_open=%lld error=%s",
+                     symbol.c_str(),
+                     intervalLabel.c_str(),
+                     static_cast<long long>(currentStartOpen),
+                     static_cast<long long>(endOpenMs),
+                     ex.what());
+            break;
+        }
+        catch (...) {
+            LOG_WARN(kLogCategory,
+                     "LiveIngestor: catch-up REST failed with unknown error symbol=%s interval=%s start_open=%lld end_open=%lld",
+                     symbol.c_str(),
+                     intervalLabel.c_str(),
+                     static_cast<long long>(currentStartOpen),
+                     static_cast<long long>(endOpenMs));
+            break;
+        }
+
+        if (page.rows.empty()) {
+            LOG_INFO(kLogCategory,
+                     "LiveIngestor: catch-up returned empty page symbol=%s interval=%s start_open=%lld end_open=%lld",
+                     symbol.c_str(),
+                     intervalLabel.c_str(),
+                     static_cast<long long>(currentStartOpen),
+                     static_cast<long long>(endOpenMs));
+            break;
+        }
+
+        auto repoRows = to_domain_candles(page.rows, intervalMs);
+        while (!repoRows.empty()) {
+            const auto lastOpenCandidate = domain::align_down_ms(repoRows.back().closeTime, intervalMs);
+            if (lastOpenCandidate < nowOpenMs) {
+                break;
+            }
+            repoRows.pop_back();
+        }
+
+        if (repoRows.empty()) {
+            LOG_INFO(kLogCategory,
+                     "LiveIngestor: catch-up batch discarded symbol=%s interval=%s start_open=%lld",
+                     symbol.c_str(),
+                     intervalLabel.c_str(),
+                     static_cast<long long>(currentStartOpen));
+            break;
+        }
+
+        if (!settlePending()) {
+            break;
+        }
+        const auto lastCloseMs = repoRows.back().closeTime;
+        const auto lastOpenMs = domain::align_down_ms(lastCloseMs, intervalMs);
+        pendingRows = repoRows.size();
+        pendingLastOpenMs = lastOpenMs;
+        pendingWrite = submit_write_(symbol, intervalLabel, std::move(repoRows));
+
+        const auto nextStartOpen = lastOpenMs + intervalMs;
+        if (nextStartOpen <= currentStartOpen) {
+            LOG_WARN(kLogCategory,
+                     "LiveIngestor: catch-up stalled symbol=%s interval=%s current_start=%lld next_start=%lld",
+                     symbol.c_str(),
+                     intervalLabel.c_str(),
+                     static_cast<long long>(currentStartOpen),
+                     static_cast<long long>(nextStartOpen));
+            break;
+        }
+
+        currentStartOpen = nextStartOpen;
+    }
+    settlePending();
+
+    LOG_INFO(kLogCategory,
+             "LiveIngestor: catch-up completed symbol=%s interval=%s persisted=%zu",
+             symbol.c_str(),
+             intervalLabel.c_str(),
+             totalPersisted);
+    return totalPersisted;
+}
+
 std::optional<std::int64_t> LiveIngestor::get_last_closed_open_ms_(const std::string& symbol,
                                                                    const std::string& intervalLabel,
                                                                    std::int64_t intervalMs) {
@@ -878,9 +1136,14 @@ void LiveIngestor::stop() {
         LOG_WARN(kLogCategory, "LiveIngestor: stop signalled but websocket stop failed with unknown error");
     }
 
+    stop_catch_up_pool_();
+
     if (worker_.joinable()) {
         worker_.join();
     }
+
+    // Last, so writes the threads above were waiting on still complete.
+    stop_writer_();
 }
 
 }  // namespace app
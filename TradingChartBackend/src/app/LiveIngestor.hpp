@@ -1,6 +1,10 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
@@ -9,19 +13,22 @@
 #include <vector>
 #include <functional>
 
+#include "domain/Ports.hpp"
 #include "domain/exchange/IExchangeKlines.hpp"
 
-namespace adapters::duckdb {
-class DuckCandleRepo;
-}
-
 namespace app {
 
 class LiveIngestor {
 public:
-    LiveIngestor(adapters::duckdb::DuckCandleRepo& repo,
+    static constexpr std::size_t kDefaultCatchUpConcurrency = 4;
+
+    // catchUpConcurrency bounds the REST catch-up pool, and with it the number
+    // of kline requests in flight after a reconnect. Writes to `repo` all go
+    // through one persistence thread, whatever thread produced them.
+    LiveIngestor(domain::contracts::ICandleWriteRepo& repo,
                  domain::IExchangeKlines& rest,
-                 domain::IExchangeLiveKlines& ws);
+                 domain::IExchangeLiveKlines& ws,
+                 std::size_t catchUpConcurrency = kDefaultCatchUpConcurrency);
 
     ~LiveIngestor();
 
@@ -51,17 +58,49 @@ private:
         }
     };
 
+    // One reconnect: completes when every symbol it scheduled has caught up.
+    struct CatchUpRecovery;
+
+    // Per-symbol catch-up slot. A symbol is never fetched by two workers at
+    // once; reconnects that arrive while it is queued or running attach to
+    // `waiting` and are served by the next run.
+    struct CatchUpState {
+        bool queued{false};
+        bool running{false};
+        std::vector<std::shared_ptr<CatchUpRecovery>> waiting;
+    };
+
+    struct PendingWrite {
+        std::string symbol;
+        std::string interval;
+        std::vector<domain::Candle> rows;
+        std::promise<bool> done;
+    };
+
     void run_worker_(std::vector<std::string> symbols, domain::Interval interval);
-    void catch_up_(const std::vector<std::string>& symbols,
-                   const std::string& intervalLabel,
-                   domain::Interval interval,
-                   std::int64_t intervalMs);
+    void start_writer_();
+    void stop_writer_();
+    void writer_loop_();
+    // Queues rows for the persistence thread; the future holds upsert_batch's
+    // result (false once the writer has stopped).
+    std::future<bool> submit_write_(const std::string& symbol,
+                                    const std::string& interval,
+                                    std::vector<domain::Candle> rows);
+    void start_catch_up_pool_();
+    void stop_catch_up_pool_();
+    void catch_up_worker_();
+    void schedule_catch_up_(const std::vector<std::string>& symbols);
+    std::size_t catch_up_symbol_(const std::string& symbol,
+                                 const std::string& intervalLabel,
+                                 domain::Interval interval,
+                                 std::int64_t intervalMs);
+    void finish_recovery_(CatchUpRecovery& recovery, const std::string& symbol, std::size_t persisted);
     std::optional<std::int64_t> get_last_closed_open_ms_(const std::string& symbol,
                                                          const std::string& intervalLabel,
                                                          std::int64_t intervalMs);
     void record_last_closed_open_(const std::string& symbol, std::int64_t openMs);
 
-    adapters::duckdb::DuckCandleRepo& repo_;
+    domain::contracts::ICandleWriteRepo& repo_;
     domain::IExchangeKlines& rest_;
     domain::IExchangeLiveKlines& ws_;
     std::atomic<bool> stopRequested_{false};
@@ -73,6 +112,23 @@ private:
     std::unordered_map<LiveKey, std::int64_t, LiveKeyHash> lastBroadcastMs_;
     std::int64_t partialThrottleMs_{0};
     bool emitPartials_{true};
+
+    const std::size_t catchUpConcurrency_;
+    std::mutex catchUpMutex_;
+    std::condition_variable catchUpCv_;
+    bool catchUpStopping_{false};
+    std::deque<std::string> catchUpQueue_;
+    std::unordered_map<std::string, CatchUpState> catchUpStates_;
+    std::string catchUpIntervalLabel_;
+    domain::Interval catchUpInterval_{};
+    std::int64_t catchUpIntervalMs_{0};
+    std::vector<std::thread> catchUpWorkers_;
+
+    std::mutex writeMutex_;
+    std::condition_variable writeCv_;
+    bool writeStopping_{false};
+    std::deque<PendingWrite> writeQueue_;
+    std::thread writer_;
 };
 
 }  // namespace app
@@ -0,0 +1,251 @@
+#include "app/TradeAggregator.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#include "domain/Models.hpp"
+
+namespace app {
+namespace {
+
+constexpr std::int64_t kMinuteMs = 60'000;
+
+domain::contracts::Candle to_contract(const domain::Candle& candle) {
+    domain::contracts::Candle out{};
+    out.ts = candle.openTime;
+    out.o = candle.open;
+    out.h = candle.high;
+    out.l = candle.low;
+    out.c = candle.close;
+    out.v = candle.baseVolume;
+    return out;
+}
+
+void start_bar(domain::Candle& bar, std::int64_t openMs, std::int64_t intervalMs, const domain::AggTrade& trade) {
+    bar.openTime = openMs;
+    bar.closeTime = openMs + intervalMs - 1;
+    bar.open = trade.price;
+    bar.high = trade.price;
+    bar.low = trade.price;
+    bar.close = trade.price;
+    bar.baseVolume = trade.quantity;
+    bar.quoteVolume = trade.price * trade.quantity;
+    bar.trades = 1;
+    bar.isClosed = false;
+}
+
+}  // namespace
+
+TradeAggregator::TradeAggregator(std::vector<domain::Interval> intervals, std::int64_t retentionMs)
+    : intervals_(std::move(intervals)), retentionMs_(std::max<std::int64_t>(retentionMs, 0)) {
+    for (const auto& interval : intervals_) {
+        if (!interval.valid() || kMinuteMs % interval.ms != 0) {
+            throw std::invalid_argument("TradeAggregator: interval must divide one minute");
+        }
+    }
+}
+
+void TradeAggregator::on_trade(std::string_view symbol, const domain::AggTrade& trade) {
+    SymbolState* state = lastState_;
+    if (state == nullptr || symbol != lastSymbol_) {
+        state = &state_for_(symbol);
+        lastSymbol_.assign(symbol.data(), symbol.size());
+        lastState_ = state;
+    }
+
+    trades_.fetch_add(1, std::memory_order_relaxed);
+    auto latest = latestTradeMs_.load(std::memory_order_relaxed);
+    while (trade.tradeTime > latest
+           && !latestTradeMs_.compare_exchange_weak(latest, trade.tradeTime, std::memory_order_relaxed)) {
+    }
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+    for (auto& series : state->series) {
+        const auto openMs = domain::align_down_ms(trade.tradeTime, series.intervalMs);
+        auto& bar = series.open;
+        if (series.hasOpen && openMs == bar.openTime) {
+            bar.high = std::max(bar.high, trade.price);
+            bar.low = std::min(bar.low, trade.price);
+            bar.close = trade.price;
+            bar.baseVolume += trade.quantity;
+            bar.quoteVolume += trade.price * trade.quantity;
+            ++bar.trades;
+            series.dirty = true;
+            continue;
+        }
+        const bool late = series.hasOpen ? openMs < bar.openTime
+                                         : !series.closed.empty() && openMs <= series.closed.back().openTime;
+        if (late) {
+            // aggTrade is ordered per symbol, so this is a straggler after
+            // close_idle_bars or a reconnect; its bar is already published.
+            lateTrades_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (series.hasOpen) {
+            close_bar_(*state, series);
+        }
+        start_bar(bar, openMs, series.intervalMs, trade);
+        series.hasOpen = true;
+        series.dirty = true;
+    }
+}
+
+void TradeAggregator::close_idle_bars(std::int64_t graceMs) {
+    const auto nowMs = latestTradeMs_.load(std::memory_order_relaxed);
+    std::shared_lock<std::shared_mutex> symbolsLock(symbolsMutex_);
+    for (auto& entry : symbols_) {
+        auto& state = *entry.second;
+        std::lock_guard<std::mutex> lock(state.mutex);
+        for (auto& series : state.series) {
+            if (series.hasOpen && series.open.closeTime + graceMs < nowMs) {
+                close_bar_(state, series);
+            }
+        }
+    }
+}
+
+void TradeAggregator::drain_closed(std::vector<ClosedBar>& out) {
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    if (out.empty()) {
+        out.swap(pending_);
+        return;
+    }
+    std::move(pending_.begin(), pending_.end(), std::back_inserter(out));
+    pending_.clear();
+}
+
+void TradeAggregator::collect_updated(std::vector<ClosedBar>& out) {
+    std::shared_lock<std::shared_mutex> symbolsLock(symbolsMutex_);
+    for (auto& entry : symbols_) {
+        auto& state = *entry.second;
+        std::lock_guard<std::mutex> lock(state.mutex);
+        for (auto& series : state.series) {
+            if (series.hasOpen && series.dirty) {
+                out.push_back(ClosedBar{state.symbol, domain::Interval{series.intervalMs}, series.open});
+                series.dirty = false;
+            }
+        }
+    }
+}
+
+bool TradeAggregator::tryGetCandles(const domain::contracts::Symbol& symbol,
+                                    domain::contracts::Interval interval,
+                                    std::int64_t fromTs,
+                                    std::int64_t toTs,
+                                    std::size_t limit,
+                                    std::vector<domain::contracts::Candle>& out) const {
+    const auto intervalMs = domain::interval_from_label(domain::contracts::intervalToString(interval)).ms;
+    // A to-only range reads from the start of history, which memory never has.
+    if (intervalMs <= 0 || limit == 0 || (fromTs <= 0 && toTs > 0)) {
+        return false;
+    }
+
+    std::string upper = symbol;
+    std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char ch) {
+        return static_cast<char>(std::toupper(ch));
+    });
+    const auto* state = find_state_(upper);
+    if (state == nullptr) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+    const auto seriesIt = std::find_if(state->series.begin(), state->series.end(), [intervalMs](const Series& series) {
+        return series.intervalMs == intervalMs;
+    });
+    if (seriesIt == state->series.end()) {
+        return false;
+    }
+    const auto& series = *seriesIt;
+    const std::size_t available = series.closed.size() + (series.hasOpen ? 1U : 0U);
+    if (available == 0) {
+        return false;
+    }
+    const auto oldestOpen = series.closed.empty() ? series.open.openTime : series.closed.front().openTime;
+
+    out.clear();
+    if (fromTs > 0) {
+        if (fromTs < oldestOpen) {
+            return false;
+        }
+        auto it = std::lower_bound(series.closed.begin(),
+                                   series.closed.end(),
+                                   fromTs,
+                                   [](const domain::Candle& candle, std::int64_t value) {
+                                       return candle.openTime < value;
+                                   });
+        for (; it != series.closed.end() && out.size() < limit; ++it) {
+            if (toTs > 0 && it->openTime > toTs) {
+                return true;
+            }
+            out.push_back(to_contract(*it));
+        }
+        if (series.hasOpen && out.size() < limit && series.open.openTime >= fromTs
+            && (toTs <= 0 || series.open.openTime <= toTs)) {
+            out.push_back(to_contract(series.open));
+        }
+        return true;
+    }
+
+    if (available < limit) {
+        return false;
+    }
+    const std::size_t fromClosed = series.hasOpen ? limit - 1 : limit;
+    out.reserve(limit);
+    for (auto it = series.closed.end() - static_cast<std::ptrdiff_t>(fromClosed); it != series.closed.end(); ++it) {
+        out.push_back(to_contract(*it));
+    }
+    if (series.hasOpen) {
+        out.push_back(to_contract(series.open));
+    }
+    return true;
+}
+
+TradeAggregator::SymbolState& TradeAggregator::state_for_(std::string_view symbol) {
+    const std::string key(symbol);
+    {
+        std::shared_lock<std::shared_mutex> lock(symbolsMutex_);
+        if (const auto it = symbols_.find(key); it != symbols_.end()) {
+            return *it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(symbolsMutex_);
+    auto& slot = symbols_[key];
+    if (!slot) {
+        slot = std::make_unique<SymbolState>();
+        slot->symbol = key;
+        slot->series.resize(intervals_.size());
+        for (std::size_t i = 0; i < intervals_.size(); ++i) {
+            slot->series[i].intervalMs = intervals_[i].ms;
+        }
+    }
+    return *slot;
+}
+
+const TradeAggregator::SymbolState* TradeAggregator::find_state_(const std::string& symbol) const {
+    std::shared_lock<std::shared_mutex> lock(symbolsMutex_);
+    const auto it = symbols_.find(symbol);
+    return it == symbols_.end() ? nullptr : it->second.get();
+}
+
+void TradeAggregator::close_bar_(SymbolState& state, Series& series) {
+    auto bar = series.open;
+    bar.isClosed = true;
+    series.hasOpen = false;
+    series.dirty = false;
+
+    series.closed.push_back(bar);
+    const auto horizon = bar.openTime - retentionMs_;
+    while (!series.closed.empty() && series.closed.front().openTime < horizon) {
+        series.closed.pop_front();
+    }
+
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    pending_.push_back(ClosedBar{state.symbol, domain::Interval{series.intervalMs}, bar});
+}
+
+}  // namespace app
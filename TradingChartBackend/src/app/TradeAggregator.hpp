@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "domain/Ports.hpp"
+#include "domain/Types.h"
+#include "domain/exchange/IExchangeTrades.hpp"
+
+namespace app {
+
+// Folds aggTrade events into sub-minute candles (1s/5s/15s) and keeps the
+// last `retentionMs` of each series in memory. Bars are bucketed and closed
+// on exchange time, not wall time, so a replay at any speed produces the same
+// candles as the live feed did. A bucket without trades produces no bar.
+class TradeAggregator : public domain::contracts::ILiveCandleSource {
+public:
+    struct ClosedBar {
+        std::string symbol;
+        domain::Interval interval;
+        domain::Candle candle;
+    };
+
+    // Every interval must divide one minute.
+    TradeAggregator(std::vector<domain::Interval> intervals, std::int64_t retentionMs);
+
+    // Hot path. Called from a single feed thread; the symbol is expected in
+    // exchange (upper) case.
+    void on_trade(std::string_view symbol, const domain::AggTrade& trade);
+
+    // Closes open bars whose window ended more than `graceMs` before the
+    // newest trade seen on any symbol, so quiet symbols still publish.
+    void close_idle_bars(std::int64_t graceMs);
+
+    // Moves the bars closed since the last call into `out`.
+    void drain_closed(std::vector<ClosedBar>& out);
+
+    // Copies the open bars that changed since the last call into `out`.
+    void collect_updated(std::vector<ClosedBar>& out);
+
+    bool tryGetCandles(const domain::contracts::Symbol& symbol,
+                       domain::contracts::Interval interval,
+                       std::int64_t fromTs,
+                       std::int64_t toTs,
+                       std::size_t limit,
+                       std::vector<domain::contracts::Candle>& out) const override;
+
+    const std::vector<domain::Interval>& intervals() const noexcept { return intervals_; }
+    std::uint64_t trades() const noexcept { return trades_.load(std::memory_order_relaxed); }
+    std::int64_t latest_trade_ms() const noexcept { return latestTradeMs_.load(std::memory_order_relaxed); }
+
+private:
+    struct Series {
+        std::int64_t intervalMs{0};
+        domain::Candle open{};
+        bool hasOpen{false};
+        bool dirty{false};
+        std::deque<domain::Candle> closed;
+    };
+
+    struct SymbolState {
+        std::string symbol;
+        mutable std::mutex mutex;
+        std::vector<Series> series;
+    };
+
+    SymbolState& state_for_(std::string_view symbol);
+    const SymbolState* find_state_(const std::string& symbol) const;
+    void close_bar_(SymbolState& state, Series& series);
+
+    const std::vector<domain::Interval> intervals_;
+    const std::int64_t retentionMs_;
+
+    mutable std::shared_mutex symbolsMutex_;
+    std::unordered_map<std::string, std::unique_ptr<SymbolState>> symbols_;
+
+    // Feed-thread cache: consecutive trades are usually for the same symbol.
+    std::string lastSymbol_;
+    SymbolState* lastState_{nullptr};
+
+    std::mutex pendingMutex_;
+    std::vector<ClosedBar> pending_;
+
+    std::atomic<std::uint64_t> trades_{0};
+    std::atomic<std::uint64_t> lateTrades_{0};
+    std::atomic<std::int64_t> latestTradeMs_{0};
+};
+
+}  // namespace app
@@ -0,0 +1,152 @@
+#include "app/TradeIngestor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <sstream>
+#include <utility>
+
+#include "api/WebSocketServer.hpp"
+#include "common/Metrics.hpp"
+#include "domain/Types.h"
+#include "logging/Log.h"
+
+namespace app {
+namespace {
+
+constexpr logging::LogCategory kLogCategory = logging::LogCategory::DATA;
+constexpr std::chrono::milliseconds kFlushPeriod{250};
+// How long past its end a bar may still receive trades (exchange time).
+constexpr std::int64_t kCloseGraceMs = 500;
+
+void broadcast_bar(const std::string& symbol,
+                   const std::string& interval,
+                   const domain::Candle& candle,
+                   bool isFinal) {
+    std::ostringstream oss;
+    oss << "{\"type\":\"candle\",\"symbol\":\"" << symbol << "\",\"interval\":\"" << interval
+        << "\",\"final\":" << (isFinal ? "true" : "false") << ",\"data\":["
+        << static_cast<long long>(candle.openTime) << ',' << candle.open << ',' << candle.high << ','
+        << candle.low << ',' << candle.close << ',' << candle.baseVolume << "]}";
+    ttp::api::broadcast(oss.str());
+}
+
+}  // namespace
+
+TradeIngestor::TradeIngestor(domain::contracts::ICandleWriteRepo& repo,
+                             domain::IExchangeLiveTrades& feed,
+                             TradeAggregator& aggregator)
+    : repo_(repo), feed_(feed), aggregator_(aggregator) {}
+
+TradeIngestor::~TradeIngestor() {
+    stop();
+}
+
+void TradeIngestor::run(const std::vector<std::string>& symbols) {
+    if (flusher_.joinable()) {
+        stop();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(flushMutex_);
+        stopping_ = false;
+    }
+    flusher_ = std::thread(&TradeIngestor::flush_loop_, this);
+
+    feed_.set_on_reconnected([]() {
+        LOG_INFO(kLogCategory, "TradeIngestor: trade stream connected");
+    });
+    feed_.subscribe_trades(symbols, [this](std::string_view symbol, const domain::AggTrade& trade) {
+        aggregator_.on_trade(symbol, trade);
+    });
+
+    LOG_INFO(kLogCategory,
+             "TradeIngestor: started symbols=%zu intervals=%zu",
+             symbols.size(),
+             aggregator_.intervals().size());
+}
+
+void TradeIngestor::stop() {
+    feed_.stop();
+    {
+        std::lock_guard<std::mutex> lock(flushMutex_);
+        stopping_ = true;
+    }
+    flushCv_.notify_all();
+    if (flusher_.joinable()) {
+        flusher_.join();
+        // Bars closed after the last periodic flush.
+        try {
+            flush_();
+        }
+        catch (const std::exception& ex) {
+            LOG_ERROR(kLogCategory, "TradeIngestor: final flush failed: %s", ex.what());
+        }
+    }
+}
+
+void TradeIngestor::flush_loop_() {
+    std::unique_lock<std::mutex> lock(flushMutex_);
+    while (!stopping_) {
+        flushCv_.wait_for(lock, kFlushPeriod, [this]() { return stopping_; });
+        lock.unlock();
+        try {
+            flush_();
+        }
+        catch (const std::exception& ex) {
+            LOG_ERROR(kLogCategory, "TradeIngestor: flush failed: %s", ex.what());
+        }
+        lock.lock();
+    }
+}
+
+void TradeIngestor::flush_() {
+    aggregator_.close_idle_bars(kCloseGraceMs);
+
+    closedScratch_.clear();
+    aggregator_.drain_closed(closedScratch_);
+    std::stable_sort(closedScratch_.begin(), closedScratch_.end(), [](const auto& lhs, const auto& rhs) {
+        if (lhs.symbol != rhs.symbol) {
+            return lhs.symbol < rhs.symbol;
+        }
+        return lhs.interval.ms < rhs.interval.ms;
+    });
+
+    auto& metrics = ttp::common::metrics::Registry::instance();
+    std::vector<domain::Candle> rows;
+    for (auto begin = closedScratch_.begin(); begin != closedScratch_.end();) {
+        auto end = std::find_if(begin, closedScratch_.end(), [&](const auto& bar) {
+            return bar.symbol != begin->symbol || bar.interval.ms != begin->interval.ms;
+        });
+
+        rows.clear();
+        for (auto it = begin; it != end; ++it) {
+            rows.push_back(it->candle);
+        }
+        const auto label = domain::interval_label(begin->interval);
+        if (repo_.upsert_batch(begin->symbol, label, rows)) {
+            metrics.incrementCounter("trades.candles_persisted_total", static_cast<std::uint64_t>(rows.size()));
+        }
+        else {
+            LOG_WARN(kLogCategory,
+                     "TradeIngestor: failed to persist symbol=%s interval=%s size=%zu",
+                     begin->symbol.c_str(),
+                     label.c_str(),
+                     rows.size());
+        }
+        for (const auto& row : rows) {
+            broadcast_bar(begin->symbol, label, row, true);
+        }
+        begin = end;
+    }
+
+    updatedScratch_.clear();
+    aggregator_.collect_updated(updatedScratch_);
+    for (const auto& bar : updatedScratch_) {
+        broadcast_bar(bar.symbol, domain::interval_label(bar.interval), bar.candle, false);
+    }
+
+    metrics.setGauge("trades.total", static_cast<double>(aggregator_.trades()));
+}
+
+}  // namespace app
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "app/TradeAggregator.hpp"
+#include "domain/Ports.hpp"
+#include "domain/exchange/IExchangeTrades.hpp"
+
+namespace app {
+
+// Drives a TradeAggregator from a live aggTrade feed. The feed thread only
+// folds trades; a flusher thread closes idle bars, persists closed ones with
+// upsert_batch and broadcasts closed and in-progress bars over the WS server.
+class TradeIngestor {
+public:
+    TradeIngestor(domain::contracts::ICandleWriteRepo& repo,
+                  domain::IExchangeLiveTrades& feed,
+                  TradeAggregator& aggregator);
+
+    ~TradeIngestor();
+
+    void run(const std::vector<std::string>& symbols);
+
+    void stop();
+
+private:
+    void flush_loop_();
+    void flush_();
+
+    domain::contracts::ICandleWriteRepo& repo_;
+    domain::IExchangeLiveTrades& feed_;
+    TradeAggregator& aggregator_;
+
+    std::mutex flushMutex_;
+    std::condition_variable flushCv_;
+    bool stopping_{false};
+    std::thread flusher_;
+    std::vector<TradeAggregator::ClosedBar> closedScratch_;
+    std::vector<TradeAggregator::ClosedBar> updatedScratch_;
+};
+
+}  // namespace app
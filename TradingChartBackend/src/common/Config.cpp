@@ -47,12 +47,32 @@ std::size_t parseThreads(const std::string& value) {
 
 std::string parseStorage(const std::string& value) {
     const auto normalized = toLower(value);
-    if (normalized == "legacy" || normalized == "duck") {
+    if (normalized == "legacy" || normalized == "duck" || normalized == "columnar") {
         return normalized;
     }
     throw std::runtime_error("Valor de storage inválido: " + value);
 }
 
+std::string parseDuckPartition(const std::string& value) {
+    const auto normalized = toLower(value);
+    if (normalized == "none" || normalized == "month" || normalized == "year") {
+        return normalized;
+    }
+    throw std::runtime_error("Valor de particionado DuckDB inválido: " + value);
+}
+
+std::uint32_t parseDays(const std::string& value, const std::string& label) {
+    try {
+        const auto parsed = std::stoul(value);
+        if (parsed > 36500U) {
+            throw std::out_of_range("days out of range");
+        }
+        return static_cast<std::uint32_t>(parsed);
+    } catch (const std::exception&) {
+        throw std::runtime_error("Valor inválido para " + label + ": " + value);
+    }
+}
+
 std::uint32_t parseDurationMs(const std::string& value, const std::string& label) {
     try {
         const auto parsed = std::stoul(value);
@@ -65,6 +85,18 @@ std::uint32_t parseDurationMs(const std::string& value, const std::string& label
     }
 }
 
+std::uint32_t parsePositive(const std::string& value, const std::string& label) {
+    try {
+        const auto parsed = std::stoul(value);
+        if (parsed == 0U || parsed > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::out_of_range("value out of range");
+        }
+        return static_cast<std::uint32_t>(parsed);
+    } catch (const std::exception&) {
+        throw std::runtime_error("Valor inválido para " + label + ": " + value);
+    }
+}
+
 std::size_t parseSize(const std::string& value, const std::string& label) {
     try {
         const auto parsed = std::stoull(value);
@@ -86,6 +118,23 @@ std::int32_t parseHttpLimit(const std::string& value, const std::string& label)
     }
 }
 
+// Playback speed multiplier; "max" (or 0) replays without pacing.
+double parseReplaySpeed(const std::string& value, const std::string& label) {
+    if (toLower(value) == "max") {
+        return 0.0;
+    }
+    try {
+        std::size_t consumed = 0;
+        const auto parsed = std::stod(value, &consumed);
+        if (consumed != value.size() || !(parsed >= 0.0)) {
+            throw std::out_of_range("speed out of range");
+        }
+        return parsed;
+    } catch (const std::exception&) {
+        throw std::runtime_error("Valor inválido para " + label + ": " + value);
+    }
+}
+
 std::string trim(std::string value) {
     auto isSpace = [](unsigned char ch) { return std::isspace(ch) != 0; };
     value.erase(value.begin(), std::find_if(value.begin(), value.end(), [&](unsigned char ch) {
@@ -183,6 +232,63 @@ Config Config::fromArgs(int argc, char** argv) {
             config.duckdbPath = std::move(pathValue);
         }
     }
+    if (const char* envColumnar = std::getenv("COLUMNAR_DIR")) {
+        auto dirValue = trim(envColumnar);
+        if (!dirValue.empty()) {
+            config.columnarDir = std::move(dirValue);
+        }
+    }
+    if (const char* envPartition = std::getenv("DUCKDB_PARTITION")) {
+        config.duckdbPartition = parseDuckPartition(trim(envPartition));
+    }
+    if (const char* envFreeze = std::getenv("DUCKDB_FREEZE_AFTER_DAYS")) {
+        config.duckdbFreezeAfterDays = parseDays(envFreeze, "DUCKDB_FREEZE_AFTER_DAYS");
+    }
+    if (const char* envColdDays = std::getenv("DUCKDB_COLD_AFTER_DAYS")) {
+        config.duckdbColdAfterDays = parseDays(envColdDays, "DUCKDB_COLD_AFTER_DAYS");
+    }
+    if (const char* envColdDir = std::getenv("DUCKDB_COLD_DIR")) {
+        config.duckdbColdDir = trim(envColdDir);
+    }
+    if (const char* envConcurrency = std::getenv("BACKFILL_CONCURRENCY")) {
+        config.backfillConcurrency = parsePositive(envConcurrency, "BACKFILL_CONCURRENCY");
+    }
+    if (const char* envWeight = std::getenv("BACKFILL_WEIGHT_BUDGET")) {
+        config.backfillWeightBudget = parsePositive(envWeight, "BACKFILL_WEIGHT_BUDGET");
+    }
+    if (const char* envShardSize = std::getenv("LIVE_SHARD_SIZE")) {
+        config.liveShardSize = parsePositive(envShardSize, "LIVE_SHARD_SIZE");
+    }
+    if (const char* envCatchUp = std::getenv("LIVE_CATCHUP_CONCURRENCY")) {
+        config.liveCatchUpConcurrency = parsePositive(envCatchUp, "LIVE_CATCHUP_CONCURRENCY");
+    }
+    if (const char* envTradeIntervals = std::getenv("LIVE_TRADE_INTERVALS")) {
+        config.liveTradeIntervals = parseCsvList(envTradeIntervals);
+    }
+    if (const char* envTradeRetention = std::getenv("LIVE_TRADE_RETENTION_S")) {
+        config.liveTradeRetentionS = parsePositive(envTradeRetention, "LIVE_TRADE_RETENTION_S");
+    }
+    if (const char* envRecord = std::getenv("LIVE_RECORD")) {
+        config.liveRecordPath = trim(envRecord);
+    }
+    if (const char* envReplay = std::getenv("REPLAY_FILE")) {
+        config.replayPath = trim(envReplay);
+    }
+    if (const char* envReplaySpeed = std::getenv("REPLAY_SPEED")) {
+        config.replaySpeed = parseReplaySpeed(trim(envReplaySpeed), "REPLAY_SPEED");
+    }
+    if (const char* envReplayLoop = std::getenv("REPLAY_LOOP")) {
+        config.replayLoop = parseBool(envReplayLoop);
+    }
+    if (const char* envAdminToken = std::getenv("HTTP_ADMIN_TOKEN")) {
+        config.httpAdminToken = trim(envAdminToken);
+    }
+    if (const char* envRestHost = std::getenv("BINANCE_REST_HOST")) {
+        auto hostValue = trim(envRestHost);
+        if (!hostValue.empty()) {
+            config.binanceRestHost = std::move(hostValue);
+        }
+    }
 
     if (auto portArg = valueFromArgs(argc, argv, "--port"); !portArg.empty()) {
         config.port = parsePort(portArg);
@@ -199,6 +305,21 @@ Config Config::fromArgs(int argc, char** argv) {
     if (auto duckArg = valueFromArgs(argc, argv, "--duckdb"); !duckArg.empty()) {
         config.duckdbPath = duckArg;
     }
+    if (auto columnarArg = valueFromArgs(argc, argv, "--columnar-dir"); !columnarArg.empty()) {
+        config.columnarDir = trim(columnarArg);
+    }
+    if (auto partitionArg = valueFromArgs(argc, argv, "--duckdb-partition"); !partitionArg.empty()) {
+        config.duckdbPartition = parseDuckPartition(partitionArg);
+    }
+    if (auto freezeArg = valueFromArgs(argc, argv, "--duckdb-freeze-after-days"); !freezeArg.empty()) {
+        config.duckdbFreezeAfterDays = parseDays(freezeArg, "--duckdb-freeze-after-days");
+    }
+    if (auto coldDaysArg = valueFromArgs(argc, argv, "--duckdb-cold-after-days"); !coldDaysArg.empty()) {
+        config.duckdbColdAfterDays = parseDays(coldDaysArg, "--duckdb-cold-after-days");
+    }
+    if (auto coldDirArg = valueFromArgs(argc, argv, "--duckdb-cold-dir"); !coldDirArg.empty()) {
+        config.duckdbColdDir = trim(coldDirArg);
+    }
     if (auto pingArg = valueFromArgs(argc, argv, "--ws-ping-period-ms"); !pingArg.empty()) {
         config.wsPingPeriodMs = parseDurationMs(pingArg, "--ws-ping-period-ms");
     }
@@ -226,6 +347,9 @@ Config Config::fromArgs(int argc, char** argv) {
     if (auto corsOriginArg = valueFromArgs(argc, argv, "--http.cors.origin"); !corsOriginArg.empty()) {
         config.httpCorsOrigin = trim(corsOriginArg);
     }
+    if (auto adminTokenArg = valueFromArgs(argc, argv, "--http.admin.token"); !adminTokenArg.empty()) {
+        config.httpAdminToken = trim(adminTokenArg);
+    }
 
     if (hasFlag(argc, argv, "--backfill")) {
         config.backfill = true;
@@ -252,6 +376,15 @@ Config Config::fromArgs(int argc, char** argv) {
     if (auto toArg = valueFromArgs(argc, argv, "--to"); !toArg.empty()) {
         config.backfillTo = trim(toArg);
     }
+    if (auto concurrencyArg = valueFromArgs(argc, argv, "--backfill-concurrency"); !concurrencyArg.empty()) {
+        config.backfillConcurrency = parsePositive(concurrencyArg, "--backfill-concurrency");
+    }
+    if (auto weightArg = valueFromArgs(argc, argv, "--backfill-weight-budget"); !weightArg.empty()) {
+        config.backfillWeightBudget = parsePositive(weightArg, "--backfill-weight-budget");
+    }
+    if (auto restHostArg = valueFromArgs(argc, argv, "--binance-rest-host"); !restHostArg.empty()) {
+        config.binanceRestHost = trim(restHostArg);
+    }
 
     if (auto liveArg = valueFromArgs(argc, argv, "--live"); !liveArg.empty()) {
         config.live = parseBool(liveArg);
@@ -269,6 +402,32 @@ Config Config::fromArgs(int argc, char** argv) {
         }
     }
 
+    if (auto shardSizeArg = valueFromArgs(argc, argv, "--live-shard-size"); !shardSizeArg.empty()) {
+        config.liveShardSize = parsePositive(shardSizeArg, "--live-shard-size");
+    }
+    if (auto catchUpArg = valueFromArgs(argc, argv, "--live-catchup-concurrency"); !catchUpArg.empty()) {
+        config.liveCatchUpConcurrency = parsePositive(catchUpArg, "--live-catchup-concurrency");
+    }
+    if (auto tradeIntervalsArg = valueFromArgs(argc, argv, "--live-trade-intervals"); !tradeIntervalsArg.empty()) {
+        config.liveTradeIntervals = parseCsvList(tradeIntervalsArg);
+    }
+    if (auto tradeRetentionArg = valueFromArgs(argc, argv, "--live-trade-retention-s"); !tradeRetentionArg.empty()) {
+        config.liveTradeRetentionS = parsePositive(tradeRetentionArg, "--live-trade-retention-s");
+    }
+
+    if (auto recordArg = valueFromArgs(argc, argv, "--live-record"); !recordArg.empty()) {
+        config.liveRecordPath = trim(recordArg);
+    }
+    if (auto replayArg = valueFromArgs(argc, argv, "--replay"); !replayArg.empty()) {
+        config.replayPath = trim(replayArg);
+    }
+    if (auto replaySpeedArg = valueFromArgs(argc, argv, "--replay-speed"); !replaySpeedArg.empty()) {
+        config.replaySpeed = parseReplaySpeed(trim(replaySpeedArg), "--replay-speed");
+    }
+    if (auto replayLoopArg = valueFromArgs(argc, argv, "--replay-loop"); !replayLoopArg.empty()) {
+        config.replayLoop = parseBool(replayLoopArg);
+    }
+
     if (config.live) {
         if (config.liveSymbols.empty()) {
             throw std::runtime_error("La opción --live requiere --live-symbols");
@@ -284,9 +443,16 @@ Config Config::fromArgs(int argc, char** argv) {
         if (intervalLabel != "1m") {
             throw std::runtime_error("Intervalo live no soportado: " + intervalLabel);
         }
+        for (auto& tradeInterval : config.liveTradeIntervals) {
+            tradeInterval = toLower(tradeInterval);
+            if (tradeInterval != "1s" && tradeInterval != "5s" && tradeInterval != "15s") {
+                throw std::runtime_error("Intervalo de trades no soportado: " + tradeInterval);
+            }
+        }
     } else {
         config.liveSymbols.clear();
         config.liveIntervals.clear();
+        config.liveTradeIntervals.clear();
     }
 
     if (config.httpMaxLimit <= 0) {
@@ -310,6 +476,10 @@ Config Config::fromArgs(int argc, char** argv) {
         }
     }
 
+    if (config.duckdbColdDir.empty()) {
+        config.duckdbColdDir = (parentDir.empty() ? std::filesystem::path{"cold"} : parentDir / "cold").string();
+    }
+
     LOG_INFO("DuckDB path: " << duckPath.string());
 
     return config;
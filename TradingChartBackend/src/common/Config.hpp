@@ -15,16 +15,32 @@ struct Config {
     std::size_t threads = 1;
     std::string storage = "legacy";
     std::string duckdbPath = "/data/market.duckdb";
+    std::string duckdbPartition = "month";
+    std::uint32_t duckdbFreezeAfterDays = 35;
+    std::uint32_t duckdbColdAfterDays = 0;
+    std::string duckdbColdDir;
+    std::string columnarDir = "data/columnar";
     bool backfill = false;
     std::string backfillExchange = "binance";
     std::vector<std::string> backfillSymbols{"BTCUSDT", "ETHUSDT"};
     std::vector<std::string> backfillIntervals{"1m"};
     std::string backfillFrom = "2025-08-01";
     std::string backfillTo = "now";
+    std::size_t backfillConcurrency = 4;
+    std::uint32_t backfillWeightBudget = 1000;
+    std::string binanceRestHost = "api.binance.com";
 
     bool live = false;
     std::vector<std::string> liveSymbols{};
     std::vector<std::string> liveIntervals{};
+    std::size_t liveShardSize = 50;
+    std::size_t liveCatchUpConcurrency = 4;
+    std::vector<std::string> liveTradeIntervals{};
+    std::uint32_t liveTradeRetentionS = 3600;
+    std::string liveRecordPath;
+    std::string replayPath;
+    double replaySpeed = 1.0;
+    bool replayLoop = false;
 
     std::uint32_t wsPingPeriodMs = 30000;
     std::uint32_t wsPongTimeoutMs = 75000;
@@ -36,6 +52,8 @@ struct Config {
     std::int32_t httpMaxLimit = 5000;
     bool httpCorsEnable = false;
     std::string httpCorsOrigin;
+    // Bearer token for /admin/*; empty leaves those routes disabled.
+    std::string httpAdminToken;
 
     static Config fromArgs(int argc, char** argv);
 };
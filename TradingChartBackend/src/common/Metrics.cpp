@@ -2,36 +2,218 @@
 
 #include <algorithm>
 #include <cmath>
-#include <memory>
+#include <map>
+#include <mutex>
+#include <sstream>
 #include <utility>
 
 namespace ttp::common::metrics {
 namespace {
 
-double computeQuantile(const std::vector<double>& sortedValues, double quantile) {
-    if (sortedValues.empty()) {
-        return 0.0;
+// Upper bounds of the exported Prometheus buckets, in seconds.
+constexpr std::array<double, 16> kPrometheusBucketsS{
+    0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025,
+    0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0};
+
+std::int64_t steadyNowNs() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+std::chrono::steady_clock::time_point fromSteadyNs(std::int64_t ns) {
+    return std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(ns)));
+}
+
+template <typename Metric>
+Metric& ensureMetric(std::shared_mutex& mutex,
+                     std::unordered_map<std::string, std::unique_ptr<Metric>>& metrics,
+                     const std::string& key) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        if (const auto it = metrics.find(key); it != metrics.end()) {
+            return *it->second;
+        }
     }
-    if (sortedValues.size() == 1U) {
-        return sortedValues.front();
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto& slot = metrics[key];
+    if (!slot) {
+        slot = std::make_unique<Metric>();
     }
+    return *slot;
+}
 
-    const double clampedQuantile = std::clamp(quantile, 0.0, 1.0);
-    const double position = clampedQuantile * static_cast<double>(sortedValues.size() - 1U);
-    const auto lowerIndex = static_cast<std::size_t>(std::floor(position));
-    const auto upperIndex = static_cast<std::size_t>(std::ceil(position));
+// Prometheus metric names allow [a-zA-Z0-9_:]; our keys use dots.
+std::string prometheusName(const std::string& key) {
+    std::string name = "ttp_";
+    name.reserve(name.size() + key.size());
+    for (const unsigned char ch : key) {
+        const bool allowed = (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9')
+            || ch == '_' || ch == ':';
+        name.push_back(allowed ? static_cast<char>(ch) : '_');
+    }
+    return name;
+}
 
-    if (lowerIndex == upperIndex) {
-        return sortedValues[lowerIndex];
+std::string prometheusLabel(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (const char ch : value) {
+        if (ch == '\\' || ch == '"') {
+            escaped.push_back('\\');
+            escaped.push_back(ch);
+        }
+        else if (ch == '\n') {
+            escaped += "\\n";
+        }
+        else {
+            escaped.push_back(ch);
+        }
     }
+    return escaped;
+}
+
+void writeHistogram(std::ostringstream& out,
+                    const std::string& name,
+                    const std::string& labelName,
+                    const std::string& labelValue,
+                    const LatencyHistogram::Merged& merged) {
+    const auto label = labelName + "=\"" + prometheusLabel(labelValue) + "\"";
+    for (const double upperS : kPrometheusBucketsS) {
+        const auto upperUs = static_cast<std::uint64_t>(std::llround(upperS * 1e6));
+        out << name << "_bucket{" << label << ",le=\"" << upperS << "\"} " << merged.countBelowUs(upperUs + 1U)
+            << '\n';
+    }
+    out << name << "_bucket{" << label << ",le=\"+Inf\"} " << merged.count << '\n';
+    out << name << "_sum{" << label << "} " << static_cast<double>(merged.sumUs) / 1e6 << '\n';
+    out << name << "_count{" << label << "} " << merged.count << '\n';
+}
 
-    const double weight = position - static_cast<double>(lowerIndex);
-    return sortedValues[lowerIndex]
-        + weight * (sortedValues[upperIndex] - sortedValues[lowerIndex]);
+bool endsWith(const std::string& value, const std::string& suffix) {
+    return value.size() >= suffix.size()
+        && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
 }
 
 }  // namespace
 
+std::size_t LatencyHistogram::bucketIndex(std::uint64_t us) noexcept {
+    if (us < kSubBuckets) {
+        return static_cast<std::size_t>(us);
+    }
+    std::size_t exponent = 63U - static_cast<std::size_t>(__builtin_clzll(us));
+    if (exponent > kMaxExponent) {
+        return kBucketCount - 1U;
+    }
+    const auto subBucket = static_cast<std::size_t>(us >> (exponent - kSubBucketBits)) - kSubBuckets;
+    return kSubBuckets + (exponent - kSubBucketBits) * kSubBuckets + subBucket;
+}
+
+std::uint64_t LatencyHistogram::bucketLowerUs(std::size_t index) noexcept {
+    if (index < kSubBuckets) {
+        return index;
+    }
+    const auto exponent = (index - kSubBuckets) / kSubBuckets + kSubBucketBits;
+    const auto subBucket = (index - kSubBuckets) % kSubBuckets;
+    return static_cast<std::uint64_t>(kSubBuckets + subBucket) << (exponent - kSubBucketBits);
+}
+
+std::uint64_t LatencyHistogram::bucketUpperUs(std::size_t index) noexcept {
+    if (index < kSubBuckets) {
+        return index + 1U;
+    }
+    const auto exponent = (index - kSubBuckets) / kSubBuckets + kSubBucketBits;
+    return bucketLowerUs(index) + (std::uint64_t{1} << (exponent - kSubBucketBits));
+}
+
+std::size_t LatencyHistogram::shardIndex() noexcept {
+    static std::atomic<std::size_t> nextShard{0};
+    thread_local const std::size_t shard = nextShard.fetch_add(1U, std::memory_order_relaxed) % kShards;
+    return shard;
+}
+
+void LatencyHistogram::recordUs(std::uint64_t us) noexcept {
+    auto& shard = shards_[shardIndex()];
+    shard.counts[bucketIndex(us)].fetch_add(1U, std::memory_order_relaxed);
+    shard.sumUs.fetch_add(us, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::recordMs(double ms) noexcept {
+    const double us = ms * 1000.0;
+    recordUs(us > 0.0 ? static_cast<std::uint64_t>(std::llround(us)) : 0U);
+}
+
+LatencyHistogram::Merged LatencyHistogram::merge() const {
+    Merged merged;
+    for (const auto& shard : shards_) {
+        for (std::size_t i = 0; i < kBucketCount; ++i) {
+            merged.counts[i] += shard.counts[i].load(std::memory_order_relaxed);
+        }
+        merged.sumUs += shard.sumUs.load(std::memory_order_relaxed);
+    }
+    // Counted from the buckets themselves, so quantile ranks always match them.
+    for (const auto count : merged.counts) {
+        merged.count += count;
+    }
+    return merged;
+}
+
+std::optional<double> LatencyHistogram::Merged::quantileMs(double quantile) const {
+    if (count == 0U) {
+        return std::nullopt;
+    }
+    const double clamped = std::clamp(quantile, 0.0, 1.0);
+    const auto rank = std::max<std::uint64_t>(
+        1U, static_cast<std::uint64_t>(std::ceil(clamped * static_cast<double>(count))));
+
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            const auto lower = static_cast<double>(bucketLowerUs(i));
+            const auto upper = static_cast<double>(bucketUpperUs(i));
+            const double midUs = i < kSubBuckets ? lower : (lower + upper - 1.0) / 2.0;
+            return midUs / 1000.0;
+        }
+    }
+    return static_cast<double>(bucketLowerUs(kBucketCount - 1U)) / 1000.0;
+}
+
+std::uint64_t LatencyHistogram::Merged::countBelowUs(std::uint64_t us) const {
+    std::uint64_t below = 0;
+    for (std::size_t i = 0; i < kBucketCount && bucketUpperUs(i) <= us; ++i) {
+        below += counts[i];
+    }
+    return below;
+}
+
+void Gauge::set(double value) noexcept {
+    const auto nowNs = steadyNowNs();
+    value_.store(value, std::memory_order_relaxed);
+    updatedNs_.store(nowNs, std::memory_order_relaxed);
+    if (value == 0.0) {
+        auto expected = kNever;
+        zeroSinceNs_.compare_exchange_strong(expected, nowNs, std::memory_order_relaxed);
+    }
+    else {
+        zeroSinceNs_.store(kNever, std::memory_order_relaxed);
+    }
+}
+
+std::chrono::steady_clock::time_point Gauge::updatedAt() const noexcept {
+    const auto ns = updatedNs_.load(std::memory_order_relaxed);
+    return ns == 0 ? std::chrono::steady_clock::time_point{} : fromSteadyNs(ns);
+}
+
+std::optional<std::chrono::steady_clock::time_point> Gauge::zeroSince() const noexcept {
+    const auto ns = zeroSinceNs_.load(std::memory_order_relaxed);
+    if (ns == kNever) {
+        return std::nullopt;
+    }
+    return fromSteadyNs(ns);
+}
+
 Registry::Registry()
     : startTime_(std::chrono::steady_clock::now()) {}
 
@@ -41,39 +223,45 @@ Registry& Registry::instance() {
 }
 
 Registry::ScopedTimer::ScopedTimer(std::string routeKey)
-    : impl_(std::make_unique<ScopedTimerImpl>(Registry::instance(), std::move(routeKey))) {}
+    : ScopedTimer(Registry::instance().route(routeKey)) {}
+
+Registry::ScopedTimer::ScopedTimer(Route& route)
+    : route_(&route), start_(std::chrono::steady_clock::now()) {}
+
+Registry::ScopedTimer::~ScopedTimer() {
+    const auto end = std::chrono::steady_clock::now();
+    route_->recordLatencyMs(std::chrono::duration<double, std::milli>(end - start_).count());
+}
 
-Registry::ScopedTimer::~ScopedTimer() = default;
+Route& Registry::route(const std::string& routeKey) {
+    return ensureMetric(mutex_, routes_, routeKey);
+}
+
+Counter& Registry::counter(const std::string& counterKey) {
+    return ensureMetric(mutex_, counters_, counterKey);
+}
+
+Gauge& Registry::gauge(const std::string& gaugeKey) {
+    return ensureMetric(mutex_, gauges_, gaugeKey);
+}
+
+LatencyHistogram& Registry::stage(const std::string& stageKey) {
+    return ensureMetric(mutex_, stages_, stageKey);
+}
 
 void Registry::incrementRequest(const std::string& routeKey) {
-    auto& metrics = ensureRouteMetrics(routeKey);
-    metrics.totalRequests.fetch_add(1U, std::memory_order_relaxed);
+    route(routeKey).countRequest();
 }
 
 void Registry::incrementCounter(const std::string& counterKey, std::uint64_t value) {
     if (value == 0U) {
         return;
     }
-
-    std::lock_guard<std::mutex> lock(mutex_);
-    counters_[counterKey].value += value;
+    counter(counterKey).add(value);
 }
 
 void Registry::setGauge(const std::string& gaugeKey, double value) {
-    const auto now = std::chrono::steady_clock::now();
-
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto& gauge = gauges_[gaugeKey];
-    gauge.value = value;
-    gauge.updatedAt = now;
-    if (value == 0.0) {
-        if (!gauge.zeroSince.has_value()) {
-            gauge.zeroSince = now;
-        }
-    }
-    else {
-        gauge.zeroSince.reset();
-    }
+    gauge(gaugeKey).set(value);
 }
 
 Registry::Snapshot Registry::snapshot() const {
@@ -81,69 +269,104 @@ Registry::Snapshot Registry::snapshot() const {
     snapshot.startTime = startTime_;
     snapshot.capturedAt = std::chrono::steady_clock::now();
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    snapshot.routes.reserve(routeMetrics_.size());
-    for (const auto& [routeKey, metricsPtr] : routeMetrics_) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    snapshot.routes.reserve(routes_.size());
+    for (const auto& [routeKey, route] : routes_) {
         RouteSnapshot routeSnapshot;
-        routeSnapshot.totalRequests
-            = metricsPtr->totalRequests.load(std::memory_order_relaxed);
-
-        auto latencies = metricsPtr->copyLatencies();
-        if (!latencies.empty()) {
-            std::sort(latencies.begin(), latencies.end());
-            routeSnapshot.p95Ms = computeQuantile(latencies, 0.95);
-            routeSnapshot.p99Ms = computeQuantile(latencies, 0.99);
-        }
-
+        routeSnapshot.totalRequests = route->totalRequests();
+        const auto merged = route->latency().merge();
+        routeSnapshot.p95Ms = merged.quantileMs(0.95);
+        routeSnapshot.p99Ms = merged.quantileMs(0.99);
         snapshot.routes.emplace(routeKey, std::move(routeSnapshot));
     }
 
     snapshot.counters.reserve(counters_.size());
     for (const auto& [key, counter] : counters_) {
-        snapshot.counters.emplace(key, CounterSnapshot{counter.value});
+        snapshot.counters.emplace(key, CounterSnapshot{counter->value()});
     }
 
     snapshot.gauges.reserve(gauges_.size());
     for (const auto& [key, gauge] : gauges_) {
-        snapshot.gauges.emplace(
-            key,
-            GaugeSnapshot{gauge.value, gauge.updatedAt, gauge.zeroSince});
+        snapshot.gauges.emplace(key, GaugeSnapshot{gauge->value(), gauge->updatedAt(), gauge->zeroSince()});
     }
 
     return snapshot;
 }
 
-void Registry::RouteMetrics::addLatency(double latencyMs) {
-    std::lock_guard<std::mutex> lock(latenciesMutex);
-    latenciesMs.push_back(latencyMs);
-}
+std::string Registry::prometheusText() const {
+    std::ostringstream out;
+    out.precision(10);
 
-std::vector<double> Registry::RouteMetrics::copyLatencies() const {
-    std::lock_guard<std::mutex> lock(latenciesMutex);
-    return latenciesMs;
-}
+    const std::chrono::duration<double> uptime = std::chrono::steady_clock::now() - startTime_;
+    out << "# TYPE ttp_uptime_seconds gauge\n";
+    out << "ttp_uptime_seconds " << uptime.count() << '\n';
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
 
-Registry::RouteMetrics& Registry::ensureRouteMetrics(const std::string& routeKey) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto [it, inserted] = routeMetrics_.try_emplace(routeKey, nullptr);
-    if (inserted) {
-        it->second = std::make_unique<RouteMetrics>();
+    // Sorted so scrapes diff cleanly.
+    const std::map<std::string, const Route*> routes = [this]() {
+        std::map<std::string, const Route*> sorted;
+        for (const auto& [key, route] : routes_) {
+            sorted.emplace(key, route.get());
+        }
+        return sorted;
+    }();
+
+    if (!routes.empty()) {
+        out << "# TYPE ttp_http_requests_total counter\n";
+        for (const auto& [key, route] : routes) {
+            out << "ttp_http_requests_total{route=\"" << prometheusLabel(key) << "\"} " << route->totalRequests()
+                << '\n';
+        }
+
+        out << "# TYPE ttp_http_request_duration_seconds histogram\n";
+        for (const auto& [key, route] : routes) {
+            const auto merged = route->latency().merge();
+            if (merged.count == 0U) {
+                continue;
+            }
+            writeHistogram(out, "ttp_http_request_duration_seconds", "route", key, merged);
+        }
     }
-    return *it->second;
-}
 
-Registry::ScopedTimerImpl::ScopedTimerImpl(Registry& registry, std::string routeKey)
-    : metrics_(&registry.ensureRouteMetrics(routeKey)),
-      start_(std::chrono::steady_clock::now()) {}
+    const std::map<std::string, const LatencyHistogram*> stages = [this]() {
+        std::map<std::string, const LatencyHistogram*> sorted;
+        for (const auto& [key, stage] : stages_) {
+            sorted.emplace(key, stage.get());
+        }
+        return sorted;
+    }();
+    if (!stages.empty()) {
+        out << "# TYPE ttp_pipeline_stage_seconds histogram\n";
+        for (const auto& [key, stage] : stages) {
+            const auto merged = stage->merge();
+            if (merged.count != 0U) {
+                writeHistogram(out, "ttp_pipeline_stage_seconds", "stage", key, merged);
+            }
+        }
+    }
 
-Registry::ScopedTimerImpl::~ScopedTimerImpl() {
-    if (metrics_ == nullptr) {
-        return;
+    std::map<std::string, std::uint64_t> counters;
+    for (const auto& [key, counter] : counters_) {
+        auto name = prometheusName(key);
+        if (!endsWith(name, "_total")) {
+            name += "_total";
+        }
+        counters[name] += counter->value();
+    }
+    for (const auto& [name, value] : counters) {
+        out << "# TYPE " << name << " counter\n" << name << ' ' << value << '\n';
     }
 
-    const auto end = std::chrono::steady_clock::now();
-    const auto duration = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(end - start_);
-    metrics_->addLatency(duration.count());
+    std::map<std::string, double> gauges;
+    for (const auto& [key, gauge] : gauges_) {
+        gauges[prometheusName(key)] = gauge->value();
+    }
+    for (const auto& [name, value] : gauges) {
+        out << "# TYPE " << name << " gauge\n" << name << ' ' << value << '\n';
+    }
+
+    return out.str();
 }
 
 }  // namespace ttp::common::metrics
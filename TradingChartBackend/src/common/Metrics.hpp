@@ -1,21 +1,104 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
-#include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
-#include <vector>
 
 namespace ttp::common::metrics {
 
-class Registry {
+// Fixed-size log-linear latency histogram (HDR style). Values are kept in
+// microseconds with 16 linear sub-buckets per power of two, so a reported
+// quantile is within 1/16 of the recorded value. Writers pick one of kShards
+// cache-line-aligned shards per thread and do relaxed atomic increments;
+// readers merge the shards.
+class LatencyHistogram {
+public:
+    static constexpr std::size_t kSubBucketBits = 4;
+    static constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBucketBits;
+    // Values at or above 2^41 us (~25 days) land in the last bucket.
+    static constexpr std::size_t kMaxExponent = 40;
+    static constexpr std::size_t kBucketCount = kSubBuckets * (kMaxExponent - kSubBucketBits + 2);
+    static constexpr std::size_t kShards = 8;
+
+    struct Merged {
+        std::array<std::uint64_t, kBucketCount> counts{};
+        std::uint64_t count{0};
+        std::uint64_t sumUs{0};
+
+        // Midpoint of the bucket holding the q-th value; nullopt when empty.
+        std::optional<double> quantileMs(double quantile) const;
+        // Values recorded below `us`, to bucket precision.
+        std::uint64_t countBelowUs(std::uint64_t us) const;
+    };
+
+    void recordUs(std::uint64_t us) noexcept;
+    void recordMs(double ms) noexcept;
+    Merged merge() const;
+
+    static std::size_t bucketIndex(std::uint64_t us) noexcept;
+    static std::uint64_t bucketLowerUs(std::size_t index) noexcept;
+    // Exclusive.
+    static std::uint64_t bucketUpperUs(std::size_t index) noexcept;
+
+private:
+    struct alignas(64) Shard {
+        std::array<std::atomic<std::uint64_t>, kBucketCount> counts{};
+        std::atomic<std::uint64_t> sumUs{0};
+    };
+
+    static std::size_t shardIndex() noexcept;
+
+    std::array<Shard, kShards> shards_{};
+};
+
+class Counter {
+public:
+    void add(std::uint64_t value = 1U) noexcept { value_.fetch_add(value, std::memory_order_relaxed); }
+    std::uint64_t value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> value_{0};
+};
+
+class Gauge {
+public:
+    void set(double value) noexcept;
+    double value() const noexcept { return value_.load(std::memory_order_relaxed); }
+    std::chrono::steady_clock::time_point updatedAt() const noexcept;
+    std::optional<std::chrono::steady_clock::time_point> zeroSince() const noexcept;
+
+private:
+    static constexpr std::int64_t kNever = -1;
+
+    std::atomic<double> value_{0.0};
+    std::atomic<std::int64_t> updatedNs_{0};
+    std::atomic<std::int64_t> zeroSinceNs_{kNever};
+};
+
+class Route {
+public:
+    void countRequest() noexcept { totalRequests_.fetch_add(1U, std::memory_order_relaxed); }
+    void recordLatencyMs(double ms) noexcept { latency_.recordMs(ms); }
+    std::uint64_t totalRequests() const noexcept { return totalRequests_.load(std::memory_order_relaxed); }
+    const LatencyHistogram& latency() const noexcept { return latency_; }
+
 private:
-    class ScopedTimerImpl;
+    std::atomic<std::uint64_t> totalRequests_{0};
+    LatencyHistogram latency_;
+};
 
+// Metrics are created on first use and never removed, so the references
+// returned by route()/counter()/gauge() stay valid for the whole process.
+// Hot paths should look a handle up once and keep it; the string-keyed
+// helpers take a shared lock per call.
+class Registry {
 public:
     struct RouteSnapshot {
         std::uint64_t totalRequests{0};
@@ -44,6 +127,7 @@ public:
     class ScopedTimer {
     public:
         explicit ScopedTimer(std::string routeKey);
+        explicit ScopedTimer(Route& route);
         ~ScopedTimer();
 
         ScopedTimer(const ScopedTimer&) = delete;
@@ -52,56 +136,37 @@ public:
         ScopedTimer& operator=(ScopedTimer&&) = delete;
 
     private:
-        std::unique_ptr<ScopedTimerImpl> impl_;
+        Route* route_{nullptr};
+        std::chrono::steady_clock::time_point start_;
     };
 
     static Registry& instance();
 
+    Route& route(const std::string& routeKey);
+    Counter& counter(const std::string& counterKey);
+    Gauge& gauge(const std::string& gaugeKey);
+    // Latency of one live-pipeline stage (see common/Trace.hpp), exported as
+    // ttp_pipeline_stage_seconds{stage="<key>"}.
+    LatencyHistogram& stage(const std::string& stageKey);
+
     void incrementRequest(const std::string& routeKey);
     void incrementCounter(const std::string& counterKey,
                           std::uint64_t value = 1U);
     void setGauge(const std::string& gaugeKey, double value);
     Snapshot snapshot() const;
 
-private:
-    struct RouteMetrics {
-        std::atomic<std::uint64_t> totalRequests{0};
-        mutable std::mutex latenciesMutex;
-        std::vector<double> latenciesMs;
-
-        void addLatency(double latencyMs);
-        std::vector<double> copyLatencies() const;
-    };
-
-    struct CounterMetrics {
-        std::uint64_t value{0};
-    };
-
-    struct GaugeMetrics {
-        double value{0.0};
-        std::chrono::steady_clock::time_point updatedAt{};
-        std::optional<std::chrono::steady_clock::time_point> zeroSince{};
-    };
-
-    class ScopedTimerImpl {
-    public:
-        ScopedTimerImpl(Registry& registry, std::string routeKey);
-        ~ScopedTimerImpl();
-
-    private:
-        RouteMetrics* metrics_{nullptr};
-        std::chrono::steady_clock::time_point start_;
-    };
+    // Prometheus text exposition format (version 0.0.4).
+    std::string prometheusText() const;
 
+private:
     Registry();
 
-    RouteMetrics& ensureRouteMetrics(const std::string& routeKey);
-
     const std::chrono::steady_clock::time_point startTime_;
-    mutable std::mutex mutex_;
-    std::unordered_map<std::string, std::unique_ptr<RouteMetrics>> routeMetrics_;
-    std::unordered_map<std::string, CounterMetrics> counters_;
-    std::unordered_map<std::string, GaugeMetrics> gauges_;
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, std::unique_ptr<Route>> routes_;
+    std::unordered_map<std::string, std::unique_ptr<Counter>> counters_;
+    std::unordered_map<std::string, std::unique_ptr<Gauge>> gauges_;
+    std::unordered_map<std::string, std::unique_ptr<LatencyHistogram>> stages_;
 };
 
 }  // namespace ttp::common::metrics
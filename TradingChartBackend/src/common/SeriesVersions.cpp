@@ -0,0 +1,82 @@
+#include "common/SeriesVersions.hpp"
+
+#include <cctype>
+#include <mutex>
+
+namespace ttp::common {
+namespace {
+
+std::string symbolKey(std::string_view symbol) {
+    std::string key;
+    key.reserve(symbol.size() + 8U);
+    for (const unsigned char ch : symbol) {
+        key.push_back(static_cast<char>(std::toupper(ch)));
+    }
+    key.push_back('|');
+    return key;
+}
+
+}  // namespace
+
+SeriesVersions& SeriesVersions::instance() {
+    static SeriesVersions versions;
+    return versions;
+}
+
+std::uint64_t SeriesVersions::series(std::string_view symbol, std::string_view interval) const {
+    auto key = symbolKey(symbol);
+    key.append(interval);
+    return lookup_(key);
+}
+
+std::uint64_t SeriesVersions::symbol(std::string_view symbol) const {
+    return lookup_(symbolKey(symbol));
+}
+
+void SeriesVersions::bump(std::string_view symbol,
+                          std::string_view interval,
+                          std::int64_t firstTs,
+                          std::int64_t lastTs) {
+    auto key = symbolKey(symbol);
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    ++versions_[key].version;
+    key.append(interval);
+    auto& entry = versions_[key];
+    ++entry.version;
+    entry.writes.push_back(Write{entry.version, firstTs, lastTs});
+    if (entry.writes.size() > kWriteLogSize) {
+        entry.writes.pop_front();
+    }
+}
+
+bool SeriesVersions::untouchedSince(std::string_view symbol,
+                                    std::string_view interval,
+                                    std::uint64_t since,
+                                    std::int64_t fromTs,
+                                    std::int64_t toTs) const {
+    auto key = symbolKey(symbol);
+    key.append(interval);
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    const auto it = versions_.find(key);
+    if (it == versions_.end() || it->second.version == since) {
+        return true;
+    }
+    const auto& writes = it->second.writes;
+    if (writes.empty() || writes.front().version > since + 1U) {
+        return false;
+    }
+    for (auto write = writes.rbegin(); write != writes.rend() && write->version > since; ++write) {
+        if (write->firstTs <= toTs && write->lastTs >= fromTs) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::uint64_t SeriesVersions::lookup_(const std::string& key) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    const auto it = versions_.find(key);
+    return it != versions_.end() ? it->second.version : 0U;
+}
+
+}  // namespace ttp::common
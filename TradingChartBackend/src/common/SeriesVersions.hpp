@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace ttp::common {
+
+// Per-series change counters, bumped by every upsert_batch. Readers that
+// derive data from a series (e.g. the HTTP response cache) remember the
+// version they started from and treat a different current version as stale.
+// Symbols are compared case-insensitively; intervals are used as given, so
+// callers pass normalized labels ("1m", "1h").
+//
+// The open-time range of the last kWriteLogSize writes per series is kept as
+// well, so data derived from old candles only (e.g. closed candle blocks)
+// can tell whether a newer version actually touched it.
+class SeriesVersions {
+public:
+    static constexpr std::size_t kWriteLogSize = 256;
+
+    static SeriesVersions& instance();
+
+    // 0 until the series is first written.
+    std::uint64_t series(std::string_view symbol, std::string_view interval) const;
+    // Changes whenever any interval of the symbol does.
+    std::uint64_t symbol(std::string_view symbol) const;
+
+    // [firstTs, lastTs] are the open times written.
+    void bump(std::string_view symbol, std::string_view interval, std::int64_t firstTs, std::int64_t lastTs);
+
+    // True when no write after version `since` touched [fromTs, toTs]. False
+    // as well when the writes since then are no longer all in the log.
+    bool untouchedSince(std::string_view symbol,
+                        std::string_view interval,
+                        std::uint64_t since,
+                        std::int64_t fromTs,
+                        std::int64_t toTs) const;
+
+private:
+    struct Write {
+        std::uint64_t version{0};
+        std::int64_t firstTs{0};
+        std::int64_t lastTs{0};
+    };
+
+    struct Entry {
+        std::uint64_t version{0};
+        std::deque<Write> writes;  // series entries only, oldest first
+    };
+
+    SeriesVersions() = default;
+
+    std::uint64_t lookup_(const std::string& key) const;
+
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, Entry> versions_;
+};
+
+}  // namespace ttp::common
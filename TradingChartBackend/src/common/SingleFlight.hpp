@@ -0,0 +1,73 @@
+#pragma once
+
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace ttp::common {
+
+// Collapses concurrent calls with the same key into one execution. The first
+// caller (the leader) runs the function; callers arriving while it is in
+// flight wait and receive the same immutable result. Nothing is kept once the
+// call finishes, so a call arriving afterwards runs again. A waiter may still
+// receive a result computed from state older than its own arrival (a write
+// that landed while the leader was running); callers that must observe such
+// writes put a version of the underlying data in the key. That version only
+// covers the writers that bump it: an in-process counter (SeriesVersions)
+// misses writes from other processes, so data shared with them needs a
+// version kept with the data itself.
+template <typename Value>
+class SingleFlight {
+public:
+    using Result = std::shared_ptr<const Value>;
+
+    struct Outcome {
+        Result value;
+        // True when this caller waited on another caller's execution.
+        bool shared{false};
+    };
+
+    // Exceptions thrown by `fn` are rethrown to the leader and every waiter.
+    template <typename Fn>
+    Outcome run(const std::string& key, Fn&& fn) {
+        std::promise<Result> promise;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (const auto it = inFlight_.find(key); it != inFlight_.end()) {
+                auto future = it->second;
+                lock.unlock();
+                return Outcome{future.get(), true};
+            }
+            inFlight_.emplace(key, promise.get_future().share());
+        }
+
+        Outcome outcome;
+        std::exception_ptr error;
+        try {
+            outcome.value = std::make_shared<const Value>(std::forward<Fn>(fn)());
+            promise.set_value(outcome.value);
+        }
+        catch (...) {
+            error = std::current_exception();
+            promise.set_exception(error);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            inFlight_.erase(key);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return outcome;
+    }
+
+private:
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_future<Result>> inFlight_;
+};
+
+}  // namespace ttp::common
@@ -0,0 +1,154 @@
+#include "common/Trace.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+#include "common/Metrics.hpp"
+
+namespace ttp::common::trace {
+namespace {
+
+constexpr std::size_t kRingSize = 1024;
+
+thread_local CandleTrace* tlsActive = nullptr;
+
+struct Ring {
+    std::mutex mutex;
+    std::array<CandleTrace, kRingSize> slots{};
+    std::size_t next{0};
+    std::size_t size{0};
+};
+
+Ring& ring() {
+    static Ring instance;
+    return instance;
+}
+
+struct Histograms {
+    std::array<metrics::LatencyHistogram*, kStageCount> stages{};
+    metrics::LatencyHistogram* endToEnd{nullptr};
+    metrics::Counter* clockSkew{nullptr};
+};
+
+const Histograms& histograms() {
+    static const Histograms instance = []() {
+        auto& registry = metrics::Registry::instance();
+        Histograms handles;
+        for (std::size_t i = 0; i < kStageCount; ++i) {
+            handles.stages[i] = &registry.stage(stageName(static_cast<Stage>(i)));
+        }
+        handles.endToEnd = &registry.stage("end_to_end");
+        handles.clockSkew = &registry.counter("trace.exchange_clock_skew");
+        return handles;
+    }();
+    return instance;
+}
+
+std::atomic<std::uint64_t> broadcastSeq{0};
+
+std::size_t index(Stage stage) noexcept {
+    return static_cast<std::size_t>(stage);
+}
+
+}  // namespace
+
+const char* stageName(Stage stage) noexcept {
+    switch (stage) {
+    case Stage::Received:
+        return "received";
+    case Stage::Processed:
+        return "processed";
+    case Stage::Persisted:
+        return "persisted";
+    case Stage::Indicators:
+        return "indicators";
+    case Stage::Enqueued:
+        return "enqueued";
+    case Stage::Sent:
+        return "sent";
+    }
+    return "unknown";
+}
+
+std::int64_t nowNs() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+Scope::Scope(std::string_view symbol,
+             std::int64_t openTime,
+             bool isFinal,
+             std::int64_t exchangeMs,
+             std::int64_t receivedNs)
+    : previous_(tlsActive) {
+    const auto length = std::min(symbol.size(), trace_.symbol.size() - 1U);
+    std::copy_n(symbol.data(), length, trace_.symbol.data());
+    trace_.openTime = openTime;
+    trace_.isFinal = isFinal;
+    trace_.exchangeMs = exchangeMs;
+    trace_.stageNs[index(Stage::Received)] = receivedNs;
+    tlsActive = &trace_;
+}
+
+Scope::~Scope() {
+    tlsActive = previous_;
+
+    const auto& handles = histograms();
+    std::int64_t lastNs = trace_.exchangeMs * 1'000'000;
+    const std::int64_t firstNs = lastNs > 0 ? lastNs : trace_.stageNs[index(Stage::Received)];
+    for (std::size_t i = 0; i < kStageCount; ++i) {
+        const auto stampNs = trace_.stageNs[i];
+        if (stampNs == 0) {
+            continue;
+        }
+        if (lastNs > 0) {
+            if (stampNs < lastNs) {
+                // Exchange clock ahead of ours (or a stage stamped out of order).
+                handles.clockSkew->add();
+            }
+            handles.stages[i]->recordUs(static_cast<std::uint64_t>(std::max<std::int64_t>(stampNs - lastNs, 0) / 1000));
+        }
+        lastNs = stampNs;
+    }
+
+    const auto sentNs = trace_.stageNs[index(Stage::Sent)];
+    if (sentNs != 0 && firstNs > 0) {
+        handles.endToEnd->recordUs(static_cast<std::uint64_t>(std::max<std::int64_t>(sentNs - firstNs, 0) / 1000));
+    }
+
+    if (trace_.stageNs[index(Stage::Enqueued)] == 0) {
+        return;
+    }
+    const bool sampled = trace_.isFinal
+        || broadcastSeq.fetch_add(1U, std::memory_order_relaxed) % kSampleEvery == 0U;
+    if (!sampled) {
+        return;
+    }
+    auto& buffer = ring();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.slots[buffer.next] = trace_;
+    buffer.next = (buffer.next + 1U) % kRingSize;
+    buffer.size = std::min(buffer.size + 1U, kRingSize);
+}
+
+void mark(Stage stage) noexcept {
+    if (tlsActive != nullptr) {
+        tlsActive->stageNs[index(stage)] = nowNs();
+    }
+}
+
+std::vector<CandleTrace> recent(std::size_t limit) {
+    auto& buffer = ring();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    const auto count = std::min(limit, buffer.size);
+    std::vector<CandleTrace> traces;
+    traces.reserve(count);
+    for (std::size_t i = 1; i <= count; ++i) {
+        traces.push_back(buffer.slots[(buffer.next + kRingSize - i) % kRingSize]);
+    }
+    return traces;
+}
+
+}  // namespace ttp::common::trace
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace ttp::common::trace {
+
+// Pipeline stages of a live kline after the exchange emitted it.
+enum class Stage : std::size_t {
+    Received,    // frame read from the Binance socket
+    Processed,   // LiveIngestor folded it into the live candle map
+    Persisted,   // upsert_batch committed (closed candles only)
+    Indicators,  // IndicatorCache folded the bar into its series
+    Enqueued,    // WebSocketServer fan-out started
+    Sent,        // last byte of the last client frame written
+};
+
+constexpr std::size_t kStageCount = 6;
+
+const char* stageName(Stage stage) noexcept;
+
+// Wall-clock nanoseconds, comparable with exchange event times.
+std::int64_t nowNs() noexcept;
+
+struct CandleTrace {
+    // NUL-terminated, truncated to fit.
+    std::array<char, 24> symbol{};
+    std::int64_t openTime{0};
+    // Binance event time "E" in ms; 0 when the frame had none.
+    std::int64_t exchangeMs{0};
+    bool isFinal{false};
+    // 0 for stages the message never reached.
+    std::array<std::int64_t, kStageCount> stageNs{};
+};
+
+// Follows one kline from the socket to the last WS byte. Everything after
+// BinanceWsClient runs synchronously on the feed thread, so the active trace
+// lives in a thread_local and downstream code stamps it through mark()
+// without any interface change. On destruction each reached stage records
+// its delta from the previous one into Registry::stage(), and every
+// kSampleEvery-th broadcast trace (plus every closed candle) is copied into
+// the ring read by recent().
+class Scope {
+public:
+    static constexpr std::uint64_t kSampleEvery = 16;
+
+    Scope(std::string_view symbol, std::int64_t openTime, bool isFinal, std::int64_t exchangeMs, std::int64_t receivedNs);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    CandleTrace trace_;
+    CandleTrace* previous_;
+};
+
+// Stamps the active trace; a no-op when there is none (replay, REST
+// catch-up, trade-built bars).
+void mark(Stage stage) noexcept;
+
+// Sampled traces, newest first.
+std::vector<CandleTrace> recent(std::size_t limit);
+
+}  // namespace ttp::common::trace
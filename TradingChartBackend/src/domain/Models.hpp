@@ -31,6 +31,9 @@ enum class Interval {
     TwelveHours,
     OneDay,
     OneWeek,
+    OneSecond,
+    FiveSeconds,
+    FifteenSeconds,
 };
 
 inline std::string intervalToString(Interval interval) {
@@ -59,6 +62,12 @@ inline std::string intervalToString(Interval interval) {
         return "1d";
     case Interval::OneWeek:
         return "1w";
+    case Interval::OneSecond:
+        return "1s";
+    case Interval::FiveSeconds:
+        return "5s";
+    case Interval::FifteenSeconds:
+        return "15s";
     case Interval::Unknown:
     default:
         break;
@@ -109,6 +118,15 @@ inline Interval intervalFromString(std::string_view value) {
     if (normalized == "1w" || normalized == "1week") {
         return Interval::OneWeek;
     }
+    if (normalized == "1s" || normalized == "1sec") {
+        return Interval::OneSecond;
+    }
+    if (normalized == "5s" || normalized == "5sec") {
+        return Interval::FiveSeconds;
+    }
+    if (normalized == "15s" || normalized == "15sec") {
+        return Interval::FifteenSeconds;
+    }
     return Interval::Unknown;
 }
 
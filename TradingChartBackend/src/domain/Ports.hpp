@@ -9,6 +9,10 @@
 
 #include "domain/Models.hpp"
 
+namespace domain {
+struct Candle;
+}  // namespace domain
+
 namespace domain::contracts {
 
 struct IntervalRangeInfo {
@@ -47,6 +51,66 @@ public:
         (void)interval;
         return std::nullopt;
     }
+
+    // Write counter kept with the data, so writes made by other processes
+    // (e.g. a backfill) count too. An empty interval covers every interval of
+    // the symbol, an empty symbol the whole store. nullopt when the repository
+    // keeps none (or cannot read it): every write then goes through this
+    // process and common::SeriesVersions sees it.
+    virtual std::optional<std::uint64_t> storedVersion(const Symbol& symbol, const std::string& interval) const {
+        (void)symbol;
+        (void)interval;
+        return std::nullopt;
+    }
+
+    // Whether the writes that took storedVersion(symbol, interval) from
+    // `since` to `until` all left open times [fromTs, toTs] alone. false when
+    // that is not known, e.g. once older writes have left the write log.
+    virtual bool storedUntouched(const Symbol& symbol,
+                                 const std::string& interval,
+                                 std::uint64_t since,
+                                 std::uint64_t until,
+                                 std::int64_t fromTs,
+                                 std::int64_t toTs) const {
+        (void)symbol;
+        (void)interval;
+        (void)since;
+        (void)until;
+        (void)fromTs;
+        (void)toTs;
+        return false;
+    }
+};
+
+// Write side of the candle store. DuckDB keeps a single writer, so callers
+// serialize upsert_batch (BackfillWorker and LiveIngestor each funnel their
+// writes through one thread).
+class ICandleWriteRepo {
+public:
+    virtual ~ICandleWriteRepo() = default;
+
+    virtual bool upsert_batch(const std::string& symbol,
+                              const std::string& interval,
+                              const std::vector<domain::Candle>& rows) = 0;
+
+    virtual std::optional<std::int64_t> max_timestamp(const std::string& symbol,
+                                                      const std::string& interval) const = 0;
+};
+
+// In-memory candles that have not necessarily reached the repository yet.
+// tryGetCandles follows getCandles semantics (range reads ascending from
+// fromTs, otherwise the newest `limit`) and returns false when its retention
+// cannot answer the request in full, so the caller reads the repository.
+class ILiveCandleSource {
+public:
+    virtual ~ILiveCandleSource() = default;
+
+    virtual bool tryGetCandles(const Symbol& symbol,
+                               Interval interval,
+                               std::int64_t fromTs,
+                               std::int64_t toTs,
+                               std::size_t limit,
+                               std::vector<Candle>& out) const = 0;
 };
 
 class ILivePublisher {
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "domain/Types.h"
+
+namespace domain {
+
+// One aggregated trade (Binance aggTrade): fills at the same price from one
+// taker order.
+struct AggTrade {
+  TimestampMs tradeTime{0};
+  double price{0};
+  double quantity{0};
+  bool buyerIsMaker{false};
+};
+
+class IExchangeLiveTrades {
+ public:
+  virtual ~IExchangeLiveTrades() = default;
+  // The symbol view is only valid during the callback.
+  virtual void subscribe_trades(
+      const std::vector<std::string>& symbols,
+      std::function<void(std::string_view, const AggTrade&)> on_trade) = 0;
+  virtual void set_on_reconnected(std::function<void()> callback) = 0;
+  virtual void stop() = 0;
+};
+
+}  // namespace domain
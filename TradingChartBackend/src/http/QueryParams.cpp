@@ -1,107 +1,126 @@
 #include "http/QueryParams.hpp"
 
+#include <algorithm>
 #include <charconv>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 namespace {
 
-std::string decode_component(std::string_view value) {
-    std::string decoded;
-    decoded.reserve(value.size());
-    for (std::size_t i = 0; i < value.size(); ++i) {
-        const char ch = value[i];
-        if (ch == '+') {
-            decoded.push_back(' ');
-        }
-        else if (ch == '%' && i + 2 < value.size()) {
-            const char* begin = value.data() + i + 1;
-            const char* end = begin + 2;
-            unsigned int code{};
-            auto [ptr, ec] = std::from_chars(begin, end, code, 16);
-            if (ec == std::errc() && ptr == end) {
-                decoded.push_back(static_cast<char>(code));
-                i += 2;
-            }
-            else {
-                decoded.push_back(ch);
-            }
+void append_encoded(std::string& out, std::string_view value) {
+    static constexpr char kHex[] = "0123456789ABCDEF";
+    for (const unsigned char ch : value) {
+        const bool unreserved = (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9')
+            || ch == '-' || ch == '_' || ch == '.' || ch == '~';
+        if (unreserved) {
+            out.push_back(static_cast<char>(ch));
         }
         else {
-            decoded.push_back(ch);
+            out.push_back('%');
+            out.push_back(kHex[ch >> 4U]);
+            out.push_back(kHex[ch & 0x0FU]);
         }
     }
-    return decoded;
 }
 
-std::optional<std::string> find_query_value(const std::string& query, std::string_view key) {
-    const std::string key_str(key);
-    std::size_t start = 0;
-    while (start <= query.size()) {
-        const auto end = query.find('&', start);
-        const auto part = query.substr(start, end == std::string::npos ? std::string::npos : end - start);
-        const auto eq = part.find('=');
-        std::string raw_key;
-        std::string raw_value;
-        if (eq == std::string::npos) {
-            raw_key = part;
-        }
-        else {
-            raw_key = part.substr(0, eq);
-            raw_value = part.substr(eq + 1);
-        }
-        if (decode_component(raw_key) == key_str) {
-            return decode_component(raw_value);
-        }
-        if (end == std::string::npos) {
-            break;
-        }
-        start = end + 1;
+template <typename Integer>
+std::optional<Integer> parse_integer(std::string_view value) {
+    if (value.empty()) {
+        return std::nullopt;
+    }
+    Integer result = 0;
+    const auto* begin = value.data();
+    const auto* end = begin + value.size();
+    auto [ptr, ec] = std::from_chars(begin, end, result);
+    if (ec != std::errc() || ptr != end) {
+        return std::nullopt;
     }
-    return std::nullopt;
+    return result;
 }
 
 }  // namespace
 
 namespace ttp::http {
 
-std::optional<std::string> opt_string(const ttp::api::Request& request, const char* key) {
+std::optional<std::string_view> opt_string(const ttp::api::Request& request, const char* key) {
     if (!key) {
         return std::nullopt;
     }
-    return find_query_value(request.query, key);
+    return request.param(key);
 }
 
 std::optional<int> opt_int(const ttp::api::Request& request, const char* key) {
     const auto value = opt_string(request, key);
-    if (!value || value->empty()) {
-        return std::nullopt;
-    }
-    int result = 0;
-    const auto* begin = value->data();
-    const auto* end = begin + value->size();
-    auto [ptr, ec] = std::from_chars(begin, end, result);
-    if (ec != std::errc() || ptr != end) {
-        return std::nullopt;
-    }
-    return result;
+    return value ? parse_int(*value) : std::nullopt;
 }
 
 std::optional<std::int64_t> opt_int64(const ttp::api::Request& request, const char* key) {
     const auto value = opt_string(request, key);
-    if (!value || value->empty()) {
-        return std::nullopt;
+    return value ? parse_int64(*value) : std::nullopt;
+}
+
+std::optional<int> parse_int(std::string_view value) {
+    return parse_integer<int>(value);
+}
+
+std::optional<std::int64_t> parse_int64(std::string_view value) {
+    return parse_integer<std::int64_t>(value);
+}
+
+std::optional<std::string_view> opt_header(const ttp::api::Request& request, std::string_view name) {
+    return request.header(name);
+}
+
+bool etag_matches(std::string_view ifNoneMatch, std::string_view etag) {
+    std::size_t start = 0;
+    while (start < ifNoneMatch.size()) {
+        const auto end = std::min(ifNoneMatch.find(',', start), ifNoneMatch.size());
+        auto candidate = ifNoneMatch.substr(start, end - start);
+        while (!candidate.empty() && (candidate.front() == ' ' || candidate.front() == '\t')) {
+            candidate.remove_prefix(1);
+        }
+        while (!candidate.empty() && (candidate.back() == ' ' || candidate.back() == '\t')) {
+            candidate.remove_suffix(1);
+        }
+        if (candidate.size() > 2 && candidate.compare(0, 2, "W/") == 0) {
+            candidate.remove_prefix(2);
+        }
+        if (candidate == "*" || candidate == etag) {
+            return true;
+        }
+        start = end + 1;
     }
-    std::int64_t result = 0;
-    const auto* begin = value->data();
-    const auto* end = begin + value->size();
-    auto [ptr, ec] = std::from_chars(begin, end, result);
-    if (ec != std::errc() || ptr != end) {
-        return std::nullopt;
+    return false;
+}
+
+std::string canonical_query(const ttp::api::Request& request) {
+    std::vector<std::pair<std::string_view, std::string_view>> params;
+    params.reserve(request.paramCount());
+    for (std::size_t i = 0; i < request.paramCount(); ++i) {
+        auto param = request.paramAt(i);
+        const auto duplicate = std::any_of(params.begin(), params.end(), [&param](const auto& seen) {
+            return seen.first == param.first;
+        });
+        if (!duplicate) {
+            params.push_back(param);
+        }
     }
-    return result;
+    std::sort(params.begin(), params.end());
+
+    std::string canonical;
+    canonical.reserve(request.query().size());
+    for (const auto& [key, value] : params) {
+        if (!canonical.empty()) {
+            canonical.push_back('&');
+        }
+        append_encoded(canonical, key);
+        canonical.push_back('=');
+        append_encoded(canonical, value);
+    }
+    return canonical;
 }
 
 }  // namespace ttp::http
-
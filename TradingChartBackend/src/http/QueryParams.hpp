@@ -3,16 +3,36 @@
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
 
 #include "api/Controllers.hpp"
 
 namespace ttp::http {
 
-std::optional<std::string> opt_string(const ttp::api::Request& request, const char* key);
+// Query parameters and headers are views into the request and live as long
+// as it does. Names are matched after percent-decoding.
+std::optional<std::string_view> opt_string(const ttp::api::Request& request, const char* key);
 
 std::optional<int> opt_int(const ttp::api::Request& request, const char* key);
 
 std::optional<std::int64_t> opt_int64(const ttp::api::Request& request, const char* key);
 
+// Whole-value decimal parses, for a parameter already looked up.
+std::optional<int> parse_int(std::string_view value);
+
+std::optional<std::int64_t> parse_int64(std::string_view value);
+
+// First header named `name`, case-insensitively.
+std::optional<std::string_view> opt_header(const ttp::api::Request& request, std::string_view name);
+
+// If-None-Match against a strong ETag with the weak comparison of RFC 9110
+// (W/ prefixes ignored); "*" matches anything.
+bool etag_matches(std::string_view ifNoneMatch, std::string_view etag);
+
+// Decoded parameters sorted by name and re-encoded, so `a=1&b=2` and
+// `b=2&a=%31` compare equal. Only the first value of a repeated name is kept,
+// as opt_string() would read it.
+std::string canonical_query(const ttp::api::Request& request);
+
 }  // namespace ttp::http
 
@@ -6,7 +6,7 @@
 
 namespace {
 
-constexpr std::array<std::string_view, 4> kSupportedIntervals{"1m", "5m", "1h", "1d"};
+constexpr std::array<std::string_view, 7> kSupportedIntervals{"1s", "5s", "15s", "1m", "5m", "1h", "1d"};
 
 }  // namespace
 
@@ -0,0 +1,205 @@
+#include "indicators/IndicatorCache.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace indicators {
+
+std::string seriesKey(std::string_view symbol, std::string_view intervalLabel) {
+    std::string key;
+    key.reserve(symbol.size() + intervalLabel.size() + 1U);
+    key.append(symbol);
+    key.push_back('@');
+    key.append(intervalLabel);
+    return key;
+}
+
+IndicatorCache::Entry::Entry(const IndicatorSpec& spec)
+    : state(spec) {}
+
+void IndicatorCache::Entry::append(std::int64_t openTime, const IndicatorValue& value) {
+    lastOpenTime = openTime;
+    if (values.empty()) {
+        return;
+    }
+    openTimes[head] = openTime;
+    values[head] = value;
+    head = (head + 1U) % values.size();
+    size = std::min(size + 1U, values.size());
+}
+
+IndicatorCache& IndicatorCache::instance() {
+    static IndicatorCache cache;
+    return cache;
+}
+
+void IndicatorCache::trackSeries(const std::string& seriesId, std::int64_t intervalMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& series = series_[seriesId];
+    if (series.intervalMs != intervalMs) {
+        series.intervalMs = intervalMs;
+        series.partial.reset();
+        series.entries.clear();
+    }
+}
+
+bool IndicatorCache::tracks(const std::string& seriesId) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return series_.find(seriesId) != series_.end();
+}
+
+void IndicatorCache::onCandle(const std::string& seriesId, const IndicatorBar& bar, bool closed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = series_.find(seriesId);
+    if (it == series_.end()) {
+        return;
+    }
+    auto& series = it->second;
+
+    if (!closed) {
+        series.partial = bar;
+        return;
+    }
+
+    if (series.partial && series.partial->openTime <= bar.openTime) {
+        series.partial.reset();
+    }
+
+    auto& entries = series.entries;
+    for (auto& entry : entries) {
+        if (bar.openTime == entry->lastOpenTime + series.intervalMs) {
+            entry->append(bar.openTime, entry->state.push(bar));
+        }
+        else if (bar.openTime > entry->lastOpenTime) {
+            // A candle went missing; the state no longer matches the series.
+            entry.reset();
+        }
+    }
+    entries.erase(std::remove(entries.begin(), entries.end(), nullptr), entries.end());
+}
+
+std::optional<IndicatorSnapshot> IndicatorCache::latest(const std::string& seriesId,
+                                                        const IndicatorSpec& spec,
+                                                        std::size_t limit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = series_.find(seriesId);
+    if (it == series_.end()) {
+        return std::nullopt;
+    }
+    auto* entry = find_(it->second, spec);
+    if (!entry || limit > entry->values.size()) {
+        return std::nullopt;
+    }
+    entry->lastUsed = ++useClock_;
+    return snapshot_(it->second, *entry, limit);
+}
+
+IndicatorSnapshot IndicatorCache::seed(const std::string& seriesId,
+                                       const IndicatorSpec& spec,
+                                       const std::vector<IndicatorBar>& bars,
+                                       std::size_t capacity,
+                                       std::size_t limit) {
+    auto built = std::make_unique<Entry>(spec);
+    built->openTimes.resize(capacity);
+    built->values.resize(capacity);
+    for (const auto& bar : bars) {
+        built->append(bar.openTime, built->state.push(bar));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& series = series_[seriesId];
+    auto* entry = find_(series, spec);
+    if (entry && entry->values.size() >= capacity) {
+        // Another request seeded it first and the feed may have advanced it since.
+        entry->lastUsed = ++useClock_;
+        return snapshot_(series, *entry, limit);
+    }
+
+    built->lastUsed = ++useClock_;
+    if (entry) {
+        for (auto& slot : series.entries) {
+            if (slot.get() == entry) {
+                slot = std::move(built);
+                entry = slot.get();
+                break;
+            }
+        }
+    }
+    else {
+        if (series.entries.size() >= kMaxEntriesPerSeries) {
+            const auto oldest = std::min_element(series.entries.begin(),
+                                                 series.entries.end(),
+                                                 [](const auto& lhs, const auto& rhs) {
+                                                     return lhs->lastUsed < rhs->lastUsed;
+                                                 });
+            series.entries.erase(oldest);
+        }
+        series.entries.push_back(std::move(built));
+        entry = series.entries.back().get();
+    }
+    return snapshot_(series, *entry, limit);
+}
+
+void IndicatorCache::invalidate(const std::string& seriesId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = series_.find(seriesId);
+    if (it != series_.end()) {
+        it->second.entries.clear();
+    }
+}
+
+void IndicatorCache::invalidateAll() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [id, series] : series_) {
+        series.entries.clear();
+    }
+}
+
+IndicatorCache::Entry* IndicatorCache::find_(Series& series, const IndicatorSpec& spec) {
+    for (auto& entry : series.entries) {
+        const auto& cached = entry->state.spec();
+        if (cached.kind == spec.kind && cached.params == spec.params) {
+            return entry.get();
+        }
+    }
+    return nullptr;
+}
+
+IndicatorSnapshot IndicatorCache::snapshot_(const Series& series, const Entry& entry, std::size_t limit) const {
+    IndicatorSnapshot snapshot;
+    const auto outputCount = indicatorOutputNames(entry.state.spec().kind).size();
+    snapshot.outputs.resize(outputCount);
+    if (limit == 0) {
+        return snapshot;
+    }
+
+    const bool hasPartial = series.partial && series.partial->openTime == entry.lastOpenTime + series.intervalMs;
+    const std::size_t closedRows = std::min(entry.size, hasPartial ? limit - 1U : limit);
+    const std::size_t rows = closedRows + (hasPartial ? 1U : 0U);
+    snapshot.openTimes.reserve(rows);
+    for (auto& output : snapshot.outputs) {
+        output.reserve(rows);
+    }
+
+    const auto capacity = entry.values.size();
+    std::size_t index = (entry.head + capacity - closedRows) % std::max<std::size_t>(capacity, 1U);
+    for (std::size_t row = 0; row < closedRows; ++row) {
+        snapshot.openTimes.push_back(entry.openTimes[index]);
+        for (std::size_t k = 0; k < outputCount; ++k) {
+            snapshot.outputs[k].push_back(entry.values[index][k]);
+        }
+        index = (index + 1U) % capacity;
+    }
+
+    if (hasPartial) {
+        const auto value = entry.state.peek(*series.partial);
+        snapshot.openTimes.push_back(series.partial->openTime);
+        for (std::size_t k = 0; k < outputCount; ++k) {
+            snapshot.outputs[k].push_back(value[k]);
+        }
+        snapshot.partial = true;
+    }
+    return snapshot;
+}
+
+}  // namespace indicators
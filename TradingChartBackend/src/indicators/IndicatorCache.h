@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "indicators/IndicatorSpec.h"
+#include "indicators/RollingIndicator.h"
+
+namespace indicators {
+
+// Series id shared by the live feed and the HTTP layer, e.g. "BTCUSDT@1m".
+std::string seriesKey(std::string_view symbol, std::string_view intervalLabel);
+
+// Last values of one indicator, oldest first, laid out like computeIndicator's result.
+struct IndicatorSnapshot {
+    std::vector<std::int64_t> openTimes;
+    std::vector<std::vector<double>> outputs;
+    // True when the last row is the in-progress candle evaluated speculatively.
+    bool partial{false};
+};
+
+// Rolling indicator results for live series, keyed by (series, indicator, params).
+// Each entry keeps its streaming state plus a bounded history of closed values:
+// a closed candle advances every entry of its series in O(1), a partial candle
+// is only remembered and evaluated with peek() when read. Entries are dropped
+// when the feed skips a candle (reconnects, catch-up) and rebuilt on demand.
+class IndicatorCache {
+public:
+    static constexpr std::size_t kMaxEntriesPerSeries = 16;
+
+    static IndicatorCache& instance();
+
+    // Only tracked series are fed by the live ingestor and may be cached.
+    void trackSeries(const std::string& seriesId, std::int64_t intervalMs);
+    bool tracks(const std::string& seriesId) const;
+
+    void onCandle(const std::string& seriesId, const IndicatorBar& bar, bool closed);
+
+    // Last `limit` values, plus the speculative in-progress one; nullopt on a miss.
+    std::optional<IndicatorSnapshot> latest(const std::string& seriesId,
+                                            const IndicatorSpec& spec,
+                                            std::size_t limit);
+
+    // Builds an entry by replaying closed `bars` (oldest first) and keeps the
+    // last `capacity` values. Returns the same view latest() would.
+    IndicatorSnapshot seed(const std::string& seriesId,
+                           const IndicatorSpec& spec,
+                           const std::vector<IndicatorBar>& bars,
+                           std::size_t capacity,
+                           std::size_t limit);
+
+    void invalidate(const std::string& seriesId);
+    void invalidateAll();
+
+private:
+    struct Entry {
+        explicit Entry(const IndicatorSpec& spec);
+
+        RollingIndicator state;
+        std::int64_t lastOpenTime{0};
+        std::uint64_t lastUsed{0};
+        // Ring of closed values; `head` is the next slot to write.
+        std::vector<std::int64_t> openTimes;
+        std::vector<IndicatorValue> values;
+        std::size_t head{0};
+        std::size_t size{0};
+
+        void append(std::int64_t openTime, const IndicatorValue& value);
+    };
+
+    struct Series {
+        std::int64_t intervalMs{0};
+        std::optional<IndicatorBar> partial;
+        std::vector<std::unique_ptr<Entry>> entries;
+    };
+
+    IndicatorCache() = default;
+
+    static Entry* find_(Series& series, const IndicatorSpec& spec);
+    IndicatorSnapshot snapshot_(const Series& series, const Entry& entry, std::size_t limit) const;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Series> series_;
+    std::uint64_t useClock_{0};
+};
+
+}  // namespace indicators
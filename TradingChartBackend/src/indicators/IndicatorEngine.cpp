@@ -1,6 +1,7 @@
 #include "indicators/IndicatorEngine.h"
 
 #include "domain/Types.h"
+#include "indicators/IndicatorFan.h"
 
 #include <cmath>
 #include <limits>
@@ -51,6 +52,30 @@ IndicatorSeries IndicatorEngine::computeEMA(const domain::CandleSeries& candles,
     return series;
 }
 
+std::vector<IndicatorSeries> IndicatorEngine::computeEMAFan(const domain::CandleSeries& candles,
+                                                            const std::vector<EmaParams>& params) {
+    std::vector<double> closes;
+    closes.reserve(candles.data.size());
+    for (const auto& candle : candles.data) {
+        closes.push_back(candle.close);
+    }
+
+    std::vector<int> periods;
+    periods.reserve(params.size());
+    for (const auto& entry : params) {
+        periods.push_back(entry.period);
+    }
+
+    const auto block = fan::emaFan<float>(closes.data(), closes.size(), periods);
+
+    std::vector<IndicatorSeries> series(params.size());
+    for (std::size_t k = 0; k < params.size(); ++k) {
+        series[k].id = params[k].name();
+        series[k].values.assign(block.column(k), block.column(k) + block.rows);
+    }
+    return series;
+}
+
 void IndicatorEngine::updateEMAIncremental(const domain::CandleSeries& candles,
                                            const EmaParams& params,
                                            IndicatorSeries& inOut) {
@@ -2,6 +2,8 @@
 
 #include "indicators/IndicatorTypes.h"
 
+#include <vector>
+
 namespace domain {
 struct CandleSeries;
 }
@@ -12,6 +14,11 @@ class IndicatorEngine {
 public:
     static IndicatorSeries computeEMA(const domain::CandleSeries& candles, const EmaParams& params);
 
+    // Every period in one pass over the closes (see indicators::fan::emaFan);
+    // returns one series per entry of `params`, in order.
+    static std::vector<IndicatorSeries> computeEMAFan(const domain::CandleSeries& candles,
+                                                      const std::vector<EmaParams>& params);
+
     static void updateEMAIncremental(const domain::CandleSeries& candles,
                                      const EmaParams& params,
                                      IndicatorSeries& inOut);
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace indicators::fan {
+
+// Many periods of one indicator in a single pass over the closes, e.g. an
+// EMA 9/21/50/100/200 overlay or an SMA ribbon. T (float or double) is the
+// precision of the running state and of the result block.
+
+// Lanes (one per period) are padded to a multiple of this so the per-bar loop
+// across periods vectorizes without a scalar remainder.
+inline constexpr std::size_t kLaneMultiple = 8;
+// Bars per tile: the closes and the row-major scratch tile stay in L1 while
+// every group of periods sweeps them, then the tile is transposed into columns.
+inline constexpr std::size_t kTileRows = 256;
+
+template <typename T>
+struct FanResult {
+    std::vector<int> periods;
+    std::size_t rows{0};
+    // Column-major: values[k * rows + i] is period k at bar i; NaN during warm-up.
+    std::vector<T> values;
+
+    T* column(std::size_t k) noexcept { return values.data() + k * rows; }
+    const T* column(std::size_t k) const noexcept { return values.data() + k * rows; }
+};
+
+namespace detail {
+
+inline std::size_t paddedLanes(std::size_t periods) {
+    return (periods + kLaneMultiple - 1U) / kLaneMultiple * kLaneMultiple;
+}
+
+// Reuses the block's storage, so callers recomputing in a loop stop paying
+// for fresh pages on every call.
+template <typename T>
+void resetResult(FanResult<T>& result, const std::vector<int>& periods, std::size_t count) {
+    result.periods = periods;
+    result.rows = count;
+    result.values.assign(periods.size() * count, std::numeric_limits<T>::quiet_NaN());
+}
+
+}  // namespace detail
+
+// EMA seeded with the SMA of the first `period` closes, as IndicatorEngine::computeEMA.
+// Until its seed bar a lane keeps the running mean (coefficient 1/(i+1)), which
+// equals that SMA at i = period - 1. Once the longest period is seeded, each
+// tile of closes is swept once per group of kLaneMultiple periods with the
+// group's state held in registers: one vector update per bar for all of them.
+// Periods <= 0 yield an all-NaN column.
+template <typename T>
+void emaFan(const double* close, std::size_t count, const std::vector<int>& periods, FanResult<T>& result) {
+    detail::resetResult(result, periods, count);
+    const std::size_t lanes = detail::paddedLanes(periods.size());
+    if (lanes == 0 || count == 0) {
+        return;
+    }
+
+    // Padding and invalid lanes run with alpha 0 and are never copied out.
+    std::vector<T> alphas(lanes, T(0));
+    std::vector<T> states(lanes, T(0));
+    std::size_t longest = 0;
+    for (std::size_t k = 0; k < periods.size(); ++k) {
+        if (periods[k] > 0) {
+            alphas[k] = T(2) / (static_cast<T>(periods[k]) + T(1));
+            longest = std::max(longest, static_cast<std::size_t>(periods[k]));
+        }
+    }
+
+    // Seeding: at most kMaxIndicatorPeriod bars, lanes branch on their own period.
+    const std::size_t seeded = std::min(count, longest);
+    for (std::size_t i = 0; i < seeded; ++i) {
+        const T x = static_cast<T>(close[i]);
+        const T meanCoef = T(1) / static_cast<T>(i + 1U);
+        for (std::size_t k = 0; k < periods.size(); ++k) {
+            if (periods[k] <= 0) {
+                continue;
+            }
+            const auto window = static_cast<std::size_t>(periods[k]);
+            states[k] += (x - states[k]) * (i < window ? meanCoef : alphas[k]);
+            if (i + 1U >= window) {
+                result.column(k)[i] = states[k];
+            }
+        }
+    }
+
+    std::vector<T> tile(kTileRows * kLaneMultiple);
+    for (std::size_t begin = seeded; begin < count; begin += kTileRows) {
+        const std::size_t end = std::min(count, begin + kTileRows);
+        for (std::size_t group = 0; group < lanes; group += kLaneMultiple) {
+            T acc[kLaneMultiple];
+            T alpha[kLaneMultiple];
+            for (std::size_t j = 0; j < kLaneMultiple; ++j) {
+                acc[j] = states[group + j];
+                alpha[j] = alphas[group + j];
+            }
+            for (std::size_t i = begin; i < end; ++i) {
+                const T x = static_cast<T>(close[i]);
+                T* __restrict row = tile.data() + (i - begin) * kLaneMultiple;
+                for (std::size_t j = 0; j < kLaneMultiple; ++j) {
+                    acc[j] += (x - acc[j]) * alpha[j];
+                    row[j] = acc[j];
+                }
+            }
+            for (std::size_t j = 0; j < kLaneMultiple; ++j) {
+                states[group + j] = acc[j];
+            }
+
+            const std::size_t columns = std::min(kLaneMultiple, periods.size() - group);
+            for (std::size_t j = 0; j < columns; ++j) {
+                if (periods[group + j] <= 0) {
+                    continue;
+                }
+                T* __restrict out = result.column(group + j) + begin;
+                const T* __restrict src = tile.data() + j;
+                for (std::size_t i = 0; i < end - begin; ++i) {
+                    out[i] = src[i * kLaneMultiple];
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+FanResult<T> emaFan(const double* close, std::size_t count, const std::vector<int>& periods) {
+    FanResult<T> result;
+    emaFan(close, count, periods, result);
+    return result;
+}
+
+// Simple moving averages from one shared prefix sum. Windows of different
+// lengths would need gathers across lanes, so each tile is swept per period
+// along time instead; the prefix rows a tile touches stay in cache across
+// periods. The prefix is kept in double regardless of T.
+template <typename T>
+void smaFan(const double* close, std::size_t count, const std::vector<int>& periods, FanResult<T>& result) {
+    detail::resetResult(result, periods, count);
+    if (periods.empty() || count == 0) {
+        return;
+    }
+
+    // Deviations from the first close keep the prefix small on long ranges.
+    const double pivot = close[0];
+    std::vector<double> prefixes(count + 1U, 0.0);
+    for (std::size_t i = 0; i < count; ++i) {
+        prefixes[i + 1U] = prefixes[i] + (close[i] - pivot);
+    }
+    const double* __restrict prefix = prefixes.data();
+
+    constexpr std::size_t kSmaTileRows = kTileRows * 16U;
+    for (std::size_t begin = 0; begin < count; begin += kSmaTileRows) {
+        const std::size_t end = std::min(count, begin + kSmaTileRows);
+        for (std::size_t k = 0; k < periods.size(); ++k) {
+            if (periods[k] <= 0) {
+                continue;
+            }
+            const auto window = static_cast<std::size_t>(periods[k]);
+            const double scale = 1.0 / static_cast<double>(periods[k]);
+            T* __restrict out = result.column(k);
+            for (std::size_t i = std::max(begin, window - 1U); i < end; ++i) {
+                out[i] = static_cast<T>(pivot + (prefix[i + 1U] - prefix[i + 1U - window]) * scale);
+            }
+        }
+    }
+}
+
+template <typename T>
+FanResult<T> smaFan(const double* close, std::size_t count, const std::vector<int>& periods) {
+    FanResult<T> result;
+    smaFan(close, count, periods, result);
+    return result;
+}
+
+}  // namespace indicators::fan
@@ -0,0 +1,245 @@
+#include "indicators/IndicatorKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace indicators::kernels {
+namespace {
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+double rsiFromAverages(double avgGain, double avgLoss) {
+    if (avgLoss == 0.0) {
+        return avgGain == 0.0 ? 50.0 : 100.0;
+    }
+    return 100.0 - 100.0 / (1.0 + avgGain / avgLoss);
+}
+
+}  // namespace
+
+void OhlcvColumns::resize(std::size_t count) {
+    openTime.resize(count);
+    open.resize(count);
+    high.resize(count);
+    low.resize(count);
+    close.resize(count);
+    volume.resize(count);
+}
+
+void sma(const double* __restrict in, std::size_t count, int period, double* __restrict out) {
+    std::fill_n(out, count, kNaN);
+    const auto window = static_cast<std::size_t>(period);
+    if (period <= 0 || count < window) {
+        return;
+    }
+
+    // Prefix sums of deviations from the first input keep precision on long ranges;
+    // the windowed difference below is then a plain element-wise loop.
+    const double pivot = in[0];
+    std::vector<double> prefix(count + 1U, 0.0);
+    for (std::size_t i = 0; i < count; ++i) {
+        prefix[i + 1U] = prefix[i] + (in[i] - pivot);
+    }
+
+    const double scale = 1.0 / static_cast<double>(period);
+    const double* __restrict head = prefix.data() + window;
+    const double* __restrict tail = prefix.data();
+    double* __restrict dst = out + (window - 1U);
+    const std::size_t outputs = count - window + 1U;
+    for (std::size_t i = 0; i < outputs; ++i) {
+        dst[i] = pivot + (head[i] - tail[i]) * scale;
+    }
+}
+
+void ema(const double* __restrict in, std::size_t count, int period, double* __restrict out) {
+    std::fill_n(out, count, kNaN);
+    if (period <= 0) {
+        return;
+    }
+    const auto window = static_cast<std::size_t>(period);
+
+    std::size_t first = 0;
+    while (first < count && !std::isfinite(in[first])) {
+        ++first;
+    }
+    if (count - first < window) {
+        return;
+    }
+
+    double sum = 0.0;
+    for (std::size_t i = first; i < first + window; ++i) {
+        sum += in[i];
+    }
+    double value = sum / static_cast<double>(period);
+    out[first + window - 1U] = value;
+
+    const double alpha = 2.0 / (static_cast<double>(period) + 1.0);
+    for (std::size_t i = first + window; i < count; ++i) {
+        value += (in[i] - value) * alpha;
+        out[i] = value;
+    }
+}
+
+void rsi(const double* __restrict close, std::size_t count, int period, double* __restrict out) {
+    std::fill_n(out, count, kNaN);
+    const auto window = static_cast<std::size_t>(period);
+    if (period <= 0 || count <= window) {
+        return;
+    }
+
+    std::vector<double> gains(count, 0.0);
+    std::vector<double> losses(count, 0.0);
+    double* __restrict gain = gains.data();
+    double* __restrict loss = losses.data();
+    for (std::size_t i = 1; i < count; ++i) {
+        const double delta = close[i] - close[i - 1U];
+        gain[i] = std::max(delta, 0.0);
+        loss[i] = std::max(-delta, 0.0);
+    }
+
+    double avgGain = 0.0;
+    double avgLoss = 0.0;
+    for (std::size_t i = 1; i <= window; ++i) {
+        avgGain += gain[i];
+        avgLoss += loss[i];
+    }
+    const double scale = 1.0 / static_cast<double>(period);
+    avgGain *= scale;
+    avgLoss *= scale;
+    out[window] = rsiFromAverages(avgGain, avgLoss);
+
+    const double keep = static_cast<double>(period - 1);
+    for (std::size_t i = window + 1U; i < count; ++i) {
+        avgGain = (avgGain * keep + gain[i]) * scale;
+        avgLoss = (avgLoss * keep + loss[i]) * scale;
+        out[i] = rsiFromAverages(avgGain, avgLoss);
+    }
+}
+
+void macd(const double* __restrict close,
+          std::size_t count,
+          int fastPeriod,
+          int slowPeriod,
+          int signalPeriod,
+          double* __restrict macdLine,
+          double* __restrict signalLine,
+          double* __restrict histogram) {
+    std::vector<double> fast(count);
+    std::vector<double> slow(count);
+    ema(close, count, fastPeriod, fast.data());
+    ema(close, count, slowPeriod, slow.data());
+
+    const double* __restrict fastData = fast.data();
+    const double* __restrict slowData = slow.data();
+    for (std::size_t i = 0; i < count; ++i) {
+        macdLine[i] = fastData[i] - slowData[i];
+    }
+
+    ema(macdLine, count, signalPeriod, signalLine);
+    for (std::size_t i = 0; i < count; ++i) {
+        histogram[i] = macdLine[i] - signalLine[i];
+    }
+}
+
+void bbands(const double* __restrict close,
+            std::size_t count,
+            int period,
+            double deviations,
+            double* __restrict upper,
+            double* __restrict middle,
+            double* __restrict lower) {
+    sma(close, count, period, middle);
+    std::fill_n(upper, count, kNaN);
+    std::fill_n(lower, count, kNaN);
+    const auto window = static_cast<std::size_t>(period);
+    if (period <= 0 || count < window) {
+        return;
+    }
+
+    // Sum of squared deviations around each window's own mean, one lag at a
+    // time: every pass is element-wise across outputs and avoids the
+    // cancellation of the E[x^2] - E[x]^2 shortcut.
+    const std::size_t first = window - 1U;
+    std::vector<double> squares(count, 0.0);
+    double* __restrict sq = squares.data();
+    for (std::size_t lag = 0; lag < window; ++lag) {
+        for (std::size_t i = first; i < count; ++i) {
+            const double diff = close[i - lag] - middle[i];
+            sq[i] += diff * diff;
+        }
+    }
+
+    const double scale = 1.0 / static_cast<double>(period);
+    for (std::size_t i = first; i < count; ++i) {
+        const double band = deviations * std::sqrt(sq[i] * scale);
+        upper[i] = middle[i] + band;
+        lower[i] = middle[i] - band;
+    }
+}
+
+void atr(const double* __restrict high,
+         const double* __restrict low,
+         const double* __restrict close,
+         std::size_t count,
+         int period,
+         double* __restrict out) {
+    std::fill_n(out, count, kNaN);
+    const auto window = static_cast<std::size_t>(period);
+    if (period <= 0 || count < window) {
+        return;
+    }
+
+    std::vector<double> ranges(count);
+    double* __restrict range = ranges.data();
+    range[0] = high[0] - low[0];
+    for (std::size_t i = 1; i < count; ++i) {
+        const double previous = close[i - 1U];
+        range[i] = std::max(high[i] - low[i], std::max(std::abs(high[i] - previous), std::abs(low[i] - previous)));
+    }
+
+    double value = 0.0;
+    for (std::size_t i = 0; i < window; ++i) {
+        value += range[i];
+    }
+    const double scale = 1.0 / static_cast<double>(period);
+    value *= scale;
+    out[window - 1U] = value;
+
+    const double keep = static_cast<double>(period - 1);
+    for (std::size_t i = window; i < count; ++i) {
+        value = (value * keep + range[i]) * scale;
+        out[i] = value;
+    }
+}
+
+void vwap(const std::int64_t* __restrict openTime,
+          const double* __restrict high,
+          const double* __restrict low,
+          const double* __restrict close,
+          const double* __restrict volume,
+          std::size_t count,
+          std::int64_t sessionMs,
+          double* __restrict out) {
+    std::vector<double> weighted(count);
+    double* __restrict pv = weighted.data();
+    for (std::size_t i = 0; i < count; ++i) {
+        pv[i] = (high[i] + low[i] + close[i]) * (1.0 / 3.0) * volume[i];
+    }
+
+    double sumPv = 0.0;
+    double sumVolume = 0.0;
+    std::int64_t session = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::int64_t current = sessionMs > 0 ? openTime[i] / sessionMs : 0;
+        if (i == 0 || current != session) {
+            session = current;
+            sumPv = 0.0;
+            sumVolume = 0.0;
+        }
+        sumPv += pv[i];
+        sumVolume += volume[i];
+        out[i] = sumVolume > 0.0 ? sumPv / sumVolume : kNaN;
+    }
+}
+
+}  // namespace indicators::kernels
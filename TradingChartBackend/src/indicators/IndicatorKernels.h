@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace indicators::kernels {
+
+// Structure-of-arrays view of a candle range, oldest first. The kernels below
+// read these columns directly so their element-wise passes auto-vectorize.
+struct OhlcvColumns {
+    std::vector<std::int64_t> openTime;
+    std::vector<double> open;
+    std::vector<double> high;
+    std::vector<double> low;
+    std::vector<double> close;
+    std::vector<double> volume;
+
+    void resize(std::size_t count);
+    std::size_t size() const noexcept { return close.size(); }
+};
+
+// Every kernel writes `count` outputs; bars without enough history are NaN.
+// Inputs and outputs must not overlap. Recurrences (EMA, Wilder smoothing)
+// stay serial in time; everything else is a flat loop over the columns.
+
+void sma(const double* in, std::size_t count, int period, double* out);
+
+// Seeded with the SMA of the first `period` finite inputs, so leading NaNs
+// (e.g. a MACD line) are skipped.
+void ema(const double* in, std::size_t count, int period, double* out);
+
+// Wilder RSI: average gain/loss seeded with a plain mean, then smoothed by 1/period.
+void rsi(const double* close, std::size_t count, int period, double* out);
+
+void macd(const double* close,
+          std::size_t count,
+          int fastPeriod,
+          int slowPeriod,
+          int signalPeriod,
+          double* macdLine,
+          double* signalLine,
+          double* histogram);
+
+// Population standard deviation, matching the usual charting definition.
+void bbands(const double* close,
+            std::size_t count,
+            int period,
+            double deviations,
+            double* upper,
+            double* middle,
+            double* lower);
+
+// Wilder ATR; the first true range is high - low.
+void atr(const double* high, const double* low, const double* close, std::size_t count, int period, double* out);
+
+// Volume-weighted typical price, reset whenever openTime crosses a multiple of sessionMs.
+void vwap(const std::int64_t* openTime,
+          const double* high,
+          const double* low,
+          const double* close,
+          const double* volume,
+          std::size_t count,
+          std::int64_t sessionMs,
+          double* out);
+
+}  // namespace indicators::kernels
@@ -0,0 +1,229 @@
+#include "indicators/IndicatorSpec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+namespace indicators {
+namespace {
+constexpr double kMaxBandDeviations = 10.0;
+// Recursive averages are read once the seed's weight has decayed below ~e^-8.
+constexpr std::size_t kEmaSettlePeriods = 4;
+constexpr std::size_t kWilderSettlePeriods = 8;
+
+std::vector<double> defaultParams(IndicatorKind kind) {
+    switch (kind) {
+    case IndicatorKind::Ema:
+    case IndicatorKind::Sma:
+        return {20.0};
+    case IndicatorKind::Rsi:
+    case IndicatorKind::Atr:
+        return {14.0};
+    case IndicatorKind::Macd:
+        return {12.0, 26.0, 9.0};
+    case IndicatorKind::Bbands:
+        return {20.0, 2.0};
+    case IndicatorKind::Vwap:
+        return {};
+    }
+    return {};
+}
+
+bool isPeriod(double value) {
+    return value >= 1.0 && value <= static_cast<double>(kMaxIndicatorPeriod) && std::floor(value) == value;
+}
+
+int period(const IndicatorSpec& spec, std::size_t index) {
+    return static_cast<int>(spec.params[index]);
+}
+
+std::size_t periodBars(const IndicatorSpec& spec, std::size_t index) {
+    return static_cast<std::size_t>(spec.params[index]);
+}
+
+}  // namespace
+
+std::optional<IndicatorKind> indicatorKindFromString(std::string_view value) {
+    if (value == "ema") {
+        return IndicatorKind::Ema;
+    }
+    if (value == "sma") {
+        return IndicatorKind::Sma;
+    }
+    if (value == "rsi") {
+        return IndicatorKind::Rsi;
+    }
+    if (value == "macd") {
+        return IndicatorKind::Macd;
+    }
+    if (value == "bbands") {
+        return IndicatorKind::Bbands;
+    }
+    if (value == "atr") {
+        return IndicatorKind::Atr;
+    }
+    if (value == "vwap") {
+        return IndicatorKind::Vwap;
+    }
+    return std::nullopt;
+}
+
+const char* indicatorKindName(IndicatorKind kind) noexcept {
+    switch (kind) {
+    case IndicatorKind::Ema:
+        return "ema";
+    case IndicatorKind::Sma:
+        return "sma";
+    case IndicatorKind::Rsi:
+        return "rsi";
+    case IndicatorKind::Macd:
+        return "macd";
+    case IndicatorKind::Bbands:
+        return "bbands";
+    case IndicatorKind::Atr:
+        return "atr";
+    case IndicatorKind::Vwap:
+        return "vwap";
+    }
+    return "unknown";
+}
+
+std::optional<std::vector<double>> parseIndicatorParams(IndicatorKind kind, std::string_view raw) {
+    auto params = defaultParams(kind);
+
+    std::size_t index = 0;
+    std::size_t start = 0;
+    while (!raw.empty() && start <= raw.size()) {
+        const auto end = std::min(raw.find(',', start), raw.size());
+        if (index >= params.size()) {
+            return std::nullopt;
+        }
+        const std::string token{raw.substr(start, end - start)};
+        if (token.empty()) {
+            return std::nullopt;
+        }
+        char* parsedEnd = nullptr;
+        const double value = std::strtod(token.c_str(), &parsedEnd);
+        if (parsedEnd != token.c_str() + token.size() || !std::isfinite(value)) {
+            return std::nullopt;
+        }
+        params[index++] = value;
+        start = end + 1U;
+    }
+
+    switch (kind) {
+    case IndicatorKind::Ema:
+    case IndicatorKind::Sma:
+    case IndicatorKind::Rsi:
+    case IndicatorKind::Atr:
+        if (!isPeriod(params[0])) {
+            return std::nullopt;
+        }
+        break;
+    case IndicatorKind::Macd:
+        if (!isPeriod(params[0]) || !isPeriod(params[1]) || !isPeriod(params[2]) || params[0] >= params[1]) {
+            return std::nullopt;
+        }
+        break;
+    case IndicatorKind::Bbands:
+        if (!isPeriod(params[0]) || params[1] <= 0.0 || params[1] > kMaxBandDeviations) {
+            return std::nullopt;
+        }
+        break;
+    case IndicatorKind::Vwap:
+        break;
+    }
+    return params;
+}
+
+std::vector<const char*> indicatorOutputNames(IndicatorKind kind) {
+    switch (kind) {
+    case IndicatorKind::Macd:
+        return {"macd", "signal", "hist"};
+    case IndicatorKind::Bbands:
+        return {"upper", "middle", "lower"};
+    default:
+        return {indicatorKindName(kind)};
+    }
+}
+
+std::size_t indicatorWarmupBars(const IndicatorSpec& spec, std::int64_t intervalMs) {
+    std::size_t bars = 0;
+    switch (spec.kind) {
+    case IndicatorKind::Sma:
+    case IndicatorKind::Bbands:
+        bars = periodBars(spec, 0) - 1U;
+        break;
+    case IndicatorKind::Ema:
+        bars = periodBars(spec, 0) * (kEmaSettlePeriods + 1U);
+        break;
+    case IndicatorKind::Rsi:
+    case IndicatorKind::Atr:
+        bars = periodBars(spec, 0) * (kWilderSettlePeriods + 1U);
+        break;
+    case IndicatorKind::Macd:
+        bars = (periodBars(spec, 1) + periodBars(spec, 2)) * (kEmaSettlePeriods + 1U);
+        break;
+    case IndicatorKind::Vwap:
+        // Enough to reach back to the start of the first requested session.
+        if (intervalMs > 0 && intervalMs < kVwapSessionMs) {
+            bars = static_cast<std::size_t>(kVwapSessionMs / intervalMs) - 1U;
+        }
+        break;
+    }
+    return std::min(bars, kMaxIndicatorWarmupBars);
+}
+
+std::vector<std::vector<double>> computeIndicator(const IndicatorSpec& spec, const kernels::OhlcvColumns& columns) {
+    const auto count = columns.size();
+    std::vector<std::vector<double>> outputs(indicatorOutputNames(spec.kind).size(), std::vector<double>(count));
+
+    switch (spec.kind) {
+    case IndicatorKind::Ema:
+        kernels::ema(columns.close.data(), count, period(spec, 0), outputs[0].data());
+        break;
+    case IndicatorKind::Sma:
+        kernels::sma(columns.close.data(), count, period(spec, 0), outputs[0].data());
+        break;
+    case IndicatorKind::Rsi:
+        kernels::rsi(columns.close.data(), count, period(spec, 0), outputs[0].data());
+        break;
+    case IndicatorKind::Macd:
+        kernels::macd(columns.close.data(),
+                      count,
+                      period(spec, 0),
+                      period(spec, 1),
+                      period(spec, 2),
+                      outputs[0].data(),
+                      outputs[1].data(),
+                      outputs[2].data());
+        break;
+    case IndicatorKind::Bbands:
+        kernels::bbands(columns.close.data(),
+                        count,
+                        period(spec, 0),
+                        spec.params[1],
+                        outputs[0].data(),
+                        outputs[1].data(),
+                        outputs[2].data());
+        break;
+    case IndicatorKind::Atr:
+        kernels::atr(columns.high.data(), columns.low.data(), columns.close.data(), count, period(spec, 0),
+                     outputs[0].data());
+        break;
+    case IndicatorKind::Vwap:
+        kernels::vwap(columns.openTime.data(),
+                      columns.high.data(),
+                      columns.low.data(),
+                      columns.close.data(),
+                      columns.volume.data(),
+                      count,
+                      kVwapSessionMs,
+                      outputs[0].data());
+        break;
+    }
+    return outputs;
+}
+
+}  // namespace indicators
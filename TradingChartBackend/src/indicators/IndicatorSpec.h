@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "indicators/IndicatorKernels.h"
+
+namespace indicators {
+
+enum class IndicatorKind {
+    Ema,
+    Sma,
+    Rsi,
+    Macd,
+    Bbands,
+    Atr,
+    Vwap,
+};
+
+inline constexpr int kMaxIndicatorPeriod = 500;
+inline constexpr std::size_t kMaxIndicatorWarmupBars = 5000;
+// VWAP restarts at every UTC day.
+inline constexpr std::int64_t kVwapSessionMs = 86'400'000;
+
+struct IndicatorSpec {
+    IndicatorKind kind{IndicatorKind::Ema};
+    // Positional parameters with defaults filled in (see parseIndicatorParams).
+    std::vector<double> params;
+};
+
+std::optional<IndicatorKind> indicatorKindFromString(std::string_view value);
+
+const char* indicatorKindName(IndicatorKind kind) noexcept;
+
+// Parses a comma-separated list such as "12,26,9"; omitted trailing values take
+// the defaults (ema/sma 20, rsi/atr 14, macd 12,26,9, bbands 20,2, vwap none).
+// Returns nullopt for malformed or out-of-range values.
+std::optional<std::vector<double>> parseIndicatorParams(IndicatorKind kind, std::string_view raw);
+
+// Names of the output series, in the order computeIndicator returns them.
+std::vector<const char*> indicatorOutputNames(IndicatorKind kind);
+
+// Candles needed ahead of the first requested one so that value has settled
+// (seed window plus enough smoothing steps for recursive averages).
+std::size_t indicatorWarmupBars(const IndicatorSpec& spec, std::int64_t intervalMs);
+
+std::vector<std::vector<double>> computeIndicator(const IndicatorSpec& spec, const kernels::OhlcvColumns& columns);
+
+}  // namespace indicators
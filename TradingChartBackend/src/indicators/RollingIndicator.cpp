@@ -0,0 +1,222 @@
+#include "indicators/RollingIndicator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace indicators {
+namespace {
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+double rsiFromAverages(double avgGain, double avgLoss) {
+    if (avgLoss == 0.0) {
+        return avgGain == 0.0 ? 50.0 : 100.0;
+    }
+    return 100.0 - 100.0 / (1.0 + avgGain / avgLoss);
+}
+
+}  // namespace
+
+double RollingIndicator::Ema::update(double input) {
+    ++count;
+    const auto window = static_cast<std::size_t>(period);
+    if (count < window) {
+        value += input;
+        return kNaN;
+    }
+    if (count == window) {
+        value = (value + input) / static_cast<double>(period);
+        return value;
+    }
+    value += (input - value) * (2.0 / (static_cast<double>(period) + 1.0));
+    return value;
+}
+
+RollingIndicator::RollingIndicator(IndicatorSpec spec)
+    : spec_(std::move(spec)) {
+    if (!spec_.params.empty()) {
+        period_ = static_cast<int>(spec_.params[0]);
+    }
+    switch (spec_.kind) {
+    case IndicatorKind::Ema:
+        state_.fast.period = period_;
+        break;
+    case IndicatorKind::Sma:
+    case IndicatorKind::Bbands:
+        window_.assign(static_cast<std::size_t>(period_), 0.0);
+        break;
+    case IndicatorKind::Macd:
+        state_.fast.period = period_;
+        state_.slow.period = static_cast<int>(spec_.params[1]);
+        state_.signal.period = static_cast<int>(spec_.params[2]);
+        break;
+    case IndicatorKind::Rsi:
+    case IndicatorKind::Atr:
+    case IndicatorKind::Vwap:
+        break;
+    }
+}
+
+IndicatorValue RollingIndicator::push(const IndicatorBar& bar) {
+    const auto value = advance(state_, bar);
+    if (!window_.empty()) {
+        window_[windowHead_] = bar.close;
+        windowHead_ = (windowHead_ + 1U) % window_.size();
+        if (windowHead_ == 0) {
+            resyncWindow();
+        }
+    }
+    return value;
+}
+
+IndicatorValue RollingIndicator::peek(const IndicatorBar& bar) const {
+    State scratch = state_;
+    return advance(scratch, bar);
+}
+
+IndicatorValue RollingIndicator::advance(State& state, const IndicatorBar& bar) const {
+    IndicatorValue value;
+    value.fill(kNaN);
+    const auto window = static_cast<std::size_t>(period_);
+    const double scale = period_ > 0 ? 1.0 / static_cast<double>(period_) : 0.0;
+    const double close = bar.close;
+
+    switch (spec_.kind) {
+    case IndicatorKind::Ema:
+        value[0] = state.fast.update(close);
+        break;
+
+    case IndicatorKind::Sma: {
+        // The ring is full once count reaches the window; its head is the bar leaving it.
+        const double outgoing = state.count >= window ? window_[windowHead_] : 0.0;
+        state.sum += close - outgoing;
+        ++state.count;
+        if (state.count >= window) {
+            value[0] = state.sum * scale;
+        }
+        break;
+    }
+
+    case IndicatorKind::Bbands: {
+        if (state.count < window) {
+            ++state.count;
+            const double delta = close - state.mean;
+            state.mean += delta / static_cast<double>(state.count);
+            state.m2 += delta * (close - state.mean);
+        }
+        else {
+            const double outgoing = window_[windowHead_];
+            const double previousMean = state.mean;
+            state.mean += (close - outgoing) * scale;
+            state.m2 += (close - outgoing) * (close - state.mean + outgoing - previousMean);
+            ++state.count;
+        }
+        if (state.count >= window) {
+            const double band = spec_.params[1] * std::sqrt(std::max(state.m2, 0.0) * scale);
+            value[0] = state.mean + band;
+            value[1] = state.mean;
+            value[2] = state.mean - band;
+        }
+        break;
+    }
+
+    case IndicatorKind::Rsi: {
+        if (state.count++ == 0) {
+            state.previousClose = close;
+            break;
+        }
+        const double delta = close - state.previousClose;
+        state.previousClose = close;
+        const double gain = std::max(delta, 0.0);
+        const double loss = std::max(-delta, 0.0);
+        const std::size_t changes = state.count - 1U;
+        if (changes < window) {
+            state.averageGain += gain;
+            state.averageLoss += loss;
+        }
+        else if (changes == window) {
+            state.averageGain = (state.averageGain + gain) * scale;
+            state.averageLoss = (state.averageLoss + loss) * scale;
+            value[0] = rsiFromAverages(state.averageGain, state.averageLoss);
+        }
+        else {
+            const double keep = static_cast<double>(period_ - 1);
+            state.averageGain = (state.averageGain * keep + gain) * scale;
+            state.averageLoss = (state.averageLoss * keep + loss) * scale;
+            value[0] = rsiFromAverages(state.averageGain, state.averageLoss);
+        }
+        break;
+    }
+
+    case IndicatorKind::Atr: {
+        double range = bar.high - bar.low;
+        if (state.count > 0) {
+            const double previous = state.previousClose;
+            range = std::max(range, std::max(std::abs(bar.high - previous), std::abs(bar.low - previous)));
+        }
+        state.previousClose = close;
+        ++state.count;
+        if (state.count < window) {
+            state.sum += range;
+        }
+        else if (state.count == window) {
+            // `mean` holds the running ATR once seeded.
+            state.mean = (state.sum + range) * scale;
+            value[0] = state.mean;
+        }
+        else {
+            state.mean = (state.mean * static_cast<double>(period_ - 1) + range) * scale;
+            value[0] = state.mean;
+        }
+        break;
+    }
+
+    case IndicatorKind::Macd: {
+        const double fast = state.fast.update(close);
+        const double slow = state.slow.update(close);
+        if (std::isfinite(fast) && std::isfinite(slow)) {
+            value[0] = fast - slow;
+            value[1] = state.signal.update(value[0]);
+            value[2] = value[0] - value[1];
+        }
+        break;
+    }
+
+    case IndicatorKind::Vwap: {
+        const std::int64_t session = bar.openTime / kVwapSessionMs;
+        if (state.count == 0 || session != state.session) {
+            state.session = session;
+            state.sessionPv = 0.0;
+            state.sessionVolume = 0.0;
+        }
+        ++state.count;
+        state.sessionPv += (bar.high + bar.low + close) * (1.0 / 3.0) * bar.volume;
+        state.sessionVolume += bar.volume;
+        if (state.sessionVolume > 0.0) {
+            value[0] = state.sessionPv / state.sessionVolume;
+        }
+        break;
+    }
+    }
+    return value;
+}
+
+void RollingIndicator::resyncWindow() {
+    // Sliding updates drift by a few ulps per step; re-derive the window
+    // statistics exactly once per lap so the error never accumulates.
+    double sum = 0.0;
+    for (const double close : window_) {
+        sum += close;
+    }
+    state_.sum = sum;
+    state_.mean = sum / static_cast<double>(window_.size());
+    double m2 = 0.0;
+    for (const double close : window_) {
+        const double diff = close - state_.mean;
+        m2 += diff * diff;
+    }
+    state_.m2 = m2;
+}
+
+}  // namespace indicators
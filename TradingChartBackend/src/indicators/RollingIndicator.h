@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "indicators/IndicatorSpec.h"
+
+namespace indicators {
+
+inline constexpr std::size_t kMaxIndicatorOutputs = 3;
+
+struct IndicatorBar {
+    std::int64_t openTime{0};
+    double high{0.0};
+    double low{0.0};
+    double close{0.0};
+    double volume{0.0};
+};
+
+// One value per output of indicatorOutputNames(kind); unused slots and bars
+// without enough history are NaN.
+using IndicatorValue = std::array<double, kMaxIndicatorOutputs>;
+
+// Streaming form of the kernels in IndicatorKernels: EMA value, Wilder
+// averages for RSI/ATR, a ring of the last `period` closes for SMA and
+// Bollinger bands. Each closed bar costs O(1).
+class RollingIndicator {
+public:
+    explicit RollingIndicator(IndicatorSpec spec);
+
+    // Consumes a closed bar and returns its values.
+    IndicatorValue push(const IndicatorBar& bar);
+
+    // Values `bar` would get if it closed now; the state is left untouched.
+    IndicatorValue peek(const IndicatorBar& bar) const;
+
+    const IndicatorSpec& spec() const noexcept { return spec_; }
+
+private:
+    struct Ema {
+        int period{0};
+        std::size_t count{0};
+        double value{0.0};
+
+        double update(double input);
+    };
+
+    // Everything except the ring, so peek() can work on a cheap copy.
+    struct State {
+        std::size_t count{0};
+        double previousClose{0.0};
+        double sum{0.0};
+        double mean{0.0};
+        double m2{0.0};
+        double averageGain{0.0};
+        double averageLoss{0.0};
+        std::int64_t session{0};
+        double sessionPv{0.0};
+        double sessionVolume{0.0};
+        Ema fast;
+        Ema slow;
+        Ema signal;
+    };
+
+    IndicatorValue advance(State& state, const IndicatorBar& bar) const;
+    void resyncWindow();
+
+    IndicatorSpec spec_;
+    int period_{0};
+    State state_;
+    std::vector<double> window_;
+    std::size_t windowHead_{0};
+};
+
+}  // namespace indicators
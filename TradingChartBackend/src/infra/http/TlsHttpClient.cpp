@@ -1,10 +1,17 @@
 #include "infra/http/TlsHttpClient.hpp"
 
+#include <atomic>
 #include <chrono>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ssl/context.hpp>
 #include <boost/asio/ssl/error.hpp>
@@ -14,6 +21,9 @@
 #include <boost/beast/version.hpp>
 
 #include <openssl/err.h>
+#include <openssl/ssl.h>
+
+#include "common/Metrics.hpp"
 
 namespace infra::http {
 namespace {
@@ -23,7 +33,15 @@ namespace http = beast::http;
 namespace net = boost::asio;
 namespace ssl = boost::asio::ssl;
 
+using Clock = std::chrono::steady_clock;
+
 constexpr int kMaxRedirects = 5;
+constexpr std::size_t kMaxIdlePerHost = 8;
+constexpr auto kDnsTtl = std::chrono::seconds(60);
+
+// Process-wide totals behind the rest.connection_reuse_ratio gauge.
+std::atomic<std::uint64_t> gRequests{0};
+std::atomic<std::uint64_t> gReuses{0};
 
 std::runtime_error makeError(const std::string& host, const std::string& target, const std::string& message) {
     std::ostringstream oss;
@@ -82,19 +100,163 @@ ParsedLocation parseRedirectLocation(const std::string& location, const std::str
     return result;
 }
 
-http::response<http::string_body> performRequest(const std::string& host, const std::string& target, int timeoutSec) {
-    if (timeoutSec <= 0) {
-        throw makeError(host, target, "timeout must be positive");
+struct HostPort {
+    std::string name;
+    std::string port;
+};
+
+HostPort splitHostPort(const std::string& host) {
+    const auto colonPos = host.rfind(':');
+    if (colonPos == std::string::npos || colonPos + 1 >= host.size() ||
+        host.find_first_not_of("0123456789", colonPos + 1) != std::string::npos) {
+        return HostPort{host, "443"};
+    }
+    return HostPort{host.substr(0, colonPos), host.substr(colonPos + 1)};
+}
+
+}  // namespace
+
+struct TlsHttpClient::Impl {
+    // beast::tcp_stream only enforces expires_after on asynchronous
+    // operations; a blocking read on a half-open socket would never return.
+    // Each connection therefore runs its steps asynchronously on an
+    // io_context of its own, which the calling thread drives to completion.
+    struct Connection {
+        explicit Connection(ssl::context& ctx) : stream(ioc, ctx) {}
+
+        ~Connection() {
+            // Pooled connections are dropped without a close_notify. OpenSSL
+            // takes that for a broken session and marks it unresumable, and the
+            // host's saved session is that same object.
+            if (served) {
+                SSL_set_shutdown(stream.native_handle(), SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
+            }
+        }
+
+        Connection(const Connection&) = delete;
+        Connection& operator=(const Connection&) = delete;
+
+        net::io_context ioc;
+        ssl::stream<beast::tcp_stream> stream;
+        // Keep-alive responses may leave bytes of the next message behind.
+        beast::flat_buffer buffer;
+        Clock::time_point lastUsed{};
+        bool served = false;
+    };
+
+    struct HostState {
+        std::vector<std::unique_ptr<Connection>> idle;
+        SSL_SESSION* session = nullptr;
+        net::ip::tcp::resolver::results_type endpoints;
+        Clock::time_point endpointsExpire{};
+    };
+
+    explicit Impl(Clock::duration idleTimeoutIn) : sslContext(ssl::context::tls_client), idleTimeout(idleTimeoutIn) {
+        // TODO: Enable certificate verification once a CA bundle is bundled with the project.
+        sslContext.set_verify_mode(ssl::verify_none);
+        SSL_CTX_set_session_cache_mode(sslContext.native_handle(), SSL_SESS_CACHE_CLIENT);
+    }
+
+    ~Impl() {
+        for (auto& entry : hosts) {
+            if (entry.second.session != nullptr) {
+                SSL_SESSION_free(entry.second.session);
+            }
+        }
+    }
+
+    // allowReuse=false always connects, e.g. after a pooled connection failed.
+    std::unique_ptr<Connection> acquire(const std::string& host,
+                                        const std::string& target,
+                                        int timeoutSec,
+                                        bool allowReuse,
+                                        bool& reused);
+    void release(const std::string& host, std::unique_ptr<Connection> connection);
+    // A server that closed one idle connection has most likely closed them all.
+    void dropIdle(const std::string& host);
+    net::ip::tcp::resolver::results_type resolve(const std::string& host, const std::string& target);
+    void rememberSession(const std::string& host, Connection& connection);
+    http::response<http::string_body> perform(const std::string& host, const std::string& target, int timeoutSec);
+    static void recordRequest(bool reused);
+
+    // Starts one asynchronous step and runs it to completion or timeout.
+    template <typename Start>
+    static beast::error_code runStep(Connection& connection, int timeoutSec, Start&& start) {
+        beast::error_code result = net::error::would_block;
+        beast::get_lowest_layer(connection.stream).expires_after(std::chrono::seconds(timeoutSec));
+        start([&result](beast::error_code ec, auto&&...) { result = ec; });
+        connection.ioc.restart();
+        connection.ioc.run();
+        return result;
     }
 
     net::io_context ioc;
-    ssl::context sslContext(ssl::context::tls_client);
-    // TODO: Enable certificate verification once a CA bundle is bundled with the project.
-    sslContext.set_verify_mode(ssl::verify_none);
+    ssl::context sslContext;
+    const Clock::duration idleTimeout;
+    std::mutex mutex;
+    std::unordered_map<std::string, HostState> hosts;
+};
 
-    ssl::stream<beast::tcp_stream> stream(ioc, sslContext);
+net::ip::tcp::resolver::results_type TlsHttpClient::Impl::resolve(const std::string& host, const std::string& target) {
+    const auto now = Clock::now();
+    {
+        std::scoped_lock lock(mutex);
+        auto& state = hosts[host];
+        if (!state.endpoints.empty() && now < state.endpointsExpire) {
+            return state.endpoints;
+        }
+    }
 
-    if (!SSL_set_tlsext_host_name(stream.native_handle(), host.c_str())) {
+    const auto endpoint = splitHostPort(host);
+    net::ip::tcp::resolver resolver(ioc);
+    beast::error_code ec;
+    auto results = resolver.resolve(endpoint.name, endpoint.port, ec);
+    if (ec) {
+        throw makeError(host, target, "DNS resolution error: " + ec.message());
+    }
+
+    std::scoped_lock lock(mutex);
+    auto& state = hosts[host];
+    state.endpoints = results;
+    state.endpointsExpire = now + kDnsTtl;
+    return results;
+}
+
+std::unique_ptr<TlsHttpClient::Impl::Connection>
+TlsHttpClient::Impl::acquire(const std::string& host,
+                             const std::string& target,
+                             int timeoutSec,
+                             bool allowReuse,
+                             bool& reused) {
+    SSL_SESSION* session = nullptr;
+    {
+        std::scoped_lock lock(mutex);
+        auto& state = hosts[host];
+        const auto now = Clock::now();
+        while (allowReuse && !state.idle.empty()) {
+            auto connection = std::move(state.idle.back());
+            state.idle.pop_back();
+            if (now - connection->lastUsed < idleTimeout) {
+                reused = true;
+                return connection;
+            }
+        }
+        if (state.session != nullptr) {
+            SSL_SESSION_up_ref(state.session);
+            session = state.session;
+        }
+    }
+
+    reused = false;
+    const auto results = resolve(host, target);
+    auto connection = std::make_unique<Connection>(sslContext);
+    auto& stream = connection->stream;
+    const auto endpoint = splitHostPort(host);
+
+    if (!SSL_set_tlsext_host_name(stream.native_handle(), endpoint.name.c_str())) {
+        if (session != nullptr) {
+            SSL_SESSION_free(session);
+        }
         const unsigned long err = ::ERR_get_error();
         const char* reason = err != 0 ? ::ERR_reason_error_string(err) : nullptr;
         std::ostringstream oss;
@@ -104,64 +266,145 @@ http::response<http::string_body> performRequest(const std::string& host, const
         }
         throw makeError(host, target, oss.str());
     }
-
-    auto resolver = net::ip::tcp::resolver(ioc);
-    beast::error_code ec;
-    auto const results = resolver.resolve(host, "443", ec);
-    if (ec) {
-        throw makeError(host, target, "DNS resolution error: " + ec.message());
+    if (session != nullptr) {
+        SSL_set_session(stream.native_handle(), session);
+        SSL_SESSION_free(session);
     }
 
-    auto& lowestLayer = beast::get_lowest_layer(stream);
-    lowestLayer.expires_after(std::chrono::seconds(timeoutSec));
-    lowestLayer.connect(results, ec);
+    auto ec = runStep(*connection, timeoutSec, [&](auto handler) {
+        beast::get_lowest_layer(stream).async_connect(results, std::move(handler));
+    });
     if (ec) {
         throw makeError(host, target, "Connection error: " + ec.message());
     }
 
-    lowestLayer.expires_after(std::chrono::seconds(timeoutSec));
-    stream.handshake(ssl::stream_base::client, ec);
+    ec = runStep(*connection, timeoutSec, [&](auto handler) {
+        stream.async_handshake(ssl::stream_base::client, std::move(handler));
+    });
     if (ec) {
         throw makeError(host, target, "TLS handshake error: " + ec.message());
     }
 
-    http::request<http::empty_body> req{http::verb::get, target, 11};
-    req.set(http::field::host, host);
-    req.set(http::field::user_agent, "TTP/0.1 (+https://local)");
-    req.set(http::field::accept, "application/json");
-    req.set(http::field::connection, "close");
+    auto& registry = ttp::common::metrics::Registry::instance();
+    registry.incrementCounter("rest.tls_handshakes");
+    if (SSL_session_reused(stream.native_handle()) != 0) {
+        registry.incrementCounter("rest.tls_sessions_resumed");
+    }
+    return connection;
+}
 
-    http::write(stream, req, ec);
-    if (ec) {
-        throw makeError(host, target, "Write error: " + ec.message());
+void TlsHttpClient::Impl::rememberSession(const std::string& host, Connection& connection) {
+    // TLS 1.3 tickets arrive after the handshake, so grab the session once a
+    // response has been read.
+    SSL_SESSION* session = SSL_get1_session(connection.stream.native_handle());
+    if (session == nullptr) {
+        return;
+    }
+    std::scoped_lock lock(mutex);
+    auto& state = hosts[host];
+    if (state.session != nullptr) {
+        SSL_SESSION_free(state.session);
     }
+    state.session = session;
+}
 
-    beast::flat_buffer buffer;
-    http::response<http::string_body> response;
-    lowestLayer.expires_after(std::chrono::seconds(timeoutSec));
-    http::read(stream, buffer, response, ec);
-    if (ec) {
-        throw makeError(host, target, "Read error: " + ec.message());
+void TlsHttpClient::Impl::release(const std::string& host, std::unique_ptr<Connection> connection) {
+    connection->lastUsed = Clock::now();
+    std::scoped_lock lock(mutex);
+    auto& idle = hosts[host].idle;
+    if (idle.size() < kMaxIdlePerHost) {
+        idle.push_back(std::move(connection));
     }
+}
 
-    stream.shutdown(ec);
-    if (ec == net::error::eof) {
-        ec = {};
+void TlsHttpClient::Impl::dropIdle(const std::string& host) {
+    std::vector<std::unique_ptr<Connection>> stale;
+    {
+        std::scoped_lock lock(mutex);
+        stale.swap(hosts[host].idle);
     }
-    if (ec == ssl::error::stream_truncated) {
-        // Allow truncated TLS shutdown which may occur with some servers.
-        ec = {};
+}
+
+void TlsHttpClient::Impl::recordRequest(bool reused) {
+    const auto total = gRequests.fetch_add(1) + 1;
+    const auto reusedTotal = reused ? gReuses.fetch_add(1) + 1 : gReuses.load();
+    auto& registry = ttp::common::metrics::Registry::instance();
+    registry.incrementCounter("rest.requests");
+    if (reused) {
+        registry.incrementCounter("rest.connections_reused");
     }
-    if (ec) {
-        throw makeError(host, target, "TLS shutdown error: " + ec.message());
+    registry.setGauge("rest.connection_reuse_ratio", static_cast<double>(reusedTotal) / static_cast<double>(total));
+}
+
+http::response<http::string_body> TlsHttpClient::Impl::perform(const std::string& host,
+                                                               const std::string& target,
+                                                               int timeoutSec) {
+    if (timeoutSec <= 0) {
+        throw makeError(host, target, "timeout must be positive");
     }
 
-    return response;
+    http::request<http::empty_body> req{http::verb::get, target, 11};
+    req.set(http::field::host, host);
+    req.set(http::field::user_agent, "TTP/0.1 (+https://local)");
+    req.set(http::field::accept, "application/json");
+    req.keep_alive(true);
+
+    // A pooled connection may have been closed by the server while idle;
+    // that surfaces on write/read, so retry once on a fresh connection.
+    for (int attempt = 0;; ++attempt) {
+        bool reused = false;
+        auto connection = acquire(host, target, timeoutSec, attempt == 0, reused);
+        auto& stream = connection->stream;
+
+        auto ec = runStep(*connection, timeoutSec, [&](auto handler) {
+            http::async_write(stream, req, std::move(handler));
+        });
+        if (ec) {
+            if (reused && attempt == 0) {
+                dropIdle(host);
+                continue;
+            }
+            throw makeError(host, target, "Write error: " + ec.message());
+        }
+
+        http::response<http::string_body> response;
+        ec = runStep(*connection, timeoutSec, [&](auto handler) {
+            http::async_read(stream, connection->buffer, response, std::move(handler));
+        });
+        if (ec) {
+            if (reused && attempt == 0) {
+                dropIdle(host);
+                continue;
+            }
+            throw makeError(host, target, "Read error: " + ec.message());
+        }
+
+        connection->served = true;
+        recordRequest(reused);
+        if (!reused) {
+            rememberSession(host, *connection);
+        }
+        if (response.keep_alive()) {
+            release(host, std::move(connection));
+        }
+        else {
+            runStep(*connection, timeoutSec, [&](auto handler) { stream.async_shutdown(std::move(handler)); });
+        }
+        return response;
+    }
 }
 
-}  // namespace
+TlsHttpClient::TlsHttpClient(std::chrono::steady_clock::duration idleTimeout)
+    : impl_(std::make_unique<Impl>(idleTimeout)) {}
 
-JsonResponse https_get_json_response(const std::string& host, const std::string& target, int timeout_sec) {
+TlsHttpClient::~TlsHttpClient() = default;
+
+TlsHttpClient& TlsHttpClient::shared() {
+    static TlsHttpClient client;
+    return client;
+}
+
+JsonResponse TlsHttpClient::get_json(const std::string& host, const std::string& target, int timeout_sec) {
     if (host.empty()) {
         throw std::runtime_error("HTTPS GET requires a non-empty host");
     }
@@ -175,7 +418,7 @@ JsonResponse https_get_json_response(const std::string& host, const std::string&
     std::string currentTarget = normalizedTarget;
 
     for (int redirectCount = 0; redirectCount <= kMaxRedirects; ++redirectCount) {
-        auto response = performRequest(currentHost, currentTarget, timeout_sec);
+        auto response = impl_->perform(currentHost, currentTarget, timeout_sec);
         const auto status = static_cast<unsigned>(response.result_int());
         if (status == 301U || status == 302U) {
             try {
@@ -197,12 +440,19 @@ JsonResponse https_get_json_response(const std::string& host, const std::string&
         if (auto it = response.base().find("X-MBX-USED-WEIGHT"); it != response.base().end()) {
             result.used_weight_header = std::string{it->value()};
         }
+        if (auto it = response.base().find(http::field::retry_after); it != response.base().end()) {
+            result.retry_after_header = std::string{it->value()};
+        }
         return result;
     }
 
     throw makeError(currentHost, currentTarget, "Too many redirects");
 }
 
+JsonResponse https_get_json_response(const std::string& host, const std::string& target, int timeout_sec) {
+    return TlsHttpClient::shared().get_json(host, target, timeout_sec);
+}
+
 std::string https_get_json(const std::string& host, const std::string& target, int timeout_sec) {
     const auto response = https_get_json_response(host, target, timeout_sec);
     if (response.status >= 400U) {
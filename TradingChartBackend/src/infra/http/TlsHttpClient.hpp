@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+#include <memory>
 #include <string>
 
 namespace infra::http {
@@ -8,10 +10,40 @@ struct JsonResponse {
     unsigned status = 0U;
     std::string body;
     std::string used_weight_header;
+    std::string retry_after_header;
     std::string final_host;
     std::string final_target;
 };
 
+// HTTPS GET client that keeps TLS connections alive per host, resumes TLS
+// sessions and caches DNS results, so back-to-back requests to one host skip
+// connect + handshake. Every network step is bounded by the request timeout.
+// Thread-safe; callers normally use shared().
+class TlsHttpClient {
+public:
+    // Servers drop idle keep-alive connections; pooled ones older than this
+    // are not handed out.
+    static constexpr std::chrono::seconds kDefaultIdleTimeout{30};
+
+    explicit TlsHttpClient(std::chrono::steady_clock::duration idleTimeout = kDefaultIdleTimeout);
+    ~TlsHttpClient();
+
+    TlsHttpClient(const TlsHttpClient&) = delete;
+    TlsHttpClient& operator=(const TlsHttpClient&) = delete;
+
+    // `host` may carry an explicit port ("127.0.0.1:8443"); 443 otherwise.
+    // Follows up to 5 redirects. Throws std::runtime_error on network errors.
+    JsonResponse get_json(const std::string& host, const std::string& target, int timeout_sec = 20);
+
+    // Process-wide pool used by the free functions below.
+    static TlsHttpClient& shared();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// Same as TlsHttpClient::shared().get_json().
 JsonResponse https_get_json_response(const std::string& host, const std::string& target, int timeout_sec = 20);
 
 // Performs an HTTPS GET request expecting a JSON payload.
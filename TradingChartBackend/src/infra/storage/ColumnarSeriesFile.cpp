@@ -0,0 +1,268 @@
+#include "infra/storage/ColumnarSeriesFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#include "logging/Log.h"
+
+namespace infra::storage {
+namespace {
+
+constexpr logging::LogCategory kLogCategory = logging::LogCategory::DATA;
+constexpr char kMagic[8] = {'T', 'T', 'P', 'C', 'O', 'L', '1', '\0'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kInitialCapacity = 4096;
+constexpr std::size_t kSlotBytes = sizeof(std::int64_t);
+
+static_assert(sizeof(double) == kSlotBytes, "columns assume 8-byte slots");
+
+std::size_t fileBytesFor(std::size_t capacity) {
+    return sizeof(ColumnarHeader) + capacity * kSlotBytes * ColumnarSeriesFile::ColumnCount;
+}
+
+}  // namespace
+
+ColumnarSeriesFile::~ColumnarSeriesFile() {
+    close();
+}
+
+bool ColumnarSeriesFile::open(const std::string& path, bool create, std::int64_t intervalMs) {
+    close();
+
+    const int flags = O_RDWR | O_CLOEXEC | (create ? O_CREAT : 0);
+    const int fd = ::open(path.c_str(), flags, 0644);
+    if (fd < 0) {
+        if (errno != ENOENT || create) {
+            LOG_WARN(kLogCategory, "ColumnarSeriesFile open failed path=%s error=%s", path.c_str(), std::strerror(errno));
+        }
+        return false;
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        LOG_WARN(kLogCategory, "ColumnarSeriesFile stat failed path=%s error=%s", path.c_str(), std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    auto fileBytes = static_cast<std::size_t>(st.st_size);
+    if (fileBytes == 0) {
+        if (!create) {
+            ::close(fd);
+            return false;
+        }
+        fileBytes = fileBytesFor(kInitialCapacity);
+        if (::ftruncate(fd, static_cast<off_t>(fileBytes)) != 0) {
+            LOG_WARN(kLogCategory,
+                     "ColumnarSeriesFile ftruncate failed path=%s error=%s",
+                     path.c_str(),
+                     std::strerror(errno));
+            ::close(fd);
+            return false;
+        }
+        if (!map_(fd, fileBytes)) {
+            ::close(fd);
+            return false;
+        }
+        auto* header = header_();
+        std::memcpy(header->magic, kMagic, sizeof(kMagic));
+        header->version = kVersion;
+        header->columnCount = ColumnCount;
+        header->capacity = kInitialCapacity;
+        header->count = 0;
+        header->intervalMs = intervalMs;
+    }
+    else if (fileBytes < sizeof(ColumnarHeader) || !map_(fd, fileBytes)) {
+        LOG_WARN(kLogCategory, "ColumnarSeriesFile invalid file path=%s bytes=%zu", path.c_str(), fileBytes);
+        ::close(fd);
+        return false;
+    }
+    ::close(fd);
+
+    const auto* header = header_();
+    if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion ||
+        header->columnCount != ColumnCount || header->count > header->capacity ||
+        fileBytesFor(static_cast<std::size_t>(header->capacity)) > mappedBytes_) {
+        LOG_WARN(kLogCategory, "ColumnarSeriesFile corrupt header path=%s", path.c_str());
+        close();
+        return false;
+    }
+
+    path_ = path;
+    return true;
+}
+
+void ColumnarSeriesFile::close() {
+    if (base_ != nullptr) {
+        ::munmap(base_, mappedBytes_);
+    }
+    base_ = nullptr;
+    mappedBytes_ = 0;
+}
+
+std::size_t ColumnarSeriesFile::size() const noexcept {
+    return isOpen() ? static_cast<std::size_t>(header_()->count) : 0;
+}
+
+std::int64_t ColumnarSeriesFile::intervalMs() const noexcept {
+    return isOpen() ? header_()->intervalMs : 0;
+}
+
+const std::int64_t* ColumnarSeriesFile::ts() const noexcept {
+    return reinterpret_cast<const std::int64_t*>(columnBase_(Ts));
+}
+
+const double* ColumnarSeriesFile::column(Column column) const noexcept {
+    return reinterpret_cast<const double*>(columnBase_(column));
+}
+
+std::size_t ColumnarSeriesFile::lowerBound(std::int64_t value) const noexcept {
+    const auto* begin = ts();
+    const auto* end = begin + size();
+    return static_cast<std::size_t>(std::lower_bound(begin, end, value) - begin);
+}
+
+std::size_t ColumnarSeriesFile::upperBound(std::int64_t value) const noexcept {
+    const auto* begin = ts();
+    const auto* end = begin + size();
+    return static_cast<std::size_t>(std::upper_bound(begin, end, value) - begin);
+}
+
+std::size_t ColumnarSeriesFile::append(const ColumnarRow* rows, std::size_t count) {
+    if (!isOpen() || rows == nullptr || count == 0) {
+        return 0;
+    }
+
+    // First pass: how many rows extend the series past its current tail.
+    const std::size_t existing = size();
+    std::int64_t lastTs = existing > 0 ? ts()[existing - 1] : std::numeric_limits<std::int64_t>::min();
+    std::size_t newRows = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (rows[i].ts > lastTs) {
+            lastTs = rows[i].ts;
+            ++newRows;
+        }
+    }
+
+    if (existing + newRows > static_cast<std::size_t>(header_()->capacity) && !grow_(existing + newRows)) {
+        return 0;
+    }
+
+    auto* tsColumn = reinterpret_cast<std::int64_t*>(columnBase_(Ts));
+    auto* openColumn = reinterpret_cast<double*>(columnBase_(Open));
+    auto* highColumn = reinterpret_cast<double*>(columnBase_(High));
+    auto* lowColumn = reinterpret_cast<double*>(columnBase_(Low));
+    auto* closeColumn = reinterpret_cast<double*>(columnBase_(Close));
+    auto* volumeColumn = reinterpret_cast<double*>(columnBase_(Volume));
+
+    const auto writeAt = [&](std::size_t index, const ColumnarRow& row) {
+        tsColumn[index] = row.ts;
+        openColumn[index] = row.open;
+        highColumn[index] = row.high;
+        lowColumn[index] = row.low;
+        closeColumn[index] = row.close;
+        volumeColumn[index] = row.volume;
+    };
+
+    std::size_t tail = existing;
+    std::size_t written = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto& row = rows[i];
+        if (tail == 0 || row.ts > tsColumn[tail - 1]) {
+            writeAt(tail, row);
+            ++tail;
+            ++written;
+            continue;
+        }
+        const auto* slot = std::lower_bound(tsColumn, tsColumn + tail, row.ts);
+        if (*slot == row.ts) {
+            writeAt(static_cast<std::size_t>(slot - tsColumn), row);
+            ++written;
+        }
+    }
+
+    // Publish the new rows only after their column slots are written.
+    header_()->count = tail;
+    return written;
+}
+
+bool ColumnarSeriesFile::map_(int fd, std::size_t bytes) {
+    void* mapped = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        LOG_WARN(kLogCategory, "ColumnarSeriesFile mmap failed bytes=%zu error=%s", bytes, std::strerror(errno));
+        return false;
+    }
+    base_ = mapped;
+    mappedBytes_ = bytes;
+    return true;
+}
+
+bool ColumnarSeriesFile::grow_(std::size_t minCapacity) {
+    const auto* header = header_();
+    std::size_t capacity = std::max<std::size_t>(static_cast<std::size_t>(header->capacity), kInitialCapacity);
+    while (capacity < minCapacity) {
+        capacity *= 2;
+    }
+
+    const std::string growPath = path_ + ".grow";
+    const int fd = ::open(growPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        LOG_WARN(kLogCategory, "ColumnarSeriesFile grow open failed path=%s error=%s", growPath.c_str(), std::strerror(errno));
+        return false;
+    }
+
+    const auto bytes = fileBytesFor(capacity);
+    void* mapped = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) == 0) {
+        mapped = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        LOG_WARN(kLogCategory, "ColumnarSeriesFile grow map failed path=%s error=%s", growPath.c_str(), std::strerror(errno));
+        ::unlink(growPath.c_str());
+        return false;
+    }
+
+    auto* target = static_cast<char*>(mapped);
+    const auto count = static_cast<std::size_t>(header->count);
+    ColumnarHeader grown = *header;
+    grown.capacity = capacity;
+    std::memcpy(target, &grown, sizeof(grown));
+    for (std::size_t column = 0; column < ColumnCount; ++column) {
+        std::memcpy(target + sizeof(ColumnarHeader) + column * capacity * kSlotBytes,
+                    columnBase_(column),
+                    count * kSlotBytes);
+    }
+    ::munmap(mapped, bytes);
+
+    if (std::rename(growPath.c_str(), path_.c_str()) != 0) {
+        LOG_WARN(kLogCategory, "ColumnarSeriesFile grow rename failed path=%s error=%s", path_.c_str(), std::strerror(errno));
+        ::unlink(growPath.c_str());
+        return false;
+    }
+
+    const std::string path = path_;
+    return open(path, false);
+}
+
+ColumnarHeader* ColumnarSeriesFile::header_() const noexcept {
+    return static_cast<ColumnarHeader*>(base_);
+}
+
+char* ColumnarSeriesFile::columnBase_(std::size_t column) const noexcept {
+    if (base_ == nullptr) {
+        return nullptr;
+    }
+    const auto capacity = static_cast<std::size_t>(header_()->capacity);
+    return static_cast<char*>(base_) + sizeof(ColumnarHeader) + column * capacity * kSlotBytes;
+}
+
+}  // namespace infra::storage
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace infra::storage {
+
+// On-disk layout of a columnar series file:
+//   [ColumnarHeader (64 bytes)]
+//   [ts     : int64  x capacity]
+//   [open   : double x capacity]
+//   [high   : double x capacity]
+//   [low    : double x capacity]
+//   [close  : double x capacity]
+//   [volume : double x capacity]
+// Only the first `count` slots of each column hold data. Growth rewrites the
+// file with a larger capacity and swaps it in with rename().
+struct ColumnarHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t columnCount;
+    std::uint64_t capacity;
+    std::uint64_t count;
+    std::int64_t intervalMs;
+    char reserved[24];
+};
+
+static_assert(sizeof(ColumnarHeader) == 64, "ColumnarHeader must stay 64 bytes");
+
+struct ColumnarRow {
+    std::int64_t ts{0};
+    double open{0.0};
+    double high{0.0};
+    double low{0.0};
+    double close{0.0};
+    double volume{0.0};
+};
+
+// One mmap'd series (symbol + interval). Not thread-safe; callers serialize
+// appends against reads.
+class ColumnarSeriesFile {
+public:
+    enum Column : std::size_t { Ts = 0, Open, High, Low, Close, Volume, ColumnCount };
+
+    ColumnarSeriesFile() = default;
+    ~ColumnarSeriesFile();
+
+    ColumnarSeriesFile(const ColumnarSeriesFile&) = delete;
+    ColumnarSeriesFile& operator=(const ColumnarSeriesFile&) = delete;
+
+    // Maps an existing file read/write; with create=true an empty file is
+    // initialized when missing.
+    bool open(const std::string& path, bool create, std::int64_t intervalMs = 0);
+    void close();
+
+    bool isOpen() const noexcept { return base_ != nullptr; }
+    const std::string& path() const noexcept { return path_; }
+
+    std::size_t size() const noexcept;
+    std::int64_t intervalMs() const noexcept;
+
+    const std::int64_t* ts() const noexcept;
+    const double* column(Column column) const noexcept;
+
+    // Index of the first row with ts >= value (binary search on the ts column).
+    std::size_t lowerBound(std::int64_t value) const noexcept;
+    // Index of the first row with ts > value.
+    std::size_t upperBound(std::int64_t value) const noexcept;
+
+    // Appends rows sorted by ts. A row whose ts is already stored replaces
+    // that slot in place; an older row with no stored slot is skipped, since
+    // inserting it would shift every column. Returns the number of rows
+    // written, so count minus the result is the number skipped.
+    std::size_t append(const ColumnarRow* rows, std::size_t count);
+
+private:
+    bool map_(int fd, std::size_t bytes);
+    bool grow_(std::size_t minCapacity);
+    ColumnarHeader* header_() const noexcept;
+    char* columnBase_(std::size_t column) const noexcept;
+
+    std::string path_;
+    void* base_{nullptr};
+    std::size_t mappedBytes_{0};
+};
+
+}  // namespace infra::storage
@@ -1,11 +1,16 @@
 #include "infra/storage/PriceDataTimeSeriesRepository.h"
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <cerrno>
 #include <chrono>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <filesystem>
-#include <fstream>
 #include <string_view>
 #include <utility>
 
@@ -19,6 +24,11 @@ namespace infra::storage {
 namespace {
 
 constexpr logging::LogCategory kLogCategory = logging::LogCategory::DB;
+constexpr std::size_t kRecordSize = sizeof(PriceData);
+constexpr std::size_t kIoChunkRecords = 1024;
+// Compaction waits until superseded log records reach this many and a quarter
+// of the live candles, unless forced.
+constexpr std::size_t kCompactionMinStale = 256;
 
 struct PreparedBatch {
     std::vector<domain::Candle> candles;
@@ -104,6 +114,21 @@ PriceData makeRecord(const domain::Candle& candle,
     return record;
 }
 
+bool writeFully(int fd, const char* data, std::size_t bytes, off_t offset) {
+    std::size_t done = 0;
+    while (done < bytes) {
+        const auto written = ::pwrite(fd, data + done, bytes - done, offset + static_cast<off_t>(done));
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        done += static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
 bool matchesDataset(const PriceData& record,
                     const std::string& symbol,
                     const std::string& intervalLabel) {
@@ -138,6 +163,11 @@ PriceDataTimeSeriesRepository::PriceDataTimeSeriesRepository() {
     }
 }
 
+PriceDataTimeSeriesRepository::~PriceDataTimeSeriesRepository() {
+    std::scoped_lock lock(mtx_);
+    closeLogUnsafe_();
+}
+
 std::string PriceDataTimeSeriesRepository::intervalToString(domain::Interval interval) {
     const auto label = domain::interval_label(interval);
     if (!label.empty()) {
@@ -172,6 +202,7 @@ void PriceDataTimeSeriesRepository::bind(const std::string& symbol,
         return;
     }
 
+    closeLogUnsafe_();
     symbol_ = symbol;
     interval_ = interval;
     filePath_ = targetPath;
@@ -189,7 +220,6 @@ void PriceDataTimeSeriesRepository::bind(const std::string& symbol,
         }
     }
 
-    openIndex_.clear();
     candles_.clear();
     meta_ = {};
     hasGap_ = false;
@@ -299,8 +329,6 @@ domain::AppendResult PriceDataTimeSeriesRepository::appendBatch(const std::vecto
         const auto intervalMs = intervalMsSnapshot;
         domain::TimestampMs lastKnownMaxOpen = candles_.empty() ? 0 : meta_.maxOpen;
         bool derivedDirty = false;
-        bool needRewriteAll = false;
-        bool needsMarkDirty = false;
         std::uint64_t slowPathInserts = 0;
 
         if (!candles_.empty() && intervalMs > 0) {
@@ -338,7 +366,6 @@ domain::AppendResult PriceDataTimeSeriesRepository::appendBatch(const std::vecto
             bool touchedDisk = false;
             bool anyLive = false;
             for (const auto& candle : prepared.candles) {
-                openIndex_.insert(candle.openTime);
                 if (candle.isClosed) {
                     lastClosedOpen_ = candle.openTime;
                 }
@@ -376,16 +403,12 @@ domain::AppendResult PriceDataTimeSeriesRepository::appendBatch(const std::vecto
                 break;
             }
 
-            auto it = std::lower_bound(candles_.begin(), candles_.end(), normalizedOpen,
-                                       [](const domain::Candle& lhs, domain::TimestampMs value) {
-                                           return lhs.openTime < value;
-                                       });
+            auto it = findOpenUnsafe_(normalizedOpen);
 
             if (it != candles_.end() && it->openTime == normalizedOpen) {
-                metrics::repoFastPathIncr("repo.rewriteAll.calls");
                 *it = preparedCandle;
                 derivedDirty = true;
-                needsMarkDirty = true;
+                summary.touchedDisk = logRecordUnsafe_(preparedCandle) || summary.touchedDisk;
                 lastKnownMaxOpen = std::max(lastKnownMaxOpen, normalizedOpen);
                 summary.appended += 1;
                 summary.liveOnly = summary.liveOnly || !preparedCandle.isClosed;
@@ -401,15 +424,10 @@ domain::AppendResult PriceDataTimeSeriesRepository::appendBatch(const std::vecto
             summary.liveOnly = summary.liveOnly || !preparedCandle.isClosed;
             summary.state = domain::RangeState::Ok;
 
-            if (insertAtEnd) {
-                appendRecordUnsafe_(preparedCandle);
-                summary.touchedDisk = summary.touchedDisk || (!noDisk_);
-            }
-            else {
-                needRewriteAll = true;
-                metrics::repoFastPathIncr("repo.rewriteAll.calls");
+            if (!insertAtEnd) {
                 ++slowPathInserts;
             }
+            summary.touchedDisk = appendRecordUnsafe_(preparedCandle) || summary.touchedDisk;
         }
 
         if (derivedDirty) {
@@ -417,13 +435,8 @@ domain::AppendResult PriceDataTimeSeriesRepository::appendBatch(const std::vecto
             updateDerivedStateUnsafe_();
         }
 
-        if (needRewriteAll) {
+        if (slowPathInserts > 0) {
             metrics::repoFastPathIncr("repo.slow_path.inserts", slowPathInserts);
-            rewriteAllUnsafe_();
-            summary.touchedDisk = summary.touchedDisk || (!noDisk_);
-        }
-        else if (needsMarkDirty) {
-            markDirtyUnsafe_();
         }
 
         const bool gapClosed = hadGapBefore && !hasGap_;
@@ -482,32 +495,124 @@ void PriceDataTimeSeriesRepository::loadOrInitFileUnsafe_() {
         return;
     }
 
-    if (!fs::exists(filePath_)) {
-        std::ofstream ofs(filePath_, std::ios::binary | std::ios::trunc);
-        if (!ofs.good()) {
-            LOG_ERROR(kLogCategory, "DB: failed to create %s", filePath_.c_str());
-            return;
-        }
+    if (!openLogUnsafe_()) {
+        LOG_ERROR(kLogCategory, "DB: failed to create %s", filePath_.c_str());
+        return;
     }
 
     rebuildCacheFromDiskUnsafe_();
 }
 
+bool PriceDataTimeSeriesRepository::openLogUnsafe_() {
+    if (fd_ >= 0) {
+        return true;
+    }
+    if (filePath_.empty()) {
+        return false;
+    }
+
+    // No O_APPEND: pwrite must be able to rewrite the tail record in place.
+    const int fd = ::open(filePath_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    fd_ = fd;
+    diskRecords_ = static_cast<std::size_t>(st.st_size) / kRecordSize;
+    return true;
+}
+
+void PriceDataTimeSeriesRepository::closeLogUnsafe_() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    fd_ = -1;
+    diskRecords_ = 0;
+    staleRecords_ = 0;
+    diskTailOpen_ = 0;
+}
+
+bool PriceDataTimeSeriesRepository::writeRecordAtUnsafe_(std::size_t index, const domain::Candle& candle) {
+    if (noDisk_ || filePath_.empty()) {
+        return false;
+    }
+    if (fd_ < 0) {
+        // Closed after a failed write; the log is rebuilt by the next compaction.
+        markDirtyUnsafe_();
+        return false;
+    }
+
+    const auto record = makeRecord(candle, symbol_, intervalToString(interval_), interval_.ms);
+    if (!writeFully(fd_,
+                    reinterpret_cast<const char*>(&record),
+                    sizeof(record),
+                    static_cast<off_t>(index * kRecordSize))) {
+        LOG_ERROR(kLogCategory,
+                  "DB: failed to write record %zu to %s (%s)",
+                  index,
+                  filePath_.c_str(),
+                  std::strerror(errno));
+        closeLogUnsafe_();
+        markDirtyUnsafe_();
+        return false;
+    }
+    return true;
+}
+
+bool PriceDataTimeSeriesRepository::logRecordUnsafe_(const domain::Candle& candle) {
+    if (diskRecords_ > 0 && candle.openTime == diskTailOpen_) {
+        metrics::RepoFastPathTimer diagTimer{"repo.tailRewrite"};
+        return writeRecordAtUnsafe_(diskRecords_ - 1, candle);
+    }
+    if (!appendRecordUnsafe_(candle)) {
+        return false;
+    }
+    // The record this one supersedes stays in the log as dead weight until
+    // compaction.
+    ++staleRecords_;
+    markDirtyUnsafe_();
+    return true;
+}
+
+std::vector<domain::Candle>::iterator
+PriceDataTimeSeriesRepository::findOpenUnsafe_(domain::TimestampMs openTime) {
+    // Candles are sorted and interval-aligned, so without gaps the slot is
+    // (openTime - first) / interval; fall back to a binary search otherwise.
+    const auto intervalMs = interval_.ms;
+    if (!candles_.empty() && intervalMs > 0 && openTime >= candles_.front().openTime) {
+        const auto slot = static_cast<std::size_t>((openTime - candles_.front().openTime) / intervalMs);
+        if (slot >= candles_.size() && openTime > candles_.back().openTime) {
+            return candles_.end();
+        }
+        if (slot < candles_.size() && candles_[slot].openTime == openTime) {
+            return candles_.begin() + static_cast<std::vector<domain::Candle>::difference_type>(slot);
+        }
+    }
+    return std::lower_bound(candles_.begin(), candles_.end(), openTime,
+                            [](const domain::Candle& lhs, domain::TimestampMs value) {
+                                return lhs.openTime < value;
+                            });
+}
+
 void PriceDataTimeSeriesRepository::rebuildCacheFromDiskUnsafe_() {
     candles_.clear();
-    openIndex_.clear();
     meta_ = {};
     hasGap_ = false;
     lastClosedOpen_ = 0;
     dirty_ = false;
     dirtySince_ = {};
+    staleRecords_ = 0;
+    diskTailOpen_ = 0;
 
     if (filePath_.empty()) {
         return;
     }
 
-    std::ifstream ifs(filePath_, std::ios::binary);
-    if (!ifs.good()) {
+    if (!openLogUnsafe_()) {
         LOG_WARN(kLogCategory,
                  "DB: failed to open %s for reading; assuming empty",
                  filePath_.c_str());
@@ -515,15 +620,58 @@ void PriceDataTimeSeriesRepository::rebuildCacheFromDiskUnsafe_() {
     }
 
     const auto intervalLabel = intervalToString(interval_);
-    PriceData record{};
-    while (ifs.read(reinterpret_cast<char*>(&record), sizeof(record))) {
-        if (record.openTime <= 0) {
+    std::vector<PriceData> records(kIoChunkRecords);
+    std::size_t index = 0;
+    while (index < diskRecords_) {
+        const auto wanted = std::min(kIoChunkRecords, diskRecords_ - index);
+        const auto got = ::pread(fd_,
+                                 records.data(),
+                                 wanted * kRecordSize,
+                                 static_cast<off_t>(index * kRecordSize));
+        if (got < 0 && errno == EINTR) {
             continue;
         }
-        if (!matchesDataset(record, symbol_, intervalLabel)) {
-            continue;
+        const auto read = got > 0 ? static_cast<std::size_t>(got) / kRecordSize : 0;
+        if (read == 0) {
+            break;
         }
-        candles_.push_back(recordToCandle(record));
+        for (std::size_t i = 0; i < read; ++i) {
+            const auto& record = records[i];
+            const bool valid = record.openTime > 0 && matchesDataset(record, symbol_, intervalLabel);
+            if (index + i + 1 == diskRecords_) {
+                diskTailOpen_ = valid ? record.openTime : 0;
+            }
+            if (valid) {
+                candles_.push_back(recordToCandle(record));
+            }
+        }
+        index += read;
+    }
+
+    // Replay the log: order by openTime and keep the last record per openTime.
+    const auto outOfOrder = std::adjacent_find(candles_.begin(), candles_.end(),
+                                               [](const domain::Candle& lhs, const domain::Candle& rhs) {
+                                                   return lhs.openTime >= rhs.openTime;
+                                               });
+    if (outOfOrder != candles_.end()) {
+        std::stable_sort(candles_.begin(), candles_.end(), [](const domain::Candle& lhs, const domain::Candle& rhs) {
+            return lhs.openTime < rhs.openTime;
+        });
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < candles_.size(); ++i) {
+            if (kept > 0 && candles_[kept - 1].openTime == candles_[i].openTime) {
+                candles_[kept - 1] = candles_[i];
+            }
+            else {
+                candles_[kept++] = candles_[i];
+            }
+        }
+        candles_.resize(kept);
+    }
+
+    staleRecords_ = diskRecords_ - candles_.size();
+    if (staleRecords_ > 0) {
+        markDirtyUnsafe_();
     }
 
     updateDerivedStateUnsafe_();
@@ -532,6 +680,7 @@ void PriceDataTimeSeriesRepository::rebuildCacheFromDiskUnsafe_() {
 void PriceDataTimeSeriesRepository::rewriteAllUnsafe_() {
     metrics::RepoFastPathTimer diagTimer{"repo.rewriteAll"};
     metrics::RepoFastPathLatencyTimer duration{"repo.rewriteAll.nanos"};
+    metrics::repoFastPathIncr("repo.rewriteAll.calls");
     if (filePath_.empty()) {
         return;
     }
@@ -543,9 +692,12 @@ void PriceDataTimeSeriesRepository::rewriteAllUnsafe_() {
         return;
     }
 
-    std::ofstream ofs(filePath_, std::ios::binary | std::ios::trunc);
-    if (!ofs.good()) {
-        LOG_ERROR(kLogCategory, "DB: failed to open %s for rewrite", filePath_.c_str());
+    // Compaction: write the sorted, deduplicated series next to the log and
+    // swap it in, so a crash never leaves a truncated dataset behind.
+    const std::string compactPath = filePath_ + ".compact";
+    const int fd = ::open(compactPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        LOG_ERROR(kLogCategory, "DB: failed to open %s for rewrite", compactPath.c_str());
         return;
     }
 
@@ -555,11 +707,34 @@ void PriceDataTimeSeriesRepository::rewriteAllUnsafe_() {
     }
     const auto intervalLabel = intervalToString(interval_);
     const auto intervalMs = interval_.ms;
-    for (const auto& candle : candles_) {
-        const auto record = makeRecord(candle, symbol_, intervalLabel, intervalMs);
-        ofs.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    std::vector<PriceData> records;
+    records.reserve(std::min(kIoChunkRecords, candles_.size()));
+    std::size_t written = 0;
+    bool ok = true;
+    for (std::size_t i = 0; i < candles_.size() && ok; ++i) {
+        records.push_back(makeRecord(candles_[i], symbol_, intervalLabel, intervalMs));
+        if (records.size() == kIoChunkRecords || i + 1 == candles_.size()) {
+            ok = writeFully(fd,
+                            reinterpret_cast<const char*>(records.data()),
+                            records.size() * kRecordSize,
+                            static_cast<off_t>(written * kRecordSize));
+            written += records.size();
+            records.clear();
+        }
+    }
+    ::close(fd);
+
+    if (!ok || std::rename(compactPath.c_str(), filePath_.c_str()) != 0) {
+        LOG_ERROR(kLogCategory, "DB: failed to rewrite %s (%s)", filePath_.c_str(), std::strerror(errno));
+        ::unlink(compactPath.c_str());
+        return;
+    }
+
+    closeLogUnsafe_();
+    if (!openLogUnsafe_()) {
+        LOG_ERROR(kLogCategory, "DB: failed to reopen %s after rewrite", filePath_.c_str());
     }
-    ofs.flush();
+    diskTailOpen_ = candles_.empty() ? 0 : candles_.back().openTime;
     dirty_ = false;
     dirtySince_ = {};
 }
@@ -584,6 +759,12 @@ bool PriceDataTimeSeriesRepository::flushIfNeededUnsafe_(bool force) {
         if (now - dirtySince_ < std::chrono::milliseconds(500)) {
             return false;
         }
+        // The log stays replayable, so only compact once it carries enough
+        // dead weight (or a write failure closed it).
+        const bool logHealthy = fd_ >= 0;
+        if (logHealthy && staleRecords_ < std::max(kCompactionMinStale, candles_.size() / 4)) {
+            return false;
+        }
     }
     rewriteAllUnsafe_();
     return !noDisk_;
@@ -597,11 +778,7 @@ void PriceDataTimeSeriesRepository::flushIfNeeded(bool force) {
 void PriceDataTimeSeriesRepository::updateDerivedStateUnsafe_() {
     metrics::RepoFastPathTimer diagTimer{"repo.updateDerived"};
     metrics::repoFastPathIncr("repo.updateDerived.count");
-    std::sort(candles_.begin(), candles_.end(), [](const domain::Candle& lhs, const domain::Candle& rhs) {
-        return lhs.openTime < rhs.openTime;
-    });
 
-    openIndex_.clear();
     meta_ = {};
     hasGap_ = false;
     lastClosedOpen_ = 0;
@@ -618,7 +795,6 @@ void PriceDataTimeSeriesRepository::updateDerivedStateUnsafe_() {
     domain::TimestampMs previousOpen = 0;
     bool first = true;
     for (const auto& candle : candles_) {
-        openIndex_.insert(candle.openTime);
         if (candle.isClosed) {
             lastClosedOpen_ = candle.openTime;
         }
@@ -633,6 +809,20 @@ void PriceDataTimeSeriesRepository::updateDerivedStateUnsafe_() {
     }
 }
 
+void PriceDataTimeSeriesRepository::noteAppendedTailUnsafe_(const domain::Candle& candle) {
+    if (candles_.size() == 1) {
+        meta_.minOpen = candle.openTime;
+    }
+    else if (interval_.ms > 0 && candle.openTime > meta_.maxOpen + interval_.ms) {
+        hasGap_ = true;
+    }
+    meta_.count = candles_.size();
+    meta_.maxOpen = candle.openTime;
+    if (candle.isClosed) {
+        lastClosedOpen_ = candle.openTime;
+    }
+}
+
 domain::Candle PriceDataTimeSeriesRepository::prepareCandleForAppend_(domain::Candle candle) const {
     const auto normalizedOpen = normalizeOpenTime(candle.openTime);
     candle.openTime = normalizedOpen;
@@ -661,10 +851,7 @@ domain::AppendResult PriceDataTimeSeriesRepository::appendOrReplaceUnsafe_(domai
         }
     }
 
-    auto it = std::lower_bound(candles_.begin(), candles_.end(), candle.openTime,
-                               [](const domain::Candle& lhs, domain::TimestampMs value) {
-                                   return lhs.openTime < value;
-                               });
+    auto it = findOpenUnsafe_(candle.openTime);
 
     if (it != candles_.end() && it->openTime == candle.openTime) {
         const bool replaceTail = (!candles_.empty() && it + 1 == candles_.end() &&
@@ -688,84 +875,35 @@ domain::AppendResult PriceDataTimeSeriesRepository::appendOrReplaceUnsafe_(domai
                 lastClosedOpen_ = newLastClosed;
             }
 
-            bool touchedDisk = false;
-            if (!noDisk_ && !filePath_.empty()) {
-                std::fstream fs(filePath_, std::ios::in | std::ios::out | std::ios::binary);
-                if (!fs.good()) {
-                    LOG_ERROR(kLogCategory,
-                              "DB: failed to open %s for tail replace",
-                              filePath_.c_str());
-                }
-                else {
-                    const auto record =
-                        makeRecord(candle, symbol_, intervalToString(interval_), interval_.ms);
-                    const auto recordSize = static_cast<std::streamoff>(sizeof(PriceData));
-                    fs.seekp(0, std::ios::end);
-                    const auto endPos = fs.tellp();
-                    if (endPos < recordSize) {
-                        LOG_ERROR(kLogCategory,
-                                  "DB: file %s too small for tail replace",
-                                  filePath_.c_str());
-                    }
-                    else {
-                        fs.seekp(-recordSize, std::ios::end);
-                        if (fs.fail()) {
-                            LOG_ERROR(kLogCategory,
-                                      "DB: failed to seek %s for tail replace",
-                                      filePath_.c_str());
-                        }
-                        else {
-                            fs.write(reinterpret_cast<const char*>(&record), sizeof(record));
-                            if (fs.fail()) {
-                                LOG_ERROR(kLogCategory,
-                                          "DB: failed to write tail replace record to %s",
-                                          filePath_.c_str());
-                            }
-                            else {
-                                fs.flush();
-                                touchedDisk = true;
-                            }
-                        }
-                    }
-                }
-                if (!touchedDisk) {
-                    markDirtyUnsafe_();
-                }
-            }
-
             result.state = domain::RangeState::Replaced;
             result.appended = 1;
-            result.touchedDisk = touchedDisk;
+            result.touchedDisk = logRecordUnsafe_(candle);
             result.liveOnly = !candle.isClosed;
             return result;
         }
 
-        metrics::repoFastPathIncr("repo.rewriteAll.calls");
         *it = candle;
         updateDerivedStateUnsafe_();
-        markDirtyUnsafe_();
         result.state = domain::RangeState::Replaced;
         result.appended = 1;
-        result.touchedDisk = false;
+        result.touchedDisk = logRecordUnsafe_(candle);
         result.liveOnly = !candle.isClosed;
         return result;
     }
 
     const bool insertAtEnd = (it == candles_.end());
-    it = candles_.insert(it, candle);
-    updateDerivedStateUnsafe_();
-
+    candles_.insert(it, candle);
     if (insertAtEnd) {
-        appendRecordUnsafe_(candle);
+        noteAppendedTailUnsafe_(candle);
     }
     else {
-        metrics::repoFastPathIncr("repo.rewriteAll.calls");
-        markDirtyUnsafe_();
+        metrics::repoFastPathIncr("repo.slow_path.inserts");
+        updateDerivedStateUnsafe_();
     }
 
     result.state = domain::RangeState::Ok;
     result.appended = 1;
-    result.touchedDisk = insertAtEnd && !noDisk_;
+    result.touchedDisk = appendRecordUnsafe_(candle);
     result.liveOnly = !candle.isClosed;
     return result;
 }
@@ -785,26 +923,19 @@ domain::Candle PriceDataTimeSeriesRepository::recordToCandle(const PriceData& re
     return candle;
 }
 
-void PriceDataTimeSeriesRepository::appendRecordUnsafe_(const domain::Candle& candle) {
+bool PriceDataTimeSeriesRepository::appendRecordUnsafe_(const domain::Candle& candle) {
     metrics::RepoFastPathTimer diagTimer{"repo.appendRecord"};
     if (noDisk_) {
         metrics::repoFastPathIncr("repo.disk.writes.skipped");
-        return;
-    }
-    if (filePath_.empty()) {
-        return;
+        return false;
     }
-
-    std::ofstream ofs(filePath_, std::ios::binary | std::ios::app);
-    if (!ofs.good()) {
-        LOG_ERROR(kLogCategory, "DB: failed to open %s for append", filePath_.c_str());
-        return;
+    if (!writeRecordAtUnsafe_(diskRecords_, candle)) {
+        return false;
     }
-
-    const auto record = makeRecord(candle, symbol_, intervalToString(interval_), interval_.ms);
-    ofs.write(reinterpret_cast<const char*>(&record), sizeof(record));
-    ofs.flush();
+    ++diskRecords_;
+    diskTailOpen_ = candle.openTime;
     metrics::repoFastPathIncr("repo.appendRecord.count");
+    return true;
 }
 
 std::int64_t PriceDataTimeSeriesRepository::normalizeOpenTime(domain::TimestampMs openTime) const {
@@ -6,7 +6,6 @@
 #include <mutex>
 #include <optional>
 #include <string>
-#include <unordered_set>
 #include <vector>
 
 #include "domain/DomainContracts.h"
@@ -22,6 +21,10 @@ struct Paths {
 class PriceDataTimeSeriesRepository : public domain::TimeSeriesRepository {
 public:
     PriceDataTimeSeriesRepository();
+    ~PriceDataTimeSeriesRepository() override;
+
+    PriceDataTimeSeriesRepository(const PriceDataTimeSeriesRepository&) = delete;
+    PriceDataTimeSeriesRepository& operator=(const PriceDataTimeSeriesRepository&) = delete;
 
     void bind(const std::string& symbol, domain::Interval interval, const Paths& paths);
 
@@ -49,7 +52,19 @@ private:
     std::string filePath_;
     bool bound_{false};
 
-    std::unordered_set<std::int64_t> openIndex_;
+    // The dataset file is an append-only log of PriceData records: a later
+    // record for an openTime supersedes earlier ones, and a reload replays it
+    // sorted. Out-of-order inserts are appended as they are. A replacement
+    // rewrites the last record in place when it holds the same openTime, and
+    // is otherwise appended and counted in staleRecords_ until compaction
+    // rewrites the file sorted and deduplicated.
+    int fd_{-1};
+    std::size_t diskRecords_{0};
+    std::size_t staleRecords_{0};
+    // openTime of the last record in the file (not necessarily the newest).
+    domain::TimestampMs diskTailOpen_{0};
+
+    // Sorted by openTime, unique.
     std::vector<domain::Candle> candles_;
     domain::RepoMetadata meta_{};
     bool hasGap_{false};
@@ -65,16 +80,22 @@ private:
                                     domain::Interval interval);
 
     void loadOrInitFileUnsafe_();
+    bool openLogUnsafe_();
+    void closeLogUnsafe_();
+    bool writeRecordAtUnsafe_(std::size_t index, const domain::Candle& candle);
+    bool logRecordUnsafe_(const domain::Candle& candle);
+    std::vector<domain::Candle>::iterator findOpenUnsafe_(domain::TimestampMs openTime);
     void rebuildCacheFromDiskUnsafe_();
     void rewriteAllUnsafe_();
     void updateDerivedStateUnsafe_();
+    void noteAppendedTailUnsafe_(const domain::Candle& candle);
     bool flushIfNeededUnsafe_(bool force = false);
     void markDirtyUnsafe_();
     domain::AppendResult appendOrReplaceUnsafe_(domain::Candle candle);
     domain::Candle prepareCandleForAppend_(domain::Candle candle) const;
     domain::Candle recordToCandle(const PriceData& record) const;
 
-    void appendRecordUnsafe_(const domain::Candle& candle);
+    bool appendRecordUnsafe_(const domain::Candle& candle);
 
     std::int64_t normalizeOpenTime(domain::TimestampMs openTime) const;
 };
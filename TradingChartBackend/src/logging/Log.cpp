@@ -13,25 +13,31 @@
 #include <cstring>
 #include <ctime>
 #include <cctype>
-#include <deque>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 namespace {
 using logging::Log;
 
 constexpr std::size_t kMessageBufferSize = 1024;
-constexpr std::size_t kQueueCapacity = 4096;
+// Per-thread ring; a power of two so offsets are a mask away.
+constexpr std::size_t kRingBytes = 64 * 1024;
+constexpr std::size_t kMaxRecordBytes = kRingBytes / 4;
+constexpr std::chrono::milliseconds kCalibrationWindow{10};
 constexpr std::chrono::milliseconds kDefaultInfoRateLimit{100};  // 10/s
 constexpr std::chrono::milliseconds kReverseBackfillLimit{500};
 constexpr std::size_t kDebugLogMaxBytes = 8 * 1024 * 1024;
 const std::filesystem::path kDebugLogPath{"./logs/ttp-debug.log"};
 
+static_assert((kRingBytes & (kRingBytes - 1)) == 0, "ring size must be a power of two");
+
 struct LogMessage {
     config::LogLevel level{};
     logging::LogCategory category{};
@@ -39,16 +45,108 @@ struct LogMessage {
     std::string text;
 };
 
-struct AsyncLogState {
+// Lines formatted by one pass of the logger thread, written with one
+// fwrite/fflush per stream.
+struct OutputBatch {
+    std::string out;
+    std::string err;
+    bool debugWritten = false;
+};
+
+// Single producer (the owning thread), single consumer (the logger thread).
+// head/tail are byte positions that only grow; the producer caches tail so
+// the common case touches no shared cache line besides head.
+struct ThreadRing {
+    alignas(64) std::atomic<std::uint64_t> head{0};
+    alignas(64) std::atomic<std::uint64_t> tail{0};
+    std::atomic<bool> retired{false};
+    alignas(64) std::array<std::byte, kRingBytes> data{};
+};
+
+struct RingRegistry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+};
+
+RingRegistry& ringRegistry() {
+    static RingRegistry registry;
+    return registry;
+}
+
+// Maps detail::now_ticks() to wall time. The rate is measured over the whole
+// run (so it converges) while the anchor is refreshed on every pass (so wall
+// clock steps show up). Only touched by the logger thread.
+class TickClock {
+public:
+    void calibrate() {
+        const auto ticks = logging::detail::now_ticks();
+        const auto realNs = wallNowNs();
+        if (startTicks_ == 0) {
+            startTicks_ = ticks;
+            startRealNs_ = realNs;
+        }
+        else if (ticks > startTicks_ && realNs > startRealNs_) {
+            nsPerTick_ = static_cast<double>(realNs - startRealNs_) / static_cast<double>(ticks - startTicks_);
+        }
+        anchorTicks_ = ticks;
+        anchorRealNs_ = realNs;
+    }
+
+    std::chrono::system_clock::time_point toTimePoint(std::uint64_t ticks) const {
+        const auto deltaTicks = static_cast<double>(static_cast<std::int64_t>(ticks - anchorTicks_));
+        const auto realNs = anchorRealNs_ + static_cast<std::int64_t>(deltaTicks * nsPerTick_);
+        return std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(realNs)));
+    }
+
+private:
+    static std::int64_t wallNowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+
+    std::uint64_t startTicks_ = 0;
+    std::int64_t startRealNs_ = 0;
+    std::uint64_t anchorTicks_ = 0;
+    std::int64_t anchorRealNs_ = 0;
+    double nsPerTick_ = 0.0;
+};
+
+struct LoggerState {
     std::mutex mutex;
     std::condition_variable cv;
-    std::deque<LogMessage> queue;
-    bool stopping = false;
+    std::atomic<bool> stopping{false};
+    // Set while the logger sleeps with every ring drained; see commit().
+    std::atomic<bool> idle{false};
+    std::atomic<std::uint64_t> dropped{0};
     std::thread worker;
+    TickClock clock;
 };
 
-AsyncLogState& asyncState() {
-    static AsyncLogState state;
+LoggerState& loggerState() {
+    static LoggerState state;
+    return state;
+}
+
+struct ProducerState {
+    std::shared_ptr<ThreadRing> ring;
+    std::uint64_t cachedTail = 0;
+    std::uint64_t pendingHead = 0;
+    // Warnings/errors that do not fit in the ring are formatted from here
+    // synchronously, as are all messages once the logger thread has stopped.
+    std::vector<std::byte> scratch;
+    bool usingScratch = false;
+
+    ~ProducerState() {
+        if (ring) {
+            ring->retired.store(true, std::memory_order_release);
+        }
+    }
+};
+
+ProducerState& producerState() {
+    thread_local ProducerState state;
     return state;
 }
 
@@ -69,7 +167,7 @@ DebugFileState& debugFileState() {
     return state;
 }
 
-void processMessage(const LogMessage& msg);
+void processMessage(const LogMessage& msg, OutputBatch& batch);
 
 std::atomic<bool>& debugSinkEnabled() {
     static std::atomic<bool> enabled{false};
@@ -185,43 +283,27 @@ void rotateDebugLogUnlocked(DebugFileState& state) {
 }
 
 void shutdownWorker();
+void workerLoop();
 
 void ensureWorkerStarted() {
     std::call_once(workerOnce(), [] {
-        auto& state = asyncState();
-        state.worker = std::thread([] {
-            auto& localState = asyncState();
-            std::unique_lock<std::mutex> lock(localState.mutex);
-            while (true) {
-                localState.cv.wait(lock, [&] {
-                    return localState.stopping || !localState.queue.empty();
-                });
-
-                if (localState.queue.empty()) {
-                    if (localState.stopping) {
-                        break;
-                    }
-                    continue;
-                }
-
-                LogMessage msg = std::move(localState.queue.front());
-                localState.queue.pop_front();
-                lock.unlock();
-
-                processMessage(msg);
-
-                lock.lock();
-            }
-        });
+        // Construct everything the worker touches before registering the
+        // atexit hook, so it is destroyed only after the worker is joined.
+        ringRegistry();
+        debugFileState();
+        snapshotFilter();
+        infoRateLimiter();
+        reverseBackfillLimiter();
+        loggerState().worker = std::thread(workerLoop);
         std::atexit(shutdownWorker);
     });
 }
 
 void shutdownWorker() {
-    auto& state = asyncState();
+    auto& state = loggerState();
     {
         std::lock_guard<std::mutex> lock(state.mutex);
-        state.stopping = true;
+        state.stopping.store(true, std::memory_order_release);
     }
     state.cv.notify_all();
     if (state.worker.joinable()) {
@@ -236,18 +318,299 @@ void shutdownWorker() {
     }
 }
 
-bool enqueueMessage(LogMessage&& msg) {
+std::shared_ptr<ThreadRing> registerRing() {
     ensureWorkerStarted();
-    auto& state = asyncState();
-    {
-        std::unique_lock<std::mutex> lock(state.mutex);
-        if (state.queue.size() >= kQueueCapacity) {
+    auto ring = std::make_shared<ThreadRing>();
+    auto& registry = ringRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.rings.push_back(ring);
+    return ring;
+}
+
+constexpr std::size_t roundUp8(std::size_t bytes) {
+    return (bytes + 7U) & ~std::size_t{7U};
+}
+
+struct DecodedArg {
+    logging::detail::ArgTag tag{};
+    std::uint64_t word = 0;
+    std::string_view text;
+};
+
+class ArgReader {
+public:
+    ArgReader(const std::byte* data, std::size_t count) : data_(data), remaining_(count) {}
+
+    bool next(DecodedArg& arg) {
+        if (remaining_ == 0) {
             return false;
         }
-        state.queue.emplace_back(std::move(msg));
+        --remaining_;
+        arg.tag = static_cast<logging::detail::ArgTag>(*data_++);
+        if (arg.tag == logging::detail::ArgTag::String) {
+            std::uint32_t length = 0;
+            std::memcpy(&length, data_, sizeof(length));
+            arg.text = std::string_view(reinterpret_cast<const char*>(data_ + sizeof(length)), length);
+            data_ += sizeof(length) + length;
+        }
+        else {
+            std::memcpy(&arg.word, data_, sizeof(arg.word));
+            data_ += sizeof(arg.word);
+        }
+        return true;
     }
-    state.cv.notify_one();
-    return true;
+
+private:
+    const std::byte* data_;
+    std::size_t remaining_;
+};
+
+template <typename T>
+void appendFormatted(std::string& out, const char* spec, T value) {
+    std::array<char, 128> buffer{};
+    const int written = std::snprintf(buffer.data(), buffer.size(), spec, value);
+    if (written < 0) {
+        return;
+    }
+    const auto length = static_cast<std::size_t>(written);
+    if (length < buffer.size()) {
+        out.append(buffer.data(), length);
+        return;
+    }
+    const auto offset = out.size();
+    out.resize(offset + length + 1U);
+    std::snprintf(out.data() + offset, length + 1U, spec, value);
+    out.resize(offset + length);
+}
+
+std::int64_t asSigned(const DecodedArg& arg) {
+    return arg.tag == logging::detail::ArgTag::Double ? static_cast<std::int64_t>(0)
+                                                      : static_cast<std::int64_t>(arg.word);
+}
+
+double asDouble(const DecodedArg& arg) {
+    if (arg.tag == logging::detail::ArgTag::Double) {
+        double value = 0.0;
+        std::memcpy(&value, &arg.word, sizeof(value));
+        return value;
+    }
+    return arg.tag == logging::detail::ArgTag::Int ? static_cast<double>(static_cast<std::int64_t>(arg.word))
+                                                   : static_cast<double>(arg.word);
+}
+
+// Re-runs printf semantics one conversion at a time: each spec is rebuilt
+// with a length modifier matching the captured 64-bit value, after applying
+// the truncation the original modifier implied.
+std::string formatDeferred(const char* fmt, ArgReader args) {
+    std::string text;
+    text.reserve(128);
+    DecodedArg arg;
+    std::array<char, 48> spec{};
+
+    const char* cursor = fmt;
+    while (*cursor != '\0') {
+        if (*cursor != '%') {
+            const char* next = std::strchr(cursor, '%');
+            const auto length = next == nullptr ? std::strlen(cursor) : static_cast<std::size_t>(next - cursor);
+            text.append(cursor, length);
+            cursor += length;
+            continue;
+        }
+        if (cursor[1] == '%') {
+            text.push_back('%');
+            cursor += 2;
+            continue;
+        }
+
+        std::size_t specLength = 0;
+        auto push = [&](char ch) {
+            if (specLength + 1U < spec.size()) {
+                spec[specLength++] = ch;
+            }
+        };
+        auto pushNumber = [&](std::int64_t value) {
+            std::array<char, 24> digits{};
+            const int count = std::snprintf(digits.data(), digits.size(), "%lld", static_cast<long long>(value));
+            for (int i = 0; i < count; ++i) {
+                push(digits[static_cast<std::size_t>(i)]);
+            }
+        };
+
+        push('%');
+        ++cursor;
+        bool leftAlign = false;
+        while (*cursor != '\0' && std::strchr("-+ #0", *cursor) != nullptr) {
+            leftAlign = leftAlign || *cursor == '-';
+            push(*cursor++);
+        }
+        std::int64_t width = -1;
+        if (*cursor == '*') {
+            ++cursor;
+            width = args.next(arg) ? asSigned(arg) : 0;
+            // A negative width is the '-' flag plus its magnitude.
+            if (width < 0) {
+                leftAlign = true;
+                width = -width;
+                push('-');
+            }
+            pushNumber(width);
+        }
+        else if (std::isdigit(static_cast<unsigned char>(*cursor)) != 0) {
+            width = 0;
+            while (std::isdigit(static_cast<unsigned char>(*cursor)) != 0) {
+                width = width * 10 + (*cursor - '0');
+                push(*cursor++);
+            }
+        }
+        std::int64_t precision = -1;
+        if (*cursor == '.') {
+            push(*cursor++);
+            precision = 0;
+            if (*cursor == '*') {
+                ++cursor;
+                precision = args.next(arg) ? asSigned(arg) : 0;
+                pushNumber(precision);
+            }
+            else {
+                while (std::isdigit(static_cast<unsigned char>(*cursor)) != 0) {
+                    precision = precision * 10 + (*cursor - '0');
+                    push(*cursor++);
+                }
+            }
+        }
+        // Length modifiers: 'H' stands for hh, 'L' for any 64-bit width.
+        char lengthModifier = '\0';
+        if (*cursor == 'h') {
+            lengthModifier = cursor[1] == 'h' ? 'H' : 'h';
+            cursor += lengthModifier == 'H' ? 2 : 1;
+        }
+        else if (*cursor != '\0' && std::strchr("lLjztq", *cursor) != nullptr) {
+            lengthModifier = 'L';
+            cursor += (cursor[0] == 'l' && cursor[1] == 'l') ? 2 : 1;
+        }
+
+        const char conversion = *cursor;
+        if (conversion == '\0') {
+            break;
+        }
+        ++cursor;
+        if (conversion == 'n') {
+            args.next(arg);
+            continue;
+        }
+        if (!args.next(arg)) {
+            text += "<?>";
+            continue;
+        }
+
+        switch (conversion) {
+        case 'd':
+        case 'i': {
+            auto value = asSigned(arg);
+            if (lengthModifier == 'H') {
+                value = static_cast<signed char>(value);
+            }
+            else if (lengthModifier == 'h') {
+                value = static_cast<short>(value);
+            }
+            else if (lengthModifier == '\0') {
+                value = static_cast<int>(value);
+            }
+            push('l');
+            push('l');
+            push(conversion);
+            spec[specLength] = '\0';
+            appendFormatted(text, spec.data(), static_cast<long long>(value));
+            break;
+        }
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X': {
+            auto value = arg.word;
+            if (lengthModifier == 'H') {
+                value = static_cast<unsigned char>(value);
+            }
+            else if (lengthModifier == 'h') {
+                value = static_cast<unsigned short>(value);
+            }
+            else if (lengthModifier == '\0') {
+                value = static_cast<unsigned int>(value);
+            }
+            push('l');
+            push('l');
+            push(conversion);
+            spec[specLength] = '\0';
+            appendFormatted(text, spec.data(), static_cast<unsigned long long>(value));
+            break;
+        }
+        case 'c':
+            push('c');
+            spec[specLength] = '\0';
+            appendFormatted(text, spec.data(), static_cast<int>(asSigned(arg)));
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            push(conversion);
+            spec[specLength] = '\0';
+            appendFormatted(text, spec.data(), asDouble(arg));
+            break;
+        case 'p':
+            push('p');
+            spec[specLength] = '\0';
+            appendFormatted(text, spec.data(), reinterpret_cast<const void*>(static_cast<std::uintptr_t>(arg.word)));
+            break;
+        case 's': {
+            if (arg.tag != logging::detail::ArgTag::String) {
+                text += "<?>";
+                break;
+            }
+            auto value = arg.text;
+            if (precision >= 0 && static_cast<std::size_t>(precision) < value.size()) {
+                value = value.substr(0, static_cast<std::size_t>(precision));
+            }
+            const auto padding = width > static_cast<std::int64_t>(value.size())
+                ? static_cast<std::size_t>(width) - value.size()
+                : 0U;
+            if (!leftAlign) {
+                text.append(padding, ' ');
+            }
+            text.append(value);
+            if (leftAlign) {
+                text.append(padding, ' ');
+            }
+            break;
+        }
+        default:
+            text += "<?>";
+            break;
+        }
+    }
+
+    if (text.size() >= kMessageBufferSize) {
+        text.resize(kMessageBufferSize - 1U);
+        text.replace(text.size() - 3U, 3U, "...");
+    }
+    return text;
+}
+
+// Without a clock the record is stamped now (it is being written inline).
+LogMessage decodeRecord(const std::byte* record, const TickClock* clock) {
+    logging::detail::RecordHeader header{};
+    std::memcpy(&header, record, sizeof(header));
+
+    LogMessage message;
+    message.level = header.level;
+    message.category = header.category;
+    message.timestamp = clock != nullptr ? clock->toTimePoint(header.ticks) : std::chrono::system_clock::now();
+    message.text = formatDeferred(header.fmt, ArgReader(record + sizeof(header), header.argc));
+    return message;
 }
 
 std::string formatLine(const LogMessage& msg) {
@@ -281,10 +644,18 @@ std::string formatLine(const LogMessage& msg) {
     return line;
 }
 
-void writeToStream(FILE* stream, const std::string& line) {
-    std::fwrite(line.data(), 1, line.size(), stream);
-    std::fputc('\n', stream);
+void appendLine(std::string& out, const std::string& line) {
+    out.append(line);
+    out.push_back('\n');
+}
+
+void writeToStream(FILE* stream, std::string& pending) {
+    if (pending.empty()) {
+        return;
+    }
+    std::fwrite(pending.data(), 1, pending.size(), stream);
     std::fflush(stream);
+    pending.clear();
 }
 
 bool writeToDebugFile(const std::string& line) {
@@ -315,11 +686,27 @@ bool writeToDebugFile(const std::string& line) {
     }
 
     state.stream << line << '\n';
-    state.stream.flush();
     state.size += lineBytes;
     return true;
 }
 
+void flushDebugFile() {
+    auto& state = debugFileState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (state.stream.is_open()) {
+        state.stream.flush();
+    }
+}
+
+void flushBatch(OutputBatch& batch) {
+    writeToStream(stdout, batch.out);
+    writeToStream(stderr, batch.err);
+    if (batch.debugWritten) {
+        flushDebugFile();
+        batch.debugWritten = false;
+    }
+}
+
 bool passesFilters(const LogMessage& msg) {
     if (msg.level == config::LogLevel::Debug && msg.category == logging::LogCategory::SNAPSHOT) {
         if (!snapshotFilter().allow(msg.text)) {
@@ -365,7 +752,7 @@ void configureForLevel(config::LogLevel level) {
     debugSinkEnabled().store(enableDebug, std::memory_order_release);
 }
 
-void processMessage(const LogMessage& msg) {
+void processMessage(const LogMessage& msg, OutputBatch& batch) {
     if (!passesFilters(msg)) {
         return;
     }
@@ -379,21 +766,138 @@ void processMessage(const LogMessage& msg) {
     switch (msg.level) {
     case config::LogLevel::Error:
     case config::LogLevel::Warn:
-        writeToStream(stderr, line);
+        appendLine(batch.err, line);
         break;
     case config::LogLevel::Info:
-        writeToStream(stdout, line);
+        appendLine(batch.out, line);
         break;
     case config::LogLevel::Debug:
     case config::LogLevel::Trace: {
-        if (!writeToDebugFile(line)) {
-            writeToStream(stdout, line);
+        if (writeToDebugFile(line)) {
+            batch.debugWritten = true;
+        }
+        else {
+            appendLine(batch.out, line);
         }
         break;
     }
     }
 }
 
+// Formats and writes one record on the calling thread.
+void processRecordNow(const std::byte* record) {
+    OutputBatch batch;
+    processMessage(decodeRecord(record, nullptr), batch);
+    flushBatch(batch);
+}
+
+// Consumes everything published so far; returns whether there was any.
+bool drainRing(ThreadRing& ring, const TickClock& clock, OutputBatch& batch) {
+    auto tail = ring.tail.load(std::memory_order_relaxed);
+    const auto head = ring.head.load(std::memory_order_acquire);
+    if (tail == head) {
+        return false;
+    }
+    while (tail < head) {
+        const auto offset = static_cast<std::size_t>(tail & (kRingBytes - 1U));
+        std::uint32_t size = 0;
+        std::memcpy(&size, ring.data.data() + offset, sizeof(size));
+        if (size == 0U) {
+            tail += kRingBytes - offset;
+            continue;
+        }
+        processMessage(decodeRecord(ring.data.data() + offset, &clock), batch);
+        tail += roundUp8(size);
+    }
+    ring.tail.store(tail, std::memory_order_release);
+    return true;
+}
+
+// Whether any ring holds records the logger has not drained yet.
+bool anyPublished(RingRegistry& registry) {
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return std::any_of(registry.rings.begin(), registry.rings.end(), [](const std::shared_ptr<ThreadRing>& ring) {
+        return ring->tail.load(std::memory_order_relaxed) != ring->head.load(std::memory_order_relaxed);
+    });
+}
+
+void workerLoop() {
+    auto& state = loggerState();
+    auto& registry = ringRegistry();
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+    OutputBatch batch;
+    std::uint64_t reportedDrops = 0;
+
+    // The tick rate needs a baseline before the first record is stamped.
+    state.clock.calibrate();
+    std::this_thread::sleep_for(kCalibrationWindow);
+
+    while (true) {
+        // Read before draining so the last pass after stop sees every
+        // record committed before the flag was raised.
+        const bool stopping = state.stopping.load(std::memory_order_acquire);
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            rings = registry.rings;
+        }
+
+        state.clock.calibrate();
+        bool drained = false;
+        bool anyRetired = false;
+        for (const auto& ring : rings) {
+            drained = drainRing(*ring, state.clock, batch) || drained;
+            anyRetired = anyRetired || ring->retired.load(std::memory_order_acquire);
+        }
+
+        const auto drops = state.dropped.load(std::memory_order_relaxed);
+        if (drops != reportedDrops) {
+            LogMessage notice;
+            notice.level = config::LogLevel::Warn;
+            notice.category = logging::LogCategory::DATA;
+            notice.timestamp = std::chrono::system_clock::now();
+            notice.text = "logger dropped " + std::to_string(drops - reportedDrops) + " messages: thread ring full";
+            appendLine(batch.err, formatLine(notice));
+            reportedDrops = drops;
+        }
+        flushBatch(batch);
+
+        if (anyRetired) {
+            // Rings of exited threads go once drained; a shared_ptr keeps the
+            // memory alive for this pass either way.
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.rings.erase(std::remove_if(registry.rings.begin(),
+                                                registry.rings.end(),
+                                                [](const std::shared_ptr<ThreadRing>& ring) {
+                                                    return ring->retired.load(std::memory_order_acquire)
+                                                        && ring->tail.load(std::memory_order_relaxed)
+                                                        == ring->head.load(std::memory_order_acquire);
+                                                }),
+                                 registry.rings.end());
+        }
+        rings.clear();
+
+        if (drained) {
+            continue;
+        }
+        if (stopping) {
+            break;
+        }
+        // Raise the flag before looking once more, so a record committed in
+        // between is either seen here or wakes the logger (see commit()).
+        state.idle.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (anyPublished(registry)) {
+            state.idle.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(state.mutex);
+        state.cv.wait(lock, [&state] {
+            return !state.idle.load(std::memory_order_relaxed) || state.stopping.load(std::memory_order_acquire);
+        });
+        state.idle.store(false, std::memory_order_relaxed);
+    }
+}
+
 }  // namespace
 
 namespace logging {
@@ -485,8 +989,12 @@ void Log::log(config::LogLevel level, LogCategory category, const char* fmt, ...
     va_end(args);
 }
 
+std::uint64_t Log::dropped_messages() {
+    return loggerState().dropped.load(std::memory_order_relaxed);
+}
+
 void Log::vlog(config::LogLevel level, LogCategory category, const char* fmt, std::va_list args) {
-    if (config::logLevelSeverity(level) < config::logLevelSeverity(currentLevel.load(std::memory_order_relaxed))) {
+    if (!enabled(level)) {
         return;
     }
 
@@ -508,18 +1016,87 @@ void Log::vlog(config::LogLevel level, LogCategory category, const char* fmt, st
         buffer[buffer.size() - 1] = '\0';
     }
 
-    LogMessage message;
-    message.level = level;
-    message.category = category;
-    message.timestamp = std::chrono::system_clock::now();
-    message.text.assign(buffer.data());
+    write(level, category, "%s", buffer.data());
+}
+
+namespace detail {
+
+std::byte* reserve(std::size_t bytes, config::LogLevel level) noexcept {
+    auto& producer = producerState();
+    const auto size = roundUp8(bytes);
+    const bool stopping = loggerState().stopping.load(std::memory_order_acquire);
 
-    if (!enqueueMessage(LogMessage(message))) {
-        // Drop low-severity messages when the queue is saturated, but ensure warnings/errors surface.
-        if (level == config::LogLevel::Error || level == config::LogLevel::Warn) {
-            processMessage(message);
+    if (!stopping && size <= kMaxRecordBytes) {
+        if (!producer.ring) {
+            try {
+                producer.ring = registerRing();
+            }
+            catch (...) {
+                return nullptr;
+            }
+        }
+        auto& ring = *producer.ring;
+        const auto head = ring.head.load(std::memory_order_relaxed);
+        const auto offset = static_cast<std::size_t>(head & (kRingBytes - 1U));
+        // A record never straddles the end; the gap is skipped with a marker.
+        const std::size_t pad = offset + size > kRingBytes ? kRingBytes - offset : 0U;
+        const auto needed = pad + size;
+        if (head + needed - producer.cachedTail > kRingBytes) {
+            producer.cachedTail = ring.tail.load(std::memory_order_acquire);
         }
+        if (head + needed - producer.cachedTail <= kRingBytes) {
+            if (pad != 0U) {
+                const std::uint32_t wrapMarker = 0;
+                std::memcpy(ring.data.data() + offset, &wrapMarker, sizeof(wrapMarker));
+            }
+            producer.pendingHead = head + needed;
+            producer.usingScratch = false;
+            return ring.data.data() + ((head + pad) & (kRingBytes - 1U));
+        }
+    }
+
+    if (!stopping && level != config::LogLevel::Error && level != config::LogLevel::Warn) {
+        loggerState().dropped.fetch_add(1U, std::memory_order_relaxed);
+        return nullptr;
+    }
+    try {
+        producer.scratch.resize(size);
+    }
+    catch (...) {
+        return nullptr;
+    }
+    producer.usingScratch = true;
+    return producer.scratch.data();
+}
+
+void commit() noexcept {
+    auto& producer = producerState();
+    if (producer.usingScratch) {
+        producer.usingScratch = false;
+        try {
+            processRecordNow(producer.scratch.data());
+        }
+        catch (...) {
+        }
+        return;
+    }
+    auto& ring = *producer.ring;
+    ring.head.store(producer.pendingHead, std::memory_order_release);
+
+    // The logger only sleeps with every ring drained, so an idle logger means
+    // this is the first record into an empty ring. The fence pairs with the
+    // one the logger takes after raising the flag.
+    auto& state = loggerState();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (state.idle.load(std::memory_order_relaxed)) {
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.idle.store(false, std::memory_order_relaxed);
+        }
+        state.cv.notify_one();
     }
 }
 
+}  // namespace detail
+
 }  // namespace logging
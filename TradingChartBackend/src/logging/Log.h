@@ -2,15 +2,146 @@
 
 #include "config/Config.h"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstdarg>
+#include <cstddef>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <string_view>
+#include <type_traits>
 
 namespace logging {
 
 enum class LogCategory { NET, DATA, CACHE, SNAPSHOT, RENDER, UI, DB };
 
+namespace detail {
+
+// Wire format of a deferred message inside a thread's ring: a RecordHeader
+// followed by `argc` arguments, each a one-byte ArgTag and its payload.
+// Records are padded to 8 bytes; a header with size 0 marks the wrap to the
+// start of the ring.
+enum class ArgTag : std::uint8_t { Int, UInt, Double, String, Pointer };
+
+struct RecordHeader {
+    std::uint32_t size;
+    config::LogLevel level;
+    LogCategory category;
+    std::uint16_t argc;
+    std::uint64_t ticks;
+    const char* fmt;
+};
+
+// Record timestamp. The TSC costs a few ns where the vDSO clock costs tens;
+// the logger thread maps ticks to wall time (see TickClock in Log.cpp).
+inline std::uint64_t now_ticks() noexcept {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    return __builtin_ia32_rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// %s arguments are copied up to this many bytes; a longer one ends in "...".
+constexpr std::size_t kMaxStringArg = 1024;
+constexpr std::string_view kStringArgCut{"..."};
+
+template <typename T>
+constexpr ArgTag tag_of() {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*>) {
+        return ArgTag::String;
+    }
+    else if constexpr (std::is_pointer_v<U> || std::is_null_pointer_v<U>) {
+        return ArgTag::Pointer;
+    }
+    else if constexpr (std::is_floating_point_v<U>) {
+        return ArgTag::Double;
+    }
+    else if constexpr (std::is_enum_v<U>) {
+        return std::is_signed_v<std::underlying_type_t<U>> ? ArgTag::Int : ArgTag::UInt;
+    }
+    else {
+        static_assert(std::is_integral_v<U>, "log arguments must be printf scalars or C strings");
+        return std::is_signed_v<U> ? ArgTag::Int : ArgTag::UInt;
+    }
+}
+
+inline const char* string_arg(const char* value) noexcept {
+    return value == nullptr ? "(null)" : value;
+}
+
+inline std::size_t string_arg_length(const char* value) noexcept {
+    return ::strnlen(string_arg(value), kMaxStringArg);
+}
+
+template <typename T>
+std::size_t encoded_size(const T& value) noexcept {
+    if constexpr (tag_of<T>() == ArgTag::String) {
+        return 1U + sizeof(std::uint32_t) + string_arg_length(value);
+    }
+    else {
+        return 1U + 8U;
+    }
+}
+
+template <typename T>
+void encode(std::byte*& out, const T& value) noexcept {
+    constexpr ArgTag tag = tag_of<T>();
+    *out++ = static_cast<std::byte>(tag);
+    if constexpr (tag == ArgTag::String) {
+        const char* text = string_arg(value);
+        const auto full = ::strnlen(text, kMaxStringArg + 1U);
+        const auto length = static_cast<std::uint32_t>(std::min(full, kMaxStringArg));
+        std::memcpy(out, &length, sizeof(length));
+        if (full > kMaxStringArg) {
+            const auto kept = length - kStringArgCut.size();
+            std::memcpy(out + sizeof(length), text, kept);
+            std::memcpy(out + sizeof(length) + kept, kStringArgCut.data(), kStringArgCut.size());
+        }
+        else {
+            std::memcpy(out + sizeof(length), text, length);
+        }
+        out += sizeof(length) + length;
+    }
+    else {
+        std::uint64_t word = 0;
+        if constexpr (tag == ArgTag::Pointer) {
+            word = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(static_cast<const void*>(value)));
+        }
+        else if constexpr (tag == ArgTag::Double) {
+            const auto number = static_cast<double>(value);
+            std::memcpy(&word, &number, sizeof(word));
+        }
+        else if constexpr (tag == ArgTag::Int) {
+            word = static_cast<std::uint64_t>(static_cast<std::int64_t>(value));
+        }
+        else {
+            word = static_cast<std::uint64_t>(value);
+        }
+        std::memcpy(out, &word, sizeof(word));
+        out += sizeof(word);
+    }
+}
+
+// Space for one record in the calling thread's ring, or nullptr when the
+// message has to be dropped. When the ring is full, warnings and errors get
+// a thread-local scratch buffer instead and are written synchronously by
+// commit(); lower levels are dropped and counted.
+std::byte* reserve(std::size_t bytes, config::LogLevel level) noexcept;
+void commit() noexcept;
+
+// Never called; gives the LOG_* macros printf format checking.
+int check_format(const char* fmt, ...)
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((format(printf, 1, 2)))
+#endif
+    ;
+
+}  // namespace detail
+
 class Log {
 public:
     static void set_log_level(config::LogLevel level);
@@ -21,12 +152,46 @@ public:
     static const char* level_to_string(config::LogLevel level);
     static const char* category_to_string(LogCategory category);
 
+    static bool enabled(config::LogLevel level) noexcept {
+        return config::logLevelSeverity(level) >= config::logLevelSeverity(currentLevel.load(std::memory_order_relaxed));
+    }
+
+    // Deferred logging used by the LOG_* macros. `fmt` must outlive the
+    // process (a string literal); the arguments are copied into the calling
+    // thread's ring and formatted on the logger thread. Precision-limited %s
+    // on unterminated buffers is not supported: strings are copied up to
+    // their NUL (or kMaxStringArg bytes).
+    template <typename... Args>
+    static void write(config::LogLevel level, LogCategory category, const char* fmt, const Args&... args) noexcept {
+        static_assert(sizeof...(Args) <= 0xFFFF, "too many log arguments");
+        const std::size_t bytes = sizeof(detail::RecordHeader) + (std::size_t{0} + ... + detail::encoded_size(args));
+        std::byte* out = detail::reserve(bytes, level);
+        if (out == nullptr) {
+            return;
+        }
+        const detail::RecordHeader header{
+            static_cast<std::uint32_t>(bytes),
+            level,
+            category,
+            static_cast<std::uint16_t>(sizeof...(Args)),
+            detail::now_ticks(),
+            fmt};
+        std::memcpy(out, &header, sizeof(header));
+        out += sizeof(header);
+        (detail::encode(out, args), ...);
+        detail::commit();
+    }
+
+    // Eagerly formatted variant for callers with a runtime format string.
     static void log(config::LogLevel level, LogCategory category, const char* fmt, ...)
 #if defined(__GNUC__) || defined(__clang__)
         __attribute__((format(printf, 3, 4)))
 #endif
         ;
 
+    // Messages dropped since start because a thread's ring was full.
+    static std::uint64_t dropped_messages();
+
 private:
     static void vlog(config::LogLevel level, LogCategory category, const char* fmt, std::va_list args);
 
@@ -35,11 +200,18 @@ private:
 
 }  // namespace logging
 
-#define LOG_ERROR(cat, ...) ::logging::Log::log(::config::LogLevel::Error, (cat), __VA_ARGS__)
-#define LOG_WARN(cat, ...)  ::logging::Log::log(::config::LogLevel::Warn,  (cat), __VA_ARGS__)
-#define LOG_INFO(cat, ...)  ::logging::Log::log(::config::LogLevel::Info,  (cat), __VA_ARGS__)
-#define LOG_DEBUG(cat, ...) ::logging::Log::log(::config::LogLevel::Debug, (cat), __VA_ARGS__)
-#define LOG_TRACE(cat, ...) ::logging::Log::log(::config::LogLevel::Trace, (cat), __VA_ARGS__)
+// Arguments are only evaluated when the level is enabled. Lines of one thread
+// come out in the order it logged them; the logger drains each thread's ring
+// in turn, so lines of different threads are not sorted by timestamp.
+#define LOG_AT_(level, cat, ...)                                                                                       \
+    (static_cast<void>(sizeof(::logging::detail::check_format(__VA_ARGS__))),                                         \
+     ::logging::Log::enabled(level) ? ::logging::Log::write((level), (cat), __VA_ARGS__) : static_cast<void>(0))
+
+#define LOG_ERROR(cat, ...) LOG_AT_(::config::LogLevel::Error, (cat), __VA_ARGS__)
+#define LOG_WARN(cat, ...)  LOG_AT_(::config::LogLevel::Warn,  (cat), __VA_ARGS__)
+#define LOG_INFO(cat, ...)  LOG_AT_(::config::LogLevel::Info,  (cat), __VA_ARGS__)
+#define LOG_DEBUG(cat, ...) LOG_AT_(::config::LogLevel::Debug, (cat), __VA_ARGS__)
+#define LOG_TRACE(cat, ...) LOG_AT_(::config::LogLevel::Trace, (cat), __VA_ARGS__)
 
 #define LOG_GUARD(expr, cat, ...)                                                                                      \
     do {                                                                                                                \
@@ -2,6 +2,7 @@
 #include <csignal>
 #include <cstdio>
 #include <chrono>
+#include <cstdint>
 #include <exception>
 #include <memory>
 #include <string>
@@ -11,11 +12,18 @@
 
 #include "adapters/binance/BinanceRestClient.hpp"
 #include "adapters/binance/BinanceWsClient.hpp"
+#include "adapters/binance/ShardedKlineFeed.hpp"
+#include "adapters/columnar/ColumnarCandleRepo.hpp"
 #include "adapters/duckdb/DuckCandleRepo.hpp"
 #include "adapters/duckdb/DuckStore.hpp"
 #include "adapters/legacy/LegacyCandleRepo.hpp"
+#include "adapters/replay/KlineRecording.hpp"
+#include "adapters/replay/ReplayKlineFeed.hpp"
+#include "adapters/replay/ReplayKlines.hpp"
 #include "app/BackfillWorker.hpp"
 #include "app/LiveIngestor.hpp"
+#include "app/TradeAggregator.hpp"
+#include "app/TradeIngestor.hpp"
 #include "api/Controllers.hpp"
 #include "api/HttpServer.hpp"
 #include "api/WebSocketServer.hpp"
@@ -42,6 +50,38 @@ std::string joinList(const std::vector<std::string>& values) {
     return joined;
 }
 
+#if defined(HAS_DUCKDB)
+// Entre dos pasadas de congelado/tiering con el servicio en marcha.
+constexpr auto kPartitionMaintenancePeriod = std::chrono::hours(1);
+
+// Mueve a Parquet y congela las particiones más antiguas que los límites
+// configurados. Devuelve cuántas particiones cambiaron.
+std::size_t maintainPartitions(const ttp::common::Config& config, adapters::duckdb::DuckStore& store) {
+    constexpr std::int64_t kMillisPerDay = 86'400'000LL;
+    const auto nowMs = static_cast<std::int64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count());
+    std::size_t changed = 0;
+    if (config.duckdbColdAfterDays > 0) {
+        const auto tiered = store.tierColdPartitions(
+            nowMs - static_cast<std::int64_t>(config.duckdbColdAfterDays) * kMillisPerDay, config.duckdbColdDir);
+        if (tiered > 0) {
+            LOG_INFO("Particiones DuckDB movidas a Parquet: " << tiered << " -> " << config.duckdbColdDir);
+        }
+        changed += tiered;
+    }
+    if (config.duckdbFreezeAfterDays > 0) {
+        const auto frozen = store.freezePartitions(
+            nowMs - static_cast<std::int64_t>(config.duckdbFreezeAfterDays) * kMillisPerDay);
+        if (frozen > 0) {
+            LOG_INFO("Particiones DuckDB congeladas: " << frozen);
+        }
+        changed += frozen;
+    }
+    return changed;
+}
+#endif
+
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -73,6 +113,10 @@ int main(int argc, char** argv) {
         LOG_INFO("  Nivel de log: " << ttp::log::levelToString(config.logLevel));
         LOG_INFO("  Hilos de trabajo: " << config.threads);
         LOG_INFO("  Storage: " << config.storage);
+        if (config.storage == "duck") {
+            LOG_INFO("  DuckDB particionado: " << config.duckdbPartition
+                     << " (congelar tras " << config.duckdbFreezeAfterDays << " días)");
+        }
         LOG_INFO("  WS ping period: " << config.wsPingPeriodMs << " ms");
         LOG_INFO("  WS pong timeout: " << config.wsPongTimeoutMs << " ms");
         LOG_INFO("  WS send queue max msgs: " << config.wsSendQueueMaxMsgs);
@@ -88,11 +132,20 @@ int main(int argc, char** argv) {
 
         std::shared_ptr<adapters::duckdb::DuckCandleRepo> duckRepo;
         std::shared_ptr<const domain::contracts::ICandleReadRepo> repo;
+#if defined(HAS_DUCKDB)
+        const auto partitionGranularity =
+            adapters::duckdb::partitionGranularityFromString(config.duckdbPartition)
+                .value_or(adapters::duckdb::PartitionGranularity::Month);
+#endif
         if (config.storage == "duck") {
 #if defined(HAS_DUCKDB)
             try {
-                adapters::duckdb::DuckStore store(config.duckdbPath);
+                adapters::duckdb::DuckStore store(config.duckdbPath, partitionGranularity);
                 store.migrate();
+                // Backfill rewrites old history; freezing or tiering first would only force thaws.
+                if (!config.backfill) {
+                    maintainPartitions(config, store);
+                }
             } catch (const std::exception& ex) {
                 LOG_WARN("No se pudieron aplicar migraciones DuckDB: " << ex.what());
             }
@@ -100,10 +153,18 @@ int main(int argc, char** argv) {
             if (config.backfill) {
                 app::BackfillWorker worker(config);
                 worker.run();
+                // Lo recién descargado que ya supera los límites se congela o se mueve ahora.
+                try {
+                    adapters::duckdb::DuckStore store(config.duckdbPath, partitionGranularity);
+                    maintainPartitions(config, store);
+                } catch (const std::exception& ex) {
+                    LOG_WARN("No se pudo congelar/mover particiones tras el backfill: " << ex.what());
+                }
                 LOG_INFO("Backfill finalizado, cerrando proceso");
                 return EXIT_SUCCESS;
             }
-            duckRepo = std::make_shared<adapters::duckdb::DuckCandleRepo>(config.duckdbPath);
+            duckRepo = std::make_shared<adapters::duckdb::DuckCandleRepo>(config.duckdbPath,
+                                                                          partitionGranularity);
             repo = duckRepo;
             LOG_INFO("Repositorio de velas: DuckDB -> " << config.duckdbPath);
 #else
@@ -114,6 +175,18 @@ int main(int argc, char** argv) {
             LOG_WARN("DuckDB solicitado pero no disponible en esta build; usando backend legacy");
             repo = std::make_shared<adapters::legacy::LegacyCandleRepo>();
 #endif
+        } else if (config.storage == "columnar") {
+            if (config.backfill) {
+                LOG_ERR("Backfill no soportado para storage='" << config.storage << "'");
+                return EXIT_FAILURE;
+            }
+            auto columnarRepo = std::make_shared<adapters::columnar::ColumnarCandleRepo>(config.columnarDir);
+            const auto imported = columnarRepo->importLegacyDatasets({"./cache", "./data"});
+            if (imported > 0) {
+                LOG_INFO("Datasets legacy importados a columnar: " << imported);
+            }
+            repo = std::move(columnarRepo);
+            LOG_INFO("Repositorio de velas: Columnar -> " << config.columnarDir);
         } else {
             if (config.backfill) {
                 LOG_ERR("Backfill no soportado para storage='" << config.storage << "'");
@@ -130,7 +203,11 @@ int main(int argc, char** argv) {
         ttp::api::setCandleRepository(std::move(repo));
         ttp::api::setHttpLimits(config.httpDefaultLimit, config.httpMaxLimit);
         ttp::api::setLiveSymbols(config.liveSymbols);
-        ttp::api::setLiveIntervals(config.liveIntervals);
+        auto advertisedIntervals = config.liveIntervals;
+        advertisedIntervals.insert(advertisedIntervals.end(),
+                                   config.liveTradeIntervals.begin(),
+                                   config.liveTradeIntervals.end());
+        ttp::api::setLiveIntervals(std::move(advertisedIntervals));
 
         ttp::api::IoContext ioContext;
         ttp::api::Endpoint endpoint{"0.0.0.0", config.port};
@@ -140,6 +217,7 @@ int main(int argc, char** argv) {
         corsConfig.enabled = config.httpCorsEnable && !config.httpCorsOrigin.empty();
         corsConfig.origin = config.httpCorsOrigin;
         server.setCorsConfig(std::move(corsConfig));
+        server.setAdminToken(config.httpAdminToken);
 
         ttp::api::WebSocketServer::instance().configureKeepAlive(
             std::chrono::milliseconds(config.wsPingPeriodMs),
@@ -149,9 +227,13 @@ int main(int argc, char** argv) {
             config.wsSendQueueMaxBytes,
             std::chrono::milliseconds(config.wsStallTimeoutMs));
 
-        std::unique_ptr<adapters::binance::BinanceRestClient> liveRestClient;
-        std::unique_ptr<adapters::binance::BinanceWsClient> liveWsClient;
+        std::unique_ptr<domain::IExchangeKlines> liveRestClient;
+        std::unique_ptr<domain::IExchangeLiveKlines> liveWsClient;
+        std::shared_ptr<adapters::replay::KlineRecorder> liveRecorder;
         std::unique_ptr<app::LiveIngestor> liveIngestor;
+        std::unique_ptr<domain::IExchangeLiveTrades> tradeFeed;
+        std::shared_ptr<app::TradeAggregator> tradeAggregator;
+        std::unique_ptr<app::TradeIngestor> tradeIngestor;
 
         if (config.live) {
             domain::Interval liveInterval{};
@@ -162,15 +244,61 @@ int main(int argc, char** argv) {
                 return EXIT_FAILURE;
             }
 
-            liveRestClient = std::make_unique<adapters::binance::BinanceRestClient>();
-            liveWsClient = std::make_unique<adapters::binance::BinanceWsClient>();
-            liveIngestor = std::make_unique<app::LiveIngestor>(*duckRepo, *liveRestClient, *liveWsClient);
+            if (!config.replayPath.empty()) {
+                liveRestClient = std::make_unique<adapters::replay::ReplayKlines>(config.replayPath);
+                liveWsClient = std::make_unique<adapters::replay::ReplayKlineFeed>(
+                    config.replayPath,
+                    adapters::replay::ReplayKlineFeed::Options{config.replaySpeed, config.replayLoop});
+                LOG_INFO("Reproduciendo grabación " << config.replayPath << " (velocidad="
+                         << (config.replaySpeed > 0.0 ? std::to_string(config.replaySpeed) : std::string{"max"})
+                         << ")");
+            } else {
+                if (!config.liveRecordPath.empty()) {
+                    liveRecorder = std::make_shared<adapters::replay::KlineRecorder>(config.liveRecordPath);
+                }
+                liveRestClient = std::make_unique<adapters::binance::BinanceRestClient>(
+                    std::make_shared<adapters::binance::WeightBudget>(config.backfillWeightBudget),
+                    config.binanceRestHost);
+                liveWsClient = std::make_unique<adapters::binance::ShardedKlineFeed>(
+                    [liveRecorder]() {
+                        auto client = std::make_unique<adapters::binance::BinanceWsClient>();
+                        client->set_recorder(liveRecorder);
+                        return client;
+                    },
+                    config.liveShardSize);
+            }
+            liveIngestor = std::make_unique<app::LiveIngestor>(
+                *duckRepo, *liveRestClient, *liveWsClient, config.liveCatchUpConcurrency);
 
             const auto liveSymbols = config.liveSymbols;
             liveIngestor->run(liveSymbols, liveInterval);
 
             LOG_INFO("Ingesta en vivo habilitada: símbolos="
                      << joinList(config.liveSymbols) << ", intervalo=" << config.liveIntervals.front());
+
+            if (!config.liveTradeIntervals.empty()) {
+                std::vector<domain::Interval> tradeIntervals;
+                for (const auto& label : config.liveTradeIntervals) {
+                    tradeIntervals.push_back(domain::interval_from_label(label));
+                }
+                tradeAggregator = std::make_shared<app::TradeAggregator>(
+                    std::move(tradeIntervals), static_cast<std::int64_t>(config.liveTradeRetentionS) * 1000);
+                if (!config.replayPath.empty()) {
+                    tradeFeed = std::make_unique<adapters::replay::ReplayKlineFeed>(
+                        config.replayPath,
+                        adapters::replay::ReplayKlineFeed::Options{config.replaySpeed, config.replayLoop});
+                } else {
+                    auto tradeClient = std::make_unique<adapters::binance::BinanceWsClient>();
+                    tradeClient->set_recorder(liveRecorder);
+                    tradeFeed = std::move(tradeClient);
+                }
+                tradeIngestor = std::make_unique<app::TradeIngestor>(*duckRepo, *tradeFeed, *tradeAggregator);
+                tradeIngestor->run(liveSymbols);
+                ttp::api::setLiveCandleSource(tradeAggregator);
+
+                LOG_INFO("Velas sub-minuto desde aggTrade: intervalos=" << joinList(config.liveTradeIntervals)
+                         << ", retención=" << config.liveTradeRetentionS << "s");
+            }
         }
 
         std::signal(SIGINT, handleSignal);
@@ -179,8 +307,25 @@ int main(int argc, char** argv) {
         server.start();
         LOG_INFO("Servidor en marcha. Esperando solicitudes...");
 
+#if defined(HAS_DUCKDB)
+        // Las particiones envejecen con el servicio en marcha: se repasan cada hora.
+        auto nextMaintenance = std::chrono::steady_clock::now() + kPartitionMaintenancePeriod;
+#endif
         while (gSignalStatus == 0) {
             std::this_thread::sleep_for(std::chrono::milliseconds(200));
+#if defined(HAS_DUCKDB)
+            if (duckRepo && std::chrono::steady_clock::now() >= nextMaintenance) {
+                nextMaintenance = std::chrono::steady_clock::now() + kPartitionMaintenancePeriod;
+                try {
+                    adapters::duckdb::DuckStore store(config.duckdbPath, partitionGranularity);
+                    if (maintainPartitions(config, store) > 0) {
+                        duckRepo->forgetWritablePartitions();
+                    }
+                } catch (const std::exception& ex) {
+                    LOG_WARN("No se pudo congelar/mover particiones DuckDB: " << ex.what());
+                }
+            }
+#endif
         }
 
         LOG_INFO("Señal " << gSignalStatus << " recibida, deteniendo servicios...");
@@ -189,6 +334,9 @@ int main(int argc, char** argv) {
         if (liveIngestor) {
             liveIngestor->stop();
         }
+        if (tradeIngestor) {
+            tradeIngestor->stop();
+        }
 
         server.stop();
 
@@ -197,12 +345,17 @@ int main(int argc, char** argv) {
         if (liveIngestor) {
             liveIngestor.reset();
         }
+        ttp::api::setLiveCandleSource(nullptr);
+        tradeIngestor.reset();
+        tradeFeed.reset();
+        tradeAggregator.reset();
         if (liveWsClient) {
             liveWsClient.reset();
         }
         if (liveRestClient) {
             liveRestClient.reset();
         }
+        liveRecorder.reset();
         if (duckRepo) {
             ttp::api::setCandleRepository(nullptr);
             duckRepo.reset();
@@ -0,0 +1,1279 @@
+// Load generator for a local server: HTTP pollers on an arrival schedule plus
+// idle WebSocket viewers.
+//
+//   make loadgen
+//   ./bin/loadgen --port 8080 --rate 400 --connections 32 --duration 30
+//       --mix candles=80,search=15,symbols=5 --burst search:50@5 --ws-viewers 2000
+//
+// Requests arrive at --rate per second (evenly spaced, or --arrival poisson)
+// and wait for one of --connections to be free. Latency is measured from the
+// time a request was due, not from when a connection picked it up, so a
+// stalled server is charged for the requests that queued behind it
+// (coordinated omission). The time from actual send to response is reported
+// separately as service time. --rate 0 runs closed-loop: every connection
+// sends its next request as soon as the previous one completes.
+//
+// WS viewers connect at --ws-connect-rate per second and only answer pings.
+// Delivery lag is measured on final candles, from the candle's close time
+// (open + interval, wall clock) to each viewer receiving it; it covers the
+// exchange, ingest and fan-out. Candles replayed by a resync after a
+// reconnect arrive late by design and show up in its tail. Fan-out spread is
+// the time between the first and each later viewer receiving the same
+// broadcast, for every broadcast.
+//
+// Only loopback targets are accepted. A summary goes to stderr and one JSON
+// line to stdout.
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "common/Metrics.hpp"
+
+namespace {
+
+using ttp::common::metrics::LatencyHistogram;
+
+enum class RequestKind : std::size_t { Candles, Indicators, Symbols, Search, Intervals, Healthz };
+constexpr std::size_t kKindCount = 6;
+constexpr std::array<const char*, kKindCount> kKindNames = {
+    "candles", "indicators", "symbols", "search", "intervals", "healthz"};
+constexpr std::array<const char*, 4> kIndicatorTypes = {"ema", "rsi", "macd", "bbands"};
+
+constexpr std::int64_t kNsPerMs = 1'000'000;
+constexpr std::int64_t kNsPerSecond = 1'000'000'000;
+// Upper bound between two passes over the slots (timeouts, retries).
+constexpr std::int64_t kTickNs = 10 * kNsPerMs;
+// A failed connection waits this long before its slot is used again.
+constexpr std::int64_t kRetryBackoffNs = 10 * kNsPerMs;
+// Broadcasts are matched across viewers for this long.
+constexpr std::int64_t kFanoutWindowNs = 10 * kNsPerSecond;
+constexpr std::size_t kMaxQueuedArrivals = 1'000'000;
+constexpr std::size_t kReadChunk = 64 * 1024;
+
+constexpr std::uint64_t kTagTimer = 0;
+constexpr std::uint64_t kTagHttp = 1;
+constexpr std::uint64_t kTagWs = 2;
+
+std::int64_t nowNs() {
+    timespec ts{};
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * kNsPerSecond + ts.tv_nsec;
+}
+
+// Candle times in broadcasts are epoch milliseconds.
+std::int64_t wallNowNs() {
+    timespec ts{};
+    ::clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * kNsPerSecond + ts.tv_nsec;
+}
+
+std::uint64_t epollKey(std::uint64_t tag, std::size_t index) {
+    return (tag << 32U) | static_cast<std::uint64_t>(index);
+}
+
+std::vector<std::string> splitList(std::string_view text, char separator) {
+    std::vector<std::string> items;
+    std::size_t start = 0;
+    while (start <= text.size()) {
+        const auto end = std::min(text.find(separator, start), text.size());
+        if (end > start) {
+            items.emplace_back(text.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+    return items;
+}
+
+std::optional<RequestKind> kindFromName(std::string_view name) {
+    for (std::size_t i = 0; i < kKindCount; ++i) {
+        if (name == kKindNames[i]) {
+            return static_cast<RequestKind>(i);
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<double> parseNumber(const std::string& text) {
+    if (text.empty()) {
+        return std::nullopt;
+    }
+    char* end = nullptr;
+    const double value = std::strtod(text.c_str(), &end);
+    if (end == nullptr || *end != '\0' || !(value >= 0.0)) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+struct Burst {
+    RequestKind kind{RequestKind::Search};
+    std::size_t size{0};
+    std::int64_t periodNs{0};
+};
+
+struct Options {
+    std::string host{"127.0.0.1"};
+    std::string port{"8080"};
+    double durationS{30.0};
+    double warmupS{0.0};
+    // Requests per second across all connections; 0 = closed loop.
+    double rate{100.0};
+    bool poisson{false};
+    std::size_t connections{16};
+    std::size_t threads{1};
+    std::array<double, kKindCount> mix{100.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    std::vector<std::string> symbols{"BTCUSDT"};
+    std::vector<std::string> intervals{"1m"};
+    int limit{500};
+    std::optional<Burst> burst;
+    std::size_t wsViewers{0};
+    double wsConnectRate{500.0};
+    std::int64_t timeoutMs{5000};
+};
+
+void printUsage(const char* program) {
+    std::fprintf(stderr,
+                 "usage: %s [options]\n"
+                 "  --host 127.0.0.1         loopback address of the server\n"
+                 "  --port 8080\n"
+                 "  --duration 30            seconds of load\n"
+                 "  --warmup 0               leading seconds left out of the results\n"
+                 "  --rate 100               requests/s in total; 0 = closed loop\n"
+                 "  --arrival constant       constant | poisson\n"
+                 "  --connections 16         concurrent HTTP connections\n"
+                 "  --threads 1              event loops; connections and viewers are split\n"
+                 "  --mix candles=100        weights over candles, indicators, symbols,\n"
+                 "                           search, intervals, healthz\n"
+                 "  --symbols BTCUSDT        comma-separated; also the search prefixes\n"
+                 "  --intervals 1m           comma-separated\n"
+                 "  --limit 500              limit= of candles and indicators requests\n"
+                 "  --burst KIND:N@S         N extra requests of KIND at once every S seconds\n"
+                 "  --ws-viewers 0           idle WebSocket viewers on /ws\n"
+                 "  --ws-connect-rate 500    viewer connections opened per second\n"
+                 "  --timeout-ms 5000        per request\n",
+                 program);
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            return false;
+        }
+        if (arg.rfind("--", 0) != 0) {
+            std::fprintf(stderr, "unexpected argument: %s\n", arg.c_str());
+            return false;
+        }
+        std::string key;
+        std::string value;
+        const auto eq = arg.find('=');
+        if (eq != std::string::npos) {
+            key = arg.substr(2, eq - 2);
+            value = arg.substr(eq + 1);
+        }
+        else {
+            key = arg.substr(2);
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "missing value for --%s\n", key.c_str());
+                return false;
+            }
+            value = argv[++i];
+        }
+
+        const auto number = parseNumber(value);
+        bool valid = true;
+        if (key == "host") {
+            options.host = value;
+        }
+        else if (key == "port") {
+            options.port = value;
+        }
+        else if (key == "duration") {
+            valid = number && *number > 0.0;
+            options.durationS = number.value_or(0.0);
+        }
+        else if (key == "warmup") {
+            valid = number.has_value();
+            options.warmupS = number.value_or(0.0);
+        }
+        else if (key == "rate") {
+            valid = number.has_value();
+            options.rate = number.value_or(0.0);
+        }
+        else if (key == "arrival") {
+            valid = value == "constant" || value == "poisson";
+            options.poisson = value == "poisson";
+        }
+        else if (key == "connections") {
+            valid = number && *number >= 1.0;
+            options.connections = static_cast<std::size_t>(number.value_or(0.0));
+        }
+        else if (key == "threads") {
+            valid = number && *number >= 1.0;
+            options.threads = static_cast<std::size_t>(number.value_or(0.0));
+        }
+        else if (key == "mix") {
+            options.mix.fill(0.0);
+            double total = 0.0;
+            for (const auto& item : splitList(value, ',')) {
+                const auto sep = item.find('=');
+                const auto kind = kindFromName(std::string_view(item).substr(0, sep));
+                const auto weight = sep == std::string::npos ? std::optional<double>{1.0}
+                                                             : parseNumber(item.substr(sep + 1));
+                if (!kind || !weight) {
+                    valid = false;
+                    break;
+                }
+                options.mix[static_cast<std::size_t>(*kind)] = *weight;
+                total += *weight;
+            }
+            valid = valid && total > 0.0;
+        }
+        else if (key == "symbols") {
+            options.symbols = splitList(value, ',');
+            valid = !options.symbols.empty();
+        }
+        else if (key == "intervals") {
+            options.intervals = splitList(value, ',');
+            valid = !options.intervals.empty();
+        }
+        else if (key == "limit") {
+            valid = number && *number >= 1.0;
+            options.limit = static_cast<int>(number.value_or(0.0));
+        }
+        else if (key == "burst") {
+            const auto colon = value.find(':');
+            const auto at = value.find('@');
+            valid = colon != std::string::npos && at != std::string::npos && colon < at;
+            if (valid) {
+                const auto kind = kindFromName(std::string_view(value).substr(0, colon));
+                const auto size = parseNumber(value.substr(colon + 1, at - colon - 1));
+                const auto period = parseNumber(value.substr(at + 1));
+                valid = kind && size && *size >= 1.0 && period && *period > 0.0;
+                if (valid) {
+                    options.burst = Burst{*kind,
+                                          static_cast<std::size_t>(*size),
+                                          static_cast<std::int64_t>(*period * static_cast<double>(kNsPerSecond))};
+                }
+            }
+        }
+        else if (key == "ws-viewers") {
+            valid = number.has_value();
+            options.wsViewers = static_cast<std::size_t>(number.value_or(0.0));
+        }
+        else if (key == "ws-connect-rate") {
+            valid = number && *number > 0.0;
+            options.wsConnectRate = number.value_or(0.0);
+        }
+        else if (key == "timeout-ms") {
+            valid = number && *number >= 1.0;
+            options.timeoutMs = static_cast<std::int64_t>(number.value_or(0.0));
+        }
+        else {
+            std::fprintf(stderr, "unknown option --%s\n", key.c_str());
+            return false;
+        }
+        if (!valid) {
+            std::fprintf(stderr, "invalid value for --%s: %s\n", key.c_str(), value.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool isLoopback(const sockaddr_storage& address) {
+    if (address.ss_family == AF_INET) {
+        const auto* in = reinterpret_cast<const sockaddr_in*>(&address);
+        return (ntohl(in->sin_addr.s_addr) >> 24U) == 127U;
+    }
+    if (address.ss_family == AF_INET6) {
+        const auto* in6 = reinterpret_cast<const sockaddr_in6*>(&address);
+        return IN6_IS_ADDR_LOOPBACK(&in6->sin6_addr) != 0;
+    }
+    return false;
+}
+
+void atomicMax(std::atomic<std::uint64_t>& target, std::uint64_t value) {
+    auto current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+std::uint64_t toUs(std::int64_t ns) {
+    return ns > 0 ? static_cast<std::uint64_t>(ns / 1000) : 0U;
+}
+
+std::uint64_t fnv1a(std::string_view data) {
+    std::uint64_t hash = 1469598103934665603ULL;
+    for (const char ch : data) {
+        hash ^= static_cast<unsigned char>(ch);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Close time in ms of a final candle broadcast:
+//   {"type":"candle",...,"interval":"1m","final":true,"data":[openMs,o,h,l,c,v]}
+std::optional<std::int64_t> finalCandleCloseMs(std::string_view payload) {
+    constexpr std::string_view kIntervalKey = "\"interval\":\"";
+    constexpr std::string_view kDataKey = "\"data\":[";
+    if (payload.find("\"type\":\"candle\"") == std::string_view::npos
+        || payload.find("\"final\":true") == std::string_view::npos) {
+        return std::nullopt;
+    }
+    const auto intervalPos = payload.find(kIntervalKey);
+    const auto dataPos = payload.find(kDataKey);
+    if (intervalPos == std::string_view::npos || dataPos == std::string_view::npos) {
+        return std::nullopt;
+    }
+
+    const char* cursor = payload.data() + intervalPos + kIntervalKey.size();
+    char* end = nullptr;
+    const long long count = std::strtoll(cursor, &end, 10);
+    std::int64_t unitMs = 0;
+    switch (end != nullptr ? *end : '\0') {
+    case 's': unitMs = 1'000; break;
+    case 'm': unitMs = 60'000; break;
+    case 'h': unitMs = 3'600'000; break;
+    case 'd': unitMs = 86'400'000; break;
+    case 'w': unitMs = 604'800'000; break;
+    default: return std::nullopt;
+    }
+
+    const long long openMs = std::strtoll(payload.data() + dataPos + kDataKey.size(), &end, 10);
+    if (count <= 0 || openMs <= 0 || end == nullptr || *end != ',') {
+        return std::nullopt;
+    }
+    return static_cast<std::int64_t>(openMs) + static_cast<std::int64_t>(count) * unitMs;
+}
+
+// A histogram plus the exact largest sample recorded into it.
+struct Latencies {
+    LatencyHistogram histogram;
+    std::atomic<std::uint64_t> maxUs{0};
+
+    void record(std::uint64_t us) {
+        histogram.recordUs(us);
+        atomicMax(maxUs, us);
+    }
+};
+
+struct KindStats {
+    Latencies latency;
+    std::atomic<std::uint64_t> count{0};
+};
+
+// Shared by all workers; histograms and counters are safe to update concurrently.
+struct Stats {
+    Latencies latency;
+    Latencies service;
+    std::array<KindStats, kKindCount> kinds;
+    std::atomic<std::uint64_t> completed{0};
+    std::atomic<std::uint64_t> status2xx{0};
+    std::atomic<std::uint64_t> status4xx{0};
+    std::atomic<std::uint64_t> status5xx{0};
+    std::atomic<std::uint64_t> statusOther{0};
+    std::atomic<std::uint64_t> errors{0};
+    std::atomic<std::uint64_t> timeouts{0};
+    std::atomic<std::uint64_t> unfinished{0};
+    std::atomic<std::uint64_t> bytes{0};
+
+    Latencies wsLag;
+    Latencies wsSpread;
+    std::atomic<std::uint64_t> wsOpen{0};
+    std::atomic<std::uint64_t> wsFailed{0};
+    std::atomic<std::uint64_t> wsClosed{0};
+    std::atomic<std::uint64_t> wsMessages{0};
+    std::atomic<std::uint64_t> wsPings{0};
+};
+
+// First arrival of each broadcast payload across all viewers.
+class FanoutClock {
+public:
+    std::int64_t spreadNs(std::uint64_t key, std::int64_t now) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (now >= nextPruneNs_) {
+            for (auto it = firstSeen_.begin(); it != firstSeen_.end();) {
+                it = now - it->second > kFanoutWindowNs ? firstSeen_.erase(it) : std::next(it);
+            }
+            nextPruneNs_ = now + kNsPerSecond;
+        }
+        const auto [it, inserted] = firstSeen_.emplace(key, now);
+        return inserted ? 0 : std::max<std::int64_t>(0, now - it->second);
+    }
+
+private:
+    std::mutex mutex_;
+    std::unordered_map<std::uint64_t, std::int64_t> firstSeen_;
+    std::int64_t nextPruneNs_{0};
+};
+
+struct Arrival {
+    std::int64_t dueNs{0};
+    RequestKind kind{RequestKind::Candles};
+};
+
+struct HttpSlot {
+    enum class State { Idle, Connecting, Writing, Reading };
+
+    int fd{-1};
+    State state{State::Idle};
+    std::int64_t readyNs{0};
+    Arrival arrival;
+    std::int64_t sentNs{0};
+    bool reused{false};
+    std::string request;
+    std::size_t written{0};
+    std::string header;
+    bool headerDone{false};
+    int status{0};
+    bool keepAlive{false};
+    bool untilClose{false};
+    std::size_t bodyRemaining{0};
+    std::size_t received{0};
+};
+
+struct WsViewer {
+    enum class State { Waiting, Connecting, Handshake, Open, Done };
+
+    int fd{-1};
+    State state{State::Waiting};
+    std::string input;
+    std::string output;
+};
+
+class Worker {
+public:
+    Worker(const Options& options,
+           const sockaddr_storage& address,
+           socklen_t addressLength,
+           std::size_t index,
+           std::size_t connections,
+           std::size_t viewers,
+           Stats& stats,
+           FanoutClock& fanout,
+           std::int64_t startNs)
+        : options_(options),
+          address_(address),
+          addressLength_(addressLength),
+          index_(index),
+          stats_(stats),
+          fanout_(fanout),
+          startNs_(startNs),
+          measureNs_(startNs + static_cast<std::int64_t>(options.warmupS * static_cast<double>(kNsPerSecond))),
+          endNs_(startNs + static_cast<std::int64_t>(options.durationS * static_cast<double>(kNsPerSecond))),
+          slots_(connections),
+          viewers_(viewers),
+          rng_(0x5eed + index),
+          kindPicker_(options.mix.begin(), options.mix.end()) {
+        const auto threads = static_cast<double>(options.threads);
+        if (options.rate > 0.0) {
+            meanGapNs_ = static_cast<double>(kNsPerSecond) * threads / options.rate;
+            nextArrivalNs_ = startNs + static_cast<std::int64_t>(meanGapNs_ * static_cast<double>(index) / threads);
+        }
+        if (options.burst) {
+            // Each worker sends its share of every burst.
+            const auto& burst = *options.burst;
+            burstShare_ = burst.size / options.threads + (index < burst.size % options.threads ? 1U : 0U);
+            nextBurstNs_ = startNs + burst.periodNs;
+        }
+        viewerGapNs_ = static_cast<std::int64_t>(static_cast<double>(kNsPerSecond) * threads / options.wsConnectRate);
+        nextViewerNs_ = startNs;
+        hostHeader_ = options.host + ":" + options.port;
+    }
+
+    void run() {
+        epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        timerFd_ = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (epollFd_ < 0 || timerFd_ < 0) {
+            std::fprintf(stderr, "worker %zu: epoll/timerfd setup failed: %s\n", index_, std::strerror(errno));
+            return;
+        }
+        epoll_event timerEvent{};
+        timerEvent.events = EPOLLIN;
+        timerEvent.data.u64 = epollKey(kTagTimer, 0);
+        ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, timerFd_, &timerEvent);
+
+        std::vector<epoll_event> events(256);
+        std::vector<char> chunk(kReadChunk);
+        while (true) {
+            const auto now = nowNs();
+            if (now >= endNs_) {
+                break;
+            }
+            enqueueArrivals_(now);
+            dispatch_(now);
+            openViewers_(now);
+            expireRequests_(now);
+            armTimer_(now);
+
+            const int ready = ::epoll_wait(epollFd_, events.data(), static_cast<int>(events.size()), -1);
+            for (int i = 0; i < ready; ++i) {
+                const auto& event = events[static_cast<std::size_t>(i)];
+                const auto tag = event.data.u64 >> 32U;
+                const auto slot = static_cast<std::size_t>(event.data.u64 & 0xFFFFFFFFULL);
+                if (tag == kTagTimer) {
+                    std::uint64_t expirations = 0;
+                    [[maybe_unused]] const auto n = ::read(timerFd_, &expirations, sizeof(expirations));
+                }
+                else if (tag == kTagHttp) {
+                    onHttpEvent_(slots_[slot], event.events, chunk);
+                }
+                else if (tag == kTagWs) {
+                    onWsEvent_(viewers_[slot], event.events, chunk);
+                }
+            }
+        }
+
+        // Requests still queued or in flight at the end were due inside the
+        // window but never answered; they are reported, not dropped silently.
+        std::uint64_t unfinished = 0;
+        for (const auto& arrival : queue_) {
+            unfinished += arrival.dueNs >= measureNs_ ? 1U : 0U;
+        }
+        for (auto& slot : slots_) {
+            if (slot.state != HttpSlot::State::Idle && slot.arrival.dueNs >= measureNs_) {
+                ++unfinished;
+            }
+            closeFd_(slot.fd);
+        }
+        stats_.unfinished.fetch_add(unfinished, std::memory_order_relaxed);
+        for (auto& viewer : viewers_) {
+            closeFd_(viewer.fd);
+        }
+        ::close(timerFd_);
+        ::close(epollFd_);
+    }
+
+private:
+    static void closeFd_(int& fd) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    int connect_() {
+        const int fd = ::socket(address_.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            return -1;
+        }
+        const int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if (::connect(fd, reinterpret_cast<const sockaddr*>(&address_), addressLength_) != 0 && errno != EINPROGRESS) {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    void watch_(int fd, std::uint64_t key, std::uint32_t events, bool add) {
+        epoll_event event{};
+        event.events = events;
+        event.data.u64 = key;
+        ::epoll_ctl(epollFd_, add ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &event);
+    }
+
+    RequestKind pickKind_() { return static_cast<RequestKind>(kindPicker_(rng_)); }
+
+    void enqueueArrivals_(std::int64_t now) {
+        if (meanGapNs_ > 0.0) {
+            std::exponential_distribution<double> gap(1.0 / meanGapNs_);
+            while (nextArrivalNs_ <= now) {
+                if (queue_.size() < kMaxQueuedArrivals) {
+                    queue_.push_back(Arrival{nextArrivalNs_, pickKind_()});
+                }
+                else if (nextArrivalNs_ >= measureNs_) {
+                    stats_.unfinished.fetch_add(1, std::memory_order_relaxed);
+                }
+                nextArrivalNs_ += static_cast<std::int64_t>(options_.poisson ? gap(rng_) : meanGapNs_);
+            }
+        }
+        if (burstShare_ > 0) {
+            while (nextBurstNs_ <= now) {
+                for (std::size_t i = 0; i < burstShare_; ++i) {
+                    queue_.push_back(Arrival{nextBurstNs_, options_.burst->kind});
+                }
+                nextBurstNs_ += options_.burst->periodNs;
+            }
+        }
+    }
+
+    void dispatch_(std::int64_t now) {
+        for (std::size_t i = 0; i < slots_.size(); ++i) {
+            auto& slot = slots_[i];
+            if (slot.state != HttpSlot::State::Idle || now < slot.readyNs) {
+                continue;
+            }
+            Arrival arrival;
+            if (!queue_.empty()) {
+                arrival = queue_.front();
+                queue_.pop_front();
+            }
+            else if (meanGapNs_ <= 0.0) {
+                arrival = Arrival{now, pickKind_()};
+            }
+            else {
+                break;
+            }
+            start_(slot, i, arrival, now);
+        }
+    }
+
+    std::string target_(RequestKind kind) {
+        const auto& symbol = options_.symbols[counter_ % options_.symbols.size()];
+        const auto& interval = options_.intervals[(counter_ / options_.symbols.size()) % options_.intervals.size()];
+        ++counter_;
+        const auto limit = std::to_string(options_.limit);
+        switch (kind) {
+        case RequestKind::Candles:
+            return "/api/v1/candles?symbol=" + symbol + "&interval=" + interval + "&limit=" + limit;
+        case RequestKind::Indicators:
+            return "/api/v1/indicators?symbol=" + symbol + "&interval=" + interval + "&type="
+                + kIndicatorTypes[counter_ % kIndicatorTypes.size()] + "&limit=" + limit;
+        case RequestKind::Symbols:
+            return "/api/v1/symbols";
+        case RequestKind::Search:
+            return "/api/v1/symbols?q=" + symbol.substr(0, 1 + counter_ % 3);
+        case RequestKind::Intervals:
+            return "/api/v1/intervals?symbol=" + symbol;
+        case RequestKind::Healthz:
+            return "/healthz";
+        }
+        return "/healthz";
+    }
+
+    void start_(HttpSlot& slot, std::size_t index, const Arrival& arrival, std::int64_t now) {
+        slot.arrival = arrival;
+        slot.sentNs = now;
+        slot.request = "GET " + target_(arrival.kind) + " HTTP/1.1\r\nHost: " + hostHeader_
+            + "\r\nUser-Agent: ttp-loadgen\r\nAccept: application/json\r\n\r\n";
+        send_(slot, index);
+    }
+
+    // (Re)sends slot.request, reusing the kept-alive connection when there is one.
+    void send_(HttpSlot& slot, std::size_t index) {
+        slot.written = 0;
+        slot.header.clear();
+        slot.headerDone = false;
+        slot.status = 0;
+        slot.keepAlive = false;
+        slot.untilClose = false;
+        slot.bodyRemaining = 0;
+        slot.received = 0;
+        slot.reused = slot.fd >= 0;
+        if (slot.fd >= 0) {
+            slot.state = HttpSlot::State::Writing;
+            watch_(slot.fd, epollKey(kTagHttp, index), EPOLLOUT, false);
+            return;
+        }
+        slot.fd = connect_();
+        if (slot.fd < 0) {
+            fail_(slot, nowNs());
+            return;
+        }
+        slot.state = HttpSlot::State::Connecting;
+        watch_(slot.fd, epollKey(kTagHttp, index), EPOLLOUT, true);
+    }
+
+    void onHttpEvent_(HttpSlot& slot, std::uint32_t events, std::vector<char>& chunk) {
+        const auto index = static_cast<std::size_t>(&slot - slots_.data());
+        switch (slot.state) {
+        case HttpSlot::State::Idle:
+            // The server closed a kept-alive connection between requests.
+            closeFd_(slot.fd);
+            return;
+        case HttpSlot::State::Connecting: {
+            int error = 0;
+            socklen_t length = sizeof(error);
+            ::getsockopt(slot.fd, SOL_SOCKET, SO_ERROR, &error, &length);
+            if (error != 0 || (events & (EPOLLERR | EPOLLHUP)) != 0) {
+                fail_(slot, nowNs());
+                return;
+            }
+            slot.state = HttpSlot::State::Writing;
+            [[fallthrough]];
+        }
+        case HttpSlot::State::Writing: {
+            while (slot.written < slot.request.size()) {
+                const auto n = ::send(slot.fd,
+                                      slot.request.data() + slot.written,
+                                      slot.request.size() - slot.written,
+                                      MSG_NOSIGNAL);
+                if (n < 0 && errno == EAGAIN) {
+                    return;
+                }
+                if (n <= 0) {
+                    retryOrFail_(slot, index);
+                    return;
+                }
+                slot.written += static_cast<std::size_t>(n);
+            }
+            slot.state = HttpSlot::State::Reading;
+            watch_(slot.fd, epollKey(kTagHttp, index), EPOLLIN, false);
+            return;
+        }
+        case HttpSlot::State::Reading:
+            read_(slot, index, chunk);
+            return;
+        }
+    }
+
+    void read_(HttpSlot& slot, std::size_t index, std::vector<char>& chunk) {
+        while (true) {
+            const auto n = ::recv(slot.fd, chunk.data(), chunk.size(), 0);
+            if (n < 0 && errno == EAGAIN) {
+                return;
+            }
+            if (n <= 0) {
+                if (slot.headerDone && slot.untilClose) {
+                    complete_(slot, false);
+                }
+                else {
+                    retryOrFail_(slot, index);
+                }
+                return;
+            }
+            const auto size = static_cast<std::size_t>(n);
+            slot.received += size;
+            std::size_t bodyBytes = size;
+            if (!slot.headerDone) {
+                slot.header.append(chunk.data(), size);
+                const auto end = slot.header.find("\r\n\r\n");
+                if (end == std::string::npos) {
+                    continue;
+                }
+                parseHeader_(slot, end);
+                bodyBytes = slot.header.size() - end - 4;
+            }
+            if (!slot.untilClose) {
+                slot.bodyRemaining -= std::min(slot.bodyRemaining, bodyBytes);
+                if (slot.bodyRemaining == 0) {
+                    complete_(slot, slot.keepAlive);
+                    return;
+                }
+            }
+        }
+    }
+
+    static void parseHeader_(HttpSlot& slot, std::size_t end) {
+        slot.headerDone = true;
+        std::string lower = slot.header.substr(0, end + 2);
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char ch) {
+            return static_cast<char>(std::tolower(ch));
+        });
+        const auto space = lower.find(' ');
+        slot.status = space == std::string::npos ? 0 : std::atoi(lower.c_str() + space + 1);
+        slot.keepAlive = lower.rfind("http/1.1", 0) == 0 && lower.find("\r\nconnection: close\r\n") == std::string::npos;
+        const auto length = lower.find("\r\ncontent-length:");
+        if (length == std::string::npos) {
+            slot.untilClose = true;
+            slot.keepAlive = false;
+        }
+        else {
+            slot.bodyRemaining = std::strtoull(lower.c_str() + length + 17, nullptr, 10);
+        }
+    }
+
+    // A kept-alive connection the server already dropped gets one fresh retry.
+    void retryOrFail_(HttpSlot& slot, std::size_t index) {
+        const bool retry = slot.reused && slot.received == 0;
+        closeFd_(slot.fd);
+        if (retry) {
+            send_(slot, index);
+            return;
+        }
+        fail_(slot, nowNs());
+    }
+
+    void fail_(HttpSlot& slot, std::int64_t now) {
+        closeFd_(slot.fd);
+        slot.state = HttpSlot::State::Idle;
+        slot.readyNs = now + kRetryBackoffNs;
+        if (slot.arrival.dueNs >= measureNs_) {
+            stats_.errors.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void complete_(HttpSlot& slot, bool keepOpen) {
+        const auto now = nowNs();
+        if (!keepOpen) {
+            closeFd_(slot.fd);
+        }
+        slot.state = HttpSlot::State::Idle;
+        if (slot.arrival.dueNs < measureNs_) {
+            return;
+        }
+        const auto latencyUs = toUs(now - slot.arrival.dueNs);
+        stats_.latency.record(latencyUs);
+        stats_.service.record(toUs(now - slot.sentNs));
+        auto& kind = stats_.kinds[static_cast<std::size_t>(slot.arrival.kind)];
+        kind.latency.record(latencyUs);
+        kind.count.fetch_add(1, std::memory_order_relaxed);
+        stats_.completed.fetch_add(1, std::memory_order_relaxed);
+        stats_.bytes.fetch_add(slot.received, std::memory_order_relaxed);
+        auto& status = slot.status >= 200 && slot.status < 300   ? stats_.status2xx
+                       : slot.status >= 400 && slot.status < 500 ? stats_.status4xx
+                       : slot.status >= 500                      ? stats_.status5xx
+                                                                 : stats_.statusOther;
+        status.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void expireRequests_(std::int64_t now) {
+        const auto timeoutNs = options_.timeoutMs * kNsPerMs;
+        for (auto& slot : slots_) {
+            if (slot.state != HttpSlot::State::Idle && now - slot.sentNs > timeoutNs) {
+                closeFd_(slot.fd);
+                slot.state = HttpSlot::State::Idle;
+                if (slot.arrival.dueNs >= measureNs_) {
+                    stats_.timeouts.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    void openViewers_(std::int64_t now) {
+        while (nextViewer_ < viewers_.size() && nextViewerNs_ <= now) {
+            auto& viewer = viewers_[nextViewer_];
+            viewer.fd = connect_();
+            if (viewer.fd < 0) {
+                viewer.state = WsViewer::State::Done;
+                stats_.wsFailed.fetch_add(1, std::memory_order_relaxed);
+            }
+            else {
+                viewer.state = WsViewer::State::Connecting;
+                viewer.output = "GET /ws HTTP/1.1\r\nHost: " + hostHeader_
+                    + "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                      "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+                watch_(viewer.fd, epollKey(kTagWs, nextViewer_), EPOLLIN | EPOLLOUT, true);
+            }
+            ++nextViewer_;
+            nextViewerNs_ += viewerGapNs_;
+        }
+    }
+
+    void closeViewer_(WsViewer& viewer, bool failed) {
+        if (viewer.state == WsViewer::State::Open) {
+            stats_.wsOpen.fetch_sub(1, std::memory_order_relaxed);
+        }
+        auto& counter = failed ? stats_.wsFailed : stats_.wsClosed;
+        counter.fetch_add(1, std::memory_order_relaxed);
+        closeFd_(viewer.fd);
+        viewer.state = WsViewer::State::Done;
+    }
+
+    bool flush_(WsViewer& viewer, std::size_t index) {
+        while (!viewer.output.empty()) {
+            const auto n = ::send(viewer.fd, viewer.output.data(), viewer.output.size(), MSG_NOSIGNAL);
+            if (n < 0 && errno == EAGAIN) {
+                watch_(viewer.fd, epollKey(kTagWs, index), EPOLLIN | EPOLLOUT, false);
+                return true;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            viewer.output.erase(0, static_cast<std::size_t>(n));
+        }
+        watch_(viewer.fd, epollKey(kTagWs, index), EPOLLIN, false);
+        return true;
+    }
+
+    void onWsEvent_(WsViewer& viewer, std::uint32_t events, std::vector<char>& chunk) {
+        const auto index = static_cast<std::size_t>(&viewer - viewers_.data());
+        if (viewer.state == WsViewer::State::Done) {
+            return;
+        }
+        if (viewer.state == WsViewer::State::Connecting) {
+            int error = 0;
+            socklen_t length = sizeof(error);
+            ::getsockopt(viewer.fd, SOL_SOCKET, SO_ERROR, &error, &length);
+            if (error != 0) {
+                closeViewer_(viewer, true);
+                return;
+            }
+            viewer.state = WsViewer::State::Handshake;
+        }
+        if ((events & EPOLLOUT) != 0 && !flush_(viewer, index)) {
+            closeViewer_(viewer, viewer.state != WsViewer::State::Open);
+            return;
+        }
+        if ((events & (EPOLLIN | EPOLLERR | EPOLLHUP)) == 0) {
+            return;
+        }
+
+        while (true) {
+            const auto n = ::recv(viewer.fd, chunk.data(), chunk.size(), 0);
+            if (n < 0 && errno == EAGAIN) {
+                break;
+            }
+            if (n <= 0) {
+                closeViewer_(viewer, viewer.state != WsViewer::State::Open);
+                return;
+            }
+            viewer.input.append(chunk.data(), static_cast<std::size_t>(n));
+        }
+
+        const auto now = nowNs();
+        if (viewer.state == WsViewer::State::Handshake) {
+            const auto end = viewer.input.find("\r\n\r\n");
+            if (end == std::string::npos) {
+                return;
+            }
+            if (viewer.input.compare(0, 12, "HTTP/1.1 101") != 0) {
+                closeViewer_(viewer, true);
+                return;
+            }
+            viewer.input.erase(0, end + 4);
+            viewer.state = WsViewer::State::Open;
+            stats_.wsOpen.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (!readFrames_(viewer, now) || !flush_(viewer, index)) {
+            closeViewer_(viewer, false);
+        }
+    }
+
+    // Consumes complete server frames; returns false once the server closes.
+    bool readFrames_(WsViewer& viewer, std::int64_t now) {
+        std::size_t offset = 0;
+        const auto& input = viewer.input;
+        const auto byte = [&input](std::size_t at) { return static_cast<std::uint8_t>(input[at]); };
+        bool open = true;
+        while (open && input.size() - offset >= 2) {
+            const std::uint8_t opcode = byte(offset) & 0x0FU;
+            const bool masked = (byte(offset + 1) & 0x80U) != 0;
+            std::uint64_t length = byte(offset + 1) & 0x7FU;
+            std::size_t headerSize = 2;
+            if (length == 126U || length == 127U) {
+                const std::size_t extra = length == 126U ? 2U : 8U;
+                if (input.size() - offset < 2 + extra) {
+                    break;
+                }
+                length = 0;
+                for (std::size_t i = 0; i < extra; ++i) {
+                    length = (length << 8U) | byte(offset + 2 + i);
+                }
+                headerSize += extra;
+            }
+            headerSize += masked ? 4U : 0U;
+            if (input.size() - offset < headerSize + length) {
+                break;
+            }
+            const std::string_view payload(input.data() + offset + headerSize, static_cast<std::size_t>(length));
+            switch (opcode) {
+            case 0x1:
+            case 0x2:
+                onMessage_(payload, now);
+                break;
+            case 0x8:
+                open = false;
+                break;
+            case 0x9: {
+                // Client frames must be masked; a zero key leaves the payload as is.
+                stats_.wsPings.fetch_add(1, std::memory_order_relaxed);
+                viewer.output.push_back(static_cast<char>(0x8AU));
+                viewer.output.push_back(static_cast<char>(0x80U | std::min<std::size_t>(payload.size(), 125U)));
+                viewer.output.append(4, '\0');
+                viewer.output.append(payload.substr(0, 125));
+                break;
+            }
+            default:
+                break;
+            }
+            offset += headerSize + static_cast<std::size_t>(length);
+        }
+        viewer.input.erase(0, offset);
+        return open;
+    }
+
+    void onMessage_(std::string_view payload, std::int64_t now) {
+        if (payload.find("\"event\":\"welcome\"") != std::string_view::npos) {
+            return;
+        }
+        stats_.wsMessages.fetch_add(1, std::memory_order_relaxed);
+        if (now < measureNs_) {
+            return;
+        }
+        stats_.wsSpread.record(toUs(fanout_.spreadNs(fnv1a(payload), now)));
+        if (const auto closeMs = finalCandleCloseMs(payload)) {
+            stats_.wsLag.record(toUs(wallNowNs() - *closeMs * kNsPerMs));
+        }
+    }
+
+    void armTimer_(std::int64_t now) {
+        std::int64_t wake = std::min(endNs_, now + kTickNs);
+        if (meanGapNs_ > 0.0) {
+            wake = std::min(wake, nextArrivalNs_);
+        }
+        if (burstShare_ > 0) {
+            wake = std::min(wake, nextBurstNs_);
+        }
+        if (nextViewer_ < viewers_.size()) {
+            wake = std::min(wake, nextViewerNs_);
+        }
+        wake = std::max(wake, now + 1);
+        itimerspec spec{};
+        spec.it_value.tv_sec = static_cast<time_t>(wake / kNsPerSecond);
+        spec.it_value.tv_nsec = static_cast<long>(wake % kNsPerSecond);
+        ::timerfd_settime(timerFd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+    }
+
+    const Options& options_;
+    sockaddr_storage address_;
+    socklen_t addressLength_;
+    std::size_t index_;
+    Stats& stats_;
+    FanoutClock& fanout_;
+    std::int64_t startNs_;
+    std::int64_t measureNs_;
+    std::int64_t endNs_;
+    std::string hostHeader_;
+
+    int epollFd_{-1};
+    int timerFd_{-1};
+    std::vector<HttpSlot> slots_;
+    std::vector<WsViewer> viewers_;
+    std::deque<Arrival> queue_;
+    std::mt19937_64 rng_;
+    std::discrete_distribution<std::size_t> kindPicker_;
+    std::size_t counter_{0};
+
+    double meanGapNs_{0.0};
+    std::int64_t nextArrivalNs_{0};
+    std::size_t burstShare_{0};
+    std::int64_t nextBurstNs_{0};
+    std::size_t nextViewer_{0};
+    std::int64_t viewerGapNs_{0};
+    std::int64_t nextViewerNs_{0};
+};
+
+struct Percentiles {
+    unsigned long long count{0};
+    double p50{0.0};
+    double p90{0.0};
+    double p99{0.0};
+    double p999{0.0};
+    double max{0.0};
+};
+
+// Quantiles are bucket midpoints and can sit above the largest sample, so
+// they are capped by the exact max of the same samples.
+Percentiles summarize(const Latencies& latencies) {
+    const auto merged = latencies.histogram.merge();
+    Percentiles result;
+    result.count = static_cast<unsigned long long>(merged.count);
+    result.max = static_cast<double>(latencies.maxUs.load()) / 1000.0;
+    const auto quantile = [&](double q) { return std::min(merged.quantileMs(q).value_or(0.0), result.max); };
+    result.p50 = quantile(0.50);
+    result.p90 = quantile(0.90);
+    result.p99 = quantile(0.99);
+    result.p999 = quantile(0.999);
+    return result;
+}
+
+std::string percentilesJson(const Latencies& latencies) {
+    const auto summary = summarize(latencies);
+    char buffer[256];
+    std::snprintf(buffer,
+                  sizeof(buffer),
+                  "{\"count\":%llu,\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,\"p999\":%.3f,\"max\":%.3f}",
+                  summary.count,
+                  summary.p50,
+                  summary.p90,
+                  summary.p99,
+                  summary.p999,
+                  summary.max);
+    return buffer;
+}
+
+void printPercentiles(const char* label, const Latencies& latencies) {
+    const auto summary = summarize(latencies);
+    std::fprintf(stderr,
+                 "  %-12s n=%-9llu p50=%8.2fms p90=%8.2fms p99=%8.2fms p99.9=%8.2fms max=%8.2fms\n",
+                 label,
+                 summary.count,
+                 summary.p50,
+                 summary.p90,
+                 summary.p99,
+                 summary.p999,
+                 summary.max);
+}
+
+void raiseFileLimit() {
+    rlimit limit{};
+    if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* resolved = nullptr;
+    if (::getaddrinfo(options.host.c_str(), options.port.c_str(), &hints, &resolved) != 0 || resolved == nullptr) {
+        std::fprintf(stderr, "cannot resolve %s:%s\n", options.host.c_str(), options.port.c_str());
+        return 2;
+    }
+    sockaddr_storage address{};
+    const auto addressLength = resolved->ai_addrlen;
+    std::memcpy(&address, resolved->ai_addr, addressLength);
+    ::freeaddrinfo(resolved);
+    if (!isLoopback(address)) {
+        std::fprintf(stderr, "refusing non-loopback target %s; loadgen only drives a local instance\n", options.host.c_str());
+        return 2;
+    }
+
+    raiseFileLimit();
+    options.threads = std::min(options.threads, std::max(options.connections, options.wsViewers));
+
+    Stats stats;
+    FanoutClock fanout;
+    const auto startNs = nowNs() + 50 * kNsPerMs;
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (std::size_t i = 0; i < options.threads; ++i) {
+        const auto share = [&](std::size_t total) {
+            return total / options.threads + (i < total % options.threads ? 1U : 0U);
+        };
+        workers.push_back(std::make_unique<Worker>(
+            options, address, addressLength, i, share(options.connections), share(options.wsViewers), stats, fanout, startNs));
+    }
+
+    std::vector<std::thread> threads;
+    for (auto& worker : workers) {
+        threads.emplace_back([&worker]() { worker->run(); });
+    }
+
+    const auto endNs = startNs + static_cast<std::int64_t>(options.durationS * static_cast<double>(kNsPerSecond));
+    std::uint64_t lastCompleted = 0;
+    for (auto tick = startNs + kNsPerSecond; tick <= endNs; tick += kNsPerSecond) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(tick - nowNs()));
+        const auto completed = stats.completed.load(std::memory_order_relaxed);
+        std::fprintf(stderr,
+                     "[%3llds] rps=%-7llu errors=%llu timeouts=%llu ws_open=%llu ws_msgs=%llu\n",
+                     static_cast<long long>((tick - startNs) / kNsPerSecond),
+                     static_cast<unsigned long long>(completed - lastCompleted),
+                     static_cast<unsigned long long>(stats.errors.load(std::memory_order_relaxed)),
+                     static_cast<unsigned long long>(stats.timeouts.load(std::memory_order_relaxed)),
+                     static_cast<unsigned long long>(stats.wsOpen.load(std::memory_order_relaxed)),
+                     static_cast<unsigned long long>(stats.wsMessages.load(std::memory_order_relaxed)));
+        lastCompleted = completed;
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const double measuredS = std::max(options.durationS - options.warmupS, 1e-9);
+    const auto completed = stats.completed.load();
+    std::fprintf(stderr,
+                 "\n%llu requests in %.1fs (%.1f/s, target %.1f/s), 2xx=%llu 4xx=%llu 5xx=%llu other=%llu "
+                 "errors=%llu timeouts=%llu unfinished=%llu\n",
+                 static_cast<unsigned long long>(completed),
+                 measuredS,
+                 static_cast<double>(completed) / measuredS,
+                 options.rate,
+                 static_cast<unsigned long long>(stats.status2xx.load()),
+                 static_cast<unsigned long long>(stats.status4xx.load()),
+                 static_cast<unsigned long long>(stats.status5xx.load()),
+                 static_cast<unsigned long long>(stats.statusOther.load()),
+                 static_cast<unsigned long long>(stats.errors.load()),
+                 static_cast<unsigned long long>(stats.timeouts.load()),
+                 static_cast<unsigned long long>(stats.unfinished.load()));
+    printPercentiles("latency", stats.latency);
+    printPercentiles("service", stats.service);
+    for (std::size_t k = 0; k < kKindCount; ++k) {
+        if (stats.kinds[k].count.load() > 0) {
+            printPercentiles(kKindNames[k], stats.kinds[k].latency);
+        }
+    }
+    if (options.wsViewers > 0) {
+        std::fprintf(stderr,
+                     "ws viewers=%zu open=%llu failed=%llu closed=%llu messages=%llu pings=%llu\n",
+                     options.wsViewers,
+                     static_cast<unsigned long long>(stats.wsOpen.load()),
+                     static_cast<unsigned long long>(stats.wsFailed.load()),
+                     static_cast<unsigned long long>(stats.wsClosed.load()),
+                     static_cast<unsigned long long>(stats.wsMessages.load()),
+                     static_cast<unsigned long long>(stats.wsPings.load()));
+        printPercentiles("ws lag", stats.wsLag);
+        printPercentiles("ws spread", stats.wsSpread);
+    }
+
+    std::string kinds;
+    for (std::size_t k = 0; k < kKindCount; ++k) {
+        if (stats.kinds[k].count.load() == 0) {
+            continue;
+        }
+        kinds += kinds.empty() ? "" : ",";
+        kinds += std::string("\"") + kKindNames[k] + "\":" + percentilesJson(stats.kinds[k].latency);
+    }
+    std::printf("{\"tool\":\"loadgen\",\"duration_s\":%.1f,\"rate\":%.1f,\"arrival\":\"%s\",\"connections\":%zu,"
+                "\"requests\":%llu,\"achieved_rps\":%.1f,\"status_2xx\":%llu,\"status_4xx\":%llu,\"status_5xx\":%llu,"
+                "\"status_other\":%llu,\"errors\":%llu,\"timeouts\":%llu,\"unfinished\":%llu,\"bytes\":%llu,"
+                "\"latency_ms\":%s,\"service_ms\":%s,\"kinds\":{%s},"
+                "\"ws\":{\"viewers\":%zu,\"open\":%llu,\"failed\":%llu,\"closed\":%llu,\"messages\":%llu,\"lag_ms\":%s,"
+                "\"spread_ms\":%s}}\n",
+                measuredS,
+                options.rate,
+                options.poisson ? "poisson" : "constant",
+                options.connections,
+                static_cast<unsigned long long>(completed),
+                static_cast<double>(completed) / measuredS,
+                static_cast<unsigned long long>(stats.status2xx.load()),
+                static_cast<unsigned long long>(stats.status4xx.load()),
+                static_cast<unsigned long long>(stats.status5xx.load()),
+                static_cast<unsigned long long>(stats.statusOther.load()),
+                static_cast<unsigned long long>(stats.errors.load()),
+                static_cast<unsigned long long>(stats.timeouts.load()),
+                static_cast<unsigned long long>(stats.unfinished.load()),
+                static_cast<unsigned long long>(stats.bytes.load()),
+                percentilesJson(stats.latency).c_str(),
+                percentilesJson(stats.service).c_str(),
+                kinds.c_str(),
+                options.wsViewers,
+                static_cast<unsigned long long>(stats.wsOpen.load()),
+                static_cast<unsigned long long>(stats.wsFailed.load()),
+                static_cast<unsigned long long>(stats.wsClosed.load()),
+                static_cast<unsigned long long>(stats.wsMessages.load()),
+                percentilesJson(stats.wsLag).c_str(),
+                percentilesJson(stats.wsSpread).c_str());
+    return stats.errors.load() + stats.timeouts.load() == 0 ? 0 : 1;
+}
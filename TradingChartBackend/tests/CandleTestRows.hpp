@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "domain/Models.hpp"
+#include "domain/Types.h"
+
+namespace test_support {
+
+inline constexpr std::int64_t kMinuteMs = 60'000;
+
+// A closed flat 1m candle; `close` tells rows apart.
+inline domain::Candle makeCandle(std::int64_t openTime, double close) {
+    domain::Candle candle;
+    candle.openTime = openTime;
+    candle.closeTime = openTime + kMinuteMs - 1;
+    candle.open = close;
+    candle.high = close;
+    candle.low = close;
+    candle.close = close;
+    candle.baseVolume = 1.0;
+    candle.isClosed = true;
+    return candle;
+}
+
+struct Row {
+    std::int64_t ts;
+    double close;
+};
+
+// Checks the open times and closes of a read, printing what came back on a
+// mismatch.
+inline bool expectRows(const char* label,
+                       const std::vector<domain::contracts::Candle>& candles,
+                       const std::vector<Row>& expected) {
+    bool ok = candles.size() == expected.size();
+    for (std::size_t i = 0; ok && i < candles.size(); ++i) {
+        ok = candles[i].ts == expected[i].ts && candles[i].c == expected[i].close;
+    }
+    if (!ok) {
+        std::cerr << label << ": unexpected rows:";
+        for (const auto& candle : candles) {
+            std::cerr << ' ' << candle.ts << '=' << candle.c;
+        }
+        std::cerr << '\n';
+    }
+    return ok;
+}
+
+}  // namespace test_support
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <boost/asio/ssl/context.hpp>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+
+namespace test_support {
+
+// Throwaway key and self-signed certificate for local HTTPS stubs, so no key
+// lives in the tree; the client does not verify peers.
+inline void useSelfSignedCertificate(boost::asio::ssl::context& context) {
+    EVP_PKEY* key = EVP_PKEY_Q_keygen(nullptr, nullptr, "EC", "P-256");
+    X509* cert = X509_new();
+    X509_set_version(cert, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 3600);
+    X509_set_pubkey(cert, key);
+    X509_NAME* name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("127.0.0.1"), -1, -1,
+                               0);
+    X509_set_issuer_name(cert, name);
+    X509_sign(cert, key, EVP_sha256());
+    SSL_CTX_use_certificate(context.native_handle(), cert);
+    SSL_CTX_use_PrivateKey(context.native_handle(), key);
+    X509_free(cert);
+    EVP_PKEY_free(key);
+}
+
+}  // namespace test_support
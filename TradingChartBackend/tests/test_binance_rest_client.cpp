@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include "TestTls.hpp"
+#include "adapters/binance/BinanceRestClient.hpp"
+#include "adapters/binance/WeightBudget.hpp"
+#include "domain/Types.h"
+
+#if defined(HAS_DUCKDB)
+#include <filesystem>
+
+#include "adapters/duckdb/DuckCandleRepo.hpp"
+#include "adapters/duckdb/DuckStore.hpp"
+#include "app/BackfillWorker.hpp"
+#include "common/Config.hpp"
+#include "domain/Models.hpp"
+#endif
+
+namespace net = boost::asio;
+namespace ssl = boost::asio::ssl;
+namespace http = boost::beast::http;
+using adapters::binance::BinanceRestClient;
+using adapters::binance::WeightBudget;
+
+namespace {
+using namespace std::chrono_literals;
+
+constexpr std::int64_t kMinute = 60'000;
+constexpr std::int64_t kStart = 1'754'006'400;  // 2025-08-01 00:00 UTC, seconds
+constexpr std::int64_t kStartMs = kStart * 1000;
+
+std::int64_t queryInt(std::string_view target, std::string_view name) {
+    const auto pos = target.find(std::string{name} + "=");
+    if (pos == std::string_view::npos) {
+        return -1;
+    }
+    return std::stoll(std::string{target.substr(pos + name.size() + 1)});
+}
+
+// Local HTTPS stand-in for /api/v3/klines. Serves one 1m candle per minute
+// from kStart for `candles` minutes, at most `pageCap` rows per response, and
+// answers the first `rateLimited` requests with 429 + Retry-After. One request
+// per connection.
+class StubBinance {
+public:
+    StubBinance(std::int64_t candles, std::size_t pageCap, int rateLimited)
+        : candles_(candles), pageCap_(pageCap), rateLimited_(rateLimited) {
+        test_support::useSelfSignedCertificate(context_);
+        acceptor_.open(net::ip::tcp::v4());
+        acceptor_.set_option(net::socket_base::reuse_address(true));
+        acceptor_.bind({net::ip::make_address("127.0.0.1"), 0});
+        acceptor_.listen();
+        thread_ = std::thread([this]() { serve_(); });
+    }
+
+    ~StubBinance() {
+        stopping_.store(true);
+        // Wake the blocking accept.
+        net::ip::tcp::socket wake(io_);
+        boost::system::error_code ec;
+        wake.connect(acceptor_.local_endpoint(), ec);
+        thread_.join();
+    }
+
+    std::string host() const { return "127.0.0.1:" + std::to_string(acceptor_.local_endpoint().port()); }
+
+    std::vector<std::string> targets() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return targets_;
+    }
+
+    std::vector<unsigned> statuses() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return statuses_;
+    }
+
+private:
+    void serve_() {
+        while (!stopping_.load()) {
+            net::ip::tcp::socket socket(io_);
+            boost::system::error_code ec;
+            acceptor_.accept(socket, ec);
+            if (ec || stopping_.load()) {
+                continue;
+            }
+            ssl::stream<net::ip::tcp::socket> stream(std::move(socket), context_);
+            stream.handshake(ssl::stream_base::server, ec);
+            if (ec) {
+                continue;
+            }
+            boost::beast::flat_buffer buffer;
+            http::request<http::string_body> request;
+            http::read(stream, buffer, request, ec);
+            if (ec) {
+                continue;
+            }
+            auto response = respond_(std::string{request.target()});
+            http::write(stream, response, ec);
+            stream.shutdown(ec);
+        }
+    }
+
+    http::response<http::string_body> respond_(const std::string& target) {
+        http::response<http::string_body> response;
+        response.keep_alive(false);
+        response.set(http::field::content_type, "application/json");
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        targets_.push_back(target);
+        if (target.find("symbol=BTCUSDT") == std::string::npos) {
+            response.result(http::status::bad_request);
+            response.body() = R"({"code":-1121,"msg":"Invalid symbol."})";
+        }
+        else if (rateLimited_ > 0) {
+            --rateLimited_;
+            response.result(http::status::too_many_requests);
+            response.set("Retry-After", "1");
+            response.body() = R"({"code":-1003,"msg":"Too many requests."})";
+        }
+        else {
+            const auto startTime = queryInt(target, "startTime");
+            const auto endTime = queryInt(target, "endTime");
+            const auto limit = static_cast<std::size_t>(queryInt(target, "limit"));
+            std::string body = "[";
+            std::size_t rows = 0;
+            for (std::int64_t minute = 0; minute < candles_ && rows < std::min(limit, pageCap_); ++minute) {
+                const auto open = kStartMs + minute * kMinute;
+                if (open < startTime || open > endTime) {
+                    continue;
+                }
+                const auto price = std::to_string(100 + minute);
+                body += (rows++ == 0 ? "[" : ",[") + std::to_string(open) + ",\"" + price + "\",\"" + price + "\",\""
+                        + price + "\",\"" + price + "\",\"1.5\"," + std::to_string(open + kMinute - 1)
+                        + ",\"150\"," + std::to_string(minute) + ",\"0\",\"0\",\"0\"]";
+            }
+            body += "]";
+            response.result(http::status::ok);
+            response.set("X-MBX-USED-WEIGHT", std::to_string(2 * targets_.size()));
+            response.body() = std::move(body);
+        }
+        statuses_.push_back(response.result_int());
+        response.prepare_payload();
+        return response;
+    }
+
+    const std::int64_t candles_;
+    const std::size_t pageCap_;
+    int rateLimited_;
+
+    net::io_context io_;
+    ssl::context context_{ssl::context::tls_server};
+    net::ip::tcp::acceptor acceptor_{io_};
+    std::atomic<bool> stopping_{false};
+    std::thread thread_;
+
+    std::mutex mutex_;
+    std::vector<std::string> targets_;
+    std::vector<unsigned> statuses_;
+};
+
+bool expectMinutes(const char* label, const domain::KlinesPage& page, std::int64_t first, std::int64_t count) {
+    bool ok = page.rows.size() == static_cast<std::size_t>(count);
+    for (std::size_t i = 0; ok && i < page.rows.size(); ++i) {
+        const auto minute = first + static_cast<std::int64_t>(i);
+        const auto& candle = page.rows[i];
+        ok = candle.openTime == kStartMs + minute * kMinute && candle.closeTime == candle.openTime + kMinute - 1
+             && candle.close == static_cast<double>(100 + minute) && candle.baseVolume == 1.5
+             && candle.quoteVolume == 150.0 && candle.trades == static_cast<domain::TradeCount>(minute)
+             && candle.isClosed;
+    }
+    if (!ok) {
+        std::cerr << label << ": unexpected rows:";
+        for (const auto& candle : page.rows) {
+            std::cerr << ' ' << (candle.openTime - kStartMs) / kMinute << '=' << candle.close;
+        }
+        std::cerr << '\n';
+    }
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    const domain::Interval minute{kMinute};
+
+    {
+        // 15 candles in the range, 4 rows per response: the first page of 10
+        // takes three requests after the rate-limited one, the next page two.
+        StubBinance stub(60, 4, 1);
+        BinanceRestClient client(std::make_shared<WeightBudget>(), stub.host());
+
+        const auto started = std::chrono::steady_clock::now();
+        const auto first = client.fetch_klines("BTCUSDT", minute, kStart, kStart + 15 * 60, 10);
+        const auto waited = std::chrono::steady_clock::now() - started;
+        if (!expectMinutes("first page", first, 0, 10)) {
+            return 1;
+        }
+        if (!first.has_more || first.next_from_ts != kStart + 10 * 60) {
+            std::cerr << "Expected the first page to continue at minute 10 (next_from_ts=" << first.next_from_ts
+                      << ")\n";
+            return 1;
+        }
+        if (waited < 900ms) {
+            std::cerr << "Expected the 429 to pause the budget for Retry-After\n";
+            return 1;
+        }
+
+        const auto second = client.fetch_klines("BTCUSDT", minute, first.next_from_ts, kStart + 15 * 60, 10);
+        if (!expectMinutes("second page", second, 10, 5) || second.has_more) {
+            return 1;
+        }
+
+        const auto statuses = stub.statuses();
+        const std::vector<unsigned> expected{429, 200, 200, 200, 200, 200};
+        if (statuses != expected) {
+            std::cerr << "Expected one 429 then five pages (requests=" << statuses.size() << ")\n";
+            return 1;
+        }
+        const auto targets = stub.targets();
+        if (targets[0] != targets[1]
+            || targets[1] != "/api/v3/klines?symbol=BTCUSDT&interval=1m&startTime=" + std::to_string(kStartMs)
+                                 + "&endTime=" + std::to_string(kStartMs + 10 * kMinute) + "&limit=10") {
+            std::cerr << "Unexpected retried request: " << targets[1] << '\n';
+            return 1;
+        }
+        if (queryInt(targets[2], "startTime") != kStartMs + 4 * kMinute
+            || queryInt(targets[2], "limit") != 6) {
+            std::cerr << "Expected the next request to resume after the last row: " << targets[2] << '\n';
+            return 1;
+        }
+
+        // Client errors are not retried.
+        bool threw = false;
+        try {
+            client.fetch_klines("ETHUSDT", minute, kStart, kStart + 60, 10);
+        }
+        catch (const std::exception&) {
+            threw = true;
+        }
+        if (!threw || stub.statuses().size() != expected.size() + 1) {
+            std::cerr << "Expected a single 400 to throw\n";
+            return 1;
+        }
+    }
+
+#if defined(HAS_DUCKDB)
+    {
+        // A full backfill of one day through the stub, paged at the real 1000
+        // rows per response.
+        StubBinance stub(2 * 1440, 1000, 0);
+        const auto dir = std::filesystem::temp_directory_path() / "ttp_test_binance_rest_client";
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+
+        ttp::common::Config config;
+        config.duckdbPath = (dir / "market.duckdb").string();
+        config.backfillSymbols = {"btcusdt"};
+        config.backfillIntervals = {"1m"};
+        config.backfillFrom = "2025-08-01";
+        config.backfillTo = "2025-08-01";
+        config.backfillConcurrency = 2;
+        config.binanceRestHost = stub.host();
+        adapters::duckdb::DuckStore(config.duckdbPath).migrate();
+        app::BackfillWorker(config).run();
+
+        const adapters::duckdb::DuckCandleRepo repo(config.duckdbPath);
+        const auto bounds = repo.get_min_max_ts("BTCUSDT", "1m");
+        if (!bounds || bounds->first != kStartMs || bounds->second != kStartMs + 1439 * kMinute) {
+            std::cerr << "Expected the backfill to store 2025-08-01 in full\n";
+            return 1;
+        }
+        const auto candles =
+            repo.getCandles("BTCUSDT", domain::contracts::Interval::OneMinute, bounds->first, bounds->second, 0);
+        if (candles.size() != 1440 || candles.back().c != 100.0 + 1439) {
+            std::cerr << "Expected 1440 stored candles (candles=" << candles.size() << ")\n";
+            return 1;
+        }
+        std::filesystem::remove_all(dir);
+    }
+#endif
+
+    return 0;
+}
@@ -0,0 +1,265 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "api/CandleBlocks.hpp"
+#include "common/SeriesVersions.hpp"
+#include "domain/Models.hpp"
+#include "domain/Ports.hpp"
+
+using domain::contracts::Candle;
+using domain::contracts::Interval;
+using ttp::api::CandleBlockStore;
+
+namespace {
+
+constexpr std::int64_t kMinute = 60'000;
+
+// In-memory 1m series with the getCandles contract of the real repos: rows
+// in [fromTs, toTs] (0 = open), the oldest `limit` of a range or the newest
+// `limit` without one. Writes bump SeriesVersions like upsert_batch does or,
+// with `stored`, only a counter and write log of the repo's own: the writes of
+// another process.
+class MemoryRepo : public domain::contracts::ICandleReadRepo {
+public:
+    explicit MemoryRepo(std::string symbol, bool stored = false) : symbol_(std::move(symbol)), stored_(stored) {}
+
+    std::vector<Candle> getCandles(const domain::contracts::Symbol&,
+                                   Interval,
+                                   std::int64_t fromTs,
+                                   std::int64_t toTs,
+                                   std::size_t limit) const override {
+        ++reads;
+        std::vector<Candle> rows;
+        for (const auto& [ts, candle] : rows_) {
+            if ((fromTs <= 0 || ts >= fromTs) && (toTs <= 0 || ts <= toTs)) {
+                rows.push_back(candle);
+            }
+        }
+        if (limit > 0 && rows.size() > limit) {
+            if (fromTs > 0 || toTs > 0) {
+                rows.resize(limit);
+            }
+            else {
+                rows.erase(rows.begin(), rows.end() - static_cast<std::ptrdiff_t>(limit));
+            }
+        }
+        return rows;
+    }
+
+    std::optional<std::pair<std::int64_t, std::int64_t>> get_min_max_ts(const domain::contracts::Symbol&,
+                                                                        const std::string&) const override {
+        if (rows_.empty()) {
+            return std::nullopt;
+        }
+        return std::make_pair(rows_.begin()->first, rows_.rbegin()->first);
+    }
+
+    std::optional<std::uint64_t> storedVersion(const domain::contracts::Symbol&, const std::string&) const override {
+        return stored_ ? std::optional<std::uint64_t>(writes_.size()) : std::nullopt;
+    }
+
+    bool storedUntouched(const domain::contracts::Symbol&,
+                         const std::string&,
+                         std::uint64_t since,
+                         std::uint64_t until,
+                         std::int64_t fromTs,
+                         std::int64_t toTs) const override {
+        for (auto version = since; version < until && version < writes_.size(); ++version) {
+            if (writes_[version].first <= toTs && writes_[version].second >= fromTs) {
+                return false;
+            }
+        }
+        return until <= writes_.size();
+    }
+
+    void write(std::int64_t firstTs, std::int64_t lastTs, double price) {
+        for (auto ts = firstTs; ts <= lastTs; ts += kMinute) {
+            Candle candle;
+            candle.ts = ts;
+            candle.o = price;
+            candle.h = price + 1.5;
+            candle.l = price - 0.25;
+            candle.c = price;
+            candle.v = static_cast<double>(ts % 7);
+            rows_[ts] = candle;
+        }
+        if (stored_) {
+            writes_.emplace_back(firstTs, lastTs);
+        }
+        else {
+            ttp::common::SeriesVersions::instance().bump(symbol_, "1m", firstTs, lastTs);
+        }
+    }
+
+    mutable int reads = 0;
+
+private:
+    std::string symbol_;
+    bool stored_;
+    std::map<std::int64_t, Candle> rows_;
+    std::vector<std::pair<std::int64_t, std::int64_t>> writes_;
+};
+
+std::string encode(const std::vector<Candle>& candles) {
+    std::string json;
+    for (const auto& candle : candles) {
+        ttp::api::appendCandleRow(json, candle);
+    }
+    return json;
+}
+
+}  // namespace
+
+int main() {
+    {
+        // Seconds are widened to milliseconds; non-finite values become 0.
+        Candle candle;
+        candle.ts = 1'700'000'000;
+        candle.o = 0.1;
+        candle.h = 1e21;
+        candle.l = -0.0;
+        candle.c = std::numeric_limits<double>::infinity();
+        candle.v = 123456.789;
+        std::string row;
+        ttp::api::appendCandleRow(row, candle);
+        if (row != "[1700000000000,0.1,1e+21,-0,0,123456.789],") {
+            std::cerr << "Unexpected row encoding: " << row << '\n';
+            return 1;
+        }
+    }
+
+    auto& store = CandleBlockStore::instance();
+    const auto nowMs =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    const std::int64_t current = nowMs / kMinute * kMinute;
+
+    {
+        // Two runs with a gap, then random writes anywhere (rebuilding the
+        // blocks they touch), a forming candle rewritten at the head, and
+        // every request shape compared with a plain read.
+        MemoryRepo repo("BTCUSDT");
+        repo.write(current - 5000 * kMinute, current - 3000 * kMinute, 1.0);
+        repo.write(current - 2000 * kMinute, current, 2.0);
+
+        std::mt19937_64 rng(42);
+        const auto slotsBack = [&rng](std::uint64_t range) {
+            return static_cast<std::int64_t>(rng() % range) * kMinute;
+        };
+        for (int i = 0; i < 4000; ++i) {
+            if (i % 50 == 0) {
+                const auto first = current - slotsBack(6000);
+                repo.write(first, first + slotsBack(5), 3.0 + i);
+            }
+            if (i % 7 == 0) {
+                repo.write(current, current, 9.0 + i);
+            }
+            std::int64_t fromTs = 0;
+            std::int64_t toTs = 0;
+            const auto limit = static_cast<std::size_t>(1 + rng() % 3000);
+            switch (rng() % 4) {
+            case 1:
+                fromTs = current - slotsBack(6000);
+                break;
+            case 2:
+                toTs = current - slotsBack(6000);
+                break;
+            case 3:
+                fromTs = current - slotsBack(6000);
+                toTs = fromTs + slotsBack(4000) + static_cast<std::int64_t>(rng() % 2) * 7;  // unaligned end
+                break;
+            default:
+                break;
+            }
+
+            std::string json;
+            const auto rows = store.assemble(repo, "BTCUSDT", Interval::OneMinute, fromTs, toTs, limit, json);
+            const auto want = repo.getCandles("BTCUSDT", Interval::OneMinute, fromTs, toTs, limit);
+            if (!rows || *rows != want.size() || json != encode(want)) {
+                std::cerr << "Mismatch from=" << fromTs << " to=" << toTs << " limit=" << limit << " rows="
+                          << (rows ? std::to_string(*rows) : std::string{"fallback"}) << '\n';
+                return 1;
+            }
+        }
+
+        // Warm blocks: the latest page reads only the tail, a closed range
+        // nothing at all.
+        std::string json;
+        repo.reads = 0;
+        store.assemble(repo, "BTCUSDT", Interval::OneMinute, 0, 0, 3000, json);
+        if (repo.reads != 1) {
+            std::cerr << "Expected one tail read for a warm latest page (reads=" << repo.reads << ")\n";
+            return 1;
+        }
+        repo.reads = 0;
+        json.clear();
+        store.assemble(repo, "BTCUSDT", Interval::OneMinute, current - 5000 * kMinute, current - 100 * kMinute, 5000,
+                       json);
+        if (repo.reads != 0) {
+            std::cerr << "Expected a warm closed range to need no read (reads=" << repo.reads << ")\n";
+            return 1;
+        }
+    }
+
+    {
+        // With a stored counter the blocks follow writes SeriesVersions never
+        // sees: a head write keeps a closed range warm, one inside it rebuilds.
+        MemoryRepo repo("SOLUSDT", true);
+        repo.write(current - 3000 * kMinute, current, 1.0);
+        const auto fromTs = current - 2500 * kMinute;
+        const auto toTs = current - 1500 * kMinute;
+        const auto expectRange = [&](const char* label, int maxReads) {
+            std::string json;
+            repo.reads = 0;
+            const auto rows = store.assemble(repo, "SOLUSDT", Interval::OneMinute, fromTs, toTs, 5000, json);
+            const auto reads = repo.reads;
+            const auto want = repo.getCandles("SOLUSDT", Interval::OneMinute, fromTs, toTs, 5000);
+            if (!rows || json != encode(want) || reads > maxReads) {
+                std::cerr << label << ": unexpected stored-version range (reads=" << reads << ")\n";
+                return false;
+            }
+            return true;
+        };
+        if (!expectRange("cold", 4)) {
+            return 1;
+        }
+        repo.write(current, current, 2.0);
+        if (!expectRange("head write", 0)) {
+            return 1;
+        }
+        repo.write(current - 2000 * kMinute, current - 2000 * kMinute, 3.0);
+        if (!expectRange("write inside", 4)) {
+            return 1;
+        }
+    }
+
+    {
+        // A cold range wider than kMaxBuildsPerRequest blocks falls back and
+        // leaves the output alone.
+        MemoryRepo repo("ETHUSDT");
+        const auto slots = static_cast<std::int64_t>((CandleBlockStore::kMaxBuildsPerRequest + 2)
+                                                     * CandleBlockStore::kBlockSlots);
+        repo.write(current - slots * kMinute, current, 1.0);
+        std::string json = "[";
+        if (store.assemble(repo, "ETHUSDT", Interval::OneMinute, current - slots * kMinute, current - kMinute, 0, json)
+            || json != "[") {
+            std::cerr << "Expected a cold wide range to fall back\n";
+            return 1;
+        }
+    }
+
+    if (store.bytes() == 0 || store.bytes() > CandleBlockStore::kMaxBytes) {
+        std::cerr << "Expected blocks within the byte budget (bytes=" << store.bytes() << ")\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+#include "CandleTestRows.hpp"
+#include "adapters/columnar/ColumnarCandleRepo.hpp"
+#include "common/SeriesVersions.hpp"
+#include "domain/Models.hpp"
+#include "domain/Types.h"
+
+using adapters::columnar::ColumnarCandleRepo;
+using domain::contracts::Interval;
+using test_support::expectRows;
+using test_support::makeCandle;
+
+namespace {
+
+constexpr std::int64_t kMinute = test_support::kMinuteMs;
+constexpr std::int64_t kBase = 1'700'000'040'000;  // minute aligned
+
+// Open time of the `slot`th minute after kBase.
+constexpr std::int64_t at(std::int64_t slot) {
+    return kBase + slot * kMinute;
+}
+
+std::vector<domain::contracts::Candle> all(const ColumnarCandleRepo& repo) {
+    return repo.getCandles("BTCUSDT", Interval::OneMinute, kBase, kBase + 100'000 * kMinute, 0);
+}
+
+}  // namespace
+
+int main() {
+    const auto root = std::filesystem::temp_directory_path() / "ttp_test_columnar_candle_repo";
+    std::filesystem::remove_all(root);
+    auto& versions = ttp::common::SeriesVersions::instance();
+
+    {
+        ColumnarCandleRepo repo(root);
+        // Unsorted input is sorted before it is appended.
+        if (!repo.upsert_batch("BTCUSDT",
+                               "1m",
+                               {makeCandle(at(2), 2.0), makeCandle(at(0), 0.0), makeCandle(at(4), 4.0)})) {
+            std::cerr << "Expected the first upsert to succeed\n";
+            return 1;
+        }
+        if (!expectRows("appended", all(repo), {{at(0), 0.0}, {at(2), 2.0}, {at(4), 4.0}})) {
+            return 1;
+        }
+
+        // Stored rows anywhere in the series are rewritten in place, together
+        // with new rows past the tail.
+        if (!repo.upsert_batch("BTCUSDT",
+                               "1m",
+                               {makeCandle(at(0), 10.0), makeCandle(at(4), 14.0), makeCandle(at(5), 15.0)})) {
+            std::cerr << "Expected the rewrite to succeed\n";
+            return 1;
+        }
+        if (!expectRows("rewritten", all(repo), {{at(0), 10.0}, {at(2), 2.0}, {at(4), 14.0}, {at(5), 15.0}})) {
+            return 1;
+        }
+
+        // A row that would fill a gap is skipped and reported; the rest of
+        // the batch still lands and bumps the series.
+        const auto before = versions.series("BTCUSDT", "1m");
+        if (repo.upsert_batch("BTCUSDT", "1m", {makeCandle(at(3), 3.0), makeCandle(at(2), 12.0)})) {
+            std::cerr << "Expected a skipped gap row to fail the upsert\n";
+            return 1;
+        }
+        if (!expectRows("gap skipped", all(repo), {{at(0), 10.0}, {at(2), 12.0}, {at(4), 14.0}, {at(5), 15.0}})
+            || versions.series("BTCUSDT", "1m") == before) {
+            std::cerr << "Expected the written row to bump the series\n";
+            return 1;
+        }
+
+        // Nothing written: no success and no new version.
+        const auto unchanged = versions.series("BTCUSDT", "1m");
+        if (repo.upsert_batch("BTCUSDT", "1m", {makeCandle(at(1), 1.0), makeCandle(at(3), 3.0)})
+            || versions.series("BTCUSDT", "1m") != unchanged) {
+            std::cerr << "Expected a batch of gap rows to fail without a version bump\n";
+            return 1;
+        }
+
+        // Past the initial capacity the file grows.
+        std::vector<domain::Candle> bulk;
+        for (std::int64_t slot = 6; slot < 5006; ++slot) {
+            bulk.push_back(makeCandle(at(slot), static_cast<double>(slot)));
+        }
+        if (!repo.upsert_batch("BTCUSDT", "1m", bulk)) {
+            std::cerr << "Expected the bulk upsert to succeed\n";
+            return 1;
+        }
+        const auto latest = repo.getCandles("BTCUSDT", Interval::OneMinute, 0, 0, 2);
+        if (!expectRows("latest", latest, {{at(5004), 5004.0}, {at(5005), 5005.0}})) {
+            return 1;
+        }
+    }
+
+    // A fresh repo maps the same files.
+    const ColumnarCandleRepo reopened(root);
+    const auto bounds = reopened.get_min_max_ts("BTCUSDT", "1m");
+    if (!bounds || bounds->first != kBase || bounds->second != kBase + 5005 * kMinute) {
+        std::cerr << "Expected the reopened series to span slots 0..5005\n";
+        return 1;
+    }
+    if (all(reopened).size() != 5004
+        || !expectRows("reopened", reopened.getCandles("BTCUSDT", Interval::OneMinute, kBase, kBase + 5 * kMinute, 0),
+                       {{at(0), 10.0}, {at(2), 12.0}, {at(4), 14.0}, {at(5), 15.0}})) {
+        std::cerr << "Expected the reopened series to keep every row\n";
+        return 1;
+    }
+    const auto intervals = reopened.listSymbolIntervals("BTCUSDT");
+    if (intervals.size() != 1 || intervals[0].interval != "1m" || reopened.symbolExists("ETHUSDT") != false) {
+        std::cerr << "Expected a single BTCUSDT 1m series\n";
+        return 1;
+    }
+
+    std::filesystem::remove_all(root);
+    return 0;
+}
@@ -0,0 +1,204 @@
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CandleTestRows.hpp"
+#include "adapters/duckdb/CandlePartitions.hpp"
+#include "adapters/duckdb/DuckCandleRepo.hpp"
+#include "adapters/duckdb/DuckStore.hpp"
+#include "domain/Models.hpp"
+#include "domain/Types.h"
+#include "duckdb.hpp"
+
+using adapters::duckdb::DuckCandleRepo;
+using adapters::duckdb::DuckStore;
+using adapters::duckdb::PartitionGranularity;
+using domain::contracts::Interval;
+using test_support::expectRows;
+using test_support::makeCandle;
+using test_support::Row;
+
+namespace {
+
+constexpr std::int64_t kMinute = test_support::kMinuteMs;
+constexpr std::int64_t kDec31Last = 1'704'067'140'000;  // 2023-12-31 23:59 UTC
+constexpr std::int64_t kJan31Late = 1'706'745'480'000;  // 2024-01-31 23:58 UTC
+constexpr std::int64_t kFeb1 = 1'706'745'600'000;       // 2024-02-01 00:00 UTC
+constexpr std::int64_t kMar1 = 1'709'251'200'000;       // 2024-03-01 00:00 UTC
+
+bool expectBounds(const char* label, const DuckCandleRepo& repo, std::int64_t minTs, std::int64_t maxTs) {
+    const auto bounds = repo.get_min_max_ts("BTCUSDT", "1m");
+    if (!bounds || bounds->first != minTs || bounds->second != maxTs) {
+        std::cerr << label << ": unexpected bounds";
+        if (bounds) {
+            std::cerr << ' ' << bounds->first << ".." << bounds->second;
+        }
+        std::cerr << '\n';
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    if (adapters::duckdb::partitionTableName(
+            "1m", adapters::duckdb::partitionBoundsFor(kFeb1, PartitionGranularity::Month), PartitionGranularity::Month)
+        != "candles_1m_202402") {
+        std::cerr << "Unexpected monthly partition name\n";
+        return 1;
+    }
+
+    const auto dir = std::filesystem::temp_directory_path() / "ttp_test_duck_candle_repo";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const std::string dbPath = (dir / "market.duckdb").string();
+
+    // Rows written with partitioning off land in the unified table.
+    DuckStore(dbPath, PartitionGranularity::None).migrate();
+    {
+        DuckCandleRepo unified(dbPath, PartitionGranularity::None);
+        if (!unified.upsert_batch("BTCUSDT", "1m", {makeCandle(kJan31Late, 1.0)})) {
+            std::cerr << "Expected the unified upsert to succeed\n";
+            return 1;
+        }
+    }
+
+    // Turning partitioning on drains them and records their bounds.
+    DuckStore(dbPath, PartitionGranularity::Month).migrate();
+    DuckCandleRepo repo(dbPath, PartitionGranularity::Month);
+    if (!expectBounds("drained", repo, kJan31Late, kJan31Late)) {
+        return 1;
+    }
+
+    // One batch across three monthly partitions.
+    const std::vector<domain::Candle> batch{makeCandle(kJan31Late + kMinute, 2.0),
+                                            makeCandle(kFeb1, 3.0),
+                                            makeCandle(kMar1 - kMinute, 4.0),
+                                            makeCandle(kMar1, 5.0)};
+    if (!repo.upsert_batch("BTCUSDT", "1m", batch)) {
+        std::cerr << "Expected the partitioned upsert to succeed\n";
+        return 1;
+    }
+    const std::vector<Row> all{{kJan31Late, 1.0},
+                               {kJan31Late + kMinute, 2.0},
+                               {kFeb1, 3.0},
+                               {kMar1 - kMinute, 4.0},
+                               {kMar1, 5.0}};
+    if (!expectRows("range", repo.getCandles("BTCUSDT", Interval::OneMinute, kJan31Late, kMar1, 0), all)
+        || !expectRows("latest", repo.getCandles("BTCUSDT", Interval::OneMinute, 0, 0, 2), {all[3], all[4]})
+        || !expectBounds("partitioned", repo, kJan31Late, kMar1)) {
+        return 1;
+    }
+    const auto intervals = repo.listSymbolIntervals("BTCUSDT");
+    if (intervals.size() != 1 || intervals[0].interval != "1m" || intervals[0].fromTs != kJan31Late
+        || intervals[0].toTs != kMar1) {
+        std::cerr << "Expected one 1m interval spanning the series\n";
+        return 1;
+    }
+
+    // Frozen partitions are thawed before the upsert that writes into them.
+    if (DuckStore(dbPath, PartitionGranularity::Month).freezePartitions(kMar1) != 2) {
+        std::cerr << "Expected January and February to freeze\n";
+        return 1;
+    }
+    {
+        DuckCandleRepo writer(dbPath, PartitionGranularity::Month);
+        if (!writer.upsert_batch("BTCUSDT", "1m", {makeCandle(kFeb1, 30.0), makeCandle(kDec31Last, 0.5)})) {
+            std::cerr << "Expected the upsert into a frozen partition to succeed\n";
+            return 1;
+        }
+        // A second batch into the now writable partition reuses it.
+        if (!writer.upsert_batch("BTCUSDT", "1m", {makeCandle(kFeb1, 31.0)})) {
+            std::cerr << "Expected the second upsert to succeed\n";
+            return 1;
+        }
+    }
+    if (!expectRows("thawed", repo.getCandles("BTCUSDT", Interval::OneMinute, kDec31Last, kFeb1, 0),
+                    {{kDec31Last, 0.5}, {kJan31Late, 1.0}, {kJan31Late + kMinute, 2.0}, {kFeb1, 31.0}})
+        || !expectBounds("widened", repo, kDec31Last, kMar1)) {
+        return 1;
+    }
+
+    // Every write counts in the database, whichever repo (or process) made it.
+    const auto before = repo.storedVersion("BTCUSDT", "1m");
+    if (!DuckCandleRepo(dbPath, PartitionGranularity::Month).upsert_batch("BTCUSDT", "1m", {makeCandle(kFeb1, 31.0)})) {
+        std::cerr << "Expected the rewrite to succeed\n";
+        return 1;
+    }
+    const auto after = repo.storedVersion("btcusdt", "1m");
+    if (!before || !after || *after != *before + 1 || repo.storedVersion("BTCUSDT", "") != after
+        || repo.storedVersion("", "") != after || repo.storedVersion("ETHUSDT", "1m") != 0U) {
+        std::cerr << "Expected the stored version to count the write\n";
+        return 1;
+    }
+    // The write log says which open times that write touched; versions moved
+    // by the startup drain were never logged, so they are unknown.
+    if (!repo.storedUntouched("BTCUSDT", "1m", *before, *after, kMar1, kMar1)
+        || repo.storedUntouched("BTCUSDT", "1m", *before, *after, kFeb1, kFeb1)
+        || repo.storedUntouched("BTCUSDT", "1m", 0, *after, kMar1, kMar1)) {
+        std::cerr << "Expected the write log to tell touched ranges apart\n";
+        return 1;
+    }
+
+    // A database partitioned before the bounds table existed gets it rebuilt.
+    {
+        duckdb::DuckDB database(dbPath);
+        duckdb::Connection connection(database);
+        auto result = connection.Query("DROP TABLE " + std::string{adapters::duckdb::kSeriesBoundsTable});
+        if (!result || result->HasError()) {
+            std::cerr << "Unable to drop the bounds table\n";
+            return 1;
+        }
+    }
+    DuckStore(dbPath, PartitionGranularity::Month).migrate();
+    if (!expectBounds("rebuilt", DuckCandleRepo(dbPath, PartitionGranularity::Month), kDec31Last, kMar1)) {
+        return 1;
+    }
+
+    // Symbols come from the bounds table, rebuilt or not.
+    const auto symbols = repo.listSymbols();
+    if (symbols.size() != 1 || symbols[0].symbol != "BTCUSDT") {
+        std::cerr << "Expected BTCUSDT as the only symbol\n";
+        return 1;
+    }
+
+    // Tiered partitions are read back from Parquet; a write into one brings
+    // it back into the database first.
+    const auto coldDir = dir / "cold";
+    if (DuckStore(dbPath, PartitionGranularity::Month).tierColdPartitions(kFeb1, coldDir.string()) != 2
+        || !std::filesystem::exists(coldDir / "1m" / "candles_1m_202401.parquet")) {
+        std::cerr << "Expected December and January to move to Parquet\n";
+        return 1;
+    }
+    if (!expectRows("cold", repo.getCandles("BTCUSDT", Interval::OneMinute, kDec31Last, kFeb1, 0),
+                    {{kDec31Last, 0.5}, {kJan31Late, 1.0}, {kJan31Late + kMinute, 2.0}, {kFeb1, 31.0}})) {
+        return 1;
+    }
+    DuckCandleRepo coldWriter(dbPath, PartitionGranularity::Month);
+    if (!coldWriter.upsert_batch("BTCUSDT", "1m", {makeCandle(kJan31Late, 10.0)})) {
+        std::cerr << "Expected the upsert into a cold partition to succeed\n";
+        return 1;
+    }
+    if (!expectRows("rehydrated", repo.getCandles("BTCUSDT", Interval::OneMinute, kDec31Last, kFeb1, 0),
+                    {{kDec31Last, 0.5}, {kJan31Late, 10.0}, {kJan31Late + kMinute, 2.0}, {kFeb1, 31.0}})) {
+        return 1;
+    }
+    {
+        duckdb::DuckDB database(dbPath);
+        duckdb::Connection connection(database);
+        auto result = connection.Query("SELECT table_name FROM " + std::string{adapters::duckdb::kPartitionCatalogTable}
+                                       + " WHERE cold_path IS NOT NULL ORDER BY table_name");
+        if (!result || result->HasError() || result->RowCount() != 1
+            || result->GetValue(0, 0).ToString() != "candles_1m_202312") {
+            std::cerr << "Expected only December to stay in Parquet\n";
+            return 1;
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+    return 0;
+}
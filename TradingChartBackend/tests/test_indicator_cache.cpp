@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "indicators/IndicatorCache.h"
+#include "indicators/IndicatorKernels.h"
+#include "indicators/IndicatorSpec.h"
+#include "indicators/RollingIndicator.h"
+
+using indicators::IndicatorBar;
+using indicators::IndicatorCache;
+using indicators::IndicatorKind;
+using indicators::IndicatorSnapshot;
+using indicators::IndicatorSpec;
+
+namespace {
+
+constexpr std::int64_t kMinute = 60'000;
+// Five hours before 2024-01-01 00:00 UTC, so the series crosses a VWAP session.
+constexpr std::int64_t kStart = 1'704'067'200'000 - 300 * kMinute;
+constexpr std::size_t kBars = 600;
+constexpr std::size_t kSeedBars = 150;
+constexpr std::size_t kGapBar = 400;
+constexpr std::size_t kCapacity = 1000;
+constexpr std::size_t kLimit = 300;
+const std::string kSeries = "TESTUSDT@1m";
+
+// Deterministic random walk with wicks and varying volume.
+std::vector<IndicatorBar> generateBars(std::size_t count) {
+    std::uint64_t seed = 42;
+    const auto uniform = [&seed]() {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<double>(seed >> 11) / 9007199254740992.0;
+    };
+    std::vector<IndicatorBar> bars;
+    double close = 100.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const double open = close;
+        close = std::max(1.0, close + (uniform() - 0.5) * 2.0);
+        IndicatorBar bar;
+        bar.openTime = kStart + static_cast<std::int64_t>(i) * kMinute;
+        bar.high = std::max(open, close) + uniform() * 0.5;
+        bar.low = std::min(open, close) - uniform() * 0.5;
+        bar.close = close;
+        bar.volume = 1.0 + uniform() * 10.0;
+        bars.push_back(bar);
+    }
+    return bars;
+}
+
+IndicatorSpec makeSpec(IndicatorKind kind, const char* params) {
+    IndicatorSpec spec;
+    spec.kind = kind;
+    spec.params = *indicators::parseIndicatorParams(kind, params);
+    return spec;
+}
+
+bool sameValue(double actual, double expected) {
+    if (std::isnan(expected) || std::isnan(actual)) {
+        return std::isnan(expected) && std::isnan(actual);
+    }
+    return std::abs(actual - expected) <= 1e-9 * std::max(1.0, std::abs(expected));
+}
+
+// The last `limit` rows of a full recompute over `bars` via the kernels.
+bool matchesRecompute(const char* label,
+                      const IndicatorSpec& spec,
+                      const std::optional<IndicatorSnapshot>& snapshot,
+                      const std::vector<IndicatorBar>& bars,
+                      std::size_t limit) {
+    const auto name = std::string(label) + ' ' + indicators::indicatorKindName(spec.kind);
+    if (!snapshot) {
+        std::cerr << name << ": expected a cached snapshot\n";
+        return false;
+    }
+
+    indicators::kernels::OhlcvColumns columns;
+    columns.resize(bars.size());
+    for (std::size_t i = 0; i < bars.size(); ++i) {
+        columns.openTime[i] = bars[i].openTime;
+        columns.open[i] = bars[i].close;
+        columns.high[i] = bars[i].high;
+        columns.low[i] = bars[i].low;
+        columns.close[i] = bars[i].close;
+        columns.volume[i] = bars[i].volume;
+    }
+    const auto expected = indicators::computeIndicator(spec, columns);
+
+    const auto rows = std::min(limit, bars.size());
+    const auto first = bars.size() - rows;
+    if (snapshot->openTimes.size() != rows || snapshot->outputs.size() != expected.size()) {
+        std::cerr << name << ": expected " << rows << " rows, got " << snapshot->openTimes.size() << '\n';
+        return false;
+    }
+    for (std::size_t row = 0; row < rows; ++row) {
+        if (snapshot->openTimes[row] != bars[first + row].openTime) {
+            std::cerr << name << ": unexpected open time at row " << row << '\n';
+            return false;
+        }
+        for (std::size_t k = 0; k < expected.size(); ++k) {
+            if (!sameValue(snapshot->outputs[k][row], expected[k][first + row])) {
+                std::cerr << name << ": output " << k << " at row " << row << " is " << snapshot->outputs[k][row]
+                          << ", recompute gives " << expected[k][first + row] << '\n';
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Live closes for bars [begin, end), with the in-progress candle updated
+// before each close and a stale close re-delivered every few bars.
+void feed(IndicatorCache& cache, const std::vector<IndicatorBar>& bars, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        auto forming = bars[i];
+        forming.close += 3.0;
+        cache.onCandle(kSeries, forming, false);
+        cache.onCandle(kSeries, bars[i], true);
+        if (i % 7 == 0) {
+            auto stale = bars[i - 3];
+            stale.close *= 2.0;
+            cache.onCandle(kSeries, stale, true);
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    const std::vector<IndicatorSpec> specs{makeSpec(IndicatorKind::Ema, ""),
+                                           makeSpec(IndicatorKind::Ema, "9"),
+                                           makeSpec(IndicatorKind::Sma, ""),
+                                           makeSpec(IndicatorKind::Sma, "50"),
+                                           makeSpec(IndicatorKind::Rsi, ""),
+                                           makeSpec(IndicatorKind::Rsi, "7"),
+                                           makeSpec(IndicatorKind::Macd, ""),
+                                           makeSpec(IndicatorKind::Macd, "5,13,4"),
+                                           makeSpec(IndicatorKind::Bbands, ""),
+                                           makeSpec(IndicatorKind::Bbands, "10,2.5"),
+                                           makeSpec(IndicatorKind::Atr, ""),
+                                           makeSpec(IndicatorKind::Vwap, "")};
+    const auto bars = generateBars(kBars);
+    auto& cache = IndicatorCache::instance();
+    cache.trackSeries(kSeries, kMinute);
+
+    // Seeded from stored candles, then advanced by live closes; stale
+    // re-deliveries are ignored.
+    const std::vector<IndicatorBar> seedBars(bars.begin(), bars.begin() + kSeedBars);
+    for (const auto& spec : specs) {
+        if (!matchesRecompute("seed", spec, cache.seed(kSeries, spec, seedBars, kCapacity, kLimit), seedBars, kLimit)) {
+            return 1;
+        }
+    }
+    feed(cache, bars, kSeedBars, kGapBar);
+    const std::vector<IndicatorBar> live(bars.begin(), bars.begin() + kGapBar);
+    for (const auto& spec : specs) {
+        if (!matchesRecompute("live", spec, cache.latest(kSeries, spec, kLimit), live, kLimit)) {
+            return 1;
+        }
+    }
+
+    // The in-progress candle is evaluated as if it closed now.
+    auto forming = bars[kGapBar];
+    forming.close += 5.0;
+    cache.onCandle(kSeries, forming, false);
+    auto withForming = live;
+    withForming.push_back(forming);
+    for (const auto& spec : specs) {
+        const auto snapshot = cache.latest(kSeries, spec, kLimit);
+        if (!matchesRecompute("forming", spec, snapshot, withForming, kLimit)) {
+            return 1;
+        }
+        if (!snapshot->partial) {
+            std::cerr << indicators::indicatorKindName(spec.kind) << ": expected the last row marked partial\n";
+            return 1;
+        }
+    }
+
+    // A skipped close drops every entry: the rolling state no longer matches
+    // the series.
+    cache.onCandle(kSeries, bars[kGapBar + 1], true);
+    for (const auto& spec : specs) {
+        if (cache.latest(kSeries, spec, kLimit)) {
+            std::cerr << indicators::indicatorKindName(spec.kind) << ": expected a miss after a gap\n";
+            return 1;
+        }
+    }
+
+    // Reseeded from the repaired series, the entries follow the feed again.
+    const std::vector<IndicatorBar> repaired(bars.begin(), bars.begin() + kGapBar + 2);
+    for (const auto& spec : specs) {
+        const auto snapshot = cache.seed(kSeries, spec, repaired, kCapacity, kLimit);
+        if (!matchesRecompute("reseed", spec, snapshot, repaired, kLimit)) {
+            return 1;
+        }
+    }
+    feed(cache, bars, kGapBar + 2, kBars);
+    for (const auto& spec : specs) {
+        if (!matchesRecompute("resumed", spec, cache.latest(kSeries, spec, kLimit), bars, kLimit)) {
+            return 1;
+        }
+    }
+    return 0;
+}
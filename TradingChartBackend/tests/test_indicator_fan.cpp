@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "indicators/IndicatorFan.h"
+#include "indicators/IndicatorKernels.h"
+
+namespace fan = indicators::fan;
+namespace kernels = indicators::kernels;
+
+namespace {
+
+// Crosses several EMA tiles and one SMA tile boundary.
+constexpr std::size_t kBars = 5000;
+// More periods than one lane group, with a period longer than the input and
+// two invalid ones that must come back all NaN.
+const std::vector<int> kPeriods{1, 2, 3, 9, 14, 20, 21, 50, 0, 100, 200, 500, -3, 6000};
+
+std::vector<double> generateCloses(std::size_t count) {
+    std::uint64_t seed = 7;
+    std::vector<double> closes;
+    double close = 30'000.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        close += (static_cast<double>(seed >> 11) / 9007199254740992.0 - 0.5) * 50.0;
+        closes.push_back(close);
+    }
+    return closes;
+}
+
+using Kernel = void (*)(const double*, std::size_t, int, double*);
+
+// Each column of the fan against the single-period kernel, within `tolerance`
+// relative to the price.
+template <typename T>
+bool matchesKernel(const char* label,
+                   const fan::FanResult<T>& result,
+                   const std::vector<double>& closes,
+                   Kernel kernel,
+                   double tolerance) {
+    if (result.periods != kPeriods || result.rows != closes.size()
+        || result.values.size() != kPeriods.size() * closes.size()) {
+        std::cerr << label << ": unexpected result shape\n";
+        return false;
+    }
+    std::vector<double> expected(closes.size());
+    for (std::size_t k = 0; k < kPeriods.size(); ++k) {
+        kernel(closes.data(), closes.size(), kPeriods[k], expected.data());
+        const T* column = result.column(k);
+        for (std::size_t i = 0; i < closes.size(); ++i) {
+            const auto actual = static_cast<double>(column[i]);
+            const bool same = std::isnan(expected[i])
+                ? std::isnan(actual)
+                : std::abs(actual - expected[i]) <= tolerance * std::abs(expected[i]);
+            if (!same) {
+                std::cerr << label << ": period " << kPeriods[k] << " bar " << i << " is " << actual
+                          << ", kernel gives " << expected[i] << '\n';
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    const auto closes = generateCloses(kBars);
+
+    if (!matchesKernel("ema double", fan::emaFan<double>(closes.data(), closes.size(), kPeriods), closes,
+                       kernels::ema, 1e-12)
+        || !matchesKernel("sma double", fan::smaFan<double>(closes.data(), closes.size(), kPeriods), closes,
+                          kernels::sma, 1e-12)
+        || !matchesKernel("ema float", fan::emaFan<float>(closes.data(), closes.size(), kPeriods), closes,
+                          kernels::ema, 1e-5)
+        || !matchesKernel("sma float", fan::smaFan<float>(closes.data(), closes.size(), kPeriods), closes,
+                          kernels::sma, 1e-6)) {
+        return 1;
+    }
+
+    // A reused block is reset to the new shape: no values survive from a
+    // longer previous run.
+    fan::FanResult<double> reused;
+    fan::emaFan(closes.data(), closes.size(), kPeriods, reused);
+    const std::vector<double> shorter(closes.begin(), closes.begin() + 300);
+    fan::emaFan(shorter.data(), shorter.size(), kPeriods, reused);
+    if (!matchesKernel("ema reused", reused, shorter, kernels::ema, 1e-12)) {
+        return 1;
+    }
+    fan::smaFan(closes.data(), closes.size(), kPeriods, reused);
+    fan::smaFan(shorter.data(), shorter.size(), kPeriods, reused);
+    if (!matchesKernel("sma reused", reused, shorter, kernels::sma, 1e-12)) {
+        return 1;
+    }
+
+    // No closes, no rows.
+    const auto empty = fan::emaFan<double>(closes.data(), 0, kPeriods);
+    if (empty.rows != 0 || !empty.values.empty() || empty.periods != kPeriods) {
+        std::cerr << "Expected an empty block for no closes\n";
+        return 1;
+    }
+    return 0;
+}
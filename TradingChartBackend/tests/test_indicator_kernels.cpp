@@ -0,0 +1,272 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/json.hpp>
+
+#include "api/Controllers.hpp"
+#include "api/Request.hpp"
+#include "app/ServiceLocator.hpp"
+#include "domain/Models.hpp"
+#include "domain/Ports.hpp"
+#include "indicators/IndicatorKernels.h"
+
+namespace kernels = indicators::kernels;
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+constexpr std::int64_t kMinute = 60'000;
+constexpr std::int64_t kStart = 1'704'067'200'000;  // 2024-01-01 00:00 UTC
+constexpr std::int64_t kStoredCandles = 40;
+
+bool sameValue(double actual, double expected) {
+    if (std::isnan(expected) || std::isnan(actual)) {
+        return std::isnan(expected) && std::isnan(actual);
+    }
+    return std::abs(actual - expected) <= 1e-12 * std::max(1.0, std::abs(expected));
+}
+
+bool expectSeries(const char* label, const std::vector<double>& actual, const std::vector<double>& expected) {
+    bool ok = actual.size() == expected.size();
+    for (std::size_t i = 0; ok && i < actual.size(); ++i) {
+        ok = sameValue(actual[i], expected[i]);
+    }
+    if (!ok) {
+        std::cerr << label << ": got";
+        for (const auto value : actual) {
+            std::cerr << ' ' << value;
+        }
+        std::cerr << '\n';
+    }
+    return ok;
+}
+
+std::vector<double> runSma(const std::vector<double>& in, int period) {
+    std::vector<double> out(in.size());
+    kernels::sma(in.data(), in.size(), period, out.data());
+    return out;
+}
+
+std::vector<double> runEma(const std::vector<double>& in, int period) {
+    std::vector<double> out(in.size());
+    kernels::ema(in.data(), in.size(), period, out.data());
+    return out;
+}
+
+std::vector<double> runRsi(const std::vector<double>& in, int period) {
+    std::vector<double> out(in.size());
+    kernels::rsi(in.data(), in.size(), period, out.data());
+    return out;
+}
+
+// Closes 1, 2, ... one minute apart from kStart; only TESTUSDT exists.
+class FakeRepo : public domain::contracts::ICandleReadRepo {
+public:
+    std::vector<domain::contracts::Candle> getCandles(const domain::contracts::Symbol& symbol,
+                                                      domain::contracts::Interval interval,
+                                                      std::int64_t fromTs,
+                                                      std::int64_t toTs,
+                                                      std::size_t limit) const override {
+        (void)interval;
+        std::vector<domain::contracts::Candle> candles;
+        if (symbol != "TESTUSDT") {
+            return candles;
+        }
+        for (std::int64_t i = 0; i < kStoredCandles && candles.size() < limit; ++i) {
+            const auto ts = kStart + i * kMinute;
+            if ((fromTs != 0 && ts < fromTs) || (toTs != 0 && ts > toTs)) {
+                continue;
+            }
+            const auto close = static_cast<double>(i + 1);
+            candles.push_back({ts, close, close, close, close, 1.0});
+        }
+        return candles;
+    }
+
+    std::optional<bool> symbolExists(const domain::contracts::Symbol& symbol) const override {
+        return symbol == "TESTUSDT";
+    }
+};
+
+std::string_view text(const boost::json::value& value) {
+    return value.as_string();
+}
+
+ttp::api::Response getIndicators(const std::string& query) {
+    return ttp::api::indicators(ttp::api::Request("GET /api/v1/indicators?" + query + " HTTP/1.1\r\n\r\n"));
+}
+
+bool expectError(const char* label, const ttp::api::Response& response, int status, const char* error) {
+    if (response.statusCode != status
+        || text(boost::json::parse(response.body).as_object().at("error")) != error) {
+        std::cerr << label << ": expected " << status << ' ' << error << ", got " << response.statusCode << ' '
+                  << response.body << '\n';
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    // SMA: NaN until the window fills; a period longer than the input, or
+    // not positive, leaves every bar NaN.
+    const std::vector<double> ramp{1, 2, 3, 4, 5};
+    if (!expectSeries("sma", runSma(ramp, 3), {kNaN, kNaN, 2, 3, 4})
+        || !expectSeries("sma period > n", runSma(ramp, 6), {kNaN, kNaN, kNaN, kNaN, kNaN})
+        || !expectSeries("sma period 0", runSma(ramp, 0), {kNaN, kNaN, kNaN, kNaN, kNaN})) {
+        return 1;
+    }
+
+    // EMA: seeded with the SMA of the first window, then alpha = 2 / (period + 1);
+    // leading NaNs (a MACD line) move the seed.
+    if (!expectSeries("ema", runEma({2, 4, 6, 8, 4, 2}, 3), {kNaN, kNaN, 4, 6, 5, 3.5})
+        || !expectSeries("ema after NaN", runEma({kNaN, kNaN, 2, 4, 6, 8}, 3), {kNaN, kNaN, kNaN, kNaN, 4, 6})
+        || !expectSeries("ema period > n", runEma({1, 2}, 3), {kNaN, kNaN})) {
+        return 1;
+    }
+
+    // Wilder RSI: the first value needs `period` changes; averages are then
+    // smoothed by 1/period. No losses reads 100, no movement 50.
+    if (!expectSeries("rsi", runRsi({1, 2, 1, 2, 3}, 2), {kNaN, kNaN, 50, 75, 87.5})
+        || !expectSeries("rsi gains only", runRsi({1, 2, 3}, 2), {kNaN, kNaN, 100})
+        || !expectSeries("rsi flat", runRsi({5, 5, 5}, 2), {kNaN, kNaN, 50})
+        || !expectSeries("rsi period = n", runRsi({1, 2, 3}, 3), {kNaN, kNaN, kNaN})) {
+        return 1;
+    }
+
+    // MACD 2/3/2: the signal is an EMA of the MACD line from its first value.
+    {
+        const std::vector<double> close{1, 2, 3, 4, 5, 9};
+        std::vector<double> line(close.size());
+        std::vector<double> signal(close.size());
+        std::vector<double> histogram(close.size());
+        kernels::macd(close.data(), close.size(), 2, 3, 2, line.data(), signal.data(), histogram.data());
+        if (!expectSeries("macd", line, {kNaN, kNaN, 0.5, 0.5, 0.5, 1.0})
+            || !expectSeries("macd signal", signal, {kNaN, kNaN, kNaN, 0.5, 0.5, 0.5 + 0.5 * 2.0 / 3.0})
+            || !expectSeries("macd hist", histogram, {kNaN, kNaN, kNaN, 0.0, 0.0, 0.5 - 0.5 * 2.0 / 3.0})) {
+            return 1;
+        }
+    }
+
+    // Bollinger bands with the population standard deviation.
+    {
+        const std::vector<double> close{1, 2, 3, 4, 8};
+        std::vector<double> upper(close.size());
+        std::vector<double> middle(close.size());
+        std::vector<double> lower(close.size());
+        kernels::bbands(close.data(), close.size(), 3, 2.0, upper.data(), middle.data(), lower.data());
+        const double narrow = 2.0 * std::sqrt(2.0 / 3.0);
+        const double wide = 2.0 * std::sqrt(14.0 / 3.0);
+        if (!expectSeries("bbands upper", upper, {kNaN, kNaN, 2 + narrow, 3 + narrow, 5 + wide})
+            || !expectSeries("bbands middle", middle, {kNaN, kNaN, 2, 3, 5})
+            || !expectSeries("bbands lower", lower, {kNaN, kNaN, 2 - narrow, 3 - narrow, 5 - wide})) {
+            return 1;
+        }
+    }
+
+    // Wilder ATR over true ranges 2, 2, 3 (gap up) and 1.5 (gap down).
+    {
+        const std::vector<double> high{10, 11, 13, 12.5};
+        const std::vector<double> low{8, 9, 12, 11};
+        const std::vector<double> close{9, 10, 12.5, 11};
+        std::vector<double> out(close.size());
+        kernels::atr(high.data(), low.data(), close.data(), close.size(), 2, out.data());
+        if (!expectSeries("atr", out, {kNaN, 2, 2.5, 2})) {
+            return 1;
+        }
+        kernels::atr(high.data(), low.data(), close.data(), close.size(), 5, out.data());
+        if (!expectSeries("atr period > n", out, {kNaN, kNaN, kNaN, kNaN})) {
+            return 1;
+        }
+    }
+
+    // VWAP restarts with each session; a session without volume yet is NaN.
+    {
+        const std::vector<std::int64_t> openTime{0, 500, 1000, 1500, 2000};
+        const std::vector<double> price{10, 20, 30, 40, 50};
+        const std::vector<double> volume{1, 3, 1, 1, 0};
+        std::vector<double> out(price.size());
+        kernels::vwap(openTime.data(), price.data(), price.data(), price.data(), volume.data(), price.size(), 1000,
+                      out.data());
+        if (!expectSeries("vwap", out, {10, 17.5, 30, 35, kNaN})) {
+            return 1;
+        }
+    }
+
+    // The handler reads warm-up candles ahead of `from`, so the first
+    // returned value is already settled.
+    app::ServiceLocator::instance().setCandleReadRepo(std::make_shared<FakeRepo>());
+    const auto from = std::to_string(kStart + 10 * kMinute);
+    const auto to = std::to_string(kStart + 14 * kMinute);
+    const auto response = getIndicators("symbol=TESTUSDT&interval=1m&type=SMA&params=3&from=" + from + "&to=" + to);
+    if (response.statusCode != 200) {
+        std::cerr << "Expected 200 from /api/v1/indicators, got " << response.statusCode << ' ' << response.body
+                  << '\n';
+        return 1;
+    }
+    const auto payload = boost::json::parse(response.body).as_object();
+    const auto& columns = payload.at("columns").as_array();
+    const auto& data = payload.at("data").as_array();
+    if (text(payload.at("type")) != "sma" || payload.at("params").as_array().size() != 1
+        || payload.at("params").as_array()[0].as_int64() != 3 || columns.size() != 2
+        || text(columns[0]) != "ts" || text(columns[1]) != "sma" || data.size() != 5) {
+        std::cerr << "Unexpected indicator payload: " << response.body << '\n';
+        return 1;
+    }
+    for (std::size_t row = 0; row < data.size(); ++row) {
+        // Close of bar i is i + 1, so the 3-bar average at bar i is i.
+        const auto bar = static_cast<std::int64_t>(row) + 10;
+        const auto& values = data[row].as_array();
+        if (values.size() != 2 || values[0].as_int64() != kStart + bar * kMinute || !values[1].is_double()
+            || !sameValue(values[1].as_double(), static_cast<double>(bar))) {
+            std::cerr << "Unexpected indicator row " << row << ": " << response.body << '\n';
+            return 1;
+        }
+    }
+
+    // Warm-up bars missing from storage come back as null.
+    const auto early = getIndicators("symbol=TESTUSDT&interval=1m&type=sma&params=3&from=" + std::to_string(kStart)
+                                     + "&to=" + std::to_string(kStart + 2 * kMinute));
+    if (early.statusCode != 200) {
+        std::cerr << "Expected 200 for the first stored bars\n";
+        return 1;
+    }
+    const auto earlyData = boost::json::parse(early.body).as_object().at("data").as_array();
+    if (earlyData.size() != 3 || !earlyData[0].as_array()[1].is_null() || !earlyData[1].as_array()[1].is_null()
+        || !sameValue(earlyData[2].as_array()[1].as_double(), 2.0)) {
+        std::cerr << "Expected null until the window fills: " << early.body << '\n';
+        return 1;
+    }
+
+    // MACD names its three outputs.
+    const auto macd = getIndicators("symbol=TESTUSDT&interval=1m&type=macd&from=" + from + "&to=" + to);
+    const auto macdColumns = boost::json::parse(macd.body).as_object().at("columns").as_array();
+    if (macd.statusCode != 200 || macdColumns.size() != 4 || text(macdColumns[1]) != "macd"
+        || text(macdColumns[2]) != "signal" || text(macdColumns[3]) != "hist") {
+        std::cerr << "Unexpected MACD columns: " << macd.body << '\n';
+        return 1;
+    }
+
+    if (!expectError("type", getIndicators("symbol=TESTUSDT&interval=1m&type=kdj"), 400, "indicator_type_invalid")
+        || !expectError("params",
+                        getIndicators("symbol=TESTUSDT&interval=1m&type=sma&params=0"),
+                        400,
+                        "indicator_params_invalid")
+        || !expectError("symbol",
+                        getIndicators("symbol=NOPEUSDT&interval=1m&type=sma&from=" + from + "&to=" + to),
+                        404,
+                        "symbol_not_found")) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "adapters/binance/BinanceWsClient.hpp"
+#include "adapters/binance/KlineMessageParser.hpp"
+
+using adapters::binance::BinanceWsClient;
+using adapters::binance::KlineMessage;
+
+namespace {
+
+// A recorded frame split around the "k" object, whose members are flat.
+struct Frame {
+    std::string head;  // up to and including "k":{
+    std::vector<std::string> members;
+    std::string tail;  // after the closing brace of "k"
+
+    std::string join() const {
+        std::string payload = head;
+        for (std::size_t i = 0; i < members.size(); ++i) {
+            payload += (i == 0 ? "" : ",") + members[i];
+        }
+        return payload + "}" + tail;
+    }
+
+    Frame without(std::string_view key) const {
+        Frame frame = *this;
+        const auto quoted = "\"" + std::string{key} + "\":";
+        const auto matches = [&quoted](const std::string& member) { return member.rfind(quoted, 0) == 0; };
+        frame.members.erase(std::remove_if(frame.members.begin(), frame.members.end(), matches), frame.members.end());
+        return frame;
+    }
+
+    Frame replaced(std::string_view key, const std::string& value) const {
+        Frame frame = *this;
+        const auto quoted = "\"" + std::string{key} + "\":";
+        for (auto& member : frame.members) {
+            if (member.rfind(quoted, 0) == 0) {
+                member = quoted + value;
+            }
+        }
+        return frame;
+    }
+};
+
+bool split(const std::string& payload, Frame& frame) {
+    const auto open = payload.find("\"k\":{");
+    const auto close = payload.find('}', open);
+    if (open == std::string::npos || close == std::string::npos) {
+        return false;
+    }
+    frame.head = payload.substr(0, open + 5);
+    frame.tail = payload.substr(close + 1);
+    frame.members.clear();
+    const auto body = payload.substr(open + 5, close - open - 5);
+    for (std::size_t begin = 0; begin <= body.size();) {
+        const auto comma = std::min(body.find(',', begin), body.size());
+        frame.members.push_back(body.substr(begin, comma - begin));
+        begin = comma + 1;
+    }
+    return true;
+}
+
+// The members of "data" around "k" swapped: "k" first, then "e", "E", "s".
+std::string kFirst(const Frame& frame) {
+    const auto data = frame.head.find("\"data\":{") + 8;
+    std::string others = frame.head.substr(data, frame.head.size() - data - 5);
+    others.pop_back();  // trailing comma
+    Frame moved = frame;
+    moved.head = frame.head.substr(0, data) + "\"k\":{";
+    moved.tail = "," + others + frame.tail;
+    return moved.join();
+}
+
+struct Outcome {
+    bool fast = false;
+    bool dom = false;
+};
+
+// The fast parser may reject anything, but whatever it accepts must match
+// the DOM parse field for field.
+bool differential(const std::string& label, const std::string& payload, Outcome& outcome) {
+    KlineMessage fast;
+    outcome.fast = adapters::binance::parse_kline_message(payload, fast);
+
+    KlineMessage dom;
+    std::string symbol;
+    try {
+        BinanceWsClient::parse_kline_message_dom(payload, dom, symbol);
+        outcome.dom = true;
+    }
+    catch (const std::exception&) {
+        outcome.dom = false;
+    }
+
+    if (!outcome.fast) {
+        return true;
+    }
+    if (!outcome.dom) {
+        std::cerr << label << ": accepted by the fast parser only: " << payload << '\n';
+        return false;
+    }
+    const auto& a = fast.candle;
+    const auto& b = dom.candle;
+    if (fast.symbol != dom.symbol || fast.eventTime != dom.eventTime || a.openTime != b.openTime
+        || a.closeTime != b.closeTime || a.open != b.open || a.high != b.high || a.low != b.low || a.close != b.close
+        || a.baseVolume != b.baseVolume || a.quoteVolume != b.quoteVolume || a.trades != b.trades
+        || a.isClosed != b.isClosed) {
+        std::cerr << label << ": parsers disagree (symbol " << fast.symbol << '/' << dom.symbol << ", E "
+                  << fast.eventTime << '/' << dom.eventTime << ", t " << a.openTime << '/' << b.openTime << ", c "
+                  << a.close << '/' << b.close << ", n " << a.trades << '/' << b.trades << "): " << payload << '\n';
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : "bench/data/binance_kline_1m.jsonl";
+    std::ifstream input(path);
+    std::vector<std::string> payloads;
+    for (std::string line; std::getline(input, line);) {
+        if (!line.empty()) {
+            payloads.push_back(line);
+        }
+    }
+    if (payloads.empty()) {
+        std::cerr << "No payloads in " << path << '\n';
+        return 1;
+    }
+
+    const std::vector<std::string_view> required{"t", "T", "s", "o", "h", "l", "c", "v", "x"};
+    const std::vector<std::string_view> optional{"q", "n", "i", "f", "L", "V", "Q", "B"};
+
+    for (std::size_t line = 0; line < payloads.size(); ++line) {
+        const auto& payload = payloads[line];
+        const auto label = std::string{path} + ":" + std::to_string(line + 1);
+        Frame frame;
+        if (!split(payload, frame)) {
+            std::cerr << label << ": no kline object\n";
+            return 1;
+        }
+
+        // Recorded frames take the fast path.
+        Outcome outcome;
+        if (!differential(label, payload, outcome)) {
+            return 1;
+        }
+        if (!outcome.fast || !outcome.dom) {
+            std::cerr << label << ": expected both parsers to accept the recorded frame\n";
+            return 1;
+        }
+
+        // Escapes anywhere in "k" fall back; the DOM decodes them.
+        const auto escapedSymbol = frame.replaced("s", "\"BTC\\u0055SDT\"").join();
+        const auto escapedOther = frame.replaced("i", "\"1\\u006d\"").join();
+        for (const auto& variant : {escapedSymbol, escapedOther}) {
+            if (!differential(label + " escaped", variant, outcome)) {
+                return 1;
+            }
+            if (outcome.fast || !outcome.dom) {
+                std::cerr << label << ": expected an escaped frame to fall back: " << variant << '\n';
+                return 1;
+            }
+        }
+
+        // Reordered members, whitespace and number forms may go either way
+        // but never disagree.
+        Frame reversed = frame;
+        std::reverse(reversed.members.begin(), reversed.members.end());
+        std::string spaced = payload;
+        for (std::size_t pos = 0; (pos = spaced.find_first_of(",:", pos)) != std::string::npos; pos += 3) {
+            spaced.insert(pos + 1, "\n ");
+        }
+        const std::vector<std::string> variants{reversed.join(),
+                                                kFirst(frame),
+                                                kFirst(reversed),
+                                                spaced,
+                                                frame.replaced("o", "67274.5").join(),
+                                                frame.replaced("t", "\"1729249980000\"").join(),
+                                                frame.replaced("x", "\"true\"").join(),
+                                                frame.replaced("s", "\"\"").join(),
+                                                frame.replaced("c", "\"+1.5\"").join(),
+                                                frame.replaced("n", "1.0").join()};
+        for (const auto& variant : variants) {
+            if (!differential(label + " variant", variant, outcome)) {
+                return 1;
+            }
+        }
+
+        // Without a required member both give up; optional ones default.
+        for (const auto key : required) {
+            if (!differential(label + " missing " + std::string{key}, frame.without(key).join(), outcome)) {
+                return 1;
+            }
+            if (outcome.fast) {
+                std::cerr << label << ": expected a frame without \"" << key << "\" to be rejected\n";
+                return 1;
+            }
+        }
+        for (const auto key : optional) {
+            if (!differential(label + " missing " + std::string{key}, frame.without(key).join(), outcome)) {
+                return 1;
+            }
+            if (!outcome.fast) {
+                std::cerr << label << ": expected a frame without \"" << key << "\" to be accepted\n";
+                return 1;
+            }
+        }
+        const auto noEventTime = payload.substr(0, payload.find("\"E\":")) + payload.substr(payload.find("\"s\":"));
+        if (!differential(label + " missing E", noEventTime, outcome) || !outcome.fast) {
+            std::cerr << label << ": expected a frame without \"E\" to be accepted\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
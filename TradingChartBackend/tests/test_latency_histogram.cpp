@@ -0,0 +1,101 @@
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "common/Metrics.hpp"
+
+using ttp::common::metrics::LatencyHistogram;
+
+namespace {
+
+// A quantile is reported to within 1/16 of the recorded value.
+bool expectQuantile(const LatencyHistogram::Merged& merged, double quantile, double expectedMs) {
+    const auto actual = merged.quantileMs(quantile);
+    if (!actual || std::abs(*actual - expectedMs) > expectedMs / 16.0) {
+        std::cerr << "q" << quantile << ": expected ~" << expectedMs << " ms, got "
+                  << (actual ? std::to_string(*actual) : std::string{"none"}) << '\n';
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    // Buckets tile the value range without gaps, and each is at most 1/16 of
+    // its lower bound wide.
+    for (std::size_t i = 0; i + 1 < LatencyHistogram::kBucketCount; ++i) {
+        const auto lower = LatencyHistogram::bucketLowerUs(i);
+        const auto upper = LatencyHistogram::bucketUpperUs(i);
+        if (lower >= upper || upper != LatencyHistogram::bucketLowerUs(i + 1)
+            || LatencyHistogram::bucketIndex(lower) != i || LatencyHistogram::bucketIndex(upper - 1) != i
+            || (i >= LatencyHistogram::kSubBuckets && (upper - lower) * LatencyHistogram::kSubBuckets > lower)) {
+            std::cerr << "Bad bucket " << i << " [" << lower << ", " << upper << ")\n";
+            return 1;
+        }
+    }
+    const auto last = LatencyHistogram::kBucketCount - 1;
+    if (LatencyHistogram::bucketIndex(std::uint64_t{1} << 41) != last
+        || LatencyHistogram::bucketIndex(std::numeric_limits<std::uint64_t>::max()) != last
+        || LatencyHistogram::bucketIndex(LatencyHistogram::bucketLowerUs(last)) != last) {
+        std::cerr << "Expected values from 2^41 us up to land in the last bucket\n";
+        return 1;
+    }
+
+    {
+        LatencyHistogram histogram;
+        if (histogram.merge().quantileMs(0.5)) {
+            std::cerr << "Expected no quantile from an empty histogram\n";
+            return 1;
+        }
+
+        // Below 16 us every microsecond has its own bucket.
+        for (std::uint64_t us = 0; us < 16; ++us) {
+            histogram.recordUs(us);
+        }
+        const auto merged = histogram.merge();
+        if (merged.count != 16 || merged.sumUs != 120 || merged.countBelowUs(8) != 8
+            || merged.quantileMs(0.0) != 0.0 || merged.quantileMs(0.5) != 0.007 || merged.quantileMs(1.0) != 0.015) {
+            std::cerr << "Expected exact quantiles below 16 us\n";
+            return 1;
+        }
+    }
+
+    {
+        // 1..1000 ms recorded from several threads.
+        LatencyHistogram histogram;
+        std::vector<std::thread> writers;
+        for (int thread = 0; thread < 4; ++thread) {
+            writers.emplace_back([&histogram, thread]() {
+                for (int ms = 1 + thread; ms <= 1000; ms += 4) {
+                    histogram.recordMs(static_cast<double>(ms));
+                }
+            });
+        }
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        histogram.recordMs(-1.0);  // clamps to 0
+
+        const auto merged = histogram.merge();
+        if (merged.count != 1001 || merged.sumUs != 500'500'000) {
+            std::cerr << "Expected 1001 values summing to 500.5 s (count=" << merged.count << ")\n";
+            return 1;
+        }
+        if (merged.quantileMs(0.0) != 0.0 || !expectQuantile(merged, 0.5, 500.0) || !expectQuantile(merged, 0.9, 900.0)
+            || !expectQuantile(merged, 0.99, 990.0) || !expectQuantile(merged, 1.0, 1000.0)) {
+            return 1;
+        }
+        // Prometheus buckets count whole histogram buckets below the bound.
+        const auto below = merged.countBelowUs(100'000);
+        if (below < 94 || below > 100) {
+            std::cerr << "Expected about 100 values below 100 ms (below=" << below << ")\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
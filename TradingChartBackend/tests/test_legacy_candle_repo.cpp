@@ -0,0 +1,119 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "adapters/legacy/LegacyCandleRepo.hpp"
+#include "infra/storage/PriceData.h"
+
+using adapters::legacy::LegacyCandleRepo;
+using domain::contracts::Interval;
+
+namespace {
+
+constexpr std::int64_t kMinute = 60'000;
+
+struct Row {
+    std::int64_t openTime;
+    double close;
+};
+
+void writeDataset(const std::filesystem::path& path, const std::vector<Row>& rows) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    for (const auto& row : rows) {
+        infra::storage::PriceData record{};
+        record.openTime = row.openTime;
+        record.openPrice = row.close;
+        record.highPrice = row.close;
+        record.lowPrice = row.close;
+        record.closePrice = row.close;
+        record.volume = 1.0;
+        out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+}
+
+bool expectRows(const char* label,
+                const std::vector<domain::contracts::Candle>& candles,
+                const std::vector<Row>& expected) {
+    bool ok = candles.size() == expected.size();
+    for (std::size_t i = 0; ok && i < candles.size(); ++i) {
+        ok = candles[i].ts == expected[i].openTime && candles[i].c == expected[i].close;
+    }
+    if (!ok) {
+        std::cerr << label << ": unexpected rows:";
+        for (const auto& candle : candles) {
+            std::cerr << ' ' << candle.ts << '=' << candle.c;
+        }
+        std::cerr << '\n';
+    }
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path() / "ttp_test_legacy_candle_repo";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const auto dataset = dir / "BTCUSDT_1m.bin";
+    LegacyCandleRepo repo({dir});
+
+    // A single record out of order in the middle of an otherwise sorted
+    // file: a sparse probe would miss it and binary search would skip rows.
+    std::vector<Row> rows;
+    for (std::int64_t i = 0; i < 4096; ++i) {
+        rows.push_back(Row{(i + 1) * kMinute, static_cast<double>(i)});
+    }
+    const auto displaced = rows[2000];
+    rows.erase(rows.begin() + 2000);
+    rows.insert(rows.begin() + 100, displaced);
+    writeDataset(dataset, rows);
+    {
+        const auto candles = repo.getCandles("BTCUSDT", Interval::OneMinute, 2000 * kMinute, 2003 * kMinute, 0);
+        const std::vector<Row> expected{
+            {2000 * kMinute, 1999}, {2001 * kMinute, 2000}, {2002 * kMinute, 2001}, {2003 * kMinute, 2002}};
+        if (!expectRows("unsorted range", candles, expected)) {
+            return 1;
+        }
+    }
+
+    // A repeated open time is answered once, with the last record written.
+    writeDataset(dataset, {{kMinute, 1}, {2 * kMinute, 2}, {3 * kMinute, 3}, {2 * kMinute, 20}, {4 * kMinute, 4}});
+    {
+        const auto candles = repo.getCandles("BTCUSDT", Interval::OneMinute, 0, 0, 0);
+        const std::vector<Row> expected{{kMinute, 1}, {2 * kMinute, 20}, {3 * kMinute, 3}, {4 * kMinute, 4}};
+        if (!expectRows("duplicate open time", candles, expected)) {
+            return 1;
+        }
+    }
+
+    // Rewriting the file with sorted rows is noticed (size changes).
+    writeDataset(dataset, {{kMinute, 1}, {2 * kMinute, 2}, {3 * kMinute, 3}});
+    {
+        const auto candles = repo.getCandles("BTCUSDT", Interval::OneMinute, 0, 0, 2);
+        if (!expectRows("sorted latest", candles, {{2 * kMinute, 2}, {3 * kMinute, 3}})) {
+            return 1;
+        }
+    }
+
+    // The per-interval time series file is never a fallback for another
+    // interval.
+    std::filesystem::remove(dataset);
+    writeDataset(dir / "BTCUSDT_1h_timeseries.bin", {{kMinute, 1}});
+    if (!repo.getCandles("BTCUSDT", Interval::OneMinute, 0, 0, 0).empty()) {
+        std::cerr << "Expected *_timeseries.bin to be excluded from the fallback lookup\n";
+        return 1;
+    }
+    writeDataset(dir / "BTCUSDT_legacy.bin", {{kMinute, 7}});
+    {
+        const auto candles = repo.getCandles("BTCUSDT", Interval::OneMinute, 0, 0, 0);
+        if (!expectRows("fallback", candles, {{kMinute, 7}})) {
+            return 1;
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+    return 0;
+}
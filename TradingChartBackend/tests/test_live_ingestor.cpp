@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "app/LiveIngestor.hpp"
+#include "common/Metrics.hpp"
+#include "domain/Ports.hpp"
+#include "domain/Types.h"
+
+namespace {
+using namespace std::chrono_literals;
+
+constexpr std::int64_t kMinute = 60'000;
+// Three catch-up pages of up to 1000 candles each.
+constexpr std::int64_t kGapCandles = 2500;
+const std::vector<std::string> kSymbols{"BTCUSDT", "ETHUSDT", "SOLUSDT"};
+
+std::int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+// Records every write and how many ran at once.
+class FakeRepo : public domain::contracts::ICandleWriteRepo {
+public:
+    explicit FakeRepo(std::int64_t lastOpenMs) : lastOpenMs_(lastOpenMs) {}
+
+    bool upsert_batch(const std::string& symbol,
+                      const std::string& interval,
+                      const std::vector<domain::Candle>& rows) override {
+        (void)interval;
+        const int inFlight = ++inFlight_;
+        maxInFlight_.store(std::max(maxInFlight_.load(), inFlight));
+        std::this_thread::sleep_for(2ms);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& row : rows) {
+                opens_[symbol].push_back(row.openTime);
+            }
+        }
+        --inFlight_;
+        return true;
+    }
+
+    std::optional<std::int64_t> max_timestamp(const std::string& symbol,
+                                              const std::string& interval) const override {
+        (void)symbol;
+        (void)interval;
+        return lastOpenMs_;
+    }
+
+    std::vector<std::int64_t> opens(const std::string& symbol) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return opens_[symbol];
+    }
+
+    int maxInFlight() const { return maxInFlight_.load(); }
+
+private:
+    const std::int64_t lastOpenMs_;
+    std::atomic<int> inFlight_{0};
+    std::atomic<int> maxInFlight_{0};
+    std::mutex mutex_;
+    std::map<std::string, std::vector<std::int64_t>> opens_;
+};
+
+// Serves every closed minute of the requested range once `serving` is set;
+// the first page of each symbol waits until every symbol is fetching, which
+// only happens when the pool runs them in parallel.
+class FakeKlines : public domain::IExchangeKlines {
+public:
+    domain::KlinesPage fetch_klines(const std::string& symbol,
+                                    domain::Interval interval,
+                                    std::int64_t from_ts,
+                                    std::int64_t to_ts,
+                                    std::size_t page_limit) override {
+        domain::KlinesPage page;
+        if (!serving.load()) {
+            return page;
+        }
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ++fetches_[symbol];
+            if (fetches_[symbol] == 1) {
+                ++fetching_;
+                cv_.notify_all();
+                parallel_ = cv_.wait_for(lock, 5s, [this]() { return fetching_ == kSymbols.size(); }) && parallel_;
+            }
+        }
+        for (auto open = from_ts * 1000; open < to_ts * 1000 && page.rows.size() < page_limit; open += interval.ms) {
+            domain::Candle candle;
+            candle.openTime = open;
+            candle.closeTime = open + interval.ms - 1;
+            candle.close = 1.0;
+            candle.isClosed = true;
+            page.rows.push_back(candle);
+        }
+        return page;
+    }
+
+    std::size_t fetches(const std::string& symbol) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return fetches_[symbol];
+    }
+
+    bool parallel() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return parallel_;
+    }
+
+    std::atomic<bool> serving{false};
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::map<std::string, std::size_t> fetches_;
+    std::size_t fetching_{0};
+    bool parallel_{true};
+};
+
+class FakeLiveKlines : public domain::IExchangeLiveKlines {
+public:
+    void subscribe(const std::vector<std::string>& symbols,
+                   domain::Interval interval,
+                   std::function<void(const std::string&, const domain::Candle&)> on_closed_candle) override {
+        (void)symbols;
+        (void)interval;
+        (void)on_closed_candle;
+        subscribed.store(true);
+    }
+
+    void set_on_reconnected(std::function<void()> callback) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        onReconnected_ = std::move(callback);
+    }
+
+    void stop() override {}
+
+    void reconnect() {
+        std::function<void()> callback;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            callback = onReconnected_;
+        }
+        if (callback) {
+            callback();
+        }
+    }
+
+    std::atomic<bool> subscribed{false};
+
+private:
+    std::mutex mutex_;
+    std::function<void()> onReconnected_;
+};
+
+bool waitFor(const std::function<bool()>& done) {
+    const auto deadline = std::chrono::steady_clock::now() + 20s;
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(5ms);
+    }
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    const domain::Interval minute{kMinute};
+    const auto lastOpenMs = domain::align_down_ms(nowMs(), kMinute) - kGapCandles * kMinute;
+    FakeRepo repo(lastOpenMs);
+    FakeKlines rest;
+    FakeLiveKlines ws;
+    auto& recoveries = ttp::common::metrics::Registry::instance().counter("catchup.recoveries_total");
+
+    app::LiveIngestor ingestor(repo, rest, ws, 4);
+    ingestor.run(kSymbols, minute);
+    if (!waitFor([&ws]() { return ws.subscribed.load(); })) {
+        std::cerr << "Expected the ingestor to subscribe\n";
+        return 1;
+    }
+
+    // Three reconnects while the first catch-up is still fetching: the later
+    // two attach to the running symbols instead of fetching the gap again.
+    const auto recoveriesBefore = recoveries.value();
+    const auto expectedLastOpen = domain::align_down_ms(nowMs(), kMinute) - kMinute;
+    rest.serving.store(true);
+    ws.reconnect();
+    ws.reconnect();
+    ws.reconnect();
+    if (!waitFor([&]() { return recoveries.value() - recoveriesBefore == 3; })) {
+        std::cerr << "Expected every reconnect to complete (completed=" << recoveries.value() - recoveriesBefore
+                  << ")\n";
+        return 1;
+    }
+    ingestor.stop();
+
+    if (!rest.parallel()) {
+        std::cerr << "Expected the symbols to be fetched in parallel\n";
+        return 1;
+    }
+    if (repo.maxInFlight() != 1) {
+        std::cerr << "Expected one writer at a time (max=" << repo.maxInFlight() << ")\n";
+        return 1;
+    }
+    for (const auto& symbol : kSymbols) {
+        // Each gap candle once, in order, up to the last closed minute.
+        const auto opens = repo.opens(symbol);
+        bool contiguous = !opens.empty() && opens.front() == lastOpenMs + kMinute;
+        for (std::size_t i = 1; contiguous && i < opens.size(); ++i) {
+            contiguous = opens[i] == opens[i - 1] + kMinute;
+        }
+        if (!contiguous || opens.back() < expectedLastOpen) {
+            std::cerr << symbol << ": expected the gap written once in order (candles=" << opens.size() << ")\n";
+            return 1;
+        }
+        // One fetch per page, plus at most one page if a minute closed while
+        // the coalesced rerun was pending.
+        if (rest.fetches(symbol) < 3 || rest.fetches(symbol) > 4) {
+            std::cerr << symbol << ": expected coalesced fetches (fetches=" << rest.fetches(symbol) << ")\n";
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,174 @@
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "logging/Log.h"
+
+using logging::LogCategory;
+
+namespace {
+
+constexpr int kThreads = 4;
+constexpr int kPerThread = 5000;
+
+std::string printfString(const char* fmt, ...)
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((format(printf, 1, 2)))
+#endif
+    ;
+
+std::string printfString(const char* fmt, ...) {
+    std::va_list args;
+    va_start(args, fmt);
+    char buffer[512];
+    std::vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+    return buffer;
+}
+
+// Message text of the INFO lines written so far, without timestamp, level
+// and category.
+std::vector<std::string> infoMessages(const std::filesystem::path& path) {
+    constexpr std::string_view kPrefix = " INFO DATA ";
+    std::vector<std::string> messages;
+    std::ifstream input(path);
+    for (std::string line; std::getline(input, line);) {
+        const auto pos = line.find(kPrefix);
+        if (pos != std::string::npos) {
+            messages.push_back(line.substr(pos + kPrefix.size()));
+        }
+    }
+    return messages;
+}
+
+}  // namespace
+
+// Logs one deferred message and keeps what printf makes of the same call.
+#define LOG_CASE(fmt, ...)                                                                                             \
+    do {                                                                                                               \
+        LOG_INFO(LogCategory::DATA, "case %zu: " fmt, expected.size(), __VA_ARGS__);                                   \
+        expected.push_back(printfString("case %zu: " fmt, expected.size(), __VA_ARGS__));                              \
+    } while (false)
+
+int main() {
+    // INFO goes to stdout; the logger thread writes it there.
+    const auto path = std::filesystem::temp_directory_path() / "ttp_test_log.out";
+    if (std::freopen(path.c_str(), "w", stdout) == nullptr) {
+        std::cerr << "Cannot redirect stdout to " << path << '\n';
+        return 1;
+    }
+    logging::Log::set_log_level(config::LogLevel::Info);
+
+    // Arguments are captured as 64-bit words and strings, then formatted on
+    // the logger thread with the conversions the format asked for.
+    std::vector<std::string> expected;
+    int local = 0;
+    LOG_CASE("%d|%5d|%-5d|%05d|%+d", -42, 7, 7, 7, 7);
+    LOG_CASE("%u %x %X %o %#x", 4'000'000'000U, 255U, 255U, 8U, 255U);
+    LOG_CASE("%lld %llu %zu %ld", -(1LL << 40), 18'446'744'073'709'551'615ULL, std::size_t{12}, -5L);
+    LOG_CASE("%hd %hhu %hhd", 70'000, 300, 200);
+    LOG_CASE("%.3f %e %g %10.4f %a", 3.14159, 1e-5, 0.5, -2.5, 1.0);
+    LOG_CASE("%s|%10s|%-10s|%.2s|", "abc", "abc", "abc", "abc");
+    LOG_CASE("%*d|%-*d|%.*s|%*s", 6, 42, 6, 42, 2, "hello", -4, "ab");
+    LOG_CASE("%c%c %% %p", 'o', 'k', static_cast<const void*>(&local));
+    const char* missing = nullptr;
+    LOG_INFO(LogCategory::DATA, "null: %s", missing);
+    expected.push_back("null: (null)");
+
+    // Strings are copied up to kMaxStringArg bytes and lines cut at the
+    // message buffer size; both cuts end in "...".
+    const std::string longText(2000, 'x');
+    LOG_INFO(LogCategory::DATA, "long: %s", longText.c_str());
+    expected.push_back("long: " + std::string(1014, 'x') + "...");
+    LOG_INFO(LogCategory::DATA, "%s", longText.c_str());
+    expected.push_back(std::string(1020, 'x') + "...");
+
+    // Disabled levels do not evaluate their arguments.
+    int evaluated = 0;
+    LOG_DEBUG(LogCategory::DATA, "debug %d", ++evaluated);
+    if (evaluated != 0) {
+        std::cerr << "Expected a disabled level to skip its arguments\n";
+        return 1;
+    }
+
+    // Each thread owns a ring: its messages come out in order, and none are
+    // lost without being counted.
+    std::vector<std::thread> writers;
+    for (int thread = 0; thread < kThreads; ++thread) {
+        writers.emplace_back([thread]() {
+            for (int seq = 0; seq < kPerThread; ++seq) {
+                LOG_INFO(LogCategory::DATA, "thread %d seq %d", thread, seq);
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    std::vector<std::string> messages;
+    std::vector<int> next(kThreads, -1);
+    int received = 0;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (true) {
+        messages = infoMessages(path);
+        received = 0;
+        next.assign(kThreads, -1);
+        for (const auto& message : messages) {
+            int thread = 0;
+            int seq = 0;
+            if (std::sscanf(message.c_str(), "thread %d seq %d", &thread, &seq) != 2) {
+                continue;
+            }
+            if (thread < 0 || thread >= kThreads || seq <= next[static_cast<std::size_t>(thread)]) {
+                std::cerr << "Out of order: " << message << '\n';
+                return 1;
+            }
+            next[static_cast<std::size_t>(thread)] = seq;
+            ++received;
+        }
+        const auto total = static_cast<std::uint64_t>(received) + logging::Log::dropped_messages();
+        if (total == kThreads * kPerThread) {
+            break;
+        }
+        if (total > kThreads * kPerThread || std::chrono::steady_clock::now() > deadline) {
+            std::cerr << "Expected " << kThreads * kPerThread << " messages written or dropped (written=" << received
+                      << " dropped=" << logging::Log::dropped_messages() << ")\n";
+            return 1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    if (messages.size() < expected.size()) {
+        std::cerr << "Missing formatted messages\n";
+        return 1;
+    }
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        if (messages[i] != expected[i]) {
+            std::cerr << "Expected '" << expected[i] << "', got '" << messages[i] << "'\n";
+            return 1;
+        }
+    }
+
+    // An idle logger sleeps until the next record arrives, then writes it.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    LOG_INFO(LogCategory::DATA, "after idle");
+    const auto wakeDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (infoMessages(path).back() != "after idle") {
+        if (std::chrono::steady_clock::now() > wakeDeadline) {
+            std::cerr << "Expected an idle logger to wake for a new record\n";
+            return 1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    std::filesystem::remove(path);
+    return 0;
+}
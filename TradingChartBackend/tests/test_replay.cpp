@@ -0,0 +1,264 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "adapters/replay/KlineRecording.hpp"
+#include "adapters/replay/ReplayKlineFeed.hpp"
+#include "adapters/replay/ReplayKlines.hpp"
+#include "domain/Types.h"
+
+using adapters::replay::KlineRecorder;
+using adapters::replay::KlineRecordingReader;
+using adapters::replay::RecordedMessage;
+using adapters::replay::ReplayKlineFeed;
+using adapters::replay::ReplayKlines;
+
+namespace {
+using namespace std::chrono_literals;
+
+constexpr std::int64_t kMinute = 60'000;
+constexpr std::int64_t kStart = 1'729'249'980;  // minute aligned, seconds
+constexpr std::int64_t kStartMs = kStart * 1000;
+
+std::string klineFrame(const std::string& symbol, std::int64_t slot, std::int64_t intervalMs, int close, bool closed) {
+    const auto open = std::to_string(kStartMs + slot * intervalMs);
+    const auto price = std::to_string(close);
+    return R"({"stream":"x@kline","data":{"e":"kline","E":)" + open + R"(,"s":")" + symbol + R"(","k":{"t":)" + open
+           + R"(,"T":)" + std::to_string(kStartMs + (slot + 1) * intervalMs - 1) + R"(,"s":")" + symbol
+           + R"(","o":")" + price + R"(","c":")" + price + R"(","h":")" + price + R"(","l":")" + price
+           + R"(","v":"1","x":)" + (closed ? "true" : "false") + "}}}";
+}
+
+const std::string kTradeFrame =
+    R"({"stream":"btcusdt@aggTrade","data":{"e":"aggTrade","E":1,"s":"BTCUSDT","a":1,"p":"100.5","q":"0.25",)"
+    R"("f":1,"l":1,"T":1729249980123,"m":true,"M":true}})";
+
+struct Delivered {
+    std::string symbol;
+    std::int64_t slot;
+    double close;
+    bool closed;
+};
+
+// Writes a recording by hand, with chosen receive times.
+void writeRecording(const std::filesystem::path& path,
+                    const std::vector<std::pair<std::int64_t, std::string>>& records) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write("TTPREC1\0", 8);
+    for (const auto& [recvNs, payload] : records) {
+        const auto length = static_cast<std::uint32_t>(payload.size());
+        out.write(reinterpret_cast<const char*>(&recvNs), sizeof(recvNs));
+        out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    }
+}
+
+}  // namespace
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path() / "ttp_test_replay";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const auto path = (dir / "klines.rec").string();
+
+    // Re-deliveries of BTCUSDT slot 1, an unclosed update, other symbols and
+    // intervals, a trade and a frame no parser accepts.
+    const std::vector<std::string> frames{klineFrame("BTCUSDT", 0, kMinute, 100, true),
+                                          klineFrame("BTCUSDT", 1, kMinute, 101, false),
+                                          klineFrame("BTCUSDT", 1, kMinute, 111, true),
+                                          klineFrame("BTCUSDT", 2, kMinute, 102, true),
+                                          klineFrame("BTCUSDT", 1, kMinute, 121, true),
+                                          klineFrame("ETHUSDT", 0, kMinute, 200, true),
+                                          klineFrame("BTCUSDT", 0, 5 * kMinute, 500, true),
+                                          kTradeFrame,
+                                          "not json",
+                                          klineFrame("BTCUSDT", 3, kMinute, 103, true)};
+    {
+        KlineRecorder recorder(path);
+        for (std::size_t i = 0; i + 1 < frames.size(); ++i) {
+            recorder.record(frames[i]);
+        }
+        if (!recorder.isOpen() || recorder.recorded() != frames.size() - 1) {
+            std::cerr << "Expected the recorder to count every frame\n";
+            return 1;
+        }
+    }
+    {
+        // Reopening appends without a second header.
+        KlineRecorder recorder(path);
+        recorder.record(frames.back());
+    }
+    {
+        // A record cut short by a crash ends the file cleanly.
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        const std::int64_t recvNs = 0;
+        const std::uint32_t length = 100;
+        out.write(reinterpret_cast<const char*>(&recvNs), sizeof(recvNs));
+        out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.write("{\"st", 4);
+    }
+
+    {
+        KlineRecordingReader reader;
+        if (!reader.open(path)) {
+            std::cerr << "Cannot open the recording\n";
+            return 1;
+        }
+        RecordedMessage message;
+        std::int64_t lastNs = 0;
+        for (const auto& frame : frames) {
+            if (!reader.next(message) || message.payload != frame || message.recvNs < lastNs) {
+                std::cerr << "Expected frames back in order: " << frame << '\n';
+                return 1;
+            }
+            lastNs = message.recvNs;
+        }
+        if (reader.next(message)) {
+            std::cerr << "Expected the truncated record to end the file\n";
+            return 1;
+        }
+        reader.rewind();
+        if (!reader.next(message) || message.payload != frames.front()) {
+            std::cerr << "Expected rewind to start over\n";
+            return 1;
+        }
+
+        const auto bad = (dir / "bad.rec").string();
+        std::ofstream(bad) << "NOTAREC!";
+        if (KlineRecordingReader{}.open(bad)) {
+            std::cerr << "Expected a file without the magic to be refused\n";
+            return 1;
+        }
+    }
+
+    {
+        // Closed candles per series, the last delivery of an open time wins,
+        // paged like the Binance REST API.
+        ReplayKlines klines(path);
+        const domain::Interval minute{kMinute};
+        if (klines.candleCount() != 6) {
+            std::cerr << "Expected 6 closed candles (candles=" << klines.candleCount() << ")\n";
+            return 1;
+        }
+        const auto first = klines.fetch_klines("btcusdt", minute, kStart, kStart + 240, 2);
+        if (first.rows.size() != 2 || first.rows[1].close != 121.0 || !first.has_more
+            || first.next_from_ts != kStart + 120) {
+            std::cerr << "Unexpected first page\n";
+            return 1;
+        }
+        const auto second = klines.fetch_klines("BTCUSDT", minute, first.next_from_ts, kStart + 240, 2);
+        if (second.rows.size() != 2 || second.rows[0].close != 102.0 || second.rows[1].close != 103.0
+            || second.has_more) {
+            std::cerr << "Unexpected second page\n";
+            return 1;
+        }
+        // Only candles closed by to_ts.
+        if (klines.fetch_klines("BTCUSDT", minute, kStart, kStart + 60, 10).rows.size() != 1
+            || klines.fetch_klines("BTCUSDT", domain::Interval{5 * kMinute}, kStart, kStart + 300, 10).rows.size() != 1
+            || !klines.fetch_klines("SOLUSDT", minute, kStart, kStart + 300, 10).rows.empty()) {
+            std::cerr << "Unexpected range, interval or symbol filtering\n";
+            return 1;
+        }
+    }
+
+    {
+        // As fast as possible: every 1m kline of the symbols, in file order.
+        ReplayKlineFeed feed(path, ReplayKlineFeed::Options{0.0, false});
+        std::vector<Delivered> delivered;
+        int reconnects = 0;
+        feed.set_on_reconnected([&reconnects]() { ++reconnects; });
+        feed.subscribe({"btcusdt", " ETHUSDT "},
+                       domain::Interval{kMinute},
+                       [&delivered](const std::string& symbol, const domain::Candle& candle) {
+                           delivered.push_back(
+                               {symbol, (candle.openTime - kStartMs) / kMinute, candle.close, candle.isClosed});
+                       });
+        feed.wait();
+        feed.stop();
+
+        const std::vector<Delivered> expected{{"BTCUSDT", 0, 100.0, true},
+                                              {"BTCUSDT", 1, 101.0, false},
+                                              {"BTCUSDT", 1, 111.0, true},
+                                              {"BTCUSDT", 2, 102.0, true},
+                                              {"BTCUSDT", 1, 121.0, true},
+                                              {"ETHUSDT", 0, 200.0, true},
+                                              {"BTCUSDT", 3, 103.0, true}};
+        bool same = delivered.size() == expected.size() && feed.delivered() == expected.size();
+        for (std::size_t i = 0; same && i < delivered.size(); ++i) {
+            same = delivered[i].symbol == expected[i].symbol && delivered[i].slot == expected[i].slot
+                   && delivered[i].close == expected[i].close && delivered[i].closed == expected[i].closed;
+        }
+        if (!same || reconnects != 1) {
+            std::cerr << "Unexpected kline replay (delivered=" << delivered.size() << " reconnects=" << reconnects
+                      << ")\n";
+            return 1;
+        }
+    }
+
+    {
+        ReplayKlineFeed feed(path, ReplayKlineFeed::Options{0.0, false});
+        std::vector<domain::AggTrade> trades;
+        feed.subscribe_trades({"BTCUSDT"}, [&trades](std::string_view symbol, const domain::AggTrade& trade) {
+            if (symbol == "BTCUSDT") {
+                trades.push_back(trade);
+            }
+        });
+        feed.wait();
+        if (trades.size() != 1 || trades[0].price != 100.5 || trades[0].quantity != 0.25
+            || trades[0].tradeTime != 1'729'249'980'123 || !trades[0].buyerIsMaker) {
+            std::cerr << "Expected the one recorded trade\n";
+            return 1;
+        }
+    }
+
+    {
+        // Looping plays the file again until stop().
+        ReplayKlineFeed feed(path, ReplayKlineFeed::Options{0.0, true});
+        std::atomic<int> count{0};
+        feed.subscribe({"BTCUSDT"}, domain::Interval{kMinute}, [&count](const auto&, const auto&) { ++count; });
+        const auto deadline = std::chrono::steady_clock::now() + 5s;
+        while (count.load() < 3 * 6 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(1ms);
+        }
+        feed.stop();
+        if (count.load() < 3 * 6) {
+            std::cerr << "Expected a looping replay to start over\n";
+            return 1;
+        }
+    }
+
+    {
+        // Paced: frames 200 ms apart at twice the recorded speed.
+        const auto paced = (dir / "paced.rec").string();
+        writeRecording(paced,
+                       {{0, klineFrame("BTCUSDT", 0, kMinute, 1, true)},
+                        {200'000'000, klineFrame("BTCUSDT", 1, kMinute, 2, true)},
+                        {400'000'000, klineFrame("BTCUSDT", 2, kMinute, 3, true)}});
+        ReplayKlineFeed feed(paced, ReplayKlineFeed::Options{2.0, false});
+        std::mutex mutex;
+        std::vector<std::chrono::steady_clock::time_point> arrivals;
+        feed.subscribe({"BTCUSDT"}, domain::Interval{kMinute}, [&](const auto&, const auto&) {
+            std::lock_guard<std::mutex> lock(mutex);
+            arrivals.push_back(std::chrono::steady_clock::now());
+        });
+        feed.wait();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (arrivals.size() != 3 || arrivals[2] - arrivals[0] < 190ms || arrivals[2] - arrivals[0] > 2s) {
+            std::cerr << "Expected about 200 ms of paced playback\n";
+            return 1;
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+    return 0;
+}
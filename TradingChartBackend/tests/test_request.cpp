@@ -0,0 +1,107 @@
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "api/Request.hpp"
+#include "http/QueryParams.hpp"
+
+using ttp::api::Request;
+
+namespace {
+
+bool expectView(const char* label, std::string_view actual, std::string_view expected) {
+    if (actual != expected) {
+        std::cerr << label << ": expected '" << expected << "', got '" << actual << "'\n";
+        return false;
+    }
+    return true;
+}
+
+bool expectParam(const Request& request, std::string_view name, std::optional<std::string_view> expected) {
+    const auto actual = request.param(name);
+    if (actual != expected) {
+        std::cerr << "param " << name << ": expected " << (expected ? "'" + std::string(*expected) + "'" : "none")
+                  << ", got " << (actual ? "'" + std::string(*actual) + "'" : "none") << '\n';
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    // Extra spaces in the request line, escapes, '+', empty and repeated
+    // parameters, padded headers and a malformed header line.
+    const Request request(
+        "GET  /api/v1/candles?symbol=BTC%55SDT&interval=1m&&limit=+5&from&x=a+b%2&symbol=ETH  HTTP/1.1\r\n"
+        "Host:  x \r\n"
+        "IF-None-Match:\t\"abc\"\t\r\n"
+        "Bad line\r\n"
+        "\r\n"
+        "body");
+    if (!expectView("method", request.method(), "GET")
+        || !expectView("path", request.path(), "/api/v1/candles")
+        || !expectView("query", request.query(), "symbol=BTC%55SDT&interval=1m&&limit=+5&from&x=a+b%2&symbol=ETH")
+        || !expectView("version", request.version(), "HTTP/1.1")) {
+        return 1;
+    }
+    if (!expectParam(request, "symbol", "BTCUSDT") || !expectParam(request, "interval", "1m")
+        || !expectParam(request, "limit", " 5") || !expectParam(request, "from", "")
+        || !expectParam(request, "x", "a b%2") || !expectParam(request, "to", std::nullopt)) {
+        return 1;
+    }
+    if (request.header("if-none-match") != std::optional<std::string_view>("\"abc\"")
+        || request.header("HOST") != std::optional<std::string_view>("x") || request.header("bad line")) {
+        std::cerr << "Expected case-insensitive, trimmed headers and no malformed header\n";
+        return 1;
+    }
+    if (ttp::http::opt_int(request, "limit")) {
+        std::cerr << "Expected ' 5' to be rejected as a limit\n";
+        return 1;
+    }
+    if (!expectView("canonical query",
+                    ttp::http::canonical_query(request),
+                    "from=&interval=1m&limit=%205&symbol=BTCUSDT&x=a%20b%252")) {
+        return 1;
+    }
+
+    // Views are offsets, so they survive a copy and a move.
+    Request copy = request;
+    const Request moved = std::move(copy);
+    if (!expectParam(moved, "symbol", "BTCUSDT") || !expectView("moved path", moved.path(), "/api/v1/candles")) {
+        return 1;
+    }
+
+    // LF-only line endings, no query, and heads cut short.
+    const Request lf("GET /ws HTTP/1.1\nUpgrade: websocket\n\n");
+    if (!expectView("lf path", lf.path(), "/ws") || !lf.query().empty()
+        || lf.header("upgrade") != std::optional<std::string_view>("websocket")) {
+        std::cerr << "Expected LF-terminated heads to parse\n";
+        return 1;
+    }
+    const Request truncated("GET /x");
+    if (!expectView("truncated path", truncated.path(), "/x") || !truncated.version().empty()) {
+        return 1;
+    }
+    const Request empty("");
+    if (!empty.method().empty() || empty.paramCount() != 0) {
+        std::cerr << "Expected an empty request to have no fields\n";
+        return 1;
+    }
+
+    // Past kInlineParams parameters spill to the heap.
+    std::string many = "GET /?";
+    for (int i = 0; i < 40; ++i) {
+        many += "k" + std::to_string(i) + "=" + std::to_string(i) + "&";
+    }
+    many += " HTTP/1.1\r\n\r\n";
+    const Request spilled(many);
+    if (spilled.paramCount() != 40 || !expectParam(spilled, "k3", "3") || !expectParam(spilled, "k39", "39")) {
+        std::cerr << "Expected 40 parameters (params=" << spilled.paramCount() << ")\n";
+        return 1;
+    }
+
+    return 0;
+}
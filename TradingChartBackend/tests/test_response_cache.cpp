@@ -0,0 +1,130 @@
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "api/Controllers.hpp"
+#include "api/ResponseCache.hpp"
+
+using ttp::api::ResponseCache;
+using ttp::api::SerializedResponse;
+
+namespace {
+using namespace std::chrono_literals;
+
+ResponseCache::Entry makeEntry(const std::string& body) {
+    auto entry = std::make_shared<SerializedResponse>();
+    entry->statusCode = 200;
+    entry->head = "HTTP/1.1 200 OK\r\n";
+    entry->body = body;
+    return entry;
+}
+
+bool expectBody(const char* label, const ResponseCache::Entry& entry, const char* expected) {
+    if (expected == nullptr ? entry != nullptr : entry == nullptr || entry->body != expected) {
+        std::cerr << label << ": expected " << (expected != nullptr ? expected : "a miss") << ", got "
+                  << (entry != nullptr ? entry->body : std::string{"a miss"}) << '\n';
+        return false;
+    }
+    return true;
+}
+
+// Keys that land in the same shard, so they share one LRU and budget.
+std::vector<std::string> sameShardKeys(std::size_t count) {
+    std::vector<std::string> keys;
+    const auto shard = std::hash<std::string>{}("k0") % ResponseCache::kShardCount;
+    for (int i = 0; keys.size() < count; ++i) {
+        auto key = "k" + std::to_string(i);
+        if (std::hash<std::string>{}(key) % ResponseCache::kShardCount == shard) {
+            keys.push_back(std::move(key));
+        }
+    }
+    return keys;
+}
+
+}  // namespace
+
+int main() {
+    {
+        ttp::api::Response response{};
+        response.statusCode = 304;
+        response.statusText = "Not Modified";
+        response.headers = {{"ETag", "\"v7\""}, {"", "dropped"}, {"Cache-Control", "no-cache"}};
+        response.body = "{}";
+        const auto serialized = ttp::api::serializeResponse(response);
+        if (serialized.statusCode != 304 || serialized.etag != "\"v7\"" || serialized.body != "{}"
+            || serialized.head
+                   != "HTTP/1.1 304 Not Modified\r\nContent-Type: application/json\r\nETag: \"v7\"\r\n"
+                      "Cache-Control: no-cache\r\n") {
+            std::cerr << "Unexpected serialized head: " << serialized.head << '\n';
+            return 1;
+        }
+    }
+
+    {
+        ResponseCache cache(1 << 20, 1h);
+        cache.store("a", 3, makeEntry("first"));
+        if (!expectBody("hit", cache.find("a", 3), "first")
+            || !expectBody("unknown key", cache.find("b", 3), nullptr)) {
+            return 1;
+        }
+        // Another version misses and drops the entry, so the old version
+        // cannot be served afterwards either.
+        if (!expectBody("new version", cache.find("a", 4), nullptr)
+            || !expectBody("dropped", cache.find("a", 3), nullptr) || cache.bytes() != 0) {
+            return 1;
+        }
+        // Storing a key again replaces it; only the new entry is counted.
+        cache.store("a", 4, makeEntry("second"));
+        const auto once = cache.bytes();
+        cache.store("a", 5, makeEntry("third"));
+        if (!expectBody("replaced", cache.find("a", 5), "third") || cache.bytes() != once - 1) {
+            std::cerr << "Expected the replacement to count only the new body\n";
+            return 1;
+        }
+    }
+
+    {
+        ResponseCache cache(1 << 20, 20ms);
+        cache.store("a", 1, makeEntry("body"));
+        std::this_thread::sleep_for(40ms);
+        if (!expectBody("expired", cache.find("a", 1), nullptr)) {
+            return 1;
+        }
+    }
+
+    {
+        // Room for three entries per shard: each costs the node overhead plus
+        // two copies of the key, the head and the body.
+        const auto keys = sameShardKeys(4);
+        const std::string body(600, 'x');
+        ResponseCache cache(ResponseCache::kShardCount * 3000, 1h);
+        for (std::size_t i = 0; i < 3; ++i) {
+            cache.store(keys[i], 1, makeEntry(body));
+        }
+        // Touching the oldest makes the second one least recently used.
+        if (cache.find(keys[0], 1) == nullptr) {
+            std::cerr << "Expected three entries to fit\n";
+            return 1;
+        }
+        cache.store(keys[3], 1, makeEntry(body));
+        if (cache.find(keys[1], 1) != nullptr || cache.find(keys[0], 1) == nullptr
+            || cache.find(keys[2], 1) == nullptr || cache.find(keys[3], 1) == nullptr) {
+            std::cerr << "Expected the least recently used entry to be evicted\n";
+            return 1;
+        }
+
+        // An entry larger than a whole shard is not stored at all.
+        cache.store("huge", 1, makeEntry(std::string(4000, 'x')));
+        if (cache.find("huge", 1) != nullptr || cache.bytes() > ResponseCache::kShardCount * 3000) {
+            std::cerr << "Expected an oversized entry to be skipped\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
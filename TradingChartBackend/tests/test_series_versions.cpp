@@ -0,0 +1,63 @@
+#include <cstdint>
+#include <iostream>
+
+#include "common/SeriesVersions.hpp"
+
+using ttp::common::SeriesVersions;
+
+int main() {
+    auto& versions = SeriesVersions::instance();
+
+    if (versions.series("BTCUSDT", "1m") != 0 || versions.symbol("BTCUSDT") != 0
+        || !versions.untouchedSince("BTCUSDT", "1m", 0, 0, 1000)) {
+        std::cerr << "Expected an unwritten series at version 0\n";
+        return 1;
+    }
+
+    // Symbols fold case; the symbol counter follows every interval.
+    versions.bump("btcusdt", "1m", 100, 200);
+    versions.bump("BTCUSDT", "1h", 0, 0);
+    if (versions.series("BTCUSDT", "1m") != 1 || versions.series("BTCUSDT", "1h") != 1
+        || versions.symbol("BtcUsdt") != 2 || versions.series("ETHUSDT", "1m") != 0) {
+        std::cerr << "Unexpected versions after two writes\n";
+        return 1;
+    }
+
+    // Ranges are inclusive at both ends and only writes after `since` count.
+    const auto since = versions.series("BTCUSDT", "1m");
+    versions.bump("BTCUSDT", "1m", 300, 400);
+    versions.bump("BTCUSDT", "1m", 500, 500);
+    if (!versions.untouchedSince("BTCUSDT", "1m", since, 0, 299)
+        || !versions.untouchedSince("BTCUSDT", "1m", since, 401, 499)
+        || versions.untouchedSince("BTCUSDT", "1m", since, 0, 300)
+        || versions.untouchedSince("BTCUSDT", "1m", since, 500, 600)
+        || versions.untouchedSince("BTCUSDT", "1m", 0, 150, 150)
+        || !versions.untouchedSince("BTCUSDT", "1m", versions.series("BTCUSDT", "1m"), 0, 1000)) {
+        std::cerr << "Unexpected untouchedSince over the write log\n";
+        return 1;
+    }
+    // Writes to another interval do not touch this one.
+    versions.bump("BTCUSDT", "1h", 0, 1000);
+    if (!versions.untouchedSince("BTCUSDT", "1m", since, 0, 299)) {
+        std::cerr << "Expected another interval's write to be ignored\n";
+        return 1;
+    }
+
+    // Once the writes since `since` no longer all fit in the log, nothing is
+    // known to be untouched.
+    const auto old = versions.series("BTCUSDT", "1m");
+    for (std::size_t i = 0; i < SeriesVersions::kWriteLogSize; ++i) {
+        versions.bump("BTCUSDT", "1m", 10'000, 10'000);
+    }
+    if (!versions.untouchedSince("BTCUSDT", "1m", old, 0, 9'999)) {
+        std::cerr << "Expected a full log of later writes to still cover the range\n";
+        return 1;
+    }
+    versions.bump("BTCUSDT", "1m", 10'000, 10'000);
+    if (versions.untouchedSince("BTCUSDT", "1m", old, 0, 9'999)) {
+        std::cerr << "Expected writes dropped from the log to count as touching\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "adapters/binance/ShardedKlineFeed.hpp"
+
+using adapters::binance::ShardedKlineFeed;
+
+namespace {
+using namespace std::chrono_literals;
+
+// Shared log of what the fake shards did, in order.
+struct Events {
+    struct Entry {
+        std::string what;  // "connect" or "stop"
+        int shard;
+    };
+
+    std::mutex mutex;
+    std::vector<Entry> entries;
+    std::vector<std::vector<std::string>> subscriptions;  // per shard id
+
+    void push(const std::string& what, int shard) {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.push_back(Entry{what, shard});
+    }
+
+    std::size_t count(const std::string& what) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return static_cast<std::size_t>(
+            std::count_if(entries.begin(), entries.end(), [&what](const Entry& entry) { return entry.what == what; }));
+    }
+
+    // Position of the first matching entry, or kMissing.
+    static constexpr std::size_t kMissing = static_cast<std::size_t>(-1);
+    std::size_t indexOf(const std::string& what, int shard) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].what == what && entries[i].shard == shard) {
+                return i;
+            }
+        }
+        return kMissing;
+    }
+};
+
+// Connects `connectDelay` after subscribe, or never when it is negative.
+class FakeShard : public domain::IExchangeLiveKlines {
+public:
+    FakeShard(Events& events, int id, std::chrono::milliseconds connectDelay)
+        : events_(events), id_(id), connectDelay_(connectDelay) {}
+
+    ~FakeShard() override { stop(); }
+
+    void subscribe(const std::vector<std::string>& symbols,
+                   domain::Interval,
+                   std::function<void(const std::string&, const domain::Candle&)>) override {
+        {
+            std::lock_guard<std::mutex> lock(events_.mutex);
+            const auto slot = static_cast<std::size_t>(id_);
+            events_.subscriptions.resize(std::max(events_.subscriptions.size(), slot + 1));
+            events_.subscriptions[slot] = symbols;
+        }
+        if (connectDelay_ < 0ms) {
+            return;
+        }
+        connector_ = std::thread([this]() {
+            std::this_thread::sleep_for(connectDelay_);
+            if (!stopped_.load()) {
+                events_.push("connect", id_);
+                if (onReconnected_) {
+                    onReconnected_();
+                }
+            }
+        });
+    }
+
+    void set_on_reconnected(std::function<void()> callback) override { onReconnected_ = std::move(callback); }
+
+    void stop() override {
+        if (stopped_.exchange(true)) {
+            return;
+        }
+        if (connector_.joinable()) {
+            connector_.join();
+        }
+        events_.push("stop", id_);
+    }
+
+private:
+    Events& events_;
+    const int id_;
+    const std::chrono::milliseconds connectDelay_;
+    std::function<void()> onReconnected_;
+    std::thread connector_;
+    std::atomic<bool> stopped_{false};
+};
+
+std::vector<std::string> makeSymbols(const std::string& prefix, int count) {
+    std::vector<std::string> symbols;
+    for (int i = 0; i < count; ++i) {
+        symbols.push_back(prefix + std::to_string(i));
+    }
+    return symbols;
+}
+
+}  // namespace
+
+int main() {
+    const auto noop = [](const std::string&, const domain::Candle&) {};
+    const domain::Interval minute{60'000};
+
+    {
+        Events events;
+        std::atomic<int> nextId{0};
+        std::atomic<int> reconnects{0};
+        ShardedKlineFeed feed([&]() { return std::make_unique<FakeShard>(events, nextId++, 30ms); }, 50);
+        feed.set_on_reconnected([&]() { reconnects.fetch_add(1); });
+
+        // 120 symbols with 50 per shard split evenly into 40/40/40.
+        feed.subscribe(makeSymbols("a", 120), minute, noop);
+        if (feed.shard_count() != 3) {
+            std::cerr << "Expected 3 shards after subscribe (shards=" << feed.shard_count() << ")\n";
+            return 1;
+        }
+
+        // 15 more go to the least loaded shards (45/45/45): every shard is
+        // replaced, and each old one stops only after its replacement
+        // connected.
+        feed.add_symbols(makeSymbols("b", 15));
+        if (feed.shard_count() != 3 || nextId.load() != 6) {
+            std::cerr << "Expected 3 replaced shards (shards=" << feed.shard_count() << ", started=" << nextId.load()
+                      << ")\n";
+            return 1;
+        }
+        for (int old = 0; old < 3; ++old) {
+            const auto stopped = events.indexOf("stop", old);
+            const auto connected = events.indexOf("connect", old + 3);
+            if (stopped == Events::kMissing || connected >= stopped) {
+                std::cerr << "Expected shard " << old << " to stop after replacement " << old + 3 << " connected\n";
+                return 1;
+            }
+        }
+        for (int shard = 3; shard < 6; ++shard) {
+            if (events.subscriptions[static_cast<std::size_t>(shard)].size() != 45) {
+                std::cerr << "Expected 45 symbols on shard " << shard << '\n';
+                return 1;
+            }
+        }
+
+        // Known symbols (in any case or spacing) change nothing.
+        feed.add_symbols({"A0", " b3 "});
+        if (nextId.load() != 6) {
+            std::cerr << "Expected no restart for known symbols\n";
+            return 1;
+        }
+
+        // 20 more fill the three shards to 50 and open a fourth with 5.
+        feed.add_symbols(makeSymbols("c", 20));
+        if (feed.shard_count() != 4 || nextId.load() != 10
+            || events.subscriptions[9].size() != 5) {
+            std::cerr << "Expected a new fourth shard with 5 symbols (shards=" << feed.shard_count() << ")\n";
+            return 1;
+        }
+
+        // The fourth shard was not waited for; give it time to connect.
+        const auto deadline = std::chrono::steady_clock::now() + 2s;
+        while (events.indexOf("connect", 9) == Events::kMissing && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(10ms);
+        }
+        feed.stop();
+        // The first shards may be retired before they connect; every
+        // connection that did happen is reported.
+        const auto connects = events.count("connect");
+        if (connects < 7 || static_cast<std::size_t>(reconnects.load()) != connects) {
+            std::cerr << "Expected every shard connection to be reported (connects=" << connects
+                      << ", reconnects=" << reconnects.load() << ")\n";
+            return 1;
+        }
+        if (feed.shard_count() != 0) {
+            std::cerr << "Expected stop to drop every shard\n";
+            return 1;
+        }
+    }
+
+    {
+        // A replacement that never connects does not keep the old shard alive
+        // past the handover timeout.
+        Events events;
+        std::atomic<int> nextId{0};
+        ShardedKlineFeed feed(
+            [&]() {
+                const int id = nextId++;
+                return std::make_unique<FakeShard>(events, id, id == 0 ? 0ms : -1ms);
+            },
+            50,
+            100ms);
+        feed.subscribe({"BTCUSDT"}, minute, noop);
+        std::this_thread::sleep_for(20ms);
+
+        const auto started = std::chrono::steady_clock::now();
+        feed.add_symbols({"ETHUSDT"});
+        const auto waited = std::chrono::steady_clock::now() - started;
+        if (waited < 100ms || waited > 2s) {
+            std::cerr << "Expected add_symbols to wait for the handover timeout\n";
+            return 1;
+        }
+        if (events.indexOf("stop", 0) == Events::kMissing) {
+            std::cerr << "Expected the old shard to stop after the timeout\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/SingleFlight.hpp"
+
+using ttp::common::SingleFlight;
+
+namespace {
+using namespace std::chrono_literals;
+
+// Holds the leader inside its function until released.
+struct Gate {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool entered{false};
+    bool open{false};
+
+    void enterAndWait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        entered = true;
+        cv.notify_all();
+        cv.wait(lock, [this]() { return open; });
+    }
+
+    void waitEntered() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this]() { return entered; });
+    }
+
+    void release() {
+        std::lock_guard<std::mutex> lock(mutex);
+        open = true;
+        cv.notify_all();
+    }
+};
+
+}  // namespace
+
+int main() {
+    {
+        // Callers arriving while the leader runs share its result.
+        SingleFlight<std::string> flights;
+        Gate gate;
+        std::atomic<int> executions{0};
+        std::atomic<int> shared{0};
+        std::vector<std::string> results(8);
+        std::vector<std::thread> threads;
+
+        const auto call = [&](std::size_t slot) {
+            const auto outcome = flights.run("BTCUSDT|1m", [&]() {
+                executions.fetch_add(1);
+                gate.enterAndWait();
+                return std::string("rows");
+            });
+            if (outcome.shared) {
+                shared.fetch_add(1);
+            }
+            results[slot] = *outcome.value;
+        };
+
+        threads.emplace_back(call, 0);
+        gate.waitEntered();
+        for (std::size_t i = 1; i < results.size(); ++i) {
+            threads.emplace_back(call, i);
+        }
+        // Waiters cannot be observed from outside; give them time to queue.
+        std::this_thread::sleep_for(100ms);
+        gate.release();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        if (executions.load() != 1 || shared.load() != 7) {
+            std::cerr << "Expected 1 execution and 7 shared results (executions=" << executions.load()
+                      << ", shared=" << shared.load() << ")\n";
+            return 1;
+        }
+        for (const auto& result : results) {
+            if (result != "rows") {
+                std::cerr << "Waiter received '" << result << "' instead of the leader's result\n";
+                return 1;
+            }
+        }
+    }
+
+    {
+        // Nothing is cached: a call after completion runs again.
+        SingleFlight<int> flights;
+        int executions = 0;
+        const auto first = flights.run("k", [&]() { return ++executions; });
+        const auto second = flights.run("k", [&]() { return ++executions; });
+        if (*first.value != 1 || *second.value != 2 || first.shared || second.shared) {
+            std::cerr << "Expected sequential calls to run independently\n";
+            return 1;
+        }
+    }
+
+    {
+        // Different keys never wait on each other.
+        SingleFlight<int> flights;
+        Gate gate;
+        std::thread leader([&]() {
+            flights.run("a", [&]() {
+                gate.enterAndWait();
+                return 1;
+            });
+        });
+        gate.waitEntered();
+        const auto other = flights.run("b", []() { return 2; });
+        gate.release();
+        leader.join();
+        if (other.shared || *other.value != 2) {
+            std::cerr << "Expected key 'b' to run while 'a' is in flight\n";
+            return 1;
+        }
+    }
+
+    {
+        // Exceptions reach the leader and every waiter, and clear the key.
+        SingleFlight<int> flights;
+        Gate gate;
+        std::atomic<int> failures{0};
+        const auto call = [&]() {
+            try {
+                flights.run("k", [&]() -> int {
+                    gate.enterAndWait();
+                    throw std::runtime_error("read failed");
+                });
+            }
+            catch (const std::runtime_error&) {
+                failures.fetch_add(1);
+            }
+        };
+
+        std::thread leader(call);
+        gate.waitEntered();
+        std::thread waiter(call);
+        std::this_thread::sleep_for(100ms);
+        gate.release();
+        leader.join();
+        waiter.join();
+        if (failures.load() != 2) {
+            std::cerr << "Expected the exception in leader and waiter (failures=" << failures.load() << ")\n";
+            return 1;
+        }
+
+        const auto retry = flights.run("k", []() { return 3; });
+        if (retry.shared || *retry.value != 3) {
+            std::cerr << "Expected a failed flight to be cleared\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
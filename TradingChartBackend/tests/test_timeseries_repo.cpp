@@ -0,0 +1,148 @@
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "infra/storage/PriceData.h"
+#include "infra/storage/PriceDataTimeSeriesRepository.h"
+
+using infra::storage::PriceDataTimeSeriesRepository;
+
+namespace {
+
+constexpr std::int64_t kMinute = 60'000;
+constexpr std::int64_t kBase = 1'700'000'040'000;  // minute aligned
+
+domain::Candle makeCandle(std::int64_t slot, double close, bool closed = true) {
+    domain::Candle candle;
+    candle.openTime = kBase + slot * kMinute;
+    candle.closeTime = closed ? candle.openTime + kMinute - 1 : candle.openTime;
+    candle.open = close;
+    candle.high = close;
+    candle.low = close;
+    candle.close = close;
+    candle.baseVolume = 1.0;
+    candle.isClosed = closed;
+    return candle;
+}
+
+std::size_t diskRecords(const std::filesystem::path& dir) {
+    std::size_t records = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        if (entry.path().filename().string().find("_timeseries.bin") != std::string::npos) {
+            records += static_cast<std::size_t>(entry.file_size()) / sizeof(infra::storage::PriceData);
+        }
+    }
+    return records;
+}
+
+bool expectSeries(const char* label, const PriceDataTimeSeriesRepository& repo, const std::vector<double>& closes) {
+    const auto latest = repo.getLatest(closes.size() + 1);
+    bool ok = latest.ok && latest.value.data.size() == closes.size();
+    for (std::size_t i = 0; ok && i < closes.size(); ++i) {
+        const auto& candle = latest.value.data[i];
+        ok = candle.openTime == kBase + static_cast<std::int64_t>(i) * kMinute && candle.close == closes[i];
+    }
+    if (!ok) {
+        std::cerr << label << ": unexpected series:";
+        if (latest.ok) {
+            for (const auto& candle : latest.value.data) {
+                std::cerr << ' ' << (candle.openTime - kBase) / kMinute << '=' << candle.close;
+            }
+        }
+        std::cerr << '\n';
+    }
+    return ok;
+}
+
+// Appends slots 0..7, then 128 rounds of an out-of-order replacement of slot 2
+// followed by an update of the forming tail candle (slot 7): every one of
+// them lands after another openTime on disk, so each supersedes a record.
+// Two more tail updates rewrite the last record in place. Returns the
+// expected closes.
+std::vector<double> writeSeries(PriceDataTimeSeriesRepository& repo) {
+    std::vector<double> expected;
+    std::vector<domain::Candle> batch;
+    for (std::int64_t slot = 0; slot < 8; ++slot) {
+        batch.push_back(makeCandle(slot, static_cast<double>(slot)));
+        expected.push_back(static_cast<double>(slot));
+    }
+    repo.appendBatch(batch);
+
+    for (int round = 0; round < 128; ++round) {
+        const double value = 100.0 + round;
+        repo.appendOrReplace(makeCandle(2, value));
+        repo.appendOrReplace(makeCandle(7, value, false));
+        expected[2] = value;
+        expected[7] = value;
+    }
+    repo.appendOrReplace(makeCandle(7, 500.0, false));
+    repo.appendOrReplace(makeCandle(7, 501.0, false));
+    expected[7] = 501.0;
+    return expected;
+}
+
+}  // namespace
+
+int main() {
+    const auto root = std::filesystem::temp_directory_path() / "ttp_test_timeseries_repo";
+    std::filesystem::remove_all(root);
+    const domain::Interval interval{kMinute};
+
+    {
+        const auto dir = root / "reload";
+        std::filesystem::create_directories(dir);
+        const infra::storage::Paths paths{dir.string()};
+
+        std::vector<double> expected;
+        {
+            PriceDataTimeSeriesRepository repo;
+            repo.bind("BTCUSDT", interval, paths);
+            expected = writeSeries(repo);
+            if (!expectSeries("in memory", repo, expected)) {
+                return 1;
+            }
+            if (diskRecords(dir) != 8 + 256) {
+                std::cerr << "Expected 264 log records (records=" << diskRecords(dir) << ")\n";
+                return 1;
+            }
+        }
+
+        // Reload replays the log: last record per openTime, sorted.
+        PriceDataTimeSeriesRepository repo;
+        repo.bind("BTCUSDT", interval, paths);
+        if (!expectSeries("reloaded", repo, expected)) {
+            return 1;
+        }
+    }
+
+    {
+        // The 256 superseded records reach the compaction threshold on their
+        // own once the dirty delay has passed.
+        const auto dir = root / "compact";
+        std::filesystem::create_directories(dir);
+        const infra::storage::Paths paths{dir.string()};
+
+        PriceDataTimeSeriesRepository repo;
+        repo.bind("BTCUSDT", interval, paths);
+        const auto expected = writeSeries(repo);
+        std::this_thread::sleep_for(std::chrono::milliseconds(600));
+        repo.flushIfNeeded();
+        if (diskRecords(dir) != 8) {
+            std::cerr << "Expected compaction to 8 records (records=" << diskRecords(dir) << ")\n";
+            return 1;
+        }
+
+        PriceDataTimeSeriesRepository reloaded;
+        reloaded.bind("BTCUSDT", interval, paths);
+        if (!expectSeries("compacted", reloaded, expected)) {
+            return 1;
+        }
+    }
+
+    std::filesystem::remove_all(root);
+    return 0;
+}
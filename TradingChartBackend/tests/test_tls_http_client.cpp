@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include "TestTls.hpp"
+#include "common/Metrics.hpp"
+#include "infra/http/TlsHttpClient.hpp"
+
+namespace net = boost::asio;
+namespace ssl = boost::asio::ssl;
+namespace http = boost::beast::http;
+using infra::http::TlsHttpClient;
+
+namespace {
+using namespace std::chrono_literals;
+
+// Local keep-alive HTTPS server, one thread per connection. "/slow" answers
+// after 200 ms, "/hang" never answers; anything else answers at once.
+class StubServer {
+public:
+    StubServer() {
+        test_support::useSelfSignedCertificate(context_);
+        acceptor_.open(net::ip::tcp::v4());
+        acceptor_.set_option(net::socket_base::reuse_address(true));
+        acceptor_.bind({net::ip::make_address("127.0.0.1"), 0});
+        acceptor_.listen();
+        thread_ = std::thread([this]() { accept_(); });
+    }
+
+    ~StubServer() {
+        stopping_.store(true);
+        net::ip::tcp::socket wake(io_);
+        boost::system::error_code ec;
+        wake.connect(acceptor_.local_endpoint(), ec);
+        thread_.join();
+        dropConnections();
+        for (auto& handler : handlers_) {
+            handler.join();
+        }
+    }
+
+    std::string host() const { return "127.0.0.1:" + std::to_string(acceptor_.local_endpoint().port()); }
+
+    int accepted() const { return accepted_.load(); }
+
+    int open() const { return open_.load(); }
+
+    // Closes every connection under the client's feet, like a server that
+    // restarted or timed out its idle keep-alives.
+    void dropConnections() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto fd : fds_) {
+            ::shutdown(fd, SHUT_RDWR);
+        }
+    }
+
+private:
+    void accept_() {
+        while (!stopping_.load()) {
+            auto socket = std::make_shared<net::ip::tcp::socket>(io_);
+            boost::system::error_code ec;
+            acceptor_.accept(*socket, ec);
+            if (ec || stopping_.load()) {
+                continue;
+            }
+            ++accepted_;
+            ++open_;
+            std::lock_guard<std::mutex> lock(mutex_);
+            fds_.push_back(socket->native_handle());
+            handlers_.emplace_back([this, socket]() {
+                serve_(std::move(*socket));
+                --open_;
+            });
+        }
+    }
+
+    void serve_(net::ip::tcp::socket socket) {
+        ssl::stream<net::ip::tcp::socket> stream(std::move(socket), context_);
+        boost::system::error_code ec;
+        stream.handshake(ssl::stream_base::server, ec);
+        boost::beast::flat_buffer buffer;
+        while (!ec && !stopping_.load()) {
+            http::request<http::string_body> request;
+            http::read(stream, buffer, request, ec);
+            if (ec) {
+                break;
+            }
+            if (request.target() == "/hang") {
+                continue;
+            }
+            if (request.target() == "/slow") {
+                std::this_thread::sleep_for(200ms);
+            }
+            http::response<http::string_body> response{http::status::ok, 11};
+            response.keep_alive(true);
+            response.set(http::field::content_type, "application/json");
+            response.body() = R"({"ok":true})";
+            response.prepare_payload();
+            http::write(stream, response, ec);
+        }
+        // Forget the descriptor before it closes and can be handed out again.
+        std::lock_guard<std::mutex> lock(mutex_);
+        fds_.erase(std::find(fds_.begin(), fds_.end(), stream.next_layer().native_handle()));
+    }
+
+    net::io_context io_;
+    ssl::context context_{ssl::context::tls_server};
+    net::ip::tcp::acceptor acceptor_{io_};
+    std::atomic<bool> stopping_{false};
+    std::atomic<int> accepted_{0};
+    std::atomic<int> open_{0};
+    std::thread thread_;
+    std::mutex mutex_;
+    std::vector<int> fds_;
+    std::vector<std::thread> handlers_;
+};
+
+std::uint64_t counter(const char* name) {
+    return ttp::common::metrics::Registry::instance().counter(name).value();
+}
+
+bool getOk(TlsHttpClient& client, const std::string& host, const std::string& target) {
+    try {
+        const auto response = client.get_json(host, target, 5);
+        return response.status == 200U && response.body == R"({"ok":true})";
+    }
+    catch (const std::exception& ex) {
+        std::cerr << target << ": " << ex.what() << '\n';
+        return false;
+    }
+}
+
+bool waitFor(const StubServer& server, int open) {
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (server.open() != open) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(5ms);
+    }
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    {
+        // Back-to-back requests share one connection.
+        StubServer server;
+        TlsHttpClient client;
+        const auto reusedBefore = counter("rest.connections_reused");
+        for (int i = 0; i < 3; ++i) {
+            if (!getOk(client, server.host(), "/ok")) {
+                return 1;
+            }
+        }
+        if (server.accepted() != 1 || counter("rest.connections_reused") - reusedBefore != 2) {
+            std::cerr << "Expected one pooled connection (accepted=" << server.accepted() << ")\n";
+            return 1;
+        }
+    }
+
+    {
+        // A connection idle past the timeout is not reused; the new one
+        // resumes the TLS session of the first.
+        StubServer server;
+        TlsHttpClient client(50ms);
+        const auto resumedBefore = counter("rest.tls_sessions_resumed");
+        if (!getOk(client, server.host(), "/ok")) {
+            return 1;
+        }
+        std::this_thread::sleep_for(100ms);
+        if (!getOk(client, server.host(), "/ok")) {
+            return 1;
+        }
+        if (server.accepted() != 2) {
+            std::cerr << "Expected the idle connection to expire (accepted=" << server.accepted() << ")\n";
+            return 1;
+        }
+        if (counter("rest.tls_sessions_resumed") - resumedBefore != 1) {
+            std::cerr << "Expected the second handshake to resume the session\n";
+            return 1;
+        }
+    }
+
+    {
+        // Two pooled connections closed by the server: the request fails on
+        // the first, then connects afresh instead of trying the other one.
+        StubServer server;
+        TlsHttpClient client;
+        bool firstOk = false;
+        std::thread other([&]() { firstOk = getOk(client, server.host(), "/slow"); });
+        const bool secondOk = getOk(client, server.host(), "/slow");
+        other.join();
+        if (!firstOk || !secondOk || server.accepted() != 2) {
+            std::cerr << "Expected two pooled connections (accepted=" << server.accepted() << ")\n";
+            return 1;
+        }
+        server.dropConnections();
+        if (!waitFor(server, 0)) {
+            std::cerr << "Expected the stub to drop its connections\n";
+            return 1;
+        }
+        if (!getOk(client, server.host(), "/ok") || server.accepted() != 3) {
+            std::cerr << "Expected one retry on a new connection (accepted=" << server.accepted() << ")\n";
+            return 1;
+        }
+    }
+
+    {
+        // A server that never answers fails the request at the timeout.
+        StubServer server;
+        TlsHttpClient client;
+        const auto started = std::chrono::steady_clock::now();
+        bool threw = false;
+        try {
+            client.get_json(server.host(), "/hang", 1);
+        }
+        catch (const std::exception&) {
+            threw = true;
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - started;
+        if (!threw || elapsed < 900ms || elapsed > 5s) {
+            std::cerr << "Expected the silent server to time out after a second\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
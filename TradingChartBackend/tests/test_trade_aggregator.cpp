@@ -0,0 +1,228 @@
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "app/TradeAggregator.hpp"
+#include "app/TradeIngestor.hpp"
+#include "domain/Models.hpp"
+#include "domain/Ports.hpp"
+#include "domain/Types.h"
+#include "domain/exchange/IExchangeTrades.hpp"
+
+using app::TradeAggregator;
+using domain::contracts::Interval;
+
+namespace {
+
+constexpr std::int64_t kT0 = 1'704'067'200'000;  // 2024-01-01 00:00 UTC
+constexpr std::int64_t kSecond = 1'000;
+constexpr std::int64_t kRetention = 60'000;
+const std::vector<domain::Interval> kIntervals{domain::Interval{1'000}, domain::Interval{5'000},
+                                               domain::Interval{15'000}};
+
+// Second 2 has no trades; +999 and +4999 are the last millisecond of their
+// buckets, +1000 and +5000 the first of the next.
+const std::vector<domain::AggTrade> kTrades{{kT0, 100.0, 1.0, false},
+                                            {kT0 + 999, 101.0, 1.0, true},
+                                            {kT0 + 1'000, 99.0, 2.0, false},
+                                            {kT0 + 3'500, 102.0, 1.0, false},
+                                            {kT0 + 4'999, 103.0, 1.0, true},
+                                            {kT0 + 5'000, 98.0, 1.0, false}};
+
+struct Bar {
+    std::int64_t openTime;
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+    double quoteVolume;
+    domain::TradeCount trades;
+};
+
+bool expectBars(const char* label,
+                const std::vector<TradeAggregator::ClosedBar>& closed,
+                std::int64_t intervalMs,
+                const std::vector<Bar>& expected) {
+    std::vector<domain::Candle> candles;
+    for (const auto& bar : closed) {
+        if (bar.symbol == "BTCUSDT" && bar.interval.ms == intervalMs) {
+            candles.push_back(bar.candle);
+        }
+    }
+    bool ok = candles.size() == expected.size();
+    for (std::size_t i = 0; ok && i < candles.size(); ++i) {
+        const auto& candle = candles[i];
+        const auto& bar = expected[i];
+        ok = candle.openTime == bar.openTime && candle.closeTime == bar.openTime + intervalMs - 1
+             && candle.open == bar.open && candle.high == bar.high && candle.low == bar.low
+             && candle.close == bar.close && candle.baseVolume == bar.volume
+             && candle.quoteVolume == bar.quoteVolume && candle.trades == bar.trades && candle.isClosed;
+    }
+    if (!ok) {
+        std::cerr << label << ' ' << intervalMs << "ms: unexpected bars:";
+        for (const auto& candle : candles) {
+            std::cerr << ' ' << candle.openTime - kT0 << '=' << candle.open << '/' << candle.high << '/'
+                      << candle.low << '/' << candle.close << " v" << candle.baseVolume << " n" << candle.trades;
+        }
+        std::cerr << '\n';
+    }
+    return ok;
+}
+
+// Records the persisted open times per symbol and interval label.
+class FakeRepo : public domain::contracts::ICandleWriteRepo {
+public:
+    bool upsert_batch(const std::string& symbol,
+                      const std::string& interval,
+                      const std::vector<domain::Candle>& rows) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& row : rows) {
+            opens_[symbol + '@' + interval].push_back(row.openTime);
+        }
+        return true;
+    }
+
+    std::optional<std::int64_t> max_timestamp(const std::string& symbol,
+                                              const std::string& interval) const override {
+        (void)symbol;
+        (void)interval;
+        return std::nullopt;
+    }
+
+    std::vector<std::int64_t> opens(const std::string& series) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return opens_[series];
+    }
+
+private:
+    std::mutex mutex_;
+    std::map<std::string, std::vector<std::int64_t>> opens_;
+};
+
+// Hands trades to the subscriber from the test thread.
+class FakeTrades : public domain::IExchangeLiveTrades {
+public:
+    void subscribe_trades(const std::vector<std::string>& symbols,
+                          std::function<void(std::string_view, const domain::AggTrade&)> on_trade) override {
+        (void)symbols;
+        onTrade_ = std::move(on_trade);
+    }
+
+    void set_on_reconnected(std::function<void()> callback) override { (void)callback; }
+
+    void stop() override {}
+
+    void push(std::string_view symbol, const domain::AggTrade& trade) { onTrade_(symbol, trade); }
+
+private:
+    std::function<void(std::string_view, const domain::AggTrade&)> onTrade_;
+};
+
+}  // namespace
+
+int main() {
+    TradeAggregator aggregator(kIntervals, kRetention);
+    for (const auto& trade : kTrades) {
+        aggregator.on_trade("BTCUSDT", trade);
+    }
+
+    // A trade on a bucket edge closes the previous bar; the empty second
+    // leaves no bar behind, and the 15s bar is still open.
+    std::vector<TradeAggregator::ClosedBar> closed;
+    aggregator.drain_closed(closed);
+    if (!expectBars("progressed",
+                    closed,
+                    1'000,
+                    {{kT0, 100.0, 101.0, 100.0, 101.0, 2.0, 201.0, 2},
+                     {kT0 + 1'000, 99.0, 99.0, 99.0, 99.0, 2.0, 198.0, 1},
+                     {kT0 + 3'000, 102.0, 102.0, 102.0, 102.0, 1.0, 102.0, 1},
+                     {kT0 + 4'000, 103.0, 103.0, 103.0, 103.0, 1.0, 103.0, 1}})
+        || !expectBars("progressed", closed, 5'000, {{kT0, 100.0, 103.0, 99.0, 103.0, 6.0, 604.0, 5}})
+        || !expectBars("progressed", closed, 15'000, {})) {
+        return 1;
+    }
+
+    // The open bars read back with the closed ones.
+    std::vector<domain::contracts::Candle> candles;
+    if (!aggregator.tryGetCandles("btcusdt", Interval::OneSecond, 0, 0, 3, candles) || candles.size() != 3
+        || candles[0].ts != kT0 + 3'000 || candles[2].ts != kT0 + 5'000 || candles[2].c != 98.0
+        || !aggregator.tryGetCandles("BTCUSDT", Interval::FifteenSeconds, kT0, 0, 10, candles) || candles.size() != 1
+        || candles[0].v != 7.0 || aggregator.tryGetCandles("BTCUSDT", Interval::FiveSeconds, 0, 0, 3, candles)) {
+        std::cerr << "Unexpected in-memory candles\n";
+        return 1;
+    }
+
+    // Idle bars close only once the newest trade on any symbol is past their
+    // end plus the grace.
+    aggregator.on_trade("ETHUSDT", {kT0 + 6'499, 2'000.0, 1.0, false});
+    aggregator.close_idle_bars(500);
+    closed.clear();
+    aggregator.drain_closed(closed);
+    if (!closed.empty()) {
+        std::cerr << "Expected no bar to close within the grace\n";
+        return 1;
+    }
+    aggregator.on_trade("ETHUSDT", {kT0 + 6'500, 2'000.0, 1.0, false});
+    aggregator.close_idle_bars(500);
+    aggregator.drain_closed(closed);
+    if (!expectBars("idle", closed, 1'000, {{kT0 + 5'000, 98.0, 98.0, 98.0, 98.0, 1.0, 98.0, 1}})
+        || !expectBars("idle", closed, 5'000, {})) {
+        return 1;
+    }
+    aggregator.on_trade("ETHUSDT", {kT0 + 20'000, 2'000.0, 1.0, false});
+    aggregator.close_idle_bars(500);
+    closed.clear();
+    aggregator.drain_closed(closed);
+    if (!expectBars("idle", closed, 5'000, {{kT0 + 5'000, 98.0, 98.0, 98.0, 98.0, 1.0, 98.0, 1}})
+        || !expectBars("idle", closed, 15'000, {{kT0, 100.0, 103.0, 98.0, 98.0, 7.0, 702.0, 6}})) {
+        return 1;
+    }
+
+    // A straggler for an already published bar is counted but changes
+    // nothing; the next in-order trade opens fresh bars.
+    const auto tradesBefore = aggregator.trades();
+    aggregator.on_trade("BTCUSDT", {kT0 + 5'500, 500.0, 1.0, false});
+    closed.clear();
+    aggregator.drain_closed(closed);
+    if (aggregator.trades() != tradesBefore + 1 || !closed.empty()
+        || !aggregator.tryGetCandles("BTCUSDT", Interval::FifteenSeconds, 0, 0, 1, candles) || candles[0].h != 103.0
+        || !aggregator.tryGetCandles("BTCUSDT", Interval::OneSecond, kT0 + 5'000, kT0 + 9'999, 10, candles)
+        || candles.size() != 1 || candles[0].c != 98.0) {
+        std::cerr << "Expected the late trade to be dropped\n";
+        return 1;
+    }
+    aggregator.on_trade("BTCUSDT", {kT0 + 20'000, 97.0, 1.0, false});
+    if (!aggregator.tryGetCandles("BTCUSDT", Interval::FifteenSeconds, 0, 0, 2, candles) || candles.size() != 2
+        || candles[0].ts != kT0 || candles[1].ts != kT0 + 15'000 || candles[1].o != 97.0) {
+        std::cerr << "Expected a fresh 15s bar after the late trade\n";
+        return 1;
+    }
+
+    // Through the ingestor, every bar closed by the feed is persisted under
+    // its interval label by the time stop() returns.
+    FakeRepo repo;
+    FakeTrades feed;
+    TradeAggregator ingested(kIntervals, kRetention);
+    {
+        app::TradeIngestor ingestor(repo, feed, ingested);
+        ingestor.run({"BTCUSDT"});
+        for (const auto& trade : kTrades) {
+            feed.push("BTCUSDT", trade);
+        }
+        ingestor.stop();
+    }
+    if (repo.opens("BTCUSDT@1s") != std::vector<std::int64_t>{kT0, kT0 + kSecond, kT0 + 3 * kSecond, kT0 + 4 * kSecond}
+        || repo.opens("BTCUSDT@5s") != std::vector<std::int64_t>{kT0} || !repo.opens("BTCUSDT@15s").empty()) {
+        std::cerr << "Unexpected persisted bars\n";
+        return 1;
+    }
+    return 0;
+}